@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: adv_policy.c
+*
+* Description: This file contains the multi-stage advertising policy. Instead
+*              of shutting BLE down as soon as fast advertising times out, the
+*              device steps down through slower advertising intervals and only
+*              hibernates after the last stage. Optionally the RTC wakes the
+*              device from hibernate periodically for a short beacon burst.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "adv_policy.h"
+#include "boot_state.h"
+#include "bond_mgr.h"
+#include "settings.h"
+#include "cyhal.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define RTC_INTR_PRIORITY         (7u)
+
+#define ADV_POLICY_COUNT(table)   ((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* The intervals and timeouts of the standard and reconnect stages are
+ * reloaded from the settings whenever a profile is restarted
+ */
+static adv_stage_t adv_standard_stages[] =
+{
+    { ADV_FAST_INTERVAL_MIN,   ADV_FAST_INTERVAL_MAX,   ADV_FAST_TIMEOUT_S,      ADV_MODE_OPEN },
+    { ADV_MEDIUM_INTERVAL_MIN, ADV_MEDIUM_INTERVAL_MAX, ADV_MEDIUM_TIMEOUT_S,    ADV_MODE_OPEN },
+    { ADV_SLOW_INTERVAL_MIN,   ADV_SLOW_INTERVAL_MAX,   ADV_SLOW_TIMEOUT_S,      ADV_MODE_OPEN },
+};
+
+static const adv_stage_t adv_beacon_stages[] =
+{
+    { ADV_FAST_INTERVAL_MIN,   ADV_FAST_INTERVAL_MAX,   ADV_BEACON_TIMEOUT_S,    ADV_MODE_OPEN },
+};
+
+/* The first stage is skipped when the address of the Central is unknown */
+static adv_stage_t adv_reconnect_stages[] =
+{
+    { ADV_FAST_INTERVAL_MIN,   ADV_FAST_INTERVAL_MAX,   ADV_DIRECTED_TIMEOUT_S,  ADV_MODE_DIRECTED },
+    { ADV_FAST_INTERVAL_MIN,   ADV_FAST_INTERVAL_MAX,   ADV_WHITELIST_TIMEOUT_S, ADV_MODE_WHITELIST },
+    { ADV_FAST_INTERVAL_MIN,   ADV_FAST_INTERVAL_MAX,   ADV_FAST_TIMEOUT_S,      ADV_MODE_OPEN },
+    { ADV_MEDIUM_INTERVAL_MIN, ADV_MEDIUM_INTERVAL_MAX, ADV_MEDIUM_TIMEOUT_S,    ADV_MODE_OPEN },
+    { ADV_SLOW_INTERVAL_MIN,   ADV_SLOW_INTERVAL_MAX,   ADV_SLOW_TIMEOUT_S,      ADV_MODE_OPEN },
+};
+
+static adv_profile_t adv_profile = ADV_PROFILE_STANDARD;
+static const adv_stage_t *adv_stages = adv_standard_stages;
+static uint8_t adv_stage_count = ADV_POLICY_COUNT(adv_standard_stages);
+static uint8_t adv_stage_index = 0u;
+
+/* Undirected advertising settings of design.cybt, restored for open stages */
+static uint8_t adv_default_type;
+static uint8_t adv_default_filter;
+
+/* Profile and stage saved for the next button wakeup. A beacon burst passes
+ * on the state retained before it.
+ */
+static adv_profile_t adv_resume_profile = ADV_PROFILE_STANDARD;
+static uint8_t adv_resume_stage = 0u;
+
+#if (ADV_BEACON_PERIOD_S > 0u)
+static cyhal_rtc_t wakeup_rtc;
+#endif
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void adv_policy_load_settings(void);
+
+
+/*******************************************************************************
+* Function Name: adv_policy_init
+********************************************************************************
+* Summary:
+*  Selects the advertising profile from the boot reason. The periodic RTC
+*  wakeup from hibernate only sends a beacon burst. A button wakeup resumes
+*  the profile retained in the backup registers, so that a bonded Central
+*  is first offered whitelist advertising; the retained stage is resumed
+*  unless it was the last one, which timed out. A cold boot uses the
+*  standard profile.
+*
+*  Must be called after boot_state_init() and settings_init().
+*
+*******************************************************************************/
+void adv_policy_init(void)
+{
+    const boot_state_t *retained = boot_state_get();
+    const cy_stc_ble_gapp_disc_param_t *disc_params =
+        cy_ble_config.discoveryModeInfo[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX].advParam;
+
+    adv_default_type = disc_params->advType;
+    adv_default_filter = disc_params->advFilterPolicy;
+
+    adv_resume_profile = ADV_PROFILE_STANDARD;
+    adv_resume_stage = 0u;
+
+    if(boot_state_is_warm() &&
+       ((ADV_PROFILE_STANDARD == retained->adv_profile) ||
+        (ADV_PROFILE_RECONNECT == retained->adv_profile)))
+    {
+        adv_resume_profile = (adv_profile_t)retained->adv_profile;
+        adv_resume_stage = retained->adv_stage;
+    }
+
+#if (ADV_BEACON_PERIOD_S > 0u)
+    (void)cyhal_rtc_init(&wakeup_rtc);
+
+    if(BOOT_REASON_TIMER == boot_state_reason())
+    {
+        adv_policy_restart(ADV_PROFILE_BEACON);
+        return;
+    }
+#endif
+
+    adv_policy_restart(adv_resume_profile);
+
+    if((adv_resume_stage > adv_stage_index) &&
+       ((adv_resume_stage + 1u) < adv_stage_count))
+    {
+        adv_stage_index = adv_resume_stage;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_restart
+********************************************************************************
+* Summary:
+*  Restarts a profile from its first stage. Called at boot and whenever a
+*  Central connects or disconnects, so that a returning Central finds the
+*  device at the fast interval.
+*
+* Parameters:
+*  adv_profile_t profile: profile to run
+*
+*******************************************************************************/
+void adv_policy_restart(adv_profile_t profile)
+{
+    cy_stc_ble_gap_bd_addr_t peer;
+
+    adv_policy_load_settings();
+    adv_profile = profile;
+    adv_stage_index = 0u;
+
+    if(ADV_PROFILE_BEACON == profile)
+    {
+        adv_stages = adv_beacon_stages;
+        adv_stage_count = ADV_POLICY_COUNT(adv_beacon_stages);
+    }
+    else if(ADV_PROFILE_RECONNECT == profile)
+    {
+        adv_stages = adv_reconnect_stages;
+        adv_stage_count = ADV_POLICY_COUNT(adv_reconnect_stages);
+
+        if(!bond_mgr_get_reconnect_peer(&peer))
+        {
+            adv_stage_index = 1u;
+        }
+    }
+    else
+    {
+        adv_stages = adv_standard_stages;
+        adv_stage_count = ADV_POLICY_COUNT(adv_standard_stages);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_current_stage
+********************************************************************************
+* Summary:
+*  Returns the parameters of the current advertising stage.
+*
+*******************************************************************************/
+const adv_stage_t* adv_policy_current_stage(void)
+{
+    return &adv_stages[adv_stage_index];
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_current_index
+********************************************************************************
+* Summary:
+*  Returns the index of the current stage in its profile.
+*
+*******************************************************************************/
+uint8_t adv_policy_current_index(void)
+{
+    return adv_stage_index;
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_apply
+********************************************************************************
+* Summary:
+*  Loads the interval and timeout of the current stage into the fast
+*  advertising parameters of the peripheral configuration, and the
+*  advertising type and filter policy of its mode into the discovery
+*  parameters. Must be called before
+*  Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, ...).
+*
+*******************************************************************************/
+void adv_policy_apply(void)
+{
+    const adv_stage_t *stage = adv_policy_current_stage();
+    cy_stc_ble_gapp_adv_params_t *adv_params =
+        &cy_ble_config.gappAdvParams[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX];
+    cy_stc_ble_gapp_disc_param_t *disc_params =
+        cy_ble_config.discoveryModeInfo[CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX].advParam;
+    cy_stc_ble_gap_bd_addr_t peer;
+
+    adv_params->fastAdvIntervalMin = stage->interval_min;
+    adv_params->fastAdvIntervalMax = stage->interval_max;
+    adv_params->fastAdvTimeOut = stage->timeout_s;
+
+    switch(stage->mode)
+    {
+        case ADV_MODE_DIRECTED:
+        {
+            (void)bond_mgr_get_reconnect_peer(&peer);
+            disc_params->advType = CY_BLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV;
+            disc_params->advFilterPolicy = CY_BLE_GAPP_SCAN_ANY_CONN_ANY;
+            disc_params->directAddrType = peer.type;
+            (void)memcpy(disc_params->directAddr, peer.bdAddr, CY_BLE_BD_ADDR_SIZE);
+            break;
+        }
+        case ADV_MODE_WHITELIST:
+        {
+            disc_params->advType = CY_BLE_GAPP_CONNECTABLE_UNDIRECTED_ADV;
+            disc_params->advFilterPolicy = CY_BLE_GAPP_SCAN_CONN_WHITELIST_ONLY;
+            break;
+        }
+        default:
+        {
+            disc_params->advType = adv_default_type;
+            disc_params->advFilterPolicy = adv_default_filter;
+            break;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_next_stage
+********************************************************************************
+* Summary:
+*  Moves to the next, slower stage after the current one timed out.
+*
+* Return:
+*  bool: false if the last stage has timed out and BLE can be shut down
+*
+*******************************************************************************/
+bool adv_policy_next_stage(void)
+{
+    if((adv_stage_index + 1u) < adv_stage_count)
+    {
+        adv_stage_index++;
+        return true;
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_save
+********************************************************************************
+* Summary:
+*  Keeps the current profile and stage in the backup registers for the next
+*  button wakeup. Called just before entering hibernate. After a beacon
+*  burst, the state retained before the burst is kept instead.
+*
+*******************************************************************************/
+void adv_policy_save(void)
+{
+    if(ADV_PROFILE_BEACON == adv_profile)
+    {
+        boot_state_save((uint8_t)adv_resume_profile, adv_resume_stage);
+    }
+    else
+    {
+        boot_state_save((uint8_t)adv_profile, adv_stage_index);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: adv_policy_hibernate_wake_sources
+********************************************************************************
+* Summary:
+*  Arms the RTC alarm for the next beacon burst, if enabled, and returns the
+*  wakeup sources to pass to cyhal_syspm_hibernate().
+*
+*******************************************************************************/
+uint32_t adv_policy_hibernate_wake_sources(void)
+{
+    uint32_t sources = CYHAL_SYSPM_HIBERNATE_PINB_LOW;
+
+#if (ADV_BEACON_PERIOD_S > 0u)
+    if(CY_RSLT_SUCCESS == cyhal_rtc_set_alarm_by_seconds(&wakeup_rtc, ADV_BEACON_PERIOD_S))
+    {
+        cyhal_rtc_enable_event(&wakeup_rtc, CYHAL_RTC_ALARM, RTC_INTR_PRIORITY, true);
+        sources |= CYHAL_SYSPM_HIBERNATE_RTC_ALARM;
+    }
+#endif
+
+    return sources;
+}
+
+
+
+/*******************************************************************************
+* Function Name: adv_policy_load_settings
+********************************************************************************
+* Summary:
+*  Loads the tunable intervals and timeouts into the stage tables. The
+*  maximum interval keeps the distance to the minimum of the defaults.
+*
+*******************************************************************************/
+static void adv_policy_load_settings(void)
+{
+    static const struct
+    {
+        settings_key_t interval;
+        settings_key_t timeout;
+        uint16_t       spread;
+    } adv_tunables[] =
+    {
+        { SETTINGS_ADV_FAST_INTERVAL,   SETTINGS_ADV_FAST_TIMEOUT,
+          ADV_FAST_INTERVAL_MAX - ADV_FAST_INTERVAL_MIN },
+        { SETTINGS_ADV_MEDIUM_INTERVAL, SETTINGS_ADV_MEDIUM_TIMEOUT,
+          ADV_MEDIUM_INTERVAL_MAX - ADV_MEDIUM_INTERVAL_MIN },
+        { SETTINGS_ADV_SLOW_INTERVAL,   SETTINGS_ADV_SLOW_TIMEOUT,
+          ADV_SLOW_INTERVAL_MAX - ADV_SLOW_INTERVAL_MIN },
+    };
+    uint32_t i;
+
+    for(i = 0u; i < ADV_POLICY_COUNT(adv_tunables); i++)
+    {
+        adv_stage_t *stage = &adv_standard_stages[i];
+
+        stage->interval_min = (uint16_t)settings_get(adv_tunables[i].interval);
+        stage->interval_max = stage->interval_min + adv_tunables[i].spread;
+        stage->timeout_s = (uint16_t)settings_get(adv_tunables[i].timeout);
+
+        /* The open stages end the reconnect profile */
+        adv_reconnect_stages[i + 2u] = *stage;
+    }
+
+    /* The whitelist stage runs at the fast interval */
+    adv_reconnect_stages[1].interval_min = adv_standard_stages[0].interval_min;
+    adv_reconnect_stages[1].interval_max = adv_standard_stages[0].interval_max;
+    adv_reconnect_stages[1].timeout_s =
+        (uint16_t)settings_get(SETTINGS_ADV_WHITELIST_TIMEOUT);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,148 @@
+/******************************************************************************
+* File Name: adv_policy.h
+*
+* Description: This file is the public interface of adv_policy.c
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef ADV_POLICY_H
+#define ADV_POLICY_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Advertising stages of the standard profile. Intervals are in 0.625 ms
+ * units, timeouts in seconds. The first stage matches the fast advertising
+ * settings in design.cybt.
+ */
+#ifndef ADV_FAST_INTERVAL_MIN
+#define ADV_FAST_INTERVAL_MIN     (32u)      /* 20 ms */
+#define ADV_FAST_INTERVAL_MAX     (48u)      /* 30 ms */
+#define ADV_FAST_TIMEOUT_S        (30u)
+#endif
+
+#ifndef ADV_MEDIUM_INTERVAL_MIN
+#define ADV_MEDIUM_INTERVAL_MIN   (244u)     /* 152.5 ms */
+#define ADV_MEDIUM_INTERVAL_MAX   (256u)     /* 160 ms */
+#define ADV_MEDIUM_TIMEOUT_S      (120u)
+#endif
+
+#ifndef ADV_SLOW_INTERVAL_MIN
+#define ADV_SLOW_INTERVAL_MIN     (1636u)    /* 1022.5 ms */
+#define ADV_SLOW_INTERVAL_MAX     (1656u)    /* 1035 ms */
+#define ADV_SLOW_TIMEOUT_S        (600u)
+#endif
+
+/* Reconnect stages tried after a bonded Central disconnects, before the
+ * standard stages. High duty cycle directed advertising is stopped by the
+ * controller after 1.28 s.
+ */
+#ifndef ADV_DIRECTED_TIMEOUT_S
+#define ADV_DIRECTED_TIMEOUT_S    (1u)
+#endif
+
+#ifndef ADV_WHITELIST_TIMEOUT_S
+#define ADV_WHITELIST_TIMEOUT_S   (10u)
+#endif
+
+/* Beacon burst sent after a periodic wakeup from hibernate */
+#ifndef ADV_BEACON_TIMEOUT_S
+#define ADV_BEACON_TIMEOUT_S      (5u)
+#endif
+
+/* Period of the hibernate wakeup beacon burst in seconds; 0 disables the
+ * periodic wakeup and the device only wakes up on the user button.
+ */
+#ifndef ADV_BEACON_PERIOD_S
+#define ADV_BEACON_PERIOD_S       (0u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    ADV_MODE_OPEN,            /* undirected, any Central may connect */
+    ADV_MODE_WHITELIST,       /* undirected, bonded Centrals only */
+    ADV_MODE_DIRECTED         /* high duty cycle, directed to one Central */
+} adv_mode_t;
+
+typedef struct
+{
+    uint16_t   interval_min;
+    uint16_t   interval_max;
+    uint16_t   timeout_s;
+    adv_mode_t mode;
+} adv_stage_t;
+
+typedef enum
+{
+    ADV_PROFILE_STANDARD,     /* fast -> medium -> slow, then hibernate */
+    ADV_PROFILE_BEACON,       /* short fast burst, then hibernate */
+    ADV_PROFILE_RECONNECT     /* directed -> whitelist -> standard */
+} adv_profile_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void adv_policy_init(void);
+void adv_policy_restart(adv_profile_t profile);
+const adv_stage_t* adv_policy_current_stage(void);
+uint8_t adv_policy_current_index(void);
+void adv_policy_apply(void);
+bool adv_policy_next_stage(void);
+void adv_policy_save(void);
+uint32_t adv_policy_hibernate_wake_sources(void);
+
+
+#endif  /* ADV_POLICY_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,269 @@
+/******************************************************************************
+* File Name: alert_pattern.c
+*
+* Description: This file contains the indication pattern engine. All channels
+*              share one tickless software timer that is armed for the next
+*              step change only, so the CPU stays in deep sleep between
+*              edges and does no work while a step is held.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "alert_pattern.h"
+#include "app_timer.h"
+#include <stddef.h>
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    const alert_pattern_t *pattern;
+    uint8_t                step;
+    bool                   running;   /* false once a held step is reached */
+    uint32_t               deadline;  /* end of the current step, in ticks */
+} alert_channel_state_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const alert_backend_t *pattern_backend = NULL;
+static alert_channel_state_t pattern_channels[ALERT_CHANNEL_COUNT];
+static app_timer_t pattern_timer;
+
+/* Number of step changes played, to compare the wakeups of patterns */
+static uint32_t pattern_edges = 0u;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void alert_pattern_enter_step(alert_channel_t channel, uint32_t start);
+static void alert_pattern_schedule(void);
+static void alert_pattern_timer_callback(void *arg);
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_init
+********************************************************************************
+* Summary:
+*  Stops all channels and selects the output backend. Must be called after
+*  app_timer_init().
+*
+* Parameters:
+*  const alert_backend_t *backend: output backend
+*
+*******************************************************************************/
+void alert_pattern_init(const alert_backend_t *backend)
+{
+    uint32_t i;
+
+    pattern_backend = backend;
+    app_timer_stop(&pattern_timer);
+
+    for(i = 0u; i < (uint32_t)ALERT_CHANNEL_COUNT; i++)
+    {
+        pattern_channels[i].pattern = NULL;
+        pattern_channels[i].running = false;
+        pattern_backend->set_outputs((alert_channel_t)i, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_play
+********************************************************************************
+* Summary:
+*  Starts a pattern on a channel. Playing the pattern that is already running
+*  keeps its phase.
+*
+* Parameters:
+*  alert_channel_t channel:        channel
+*  const alert_pattern_t *pattern: pattern to play
+*
+*******************************************************************************/
+void alert_pattern_play(alert_channel_t channel, const alert_pattern_t *pattern)
+{
+    if(pattern == pattern_channels[channel].pattern)
+    {
+        return;
+    }
+
+    pattern_channels[channel].pattern = pattern;
+    pattern_channels[channel].step = 0u;
+    alert_pattern_enter_step(channel, app_timer_now());
+    alert_pattern_schedule();
+}
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_get_edge_count
+********************************************************************************
+* Summary:
+*  Returns the number of step changes played since init.
+*
+*******************************************************************************/
+uint32_t alert_pattern_get_edge_count(void)
+{
+    return pattern_edges;
+}
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_enter_step
+********************************************************************************
+* Summary:
+*  Sets the outputs of the current step of a channel and computes when the
+*  step ends.
+*
+* Parameters:
+*  alert_channel_t channel: channel
+*  uint32_t start:          start of the step, in ticks
+*
+*******************************************************************************/
+static void alert_pattern_enter_step(alert_channel_t channel, uint32_t start)
+{
+    alert_channel_state_t *state = &pattern_channels[channel];
+    const alert_step_t *step = &state->pattern->steps[state->step];
+
+    pattern_backend->set_outputs(channel, step->outputs);
+    pattern_edges++;
+
+    state->running = (0u != step->duration_ms);
+    state->deadline = start + APP_TIMER_MS_TO_TICKS(step->duration_ms);
+
+    /* Restart the timing if the wakeup came later than the whole step */
+    if((int32_t)(app_timer_now() - state->deadline) >= 0)
+    {
+        state->deadline = app_timer_now() + APP_TIMER_MS_TO_TICKS(step->duration_ms);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_schedule
+********************************************************************************
+* Summary:
+*  Arms the pattern timer for the earliest step change of all channels, or
+*  stops it if every channel holds its outputs.
+*
+*******************************************************************************/
+static void alert_pattern_schedule(void)
+{
+    uint32_t now = app_timer_now();
+    uint32_t delay = UINT32_MAX;
+    uint32_t i;
+
+    for(i = 0u; i < (uint32_t)ALERT_CHANNEL_COUNT; i++)
+    {
+        if(pattern_channels[i].running)
+        {
+            int32_t remaining = (int32_t)(pattern_channels[i].deadline - now);
+
+            if(remaining < 0)
+            {
+                remaining = 0;
+            }
+
+            if((uint32_t)remaining < delay)
+            {
+                delay = (uint32_t)remaining;
+            }
+        }
+    }
+
+    if(UINT32_MAX == delay)
+    {
+        app_timer_stop(&pattern_timer);
+    }
+    else
+    {
+        app_timer_start(&pattern_timer, delay, 0u, alert_pattern_timer_callback, NULL);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: alert_pattern_timer_callback
+********************************************************************************
+* Summary:
+*  Pattern timer callback. Advances every channel whose step has ended. The
+*  next step starts at the end of the previous one, so the pattern timing
+*  does not drift with the wakeup latency.
+*
+*******************************************************************************/
+static void alert_pattern_timer_callback(void *arg)
+{
+    uint32_t now = app_timer_now();
+    uint32_t i;
+
+    (void)arg;
+
+    for(i = 0u; i < (uint32_t)ALERT_CHANNEL_COUNT; i++)
+    {
+        alert_channel_state_t *state = &pattern_channels[i];
+
+        if(state->running && ((int32_t)(now - state->deadline) >= 0))
+        {
+            if((state->step + 1u) < state->pattern->count)
+            {
+                state->step++;
+            }
+            else if(state->pattern->repeat)
+            {
+                state->step = 0u;
+            }
+            else
+            {
+                /* Non-repeating pattern finished: hold the last step */
+                state->running = false;
+                continue;
+            }
+
+            alert_pattern_enter_step((alert_channel_t)i, state->deadline);
+        }
+    }
+
+    alert_pattern_schedule();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,117 @@
+/******************************************************************************
+* File Name: alert_pattern.h
+*
+* Description: This file is the public interface of alert_pattern.c, the
+*              engine that plays LED and buzzer indication patterns.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef ALERT_PATTERN_H
+#define ALERT_PATTERN_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Outputs of a channel that a pattern step turns on */
+#define ALERT_OUTPUT_LED          (0x01u)
+#define ALERT_OUTPUT_BUZZER       (0x02u)
+
+/* Number of elements in a step table */
+#define ALERT_PATTERN_STEPS(table) (sizeof(table) / sizeof((table)[0]))
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    ALERT_CHANNEL_LINK,       /* CYBSP_USER_LED1: advertising/connected */
+    ALERT_CHANNEL_ALERT,      /* CYBSP_USER_LED2 and buzzer: alert level */
+    ALERT_CHANNEL_COUNT
+} alert_channel_t;
+
+/* One step of a pattern: the outputs held for duration_ms. A step with a
+ * duration of 0 is held until another pattern is played.
+ */
+typedef struct
+{
+    uint16_t duration_ms;
+    uint8_t  outputs;
+} alert_step_t;
+
+/* Patterns are const tables; the steps of a repeating pattern are played in
+ * a loop.
+ */
+typedef struct
+{
+    const alert_step_t *steps;
+    uint8_t             count;
+    bool                repeat;
+} alert_pattern_t;
+
+/* Output backend. The engine only decides when outputs change; the backend
+ * drives the pins.
+ */
+typedef struct
+{
+    void (*set_outputs)(alert_channel_t channel, uint8_t outputs);
+} alert_backend_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void alert_pattern_init(const alert_backend_t *backend);
+void alert_pattern_play(alert_channel_t channel, const alert_pattern_t *pattern);
+uint32_t alert_pattern_get_edge_count(void);
+
+
+#endif  /* ALERT_PATTERN_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,413 @@
+/******************************************************************************
+* File Name: app_event.c
+*
+* Description: This file contains the lock-free event queue used by the
+*              interrupt handlers to hand work to the main loop.
+*
+*              Producers are interrupt handlers of any priority; the consumer
+*              is the main loop. Every slot carries a sequence number, so a
+*              slot claimed by a producer becomes visible to the consumer only
+*              once its contents are written (bounded queue of D. Vyukov).
+*              Events posted with coalescing are dropped while an event of the
+*              same type is still waiting in the queue. Such an event is never
+*              rejected: if the queue is full, it waits in a per-type overflow
+*              set that is read once the queue is empty.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "app_event.h"
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define APP_EVENT_QUEUE_MASK      (APP_EVENT_QUEUE_SIZE - 1u)
+
+#if ((APP_EVENT_QUEUE_SIZE & APP_EVENT_QUEUE_MASK) != 0u)
+#error "APP_EVENT_QUEUE_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    /* Equal to the queue position when the slot is free for a producer, and
+     * to the position plus one once its event can be read.
+     */
+    volatile uint32_t sequence;
+    app_event_t       event;
+
+    /* Bit of the event type in event_coalesce_mask if the event was posted
+     * with coalescing, 0 otherwise
+     */
+    uint32_t          coalesce_bit;
+} app_event_slot_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static app_event_slot_t event_queue[APP_EVENT_QUEUE_SIZE];
+
+/* Free-running positions. event_wr is claimed by the producers with an
+ * exclusive load/store pair; event_rd is only written by the main loop.
+ */
+static volatile uint32_t event_wr = 0u;
+static volatile uint32_t event_rd = 0u;
+
+/* One bit per event type that is waiting with coalescing, in the queue or
+ * in the overflow set. The producer that sets the bit owns the event until
+ * the main loop clears it again.
+ */
+static volatile uint32_t event_coalesce_mask = 0u;
+
+/* Coalescing events that found the queue full, with their data. They are
+ * read after the queued events, so a merged post is never lost.
+ */
+static volatile uint32_t event_overflow_mask = 0u;
+static uint32_t event_overflow_data[APP_EVENT_TYPE_COUNT];
+
+static volatile uint32_t event_dropped = 0u;
+static volatile uint32_t event_coalesced = 0u;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool app_event_get_overflow(app_event_t *event);
+static uint32_t app_event_fetch_or(volatile uint32_t *word, uint32_t bits);
+static void app_event_fetch_and(volatile uint32_t *word, uint32_t bits);
+static void app_event_increment(volatile uint32_t *word);
+
+
+/*******************************************************************************
+* Function Name: app_event_init
+********************************************************************************
+* Summary:
+*  Empties the queue. Must be called before the interrupts that post events
+*  are enabled.
+*
+*******************************************************************************/
+void app_event_init(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < APP_EVENT_QUEUE_SIZE; i++)
+    {
+        event_queue[i].sequence = i;
+    }
+
+    event_wr = 0u;
+    event_rd = 0u;
+    event_coalesce_mask = 0u;
+    event_overflow_mask = 0u;
+    event_dropped = 0u;
+    event_coalesced = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_post
+********************************************************************************
+* Summary:
+*  Adds an event to the queue. Safe to call from interrupt handlers of any
+*  priority and from the main loop; never blocks.
+*
+* Parameters:
+*  app_event_type_t type: event type
+*  uint32_t data:         event data
+*  bool coalesce:         drop the event if one of the same type, also posted
+*                         with coalescing, is still waiting in the queue
+*
+* Return:
+*  bool: true if the event is queued or merged with a queued one, false if
+*        the queue is full. A coalescing event that finds the queue full is
+*        kept in the overflow set instead, so it is never rejected.
+*
+*******************************************************************************/
+bool app_event_post(app_event_type_t type, uint32_t data, bool coalesce)
+{
+    uint32_t bit = 1u << (uint32_t)type;
+    uint32_t pos;
+    app_event_slot_t *slot;
+
+    if(coalesce && (0u != (app_event_fetch_or(&event_coalesce_mask, bit) & bit)))
+    {
+        app_event_increment(&event_coalesced);
+        return true;
+    }
+
+    /* Claim a slot. A producer that is interrupted between the exclusive load
+     * and store retries with the position left by the interrupting producer.
+     */
+    do
+    {
+        pos = __LDREXW(&event_wr);
+        slot = &event_queue[pos & APP_EVENT_QUEUE_MASK];
+
+        if(slot->sequence != pos)
+        {
+            /* The consumer has not released this slot yet: queue full */
+            __CLREX();
+
+            if(coalesce)
+            {
+                /* Other posts of this type may already have merged into
+                 * this one, so it must still be delivered
+                 */
+                event_overflow_data[type] = data;
+                __DMB();
+                (void)app_event_fetch_or(&event_overflow_mask, bit);
+                return true;
+            }
+            app_event_increment(&event_dropped);
+            return false;
+        }
+    } while(0u != __STREXW(pos + 1u, &event_wr));
+
+    slot->event.type = type;
+    slot->event.data = data;
+    slot->coalesce_bit = coalesce ? bit : 0u;
+
+    /* Publish the slot only after its contents are written */
+    __DMB();
+    slot->sequence = pos + 1u;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_get
+********************************************************************************
+* Summary:
+*  Removes the oldest event from the queue, or when the queue is empty a
+*  coalescing event that found it full. Must only be called from the main
+*  loop.
+*
+* Parameters:
+*  app_event_t *event: destination
+*
+* Return:
+*  bool: false if the queue is empty
+*
+*******************************************************************************/
+bool app_event_get(app_event_t *event)
+{
+    uint32_t pos = event_rd;
+    app_event_slot_t *slot = &event_queue[pos & APP_EVENT_QUEUE_MASK];
+
+    if(slot->sequence != (pos + 1u))
+    {
+        return app_event_get_overflow(event);
+    }
+
+    __DMB();
+
+    /* A new event of this type is queued again from now on. Posts that
+     * merged before this point are covered by the event read below.
+     */
+    if(0u != slot->coalesce_bit)
+    {
+        app_event_fetch_and(&event_coalesce_mask, ~slot->coalesce_bit);
+        __DMB();
+    }
+    *event = slot->event;
+
+    /* Release the slot only after the event has been copied out */
+    __DMB();
+    slot->sequence = pos + APP_EVENT_QUEUE_SIZE;
+    event_rd = pos + 1u;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_pending
+********************************************************************************
+* Summary:
+*  Returns true if an event is waiting, queued or in the overflow set. Called with interrupts disabled to
+*  decide whether the CPU may sleep: an interrupt that becomes pending after
+*  the check still ends the WFI, so no event is left waiting for a later
+*  wakeup.
+*
+*******************************************************************************/
+bool app_event_pending(void)
+{
+    uint32_t pos = event_rd;
+
+    return ((event_queue[pos & APP_EVENT_QUEUE_MASK].sequence == (pos + 1u)) ||
+            (0u != event_overflow_mask));
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_get_dropped
+********************************************************************************
+* Summary:
+*  Returns the number of events lost because the queue was full. Only events
+*  posted without coalescing are lost.
+*
+*******************************************************************************/
+uint32_t app_event_get_dropped(void)
+{
+    return event_dropped;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_get_coalesced
+********************************************************************************
+* Summary:
+*  Returns the number of events merged with an event already in the queue.
+*
+*******************************************************************************/
+uint32_t app_event_get_coalesced(void)
+{
+    return event_coalesced;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_get_overflow
+********************************************************************************
+* Summary:
+*  Removes the coalescing event of lowest type from the overflow set. Its
+*  producer keeps owning the type, and so cannot write the data again, until
+*  the coalescing bit is cleared after the data was read.
+*
+* Parameters:
+*  app_event_t *event: destination
+*
+* Return:
+*  bool: false if the overflow set is empty
+*
+*******************************************************************************/
+static bool app_event_get_overflow(app_event_t *event)
+{
+    uint32_t mask = event_overflow_mask;
+    uint32_t type;
+    uint32_t bit;
+
+    if(0u == mask)
+    {
+        return false;
+    }
+
+    for(type = 0u; 0u == (mask & (1u << type)); type++)
+    {
+    }
+    bit = 1u << type;
+
+    app_event_fetch_and(&event_overflow_mask, ~bit);
+    __DMB();
+    event->type = (app_event_type_t)type;
+    event->data = event_overflow_data[type];
+    __DMB();
+    app_event_fetch_and(&event_coalesce_mask, ~bit);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_fetch_or
+********************************************************************************
+* Summary:
+*  Atomically sets bits in a word shared with interrupt handlers.
+*
+* Return:
+*  uint32_t: value of the word before the update
+*
+*******************************************************************************/
+static uint32_t app_event_fetch_or(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while(0u != __STREXW(old | bits, word));
+
+    return old;
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_fetch_and
+********************************************************************************
+* Summary:
+*  Atomically clears the bits of a word that are zero in the mask.
+*
+*******************************************************************************/
+static void app_event_fetch_and(volatile uint32_t *word, uint32_t bits)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while(0u != __STREXW(old & bits, word));
+}
+
+
+/*******************************************************************************
+* Function Name: app_event_increment
+********************************************************************************
+* Summary:
+*  Atomically increments a counter shared with interrupt handlers.
+*
+*******************************************************************************/
+static void app_event_increment(volatile uint32_t *word)
+{
+    uint32_t old;
+
+    do
+    {
+        old = __LDREXW(word);
+    } while(0u != __STREXW(old + 1u, word));
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,98 @@
+/******************************************************************************
+* File Name: app_event.h
+*
+* Description: This file is the public interface of app_event.c, the event
+*              queue between the interrupt handlers and the main loop.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef APP_EVENT_H
+#define APP_EVENT_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Number of queue slots. Must be a power of two. */
+#ifndef APP_EVENT_QUEUE_SIZE
+#define APP_EVENT_QUEUE_SIZE      (16u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    APP_EVENT_TIMER,          /* Wakeup timer expired */
+    APP_EVENT_BUTTON,         /* User button edge; data holds the pin level */
+    APP_EVENT_BLE,            /* BLESS interrupt; the stack has work pending */
+    APP_EVENT_TYPE_COUNT
+} app_event_type_t;
+
+typedef struct
+{
+    app_event_type_t type;
+    uint32_t         data;
+} app_event_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void app_event_init(void);
+bool app_event_post(app_event_type_t type, uint32_t data, bool coalesce);
+bool app_event_get(app_event_t *event);
+bool app_event_pending(void);
+uint32_t app_event_get_dropped(void);
+uint32_t app_event_get_coalesced(void);
+
+
+#endif  /* APP_EVENT_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,416 @@
+/******************************************************************************
+* File Name: app_log.c
+*
+* Description: This file contains the deferred, tokenized logger. Call sites
+*              store a compact record (message ID and one 32-bit argument) in
+*              a RAM ring. The ring is drained to the debug UART from the main
+*              loop, outside of the BLE event handlers.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "app_log.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+
+#if (APP_LOG_LEVEL > APP_LOG_LEVEL_NONE)
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define APP_LOG_RING_MASK         (APP_LOG_RING_SIZE - 1u)
+
+/* Longest text line, with the prefix and the line end. A line is only
+ * written once the UART FIFO (128 bytes) has room for all of it.
+ */
+#define APP_LOG_LINE_SIZE         (80u)
+
+#if ((APP_LOG_RING_SIZE & APP_LOG_RING_MASK) != 0u)
+#error "APP_LOG_RING_SIZE must be a power of two"
+#endif
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    uint8_t  level;
+    uint8_t  id;
+    uint32_t arg;
+} app_log_record_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static app_log_record_t log_ring[APP_LOG_RING_SIZE];
+
+/* Free-running indices. log_wr is only written by the producer (the BLE
+ * event path) and log_rd only by the consumer (the drain), so no lock is
+ * needed on a single core.
+ */
+static volatile uint32_t log_wr = 0u;
+static volatile uint32_t log_rd = 0u;
+
+/* Records lost because the ring was full, and how many have been reported */
+static volatile uint32_t log_dropped = 0u;
+static uint32_t log_dropped_reported = 0u;
+
+/* Records are kept in the ring until the debug UART is initialized */
+static bool log_started = false;
+
+/* Optional second consumer, see app_log_set_tap() */
+static app_log_tap_t log_tap = NULL;
+
+#if (APP_LOG_TEXT != 0u)
+#define APP_LOG_TEXT_ENTRY(name, text)  text,
+
+static const char * const log_text[APP_LOG_ID_COUNT] =
+{
+    APP_LOG_MESSAGES(APP_LOG_TEXT_ENTRY)
+};
+
+static const char * const log_prefix[] =
+{
+    "",
+    "[ERROR] : ",
+    "[INFO] : "
+};
+
+#undef APP_LOG_TEXT_ENTRY
+
+/* Text of the next record, formatted but not yet written to the UART */
+static char log_line[APP_LOG_LINE_SIZE];
+static uint32_t log_line_length = 0u;
+#endif
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool app_log_emit(const app_log_record_t *record);
+#if (APP_LOG_TEXT != 0u)
+static bool app_log_send_line(void);
+#endif
+
+
+/*******************************************************************************
+* Function Name: app_log_write
+********************************************************************************
+* Summary:
+*  Stores a log record in the RAM ring. The call never blocks; if the ring is
+*  full the record is dropped and counted.
+*
+* Parameters:
+*  uint8_t level:     APP_LOG_LEVEL_ERROR or APP_LOG_LEVEL_INFO
+*  app_log_id_t id:   message token
+*  uint32_t arg:      argument consumed by the message text, if any
+*
+*******************************************************************************/
+void app_log_write(uint8_t level, app_log_id_t id, uint32_t arg)
+{
+    uint32_t wr = log_wr;
+
+    if((wr - log_rd) >= APP_LOG_RING_SIZE)
+    {
+        log_dropped++;
+    }
+    else
+    {
+        log_ring[wr & APP_LOG_RING_MASK].level = level;
+        log_ring[wr & APP_LOG_RING_MASK].id = (uint8_t)id;
+        log_ring[wr & APP_LOG_RING_MASK].arg = arg;
+
+        /* Publish the record only after its contents are written */
+        __DMB();
+        log_wr = wr + 1u;
+    }
+
+    if(NULL != log_tap)
+    {
+        log_tap(level, id, arg);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_log_start
+********************************************************************************
+* Summary:
+*  Enables the output of the records. Must be called once the debug UART is
+*  initialized; records written before are kept in the ring.
+*
+*******************************************************************************/
+void app_log_start(void)
+{
+    log_started = true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_log_drain
+********************************************************************************
+* Summary:
+*  Moves pending records to the debug UART. Only as many records (binary
+*  records or whole text lines) as fit in the UART FIFO are written, so the
+*  call does not wait on the UART.
+*
+* Return:
+*  bool: true if records are still pending in the ring
+*
+*******************************************************************************/
+bool app_log_drain(void)
+{
+    app_log_record_t record;
+    uint32_t dropped = log_dropped;
+
+    if(!log_started)
+    {
+        return (log_rd != log_wr);
+    }
+
+#if (APP_LOG_TEXT != 0u)
+    /* A line left over from the last call goes out first */
+    (void)app_log_send_line();
+#endif
+
+    if(dropped != log_dropped_reported)
+    {
+        record.level = APP_LOG_LEVEL_ERROR;
+        record.id = (uint8_t)APP_LOG_ID_LOG_OVERFLOW;
+        record.arg = dropped - log_dropped_reported;
+
+        if(app_log_emit(&record))
+        {
+            log_dropped_reported = dropped;
+        }
+    }
+
+    while(log_rd != log_wr)
+    {
+        record = log_ring[log_rd & APP_LOG_RING_MASK];
+
+        if(!app_log_emit(&record))
+        {
+            break;
+        }
+
+        /* Release the slot only after the record has been copied out */
+        __DMB();
+        log_rd = log_rd + 1u;
+    }
+
+#if (APP_LOG_TEXT != 0u)
+    return ((log_rd != log_wr) || (0u != log_line_length));
+#else
+    return (log_rd != log_wr);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: app_log_flush
+********************************************************************************
+* Summary:
+*  Drains the ring completely and waits until the UART has shifted out the
+*  last byte. Used before entering hibernate, where the UART is powered off.
+*
+*******************************************************************************/
+void app_log_flush(void)
+{
+    if(!log_started)
+    {
+        return;
+    }
+
+    while(app_log_drain())
+    {
+    }
+
+    while(1UL == cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj))
+    {
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_log_set_tap
+********************************************************************************
+* Summary:
+*  Registers a function that receives every record as it is written, for
+*  example to forward the log over Bluetooth LE. The tap runs in the context
+*  of the caller of app_log_write() and must not write log records itself.
+*
+* Parameters:
+*  app_log_tap_t tap: function to call, or NULL to remove it
+*
+*******************************************************************************/
+void app_log_set_tap(app_log_tap_t tap)
+{
+    log_tap = tap;
+}
+
+
+/*******************************************************************************
+* Function Name: app_log_emit
+********************************************************************************
+* Summary:
+*  Writes one record to the debug UART, either as text or as a binary record.
+*  A text record is formatted once into the line buffer, which is written
+*  with a single UART call when the FIFO has room for the whole line.
+*
+* Parameters:
+*  const app_log_record_t *record: record to write
+*
+* Return:
+*  bool: true if the record was taken, false if the UART FIFO is full. A
+*        text record that was taken may still wait in the line buffer.
+*
+*******************************************************************************/
+static bool app_log_emit(const app_log_record_t *record)
+{
+#if (APP_LOG_TEXT != 0u)
+    int count;
+
+    /* The previous line must be out before the next one is formatted */
+    if(!app_log_send_line())
+    {
+        return false;
+    }
+
+    if(record->id < (uint8_t)APP_LOG_ID_COUNT)
+    {
+        count = snprintf(log_line, APP_LOG_LINE_SIZE - 2u, "%s", log_prefix[record->level]);
+        count += snprintf(&log_line[count], APP_LOG_LINE_SIZE - 2u - (uint32_t)count,
+                          log_text[record->id], (unsigned long)record->arg);
+
+        /* A truncated line still ends with the line end */
+        if(count > (int)(APP_LOG_LINE_SIZE - 3u))
+        {
+            count = (int)(APP_LOG_LINE_SIZE - 3u);
+        }
+        log_line[count] = '\r';
+        log_line[count + 1] = '\n';
+        log_line_length = (uint32_t)count + 2u;
+
+        (void)app_log_send_line();
+    }
+
+    return true;
+#else
+    uint8_t wire[APP_LOG_WIRE_SIZE];
+    size_t length = APP_LOG_WIRE_SIZE;
+
+    if(cyhal_uart_writable(&cy_retarget_io_uart_obj) < APP_LOG_WIRE_SIZE)
+    {
+        return false;
+    }
+
+    (void)app_log_encode(record->level, (app_log_id_t)record->id, record->arg, wire);
+    (void)cyhal_uart_write(&cy_retarget_io_uart_obj, wire, &length);
+
+    return true;
+#endif
+}
+
+
+#if (APP_LOG_TEXT != 0u)
+/*******************************************************************************
+* Function Name: app_log_send_line
+********************************************************************************
+* Summary:
+*  Writes the line buffer to the debug UART if the FIFO has room for all of
+*  it, so that lines are never split or interleaved with other output.
+*
+* Return:
+*  bool: true if the line buffer is empty
+*
+*******************************************************************************/
+static bool app_log_send_line(void)
+{
+    size_t length = log_line_length;
+
+    if((0u != length) &&
+       (cyhal_uart_writable(&cy_retarget_io_uart_obj) >= length))
+    {
+        (void)cyhal_uart_write(&cy_retarget_io_uart_obj, log_line, &length);
+        log_line_length = 0u;
+    }
+
+    return (0u == log_line_length);
+}
+#endif
+
+#endif  /* (APP_LOG_LEVEL > APP_LOG_LEVEL_NONE) */
+
+
+/*******************************************************************************
+* Function Name: app_log_encode
+********************************************************************************
+* Summary:
+*  Encodes a record in the binary wire format decoded by
+*  tools/app_log_decode.py.
+*
+* Parameters:
+*  uint8_t level:     APP_LOG_LEVEL_ERROR or APP_LOG_LEVEL_INFO
+*  app_log_id_t id:   message token
+*  uint32_t arg:      argument of the record
+*  uint8_t *wire:     destination, APP_LOG_WIRE_SIZE bytes
+*
+* Return:
+*  uint32_t: number of bytes written
+*
+*******************************************************************************/
+uint32_t app_log_encode(uint8_t level, app_log_id_t id, uint32_t arg, uint8_t *wire)
+{
+    wire[0] = APP_LOG_SYNC_BYTE;
+    wire[1] = level;
+    wire[2] = (uint8_t)id;
+    wire[3] = (uint8_t)(arg);
+    wire[4] = (uint8_t)(arg >> 8u);
+    wire[5] = (uint8_t)(arg >> 16u);
+    wire[6] = (uint8_t)(arg >> 24u);
+
+    return APP_LOG_WIRE_SIZE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,225 @@
+/******************************************************************************
+* File Name: app_log.h
+*
+* Description: This file is the public interface of app_log.c, the deferred,
+*              tokenized logger used in the BLE event path.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef APP_LOG_H
+#define APP_LOG_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Log levels. A call site is compiled in only if its level is less than or
+ * equal to APP_LOG_LEVEL.
+ */
+#define APP_LOG_LEVEL_NONE        (0u)
+#define APP_LOG_LEVEL_ERROR       (1u)
+#define APP_LOG_LEVEL_INFO        (2u)
+
+/* Release builds keep error records only; Debug builds keep everything */
+#ifndef APP_LOG_LEVEL
+#if defined(NDEBUG)
+#define APP_LOG_LEVEL             APP_LOG_LEVEL_ERROR
+#else
+#define APP_LOG_LEVEL             APP_LOG_LEVEL_INFO
+#endif
+#endif
+
+/* When APP_LOG_TEXT is 1 the records are decoded on the target and printed
+ * through retarget-io. When it is 0 the raw records are written to the debug
+ * UART and decoded on the host with tools/app_log_decode.py, so neither the
+ * format strings nor printf are linked.
+ */
+#ifndef APP_LOG_TEXT
+#if defined(NDEBUG)
+#define APP_LOG_TEXT              (0u)
+#else
+#define APP_LOG_TEXT              (1u)
+#endif
+#endif
+
+/* Number of records held in RAM. Must be a power of two. */
+#ifndef APP_LOG_RING_SIZE
+#define APP_LOG_RING_SIZE         (32u)
+#endif
+
+/* First byte of every record in the binary UART stream */
+#define APP_LOG_SYNC_BYTE         (0xA5u)
+
+/* Sync byte, level, ID and 32-bit little-endian argument */
+#define APP_LOG_WIRE_SIZE         (7u)
+
+/* Message table. Each entry is the token name and the text printed for it.
+ * The text may contain a single conversion that consumes the 32-bit record
+ * argument. Append new messages at the end to keep existing IDs stable for
+ * the host decoder.
+ */
+#define APP_LOG_MESSAGES(X)                                                   \
+    X(BLE_EVENT,            "BLE Event 0x%lX")                                \
+    X(STACK_ON,             "BLE stack started")                              \
+    X(ADV_TIMEOUT,          "Advertisement timeout event")                    \
+    X(GATT_RSP_TIMEOUT,     "GATT response timeout")                          \
+    X(BLE_TIMEOUT,          "BLE timeout event")                              \
+    X(LE_MASK_COMPLETE,     "Set LE mask event mask command completed")       \
+    X(DEVICE_ADDR_COMPLETE, "Set device address command has completed")       \
+    X(TX_PWR_COMPLETE,      "Set Tx power command completed")                 \
+    X(SHUTDOWN_COMPLETE,    "BLE shutdown complete")                          \
+    X(GAP_CONNECTED,        "GAP device connected")                           \
+    X(GAP_ENHANCE_CONN,     "GAP enhanced connection complete")               \
+    X(GAP_DISCONNECTED,     "GAP device disconnected")                        \
+    X(ADV_STARTED,          "BLE advertisement started")                      \
+    X(ADV_STOPPED,          "BLE advertisement stopped")                      \
+    X(GATT_CONNECTED,       "GATT device connected")                          \
+    X(GATT_DISCONNECTED,    "GATT device disconnected")                       \
+    X(GATT_MTU_REQ,         "GATT MTU Exchange Request received")             \
+    X(GATT_READ_REQ,        "GATT read characteristic request received")      \
+    X(ADV_START_FAILED,     "Failed to start advertisement")                  \
+    X(HIBERNATE,            "Entering hibernate mode")                        \
+    X(LOG_OVERFLOW,         "%lu log records dropped")                        \
+    X(ADV_INTERVAL,         "Advertising interval %lu x 0.625 ms")            \
+    X(BOOT_BSP,             "Boot: BSP ready at %lu us")                      \
+    X(BOOT_GPIO,            "Boot: GPIO ready at %lu us")                     \
+    X(BOOT_BLE_ENABLED,     "Boot: BLE enabled at %lu us")                    \
+    X(BOOT_STACK_ON,        "Boot: BLE stack on at %lu us")                   \
+    X(BOOT_FIRST_ADV,       "Boot: first advertisement at %lu us")            \
+    X(BOOT_READY,           "Boot: radio active at %lu us")                   \
+    X(BOOT_REASON,          "Boot reason %lu (0 cold, 1 button, 2 RTC)")      \
+    X(BONDED,               "Bonded with peer, BD handle %lu")                \
+    X(AUTH_FAILED,          "Pairing failed, error 0x%lX")                    \
+    X(RECONNECT_MS,         "Connected %lu ms after the last disconnection")  \
+    X(ADV_MODE,             "Advertising mode %lu (0 open, 1 WL, 2 direct)")  \
+    X(SETTING_CHANGED,      "Setting %lu changed")                            \
+    X(SETTINGS_WR_FAILED,   "Settings flash write failed: 0x%lX")             \
+    X(LOCATOR_TAG_FOUND,    "Find Me tag found, RSSI %ld dBm")                \
+    X(LOCATOR_ALERTED,      "Find Me tag alerted, RSSI %ld dBm")              \
+    X(LOCATOR_CONN_FAILED,  "Find Me tag connection failed: 0x%lX")           \
+    X(SCAN_START_FAILED,    "Failed to start scanning: 0x%lX")                \
+    X(SCAN_DEVICES,         "%lu devices in the scan table")                  \
+    X(PROXIMITY_FAR,        "Link out of range, RSSI %ld dBm")                \
+    X(PROXIMITY_NEAR,       "Link back in range, RSSI %ld dBm")               \
+    X(RSSI_PERIOD,          "RSSI sampled every %lu ms")                      \
+    X(ATT_MTU,              "ATT MTU %lu bytes")                              \
+    X(DATA_LENGTH,          "LL data length %lu bytes")                       \
+    X(TELEMETRY_RATE,       "Telemetry %lu bytes/s")                          \
+    X(TELEMETRY_NTF_EVT,    "%lu notifications per 100 conn events")          \
+    X(CONN_INTERVAL,        "Connection interval %lu x 1.25 ms")              \
+    X(CONN_LATENCY,         "Peripheral latency %lu")                         \
+    X(CONN_PARAM_REJECTED,  "Connection update rejected, BD handle %lu")      \
+    X(ALERT_LATENCY,        "Alert output %lu us after the interrupt")        \
+    X(BUTTON_GESTURE,       "Button gesture %lu")                             \
+    X(BUTTON_WAKEUPS,       "%lu wakeups for the last button gesture")        \
+    X(STATUS_LINKS,         "Status: %lu links")                              \
+    X(STATUS_ALERT,         "Status: alert level %lu")                        \
+    X(PHY_UPDATE,           "PHY updated, mask 0x%lX")                        \
+    X(PHY_FALLBACK,         "Falling back to 1M PHY, RSSI %ld dBm")           \
+    X(PHY_REFUSED,          "Link stays on 1M PHY: 0x%lX")                    \
+    X(SECURITY_REQ_FAILED,  "Security request failed: 0x%lX")                 \
+    X(DISPATCH_FULL,        "No room for a handler of BLE event 0x%lX")       \
+    X(CONN_PARAM_TIMEOUT,   "Connection update not answered, BD handle %lu")
+
+/* Call site macros. Disabled levels expand to nothing and do not evaluate
+ * their argument.
+ */
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_ERROR)
+#define APP_LOG_ERROR(id, arg)                                                \
+    app_log_write(APP_LOG_LEVEL_ERROR, APP_LOG_ID_##id, (uint32_t)(arg))
+#else
+#define APP_LOG_ERROR(id, arg)    ((void)0)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+#define APP_LOG_INFO(id, arg)                                                 \
+    app_log_write(APP_LOG_LEVEL_INFO, APP_LOG_ID_##id, (uint32_t)(arg))
+#else
+#define APP_LOG_INFO(id, arg)     ((void)0)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+#define APP_LOG_ID_ENUM(name, text)   APP_LOG_ID_##name,
+
+typedef enum
+{
+    APP_LOG_MESSAGES(APP_LOG_ID_ENUM)
+    APP_LOG_ID_COUNT
+} app_log_id_t;
+
+#undef APP_LOG_ID_ENUM
+
+/* Called with every record as it is written, in addition to the ring */
+typedef void (*app_log_tap_t)(uint8_t level, app_log_id_t id, uint32_t arg);
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+#if (APP_LOG_LEVEL > APP_LOG_LEVEL_NONE)
+void app_log_write(uint8_t level, app_log_id_t id, uint32_t arg);
+void app_log_start(void);
+bool app_log_drain(void);
+void app_log_flush(void);
+void app_log_set_tap(app_log_tap_t tap);
+#else
+#define app_log_start()           ((void)0)
+#define app_log_drain()           (false)
+#define app_log_flush()           ((void)0)
+#define app_log_set_tap(tap)      ((void)(tap))
+#endif
+
+uint32_t app_log_encode(uint8_t level, app_log_id_t id, uint32_t arg, uint8_t *wire);
+
+
+#endif  /* APP_LOG_H */
+
+
+/* [] END OF FILE */
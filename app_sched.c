@@ -0,0 +1,382 @@
+/******************************************************************************
+* File Name: app_sched.c
+*
+* Description: This file contains the cooperative task scheduler of the main
+*              loop. Each task has a priority and runs to completion. Poll
+*              tasks run once after every wakeup; timed tasks run once their
+*              release time has passed. A timed
+*              task also has a deadline: it runs at the first wakeup after
+*              its release, and the wakeup timer is armed for the earliest
+*              deadline only, so a task with slack rides on the wakeups of
+*              others instead of adding its own. With no task ready, the
+*              idle function puts the device to sleep.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "app_sched.h"
+#include "app_timer.h"
+#include "cycle_counter.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Added tasks, by priority, then in the order they were added */
+static app_sched_task_t *sched_list = NULL;
+
+static app_sched_idle_t sched_idle;
+
+/* Wakeup for the earliest deadline of the timed tasks */
+static app_timer_t sched_timer;
+static uint32_t sched_timer_deadline;
+
+static app_sched_stats_t sched_stats;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static app_sched_task_t* app_sched_pick(void);
+static void app_sched_arm(void);
+static void app_sched_timer_callback(void *arg);
+
+
+/*******************************************************************************
+* Function Name: app_sched_init
+********************************************************************************
+* Summary:
+*  Removes all tasks, stops the deadline wakeup and clears the statistics.
+*
+* Parameters:
+*  app_sched_idle_t idle: called when no task is ready
+*
+*******************************************************************************/
+void app_sched_init(app_sched_idle_t idle)
+{
+    app_timer_stop(&sched_timer);
+    sched_list = NULL;
+    sched_idle = idle;
+    (void)memset(&sched_stats, 0, sizeof(sched_stats));
+
+    cycle_counter_init();
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_add
+********************************************************************************
+* Summary:
+*  Adds a task. A poll task is ready at once; other tasks wait for
+*  app_sched_wake().
+*
+* Parameters:
+*  app_sched_task_t *task:  task descriptor
+*  app_sched_run_t run:     task body
+*  void *arg:               argument of the task body
+*  uint8_t priority:        0 runs first
+*  bool poll:               run the task after every wakeup
+*
+*******************************************************************************/
+void app_sched_add(app_sched_task_t *task, app_sched_run_t run, void *arg,
+                   uint8_t priority, bool poll)
+{
+    app_sched_task_t **link = &sched_list;
+
+    task->run = run;
+    task->arg = arg;
+    task->priority = priority;
+    task->poll = poll;
+    task->ready = poll;
+    task->timed = false;
+
+    while((NULL != *link) && ((*link)->priority <= priority))
+    {
+        link = &(*link)->next;
+    }
+
+    task->next = *link;
+    *link = task;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_wake
+********************************************************************************
+* Summary:
+*  Runs a task once after a delay, at the first wakeup between the delay and
+*  the delay plus the slack. Replaces an earlier request of the task. Must
+*  be called from the main loop; interrupt handlers post an app_event
+*  instead.
+*
+* Parameters:
+*  app_sched_task_t *task:  task
+*  uint32_t delay_ticks:    earliest time, in wakeup timer ticks from now
+*  uint32_t slack_ticks:    time the task may wait for another wakeup
+*
+*******************************************************************************/
+void app_sched_wake(app_sched_task_t *task, uint32_t delay_ticks, uint32_t slack_ticks)
+{
+    task->release = app_timer_now() + delay_ticks;
+    task->deadline = task->release + slack_ticks;
+    task->timed = true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_cancel
+********************************************************************************
+* Summary:
+*  Drops the pending run of a task that is not a poll task. The wakeup timer
+*  is armed again for the remaining tasks before the device next sleeps.
+*
+* Parameters:
+*  app_sched_task_t *task: task
+*
+*******************************************************************************/
+void app_sched_cancel(app_sched_task_t *task)
+{
+    task->timed = false;
+    task->ready = task->poll;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_run
+********************************************************************************
+* Summary:
+*  Runs the tasks. The ready task of highest priority runs next; the choice
+*  is made again after each task, so a task woken without delay by a task of
+*  higher priority runs before those of lower priority. Never returns.
+*
+*******************************************************************************/
+void app_sched_run(void)
+{
+    app_sched_task_t *task;
+    uint32_t start;
+    uint32_t cycles;
+
+    for(;;)
+    {
+        start = cycle_counter_read();
+        task = app_sched_pick();
+        if(NULL == task)
+        {
+            app_sched_arm();
+        }
+        cycles = cycle_counter_read() - start;
+
+        sched_stats.cycles_total += cycles;
+        if(cycles > sched_stats.cycles_max)
+        {
+            sched_stats.cycles_max = cycles;
+        }
+
+        if(NULL != task)
+        {
+            task->ready = false;
+            sched_stats.dispatches++;
+
+            if(task->run(task->arg))
+            {
+                task->ready = true;
+            }
+        }
+        else
+        {
+            sched_stats.idles++;
+            sched_idle();
+
+            for(task = sched_list; NULL != task; task = task->next)
+            {
+                task->ready = task->ready || task->poll;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_pending
+********************************************************************************
+* Summary:
+*  Returns true if a task waits to run, either ready or woken for a later
+*  time. Poll tasks are not counted: they only run after a wakeup.
+*
+*******************************************************************************/
+bool app_sched_pending(void)
+{
+    app_sched_task_t *task;
+
+    for(task = sched_list; NULL != task; task = task->next)
+    {
+        if(task->timed || (task->ready && !task->poll))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_get_stats
+********************************************************************************
+* Summary:
+*  Copies the number of dispatches and the CPU cycles spent picking tasks.
+*
+* Parameters:
+*  app_sched_stats_t *stats: destination
+*
+*******************************************************************************/
+void app_sched_get_stats(app_sched_stats_t *stats)
+{
+    *stats = sched_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_pick
+********************************************************************************
+* Summary:
+*  Releases the timed tasks whose time has come and returns the ready task
+*  of highest priority, or NULL.
+*
+*******************************************************************************/
+static app_sched_task_t* app_sched_pick(void)
+{
+    app_sched_task_t *task;
+    uint32_t now = 0u;
+    bool now_valid = false;
+
+    for(task = sched_list; NULL != task; task = task->next)
+    {
+        if(task->timed)
+        {
+            /* The wakeup timer is only read when a task waits for it */
+            if(!now_valid)
+            {
+                now = app_timer_now();
+                now_valid = true;
+            }
+
+            if((int32_t)(now - task->release) >= 0)
+            {
+                task->timed = false;
+                task->ready = true;
+            }
+        }
+
+        if(task->ready)
+        {
+            return task;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_arm
+********************************************************************************
+* Summary:
+*  Arms the wakeup for the earliest deadline of the timed tasks. The wakeup
+*  timer is only reprogrammed when that deadline changes.
+*
+*******************************************************************************/
+static void app_sched_arm(void)
+{
+    app_sched_task_t *task;
+    uint32_t now = app_timer_now();
+    uint32_t delay = 0u;
+    bool timed = false;
+    int32_t remaining;
+
+    for(task = sched_list; NULL != task; task = task->next)
+    {
+        if(task->timed)
+        {
+            remaining = (int32_t)(task->deadline - now);
+            if(remaining < 0)
+            {
+                remaining = 0;
+            }
+
+            if(!timed || ((uint32_t)remaining < delay))
+            {
+                delay = (uint32_t)remaining;
+                timed = true;
+            }
+        }
+    }
+
+    if(!timed)
+    {
+        app_timer_stop(&sched_timer);
+    }
+    else if(!app_timer_is_active(&sched_timer) || (sched_timer_deadline != (now + delay)))
+    {
+        sched_timer_deadline = now + delay;
+        app_timer_start(&sched_timer, delay, 0u, app_sched_timer_callback, NULL);
+    }
+    else
+    {
+        /* Already armed for this deadline */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_timer_callback
+********************************************************************************
+* Summary:
+*  Deadline wakeup. The wakeup itself is what matters: the scheduler
+*  releases the timed tasks when it picks the next task.
+*
+*******************************************************************************/
+static void app_sched_timer_callback(void *arg)
+{
+    (void)arg;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name: app_sched.h
+*
+* Description: This file is the public interface of app_sched.c, the
+*              cooperative task scheduler of the main loop.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef APP_SCHED_H
+#define APP_SCHED_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Task priorities of the application. The BLE stack runs first so that a
+ * wakeup is handled before any output is produced for it; the periodic
+ * link work (RSSI samples, parameter requests) follows it.
+ */
+#define APP_SCHED_PRIO_BLE        (0u)
+#define APP_SCHED_PRIO_LINK       (1u)
+#define APP_SCHED_PRIO_STORAGE    (2u)
+#define APP_SCHED_PRIO_OUTPUT     (3u)
+#define APP_SCHED_PRIO_CONSOLE    (4u)
+
+/* Slack given to periodic work: a quarter of its delay */
+#define APP_SCHED_SLACK(ticks)    ((ticks) / 4u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* Task body. Returns true if it has more work, to run again before the
+ * device sleeps.
+ */
+typedef bool (*app_sched_run_t)(void *arg);
+
+/* Sleeps until the next interrupt, unless an interrupt event is pending */
+typedef void (*app_sched_idle_t)(void);
+
+/* Task descriptor. Owned by the caller, usually static; must stay valid once
+ * added.
+ */
+typedef struct app_sched_task
+{
+    app_sched_run_t        run;
+    void                   *arg;
+    uint8_t                priority;    /* 0 runs first */
+    bool                   poll;        /* runs after every wakeup */
+    bool                   ready;
+    bool                   timed;
+    uint32_t               release;     /* earliest tick to run at */
+    uint32_t               deadline;    /* latest tick to run at */
+    struct app_sched_task  *next;
+} app_sched_task_t;
+
+typedef struct
+{
+    uint32_t dispatches;      /* task bodies run */
+    uint32_t idles;           /* calls to the idle function */
+    uint32_t cycles_total;    /* CPU cycles spent picking the tasks */
+    uint32_t cycles_max;      /* longest pick */
+} app_sched_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void app_sched_init(app_sched_idle_t idle);
+void app_sched_add(app_sched_task_t *task, app_sched_run_t run, void *arg,
+                   uint8_t priority, bool poll);
+void app_sched_wake(app_sched_task_t *task, uint32_t delay_ticks, uint32_t slack_ticks);
+void app_sched_cancel(app_sched_task_t *task);
+void app_sched_run(void);
+bool app_sched_pending(void);
+void app_sched_get_stats(app_sched_stats_t *stats);
+
+
+#endif  /* APP_SCHED_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,379 @@
+/******************************************************************************
+* File Name: app_timer.c
+*
+* Description: This file contains tickless software timers built on the deep
+*              sleep wakeup timer (lptimer). The hardware timer is armed for
+*              the earliest pending deadline only, and is left disabled while
+*              no software timer is running, so the CPU is not woken up unless
+*              a timer actually expires. Timer callbacks run in the main loop.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "app_timer.h"
+#include "app_event.h"
+#include "cyhal.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define WAKEUP_INTR_PRIORITY      (7u)
+
+/* Shortest delay the lptimer can be armed with, in ticks */
+#define APP_TIMER_MIN_DELAY       (4u)
+
+/* Longest delay armed at once. Longer deadlines are reached in several
+ * steps.
+ */
+#define APP_TIMER_MAX_DELAY       (0x40000000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static cyhal_lptimer_t wakeup_timer;
+
+/* Running timers, in no particular order */
+static app_timer_t *timer_list = NULL;
+
+/* Number of wakeup timer interrupts since init */
+static volatile uint32_t timer_wakeups = 0u;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void app_timer_interrupt_handler(void *handler_arg, cyhal_lptimer_event_t event);
+static void app_timer_unlink(app_timer_t *timer);
+static void app_timer_rearm(void);
+
+
+/*******************************************************************************
+* Function Name: app_timer_init
+********************************************************************************
+* Summary:
+*  Initializes the deep sleep wakeup timer. The timer interrupt stays disabled
+*  until a software timer is started.
+*
+*******************************************************************************/
+void app_timer_init(void)
+{
+    cyhal_lptimer_init(&wakeup_timer);
+    cyhal_lptimer_register_callback(&wakeup_timer, app_timer_interrupt_handler, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_start
+********************************************************************************
+* Summary:
+*  Starts (or restarts) a software timer.
+*
+* Parameters:
+*  app_timer_t *timer:            timer object
+*  uint32_t delay_ticks:          ticks until the first expiry
+*  uint32_t period_ticks:         reload value in ticks, 0 for a one-shot timer
+*  app_timer_callback_t callback: function called from app_timer_process()
+*  void *arg:                     argument passed to the callback
+*
+*******************************************************************************/
+void app_timer_start(app_timer_t *timer, uint32_t delay_ticks, uint32_t period_ticks,
+                     app_timer_callback_t callback, void *arg)
+{
+    if(timer->active)
+    {
+        app_timer_unlink(timer);
+    }
+
+    timer->deadline = app_timer_now() + delay_ticks;
+    timer->period = period_ticks;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->active = true;
+    timer->next = timer_list;
+    timer_list = timer;
+
+    app_timer_rearm();
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_stop
+********************************************************************************
+* Summary:
+*  Stops a software timer. Stopping a timer that is not running has no effect.
+*
+* Parameters:
+*  app_timer_t *timer: timer object
+*
+*******************************************************************************/
+void app_timer_stop(app_timer_t *timer)
+{
+    if(timer->active)
+    {
+        app_timer_unlink(timer);
+        app_timer_rearm();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_is_active
+********************************************************************************
+* Summary:
+*  Returns true if the timer is running.
+*
+*******************************************************************************/
+bool app_timer_is_active(const app_timer_t *timer)
+{
+    return timer->active;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_now
+********************************************************************************
+* Summary:
+*  Returns the free-running wakeup timer count in ticks. The count keeps
+*  running in deep sleep.
+*
+*******************************************************************************/
+uint32_t app_timer_now(void)
+{
+    return cyhal_lptimer_read(&wakeup_timer);
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_next_delay
+********************************************************************************
+* Summary:
+*  Returns the time until the earliest deadline of the running timers, or 0
+*  if a deadline has passed and its callback has not run yet.
+*
+* Parameters:
+*  uint32_t *delay_ticks: destination, in wakeup timer ticks
+*
+* Return:
+*  bool: false if no timer is running
+*
+*******************************************************************************/
+bool app_timer_next_delay(uint32_t *delay_ticks)
+{
+    uint32_t now;
+    uint32_t delay = APP_TIMER_MAX_DELAY;
+    app_timer_t *timer;
+
+    if(NULL == timer_list)
+    {
+        return false;
+    }
+
+    now = app_timer_now();
+
+    for(timer = timer_list; NULL != timer; timer = timer->next)
+    {
+        int32_t remaining = (int32_t)(timer->deadline - now);
+
+        if(remaining < 0)
+        {
+            remaining = 0;
+        }
+
+        if((uint32_t)remaining < delay)
+        {
+            delay = (uint32_t)remaining;
+        }
+    }
+
+    *delay_ticks = delay;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_process
+********************************************************************************
+* Summary:
+*  Runs the callbacks of the expired timers and arms the wakeup timer for the
+*  next deadline. Called from the main loop for each APP_EVENT_TIMER event.
+*
+*******************************************************************************/
+void app_timer_process(void)
+{
+    bool expired = true;
+
+    while(expired)
+    {
+        uint32_t now = app_timer_now();
+        app_timer_t *timer;
+
+        expired = false;
+
+        /* Handle one expired timer per pass; its callback may start or stop
+         * other timers and change the list.
+         */
+        for(timer = timer_list; NULL != timer; timer = timer->next)
+        {
+            if((int32_t)(now - timer->deadline) >= 0)
+            {
+                expired = true;
+                break;
+            }
+        }
+
+        if(expired)
+        {
+            if(0u != timer->period)
+            {
+                timer->deadline += timer->period;
+
+                /* Skip the periods that were missed */
+                if((int32_t)(now - timer->deadline) >= 0)
+                {
+                    timer->deadline = now + timer->period;
+                }
+            }
+            else
+            {
+                app_timer_unlink(timer);
+            }
+
+            timer->callback(timer->arg);
+        }
+    }
+
+    app_timer_rearm();
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_get_wakeup_count
+********************************************************************************
+* Summary:
+*  Returns the number of wakeup timer interrupts since init.
+*
+*******************************************************************************/
+uint32_t app_timer_get_wakeup_count(void)
+{
+    return timer_wakeups;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_interrupt_handler
+********************************************************************************
+* Summary:
+*  Wakeup timer interrupt handler. Posts a timer event; the expired timers
+*  are handled by app_timer_process() in the main loop.
+*
+* Parameters:
+*  void *handler_arg (unused)
+*  cyhal_lptimer_event_t event (unused)
+*
+*******************************************************************************/
+static void app_timer_interrupt_handler(void *handler_arg, cyhal_lptimer_event_t event)
+{
+    (void)handler_arg;
+    (void)event;
+
+    timer_wakeups++;
+
+    (void)app_event_post(APP_EVENT_TIMER, 0u, true);
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_unlink
+********************************************************************************
+* Summary:
+*  Removes a timer from the list of running timers.
+*
+*******************************************************************************/
+static void app_timer_unlink(app_timer_t *timer)
+{
+    app_timer_t **link = &timer_list;
+
+    while(NULL != *link)
+    {
+        if(*link == timer)
+        {
+            *link = timer->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+
+    timer->next = NULL;
+    timer->active = false;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_rearm
+********************************************************************************
+* Summary:
+*  Arms the wakeup timer for the earliest deadline, or disables its interrupt
+*  if no timer is running.
+*
+*******************************************************************************/
+static void app_timer_rearm(void)
+{
+    uint32_t delay;
+
+    if(!app_timer_next_delay(&delay))
+    {
+        cyhal_lptimer_enable_event(&wakeup_timer, CYHAL_LPTIMER_COMPARE_MATCH,
+                                   WAKEUP_INTR_PRIORITY, false);
+        return;
+    }
+
+    if(delay < APP_TIMER_MIN_DELAY)
+    {
+        delay = APP_TIMER_MIN_DELAY;
+    }
+
+    cyhal_lptimer_set_delay(&wakeup_timer, delay);
+    cyhal_lptimer_enable_event(&wakeup_timer, CYHAL_LPTIMER_COMPARE_MATCH,
+                               WAKEUP_INTR_PRIORITY, true);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,101 @@
+/******************************************************************************
+* File Name: app_timer.h
+*
+* Description: This file is the public interface of app_timer.c, the tickless
+*              software timers that run on the deep sleep wakeup timer.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef APP_TIMER_H
+#define APP_TIMER_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* The wakeup timer runs from the 32768 Hz LFCLK */
+#define APP_TIMER_TICKS_PER_SEC   (32768u)
+
+/* Converts milliseconds to wakeup timer ticks */
+#define APP_TIMER_MS_TO_TICKS(ms) ((uint32_t)(((uint64_t)(ms) * APP_TIMER_TICKS_PER_SEC) / 1000u))
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef void (*app_timer_callback_t)(void *arg);
+
+/* Timer object. Owned by the caller; must stay valid while the timer runs. */
+typedef struct app_timer
+{
+    uint32_t             deadline;
+    uint32_t             period;
+    app_timer_callback_t callback;
+    void                 *arg;
+    bool                 active;
+    struct app_timer     *next;
+} app_timer_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void app_timer_init(void);
+void app_timer_start(app_timer_t *timer, uint32_t delay_ticks, uint32_t period_ticks,
+                     app_timer_callback_t callback, void *arg);
+void app_timer_stop(app_timer_t *timer);
+bool app_timer_is_active(const app_timer_t *timer);
+uint32_t app_timer_now(void);
+bool app_timer_next_delay(uint32_t *delay_ticks);
+void app_timer_process(void);
+uint32_t app_timer_get_wakeup_count(void);
+
+
+#endif  /* APP_TIMER_H */
+
+
+/* [] END OF FILE */
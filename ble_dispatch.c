@@ -0,0 +1,382 @@
+/******************************************************************************
+* File Name: ble_dispatch.c
+*
+* Description: This file contains the dispatcher for BLE stack and service
+*              events. Modules register const tables of (event, handler) rows;
+*              the dispatcher indexes them by event code with one directly
+*              indexed window per event code range, so that the lookup cost
+*              does not depend on the number of handled events. Each slot
+*              keeps hit counts and the CPU cycles spent in its handlers.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "ble_dispatch.h"
+#include "app_log.h"
+#include "cycle_counter.h"
+#include "profiler.h"
+#include "trace.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define BLE_DISPATCH_RANGE_MASK   (BLE_DISPATCH_RANGE_SIZE - 1u)
+
+/* Marks an event code of a window that has no slot */
+#define BLE_DISPATCH_NO_SLOT      (0xFFu)
+
+#if ((BLE_DISPATCH_RANGE_SIZE & BLE_DISPATCH_RANGE_MASK) != 0u)
+#error "BLE_DISPATCH_RANGE_SIZE must be a power of two"
+#endif
+
+#if (BLE_DISPATCH_MAX_EVENTS >= BLE_DISPATCH_NO_SLOT)
+#error "BLE_DISPATCH_MAX_EVENTS must be below 255"
+#endif
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    uint32_t               count;
+    ble_dispatch_handler_t handlers[BLE_DISPATCH_MAX_HANDLERS];
+    ble_dispatch_stats_t   stats;
+} ble_dispatch_slot_t;
+
+/* Window of event codes starting at base, mapped to slot numbers */
+typedef struct
+{
+    uint32_t base;
+    uint8_t  slots[BLE_DISPATCH_RANGE_SIZE];
+} ble_dispatch_range_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static ble_dispatch_slot_t dispatch_slots[BLE_DISPATCH_MAX_EVENTS];
+static uint32_t dispatch_slot_count = 0u;
+
+static ble_dispatch_range_t dispatch_ranges[BLE_DISPATCH_MAX_RANGES];
+static uint32_t dispatch_range_count = 0u;
+
+/* Called for event codes without a registered handler */
+static ble_dispatch_handler_t dispatch_default_handler = NULL;
+static ble_dispatch_stats_t dispatch_unhandled_stats;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static ble_dispatch_slot_t* ble_dispatch_find(uint32_t event, bool insert);
+static void ble_dispatch_account(ble_dispatch_stats_t *stats, uint32_t cycles);
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_init
+********************************************************************************
+* Summary:
+*  Clears the event index and the statistics and enables the cycle counter.
+*
+* Parameters:
+*  ble_dispatch_handler_t default_handler: handler for events that have no
+*                                          registered handler, or NULL
+*
+*******************************************************************************/
+void ble_dispatch_init(ble_dispatch_handler_t default_handler)
+{
+    (void)memset(dispatch_slots, 0, sizeof(dispatch_slots));
+    dispatch_slot_count = 0u;
+    dispatch_range_count = 0u;
+    (void)memset(&dispatch_unhandled_stats, 0, sizeof(dispatch_unhandled_stats));
+    dispatch_default_handler = default_handler;
+
+    cycle_counter_init();
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_register
+********************************************************************************
+* Summary:
+*  Adds the rows of a handler table to the event index. Must be called after
+*  ble_dispatch_init() and before Cy_BLE_ProcessEvents() is first called.
+*
+* Parameters:
+*  const ble_dispatch_entry_t *table: handler table
+*  uint32_t count:                    number of rows in the table
+*
+* Return:
+*  bool: false if the slots, the windows or the handler list of an event are
+*        full. The rows that did not fit are logged and left out; the
+*        others are registered.
+*
+*******************************************************************************/
+bool ble_dispatch_register(const ble_dispatch_entry_t *table, uint32_t count)
+{
+    bool result = true;
+    uint32_t i;
+
+    for(i = 0u; i < count; i++)
+    {
+        ble_dispatch_slot_t *slot = ble_dispatch_find(table[i].event, true);
+
+        if((NULL == slot) || (slot->count >= BLE_DISPATCH_MAX_HANDLERS))
+        {
+            APP_LOG_ERROR(DISPATCH_FULL, table[i].event);
+            result = false;
+        }
+        else
+        {
+            slot->handlers[slot->count] = table[i].handler;
+            slot->count++;
+        }
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_event
+********************************************************************************
+* Summary:
+*  Event callback registered with the BLE stack and the BLE services. Calls
+*  the handlers registered for the event and updates its statistics. The
+*  event is recorded in the trace first; the recording is not included in
+*  the statistics.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+void ble_dispatch_event(uint32_t event, void *eventParam)
+{
+    uint32_t start;
+    ble_dispatch_slot_t *slot;
+    uint32_t i;
+
+    trace_record(event, eventParam);
+
+    start = cycle_counter_read();
+    slot = ble_dispatch_find(event, false);
+
+    PROFILER_BEGIN(BLE_DISPATCH);
+
+    if(NULL != slot)
+    {
+        for(i = 0u; i < slot->count; i++)
+        {
+            slot->handlers[i](event, eventParam);
+        }
+
+        ble_dispatch_account(&slot->stats, cycle_counter_read() - start);
+    }
+    else
+    {
+        if(NULL != dispatch_default_handler)
+        {
+            dispatch_default_handler(event, eventParam);
+        }
+
+        dispatch_unhandled_stats.event = event;
+        ble_dispatch_account(&dispatch_unhandled_stats,
+                             cycle_counter_read() - start);
+    }
+
+    PROFILER_END(BLE_DISPATCH);
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_get_stats
+********************************************************************************
+* Summary:
+*  Copies the statistics of the registered events.
+*
+* Parameters:
+*  ble_dispatch_stats_t *stats: destination array
+*  uint32_t max_count:          number of elements in the destination array
+*
+* Return:
+*  uint32_t: number of elements written
+*
+*******************************************************************************/
+uint32_t ble_dispatch_get_stats(ble_dispatch_stats_t *stats, uint32_t max_count)
+{
+    uint32_t count = 0u;
+    uint32_t i;
+
+    for(i = 0u; (i < dispatch_slot_count) && (count < max_count); i++)
+    {
+        stats[count] = dispatch_slots[i].stats;
+        count++;
+    }
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_get_unhandled_stats
+********************************************************************************
+* Summary:
+*  Copies the statistics of events without a registered handler. The event
+*  field holds the code of the last such event.
+*
+* Parameters:
+*  ble_dispatch_stats_t *stats: destination
+*
+*******************************************************************************/
+void ble_dispatch_get_unhandled_stats(ble_dispatch_stats_t *stats)
+{
+    *stats = dispatch_unhandled_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_reset_stats
+********************************************************************************
+* Summary:
+*  Clears the statistics of all events. Registered handlers are kept.
+*
+*******************************************************************************/
+void ble_dispatch_reset_stats(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < dispatch_slot_count; i++)
+    {
+        dispatch_slots[i].stats.hits = 0u;
+        dispatch_slots[i].stats.cycles_total = 0u;
+        dispatch_slots[i].stats.cycles_max = 0u;
+    }
+
+    (void)memset(&dispatch_unhandled_stats, 0, sizeof(dispatch_unhandled_stats));
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_find
+********************************************************************************
+* Summary:
+*  Finds the slot of an event: the window of its range is looked up among
+*  the few windows in use, and the code is then an index into that window.
+*
+* Parameters:
+*  uint32_t event: event code
+*  bool insert:    claim a window and a slot if the event is not in the index
+*
+* Return:
+*  ble_dispatch_slot_t*: slot of the event, or NULL if not found (or no
+*                        window or slot is left when inserting)
+*
+*******************************************************************************/
+static ble_dispatch_slot_t* ble_dispatch_find(uint32_t event, bool insert)
+{
+    uint32_t base = event & ~BLE_DISPATCH_RANGE_MASK;
+    ble_dispatch_range_t *range = NULL;
+    uint32_t index;
+    uint32_t i;
+
+    for(i = 0u; i < dispatch_range_count; i++)
+    {
+        if(dispatch_ranges[i].base == base)
+        {
+            range = &dispatch_ranges[i];
+            break;
+        }
+    }
+
+    if(NULL == range)
+    {
+        if(!insert || (dispatch_range_count >= BLE_DISPATCH_MAX_RANGES))
+        {
+            return NULL;
+        }
+
+        range = &dispatch_ranges[dispatch_range_count];
+        range->base = base;
+        (void)memset(range->slots, BLE_DISPATCH_NO_SLOT, sizeof(range->slots));
+        dispatch_range_count++;
+    }
+
+    index = range->slots[event & BLE_DISPATCH_RANGE_MASK];
+
+    if(BLE_DISPATCH_NO_SLOT == index)
+    {
+        if(!insert || (dispatch_slot_count >= BLE_DISPATCH_MAX_EVENTS))
+        {
+            return NULL;
+        }
+
+        index = dispatch_slot_count;
+        range->slots[event & BLE_DISPATCH_RANGE_MASK] = (uint8_t)index;
+        dispatch_slots[index].stats.event = event;
+        dispatch_slot_count++;
+    }
+
+    return &dispatch_slots[index];
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_account
+********************************************************************************
+* Summary:
+*  Adds one handler run to the statistics of an event.
+*
+*******************************************************************************/
+static void ble_dispatch_account(ble_dispatch_stats_t *stats, uint32_t cycles)
+{
+    stats->hits++;
+    stats->cycles_total += cycles;
+
+    if(cycles > stats->cycles_max)
+    {
+        stats->cycles_max = cycles;
+    }
+}
+
+
+/* [] END OF FILE */
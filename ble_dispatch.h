@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name: ble_dispatch.h
+*
+* Description: This file is the public interface of ble_dispatch.c, the
+*              table-driven dispatcher for BLE stack and service events.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef BLE_DISPATCH_H
+#define BLE_DISPATCH_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Number of distinct event codes that can have handlers */
+#ifndef BLE_DISPATCH_MAX_EVENTS
+#define BLE_DISPATCH_MAX_EVENTS   (48u)
+#endif
+
+/* The event codes of cy_en_ble_event_t are grouped by layer in ranges
+ * (general, GAP, GATT, L2CAP, then the services). The index holds one
+ * directly indexed window of BLE_DISPATCH_RANGE_SIZE codes for each range
+ * with registered handlers. The size must be a power of two.
+ */
+#ifndef BLE_DISPATCH_RANGE_SIZE
+#define BLE_DISPATCH_RANGE_SIZE   (64u)
+#endif
+
+#ifndef BLE_DISPATCH_MAX_RANGES
+#define BLE_DISPATCH_MAX_RANGES   (6u)
+#endif
+
+/* Number of handlers that can be registered for the same event code. They are
+ * called in registration order. The Target build registers five handlers
+ * for the GATT connection events and the Locator build six; the limit
+ * leaves room for two more modules.
+ */
+#ifndef BLE_DISPATCH_MAX_HANDLERS
+#define BLE_DISPATCH_MAX_HANDLERS (8u)
+#endif
+
+/* Number of elements in a handler table */
+#define BLE_DISPATCH_COUNT(table) (sizeof(table) / sizeof((table)[0]))
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef void (*ble_dispatch_handler_t)(uint32_t event, void *eventParam);
+
+/* One row of a module's handler table. Modules keep their tables in const
+ * memory and register them once at init.
+ */
+typedef struct
+{
+    uint32_t               event;
+    ble_dispatch_handler_t handler;
+} ble_dispatch_entry_t;
+
+/* Statistics of one event code */
+typedef struct
+{
+    uint32_t event;
+    uint32_t hits;
+    uint64_t cycles_total;
+    uint32_t cycles_max;
+} ble_dispatch_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void ble_dispatch_init(ble_dispatch_handler_t default_handler);
+bool ble_dispatch_register(const ble_dispatch_entry_t *table, uint32_t count);
+void ble_dispatch_event(uint32_t event, void *eventParam);
+uint32_t ble_dispatch_get_stats(ble_dispatch_stats_t *stats, uint32_t max_count);
+void ble_dispatch_get_unhandled_stats(ble_dispatch_stats_t *stats);
+void ble_dispatch_reset_stats(void);
+
+
+#endif  /* BLE_DISPATCH_H */
+
+
+/* [] END OF FILE */
@@ -43,8 +43,29 @@
  * Include header files
  *****************************************************************************/
 #include "ble_findme.h"
+#include "app_log.h"
+#include "app_event.h"
+#include "app_sched.h"
+#include "ble_dispatch.h"
+#include "app_timer.h"
+#include "status_led.h"
+#include "power_stats.h"
+#include "conn_table.h"
+#include "adv_policy.h"
+#include "boot_profile.h"
+#include "bond_mgr.h"
+#include "settings.h"
+#include "findme_locator.h"
+#include "proximity.h"
+#include "profiler.h"
+#include "telemetry.h"
+#include "conn_param.h"
+#include "phy_policy.h"
+#include "sleep_policy.h"
+#include "trace.h"
+#include "button.h"
+#include "cycle_counter.h"
 #include "cyhal.h"
-#include "cy_retarget_io.h"
 #include "cybsp.h"
 #include "cycfg_ble.h"
 
@@ -53,50 +74,149 @@
 * Macros
 ********************************************************************************/
 #define BLESS_INTR_PRIORITY       (1u)
-#define WAKEUP_INTR_PRIORITY      (7u)
-#define WAKEUP_TIMER_DELAY_MS     (250)
-/* Timer value to get 0.25 sec with wakeup timer input clock of 32768 Hz,
- * where 32768Hz is LFCLK in PSoC 6 MCU */
-#define WAKEUP_TIMER_MATCH_VALUE  (WAKEUP_TIMER_DELAY_MS * 32768 / 1000)
-
-
-/*******************************************************************************
-* Global Variables
-********************************************************************************/
-cyhal_lptimer_t wakeup_timer;
-bool wakeup_intr_flag = false;
-bool gpio_intr_flag = false;
-uint8 alert_level = CY_BLE_NO_ALERT;
-cy_stc_ble_conn_handle_t app_conn_handle;
 
 
 /*******************************************************************************
 * Function Prototypes
 ********************************************************************************/
+static bool findme_ble_task(void *arg);
+static bool findme_storage_task(void *arg);
+static bool findme_output_task(void *arg);
 static void ble_init(void);
+static void ble_process_events(void);
 static void bless_interrupt_handler(void);
-static void stack_event_handler(uint32 event, void* eventParam);
 static void ble_start_advertisement(void);
-static void wakeup_timer_init(void);
-static void wakeup_timer_interrupt_handler(void *handler_arg, cyhal_lptimer_event_t event);
-static void ble_ias_callback(uint32 event, void *eventParam);
+static void ble_update_status(void);
+static void ble_set_tx_power(cy_en_ble_bless_ch_type_t channel, uint8_t bd_handle);
 static void enter_low_power_mode(void);
+static void ble_button_gesture(button_gesture_t gesture);
+
+static void ble_evt_stack_on(uint32_t event, void* eventParam);
+static void ble_evt_timeout(uint32_t event, void* eventParam);
+static void ble_evt_gap_disconnected(uint32_t event, void* eventParam);
+static void ble_evt_adv_start_stop(uint32_t event, void* eventParam);
+static void ble_evt_gatt_connect(uint32_t event, void* eventParam);
+static void ble_evt_gatt_disconnect(uint32_t event, void* eventParam);
+static void ble_evt_ias_write(uint32_t event, void* eventParam);
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+static void ble_evt_log_only(uint32_t event, void* eventParam);
+static void ble_evt_unhandled(uint32_t event, void* eventParam);
+#endif
+
+
+/*******************************************************************************
+* BLE event handler table
+********************************************************************************/
+static const ble_dispatch_entry_t findme_event_table[] =
+{
+    /* General events */
+    { CY_BLE_EVT_STACK_ON,                       ble_evt_stack_on },
+    { CY_BLE_EVT_TIMEOUT,                        ble_evt_timeout },
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    { CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE,     ble_evt_log_only },
+    { CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE,       ble_evt_log_only },
+    { CY_BLE_EVT_SET_TX_PWR_COMPLETE,            ble_evt_log_only },
+    { CY_BLE_EVT_STACK_SHUTDOWN_COMPLETE,        ble_evt_log_only },
+#endif
+
+    /* GAP events */
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    { CY_BLE_EVT_GAP_DEVICE_CONNECTED,           ble_evt_log_only },
+    { CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE,      ble_evt_log_only },
+#endif
+
+    /* GATT events */
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    { CY_BLE_EVT_GATTS_XCNHG_MTU_REQ,            ble_evt_log_only },
+    { CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ, ble_evt_log_only },
+#endif
+};
+
+/* Events of the Peripheral role. Not registered in the Locator build, where
+ * they would act on the Locator's own link to a tag.
+ */
+static const ble_dispatch_entry_t findme_target_event_table[] =
+{
+    /* GAP events */
+    { CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,        ble_evt_gap_disconnected },
+    { CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP,  ble_evt_adv_start_stop },
+
+    /* GATT events */
+    { CY_BLE_EVT_GATT_CONNECT_IND,               ble_evt_gatt_connect },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND,            ble_evt_gatt_disconnect },
+
+    /* Immediate Alert Service events */
+    { CY_BLE_EVT_IASS_WRITE_CHAR_CMD,            ble_evt_ias_write },
+};
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static app_sched_task_t findme_ble_task_desc;
+static app_sched_task_t findme_storage_task_desc;
+static app_sched_task_t findme_output_task_desc;
+
+/* Cycle count of the first BLESS interrupt since the stack last processed
+ * its events, and a copy taken for the current processing pass. An Alert
+ * Level write handled in the pass is timed from that interrupt.
+ */
+static volatile uint32_t bless_isr_cycles;
+static volatile bool bless_isr_stamped = false;
+static uint32_t ble_pass_cycles;
+static bool ble_pass_stamped = false;
+
+/* Set when advertising is stopped to restart it from the first stage */
+static bool ble_adv_restart = false;
+
+/* Stack parameters of design.cybt with the GAP role of this build */
+static cy_stc_ble_params_t ble_params;
+
+/* Button wakeups counted up to the previous gesture */
+static uint32_t ble_button_wakeups = 0u;
 
 
 /*******************************************************************************
 * Function Name: ble_findme_init
 ********************************************************************************
 * Summary:
-* This function initializes the BLE and a deep sleep wakeup timer.
+* This function initializes the BLE and a deep sleep wakeup timer, and adds
+* the tasks of the application to the scheduler. The tasks run after every
+* wakeup; the device sleeps when they are done.
 *
 *******************************************************************************/
 void ble_findme_init(void)
 {
-    /* Configure BLE */
+    /* Empty the interrupt event queue before any producer is enabled */
+    app_event_init();
+
+    app_sched_init(enter_low_power_mode);
+    app_sched_add(&findme_ble_task_desc, findme_ble_task, NULL,
+                  APP_SCHED_PRIO_BLE, true);
+    app_sched_add(&findme_storage_task_desc, findme_storage_task, NULL,
+                  APP_SCHED_PRIO_STORAGE, true);
+    app_sched_add(&findme_output_task_desc, findme_output_task, NULL,
+                  APP_SCHED_PRIO_OUTPUT, true);
+
+    /* Configure BLE and load the settings */
+    conn_table_init();
     ble_init();
 
-    /* Configure deep sleep wakeup timer */
-    wakeup_timer_init();
+    /* Pick the advertising profile for this boot */
+    adv_policy_init();
+
+    /* Configure deep sleep wakeup timer and the status LEDs */
+    app_timer_init();
+    status_led_init();
+    button_init(ble_button_gesture);
+
+    /* The cycle counter stops in deep sleep; time the rest of the boot with
+     * the wakeup timer
+     */
+    boot_profile_use_timer();
+
+    /* Start power state accounting */
+    power_stats_init();
 
     /* Enable global interrupts */
     __enable_irq();
@@ -104,65 +224,102 @@ void ble_findme_init(void)
 
 
 /*******************************************************************************
-* Function Name: ble_findme_process
+* Function Name: findme_ble_task
 ********************************************************************************
 * Summary:
-*  This function processes the BLE events and configures the device to enter
-*  low power mode as required.
+*  Lets the BLE stack process its events and handles everything the
+*  interrupt handlers have posted since the last wakeup, in one batch.
 *
 *******************************************************************************/
-void ble_findme_process(void)
+static bool findme_ble_task(void *arg)
 {
-    /* Enter low power mode. The call to enter_low_power_mode also causes the
-     * device to enter hibernate mode if the BLE stack is shutdown.
-     */
-    enter_low_power_mode();
+    app_event_t event;
+
+    (void)arg;
 
     /* Cy_BLE_ProcessEvents() allows the BLE stack to process pending events */
-    Cy_BLE_ProcessEvents();
+    ble_process_events();
 
-    if(wakeup_intr_flag)
+    while(app_event_get(&event))
     {
-        wakeup_intr_flag = false;
-
-        /* Update CYBSP_USER_LED1 to indicate current BLE status */
-        if(CY_BLE_ADV_STATE_ADVERTISING == Cy_BLE_GetAdvertisementState())
-        {
-            cyhal_gpio_toggle((cyhal_gpio_t)CYBSP_USER_LED1);
-        }
-        else if(CY_BLE_CONN_STATE_CONNECTED == Cy_BLE_GetConnectionState(app_conn_handle))
-        {
-            cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED1, CYBSP_LED_STATE_ON);
-        }
-        else
-        {
-            cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED1, CYBSP_LED_STATE_OFF);
-        }
-
-        /* Update CYBSP_USER_LED2 to indicate current alert level */
-        switch(alert_level)
+        switch(event.type)
         {
-            case CY_BLE_NO_ALERT:
+            case APP_EVENT_TIMER:
             {
-                cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED2, CYBSP_LED_STATE_OFF);
+                /* Run the expired software timers (LED blinking) and arm the
+                 * wakeup timer for the next deadline
+                 */
+                app_timer_process();
                 break;
             }
-            case CY_BLE_MILD_ALERT:
+
+            case APP_EVENT_BLE:
             {
-                cyhal_gpio_toggle((cyhal_gpio_t)CYBSP_USER_LED2);
+                /* BLESS interrupt after the call above; let the stack
+                 * handle it before sleeping again
+                 */
+                ble_process_events();
                 break;
             }
-            case CY_BLE_HIGH_ALERT:
+
+            case APP_EVENT_BUTTON:
             {
-                cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED2, CYBSP_LED_STATE_ON);
+                /* Debounce the edge on the wakeup timer */
+                button_process_edge();
                 break;
             }
+
             default:
             {
                 break;
             }
         }
     }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: findme_storage_task
+********************************************************************************
+* Summary:
+*  Writes new bonding data, then changed settings, to flash. With the BLE
+*  stack stopped no radio event wakes the device to continue a write, and
+*  the sleep policy holds off hibernate until it is done, so the task runs
+*  again before the device sleeps.
+*
+*******************************************************************************/
+static bool findme_storage_task(void *arg)
+{
+    (void)arg;
+
+    bond_mgr_process();
+    settings_process();
+
+    return (CY_BLE_STATE_STOPPED == Cy_BLE_GetState()) &&
+           ((0u != cy_ble_pendingFlashWrite) || settings_pending());
+}
+
+
+/*******************************************************************************
+* Function Name: findme_output_task
+********************************************************************************
+* Summary:
+*  Hands the buffered telemetry to the stack while it has room, then moves
+*  the log records to the debug UART. Only what fits in the UART FIFO is
+*  written; the rest is left for the next wakeup so that the CPU does not
+*  wait on the UART.
+*
+*******************************************************************************/
+static bool findme_output_task(void *arg)
+{
+    (void)arg;
+
+    telemetry_process();
+    (void)app_log_drain();
+
+    return false;
 }
 
 
@@ -175,6 +332,7 @@ void ble_findme_process(void)
 *******************************************************************************/
 static void ble_init(void)
 {
+#if (BLE_DUAL_CORE == 0u)
     static const cy_stc_sysint_t bless_isr_config =
     {
       /* The BLESS interrupt */
@@ -189,21 +347,75 @@ static void ble_init(void)
 
     /* Store the pointer to blessIsrCfg in the BLE configuration structure */
     cy_ble_config.hw->blessIsrConfig = &bless_isr_config;
+#endif
 
-    /* Registers the generic callback functions  */
-    Cy_BLE_RegisterEventCallback(stack_event_handler);
+    /* Build the event index and register the dispatcher as the generic
+     * callback function. The handlers that only log are left out of builds
+     * without info records.
+     */
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    ble_dispatch_init(ble_evt_unhandled);
+#else
+    ble_dispatch_init(NULL);
+#endif
+    profiler_init();
+    trace_init();
+    settings_init();
+
+    if(0u == FINDME_LOCATOR)
+    {
+        /* The Peripheral role: bonding, link tuning, proximity and the
+         * Find Me Target handlers
+         */
+        bond_mgr_init();
+        proximity_init(ble_update_status);
+        conn_param_init();
+        phy_policy_init();
+        telemetry_init();
+        if(!ble_dispatch_register(findme_target_event_table,
+                                  BLE_DISPATCH_COUNT(findme_target_event_table)))
+        {
+            CY_ASSERT(0u);
+        }
+    }
+    else
+    {
+        findme_locator_init();
+    }
+    if(!ble_dispatch_register(findme_event_table,
+                              BLE_DISPATCH_COUNT(findme_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+    Cy_BLE_RegisterEventCallback(ble_dispatch_event);
+
+    /* design.cybt configures both GAP roles so that one configuration builds
+     * either device; the stack only runs the role of this build
+     */
+    ble_params = *cy_ble_config.params;
+    ble_params.gapRole = (0u == FINDME_LOCATOR) ? CY_BLE_GAP_PERIPHERAL :
+                                                  CY_BLE_GAP_CENTRAL;
+    cy_ble_config.params = &ble_params;
 
     /* Initializes the BLE host */
     Cy_BLE_Init(&cy_ble_config);
 
+#if (BLE_DUAL_CORE != 0u)
+    /* The controller on CM0+ owns the BLESS interrupt. Each message it
+     * sends through the IPC pipe rings this core with an IPC interrupt.
+     */
+    Cy_BLE_RegisterAppHostCallback(bless_interrupt_handler);
+#endif
+
     /* Enables BLE */
     Cy_BLE_Enable();
+    boot_profile_mark(BOOT_STAGE_BLE_ENABLED);
 
     /* Enables BLE Low-power mode (LPM)*/
     Cy_BLE_EnableLowPowerMode();
 
-    /* Register IAS event handler */
-    Cy_BLE_IAS_RegisterAttrCallback(ble_ias_callback);
+    /* Route IAS events through the dispatcher as well */
+    Cy_BLE_IAS_RegisterAttrCallback(ble_dispatch_event);
 }
 
 
@@ -211,288 +423,525 @@ static void ble_init(void)
 * Function Name: bless_interrupt_handler
 *******************************************************************************
 * Summary:
-*  Wrapper function for handling interrupts from BLESS.
+*  Wrapper function for handling interrupts from BLESS. With the controller
+*  on CM0+, it is the callback of the IPC interrupt raised for each message
+*  from the controller instead, and the stack handles the pipe itself.
 *
 ******************************************************************************/
 static void bless_interrupt_handler(void)
 {
+    PROFILER_BEGIN(BLESS_ISR);
+
+    if(!bless_isr_stamped)
+    {
+        bless_isr_cycles = cycle_counter_read();
+        bless_isr_stamped = true;
+    }
+
+#if (BLE_DUAL_CORE == 0u)
     Cy_BLE_BlessIsrHandler();
+#endif
+
+    /* Keep the main loop awake until the stack has processed the interrupt */
+    (void)app_event_post(APP_EVENT_BLE, 0u, true);
+
+    PROFILER_END(BLESS_ISR);
+}
+
+
+/*******************************************************************************
+* Function Name: ble_process_events
+********************************************************************************
+* Summary:
+*  Lets the BLE stack process its pending events. The time spent is accounted
+*  to the BLE power state and profiled. The first BLESS interrupt since the
+*  previous pass is the start of the alert latency measured in this pass.
+*
+*******************************************************************************/
+static void ble_process_events(void)
+{
+    uint32_t interrupt_state;
+
+    PROFILER_BEGIN(PROCESS_EVENTS);
+
+    /* Interrupts from here on belong to the next pass */
+    interrupt_state = Cy_SysLib_EnterCriticalSection();
+    ble_pass_cycles = bless_isr_cycles;
+    ble_pass_stamped = bless_isr_stamped;
+    bless_isr_stamped = false;
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    power_stats_enter(POWER_STATE_BLE);
+    Cy_BLE_ProcessEvents();
+    power_stats_enter(POWER_STATE_ACTIVE);
+
+    ble_pass_stamped = false;
+
+    PROFILER_END(PROCESS_EVENTS);
 }
 
 
 /*******************************************************************************
-* Function Name: stack_event_handler
+* Function Name: ble_evt_stack_on
 ********************************************************************************
+* Summary:
+*  This event is received when the BLE stack is started.
 *
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_stack_on(uint32_t event, void* eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    APP_LOG_INFO(STACK_ON, 0u);
+    boot_profile_mark(BOOT_STAGE_STACK_ON);
+    ble_set_tx_power(CY_BLE_LL_ADV_CH_TYPE, 0u);
+    ble_start_advertisement();
+}
+
+
+/*******************************************************************************
+* Function Name: ble_evt_timeout
+********************************************************************************
 * Summary:
-*   This is an event callback function to receive events from the BLE Component.
+*  This event is received when there is a timeout.
 *
 * Parameters:
-*  uint32 event:      event from the BLE component
+*  uint32_t event:    event from the BLE component
 *  void* eventParam:  parameters related to the event
 *
 *******************************************************************************/
-static void stack_event_handler(uint32_t event, void* eventParam)
+static void ble_evt_timeout(uint32_t event, void* eventParam)
 {
-    switch(event)
-    {
-        /**********************************************************************
-         * General events
-         *********************************************************************/
+    /* Reason for Timeout */
+    cy_en_ble_to_reason_code_t reason_code =
+        ((cy_stc_ble_timeout_param_t*)eventParam)->reasonCode;
 
-        /* This event is received when the BLE stack is started */
-        case CY_BLE_EVT_STACK_ON:
+    (void)event;
+
+    switch(reason_code)
+    {
+        case CY_BLE_GAP_ADV_TO:
         {
-            printf("[INFO] : BLE stack started \r\n");
-            ble_start_advertisement();
+            APP_LOG_INFO(ADV_TIMEOUT, 0u);
             break;
         }
-
-        /* This event is received when there is a timeout */
-        case CY_BLE_EVT_TIMEOUT:
+        case CY_BLE_GATT_RSP_TO:
         {
-            /* Reason for Timeout */
-            cy_en_ble_to_reason_code_t reason_code =
-                ((cy_stc_ble_timeout_param_t*)eventParam)->reasonCode;
-
-            switch(reason_code)
-            {
-                case CY_BLE_GAP_ADV_TO:
-                {
-                    printf("[INFO] : Advertisement timeout event \r\n");
-                    break;
-                }
-                case CY_BLE_GATT_RSP_TO:
-                {
-                    printf("[INFO] : GATT response timeout\r\n");
-                    break;
-                }
-                default:
-                {
-                    printf("[INFO] : BLE timeout event\r\n");
-                    break;
-                }
-            }
+            APP_LOG_INFO(GATT_RSP_TIMEOUT, 0u);
             break;
         }
+        default:
+        {
+            APP_LOG_INFO(BLE_TIMEOUT, 0u);
+            break;
+        }
+    }
+}
+
 
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+/*******************************************************************************
+* Function Name: ble_evt_log_only
+********************************************************************************
+* Summary:
+*  Handles the events that only need to be reported on the debug UART: stack
+*  command completions, GAP connection and the GATT requests that are served
+*  by the BLE stack itself.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_log_only(uint32_t event, void* eventParam)
+{
+    (void)eventParam;
+
+    switch(event)
+    {
         /* This event indicates completion of Set LE event mask */
         case CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE:
         {
-            printf("[INFO] : Set LE mask event mask command completed\r\n");
+            APP_LOG_INFO(LE_MASK_COMPLETE, 0u);
             break;
         }
 
         /* This event indicates set device address command completed */
         case CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE:
         {
-            printf("[INFO] : Set device address command has completed \r\n");
+            APP_LOG_INFO(DEVICE_ADDR_COMPLETE, 0u);
             break;
         }
 
         /* This event indicates set Tx Power command completed */
         case CY_BLE_EVT_SET_TX_PWR_COMPLETE:
         {
-            printf("[INFO] : Set Tx power command completed\r\n");
+            APP_LOG_INFO(TX_PWR_COMPLETE, 0u);
             break;
         }
 
         /* This event indicates BLE Stack Shutdown is completed */
         case CY_BLE_EVT_STACK_SHUTDOWN_COMPLETE:
         {
-            printf("[INFO] : BLE shutdown complete\r\n");
+            APP_LOG_INFO(SHUTDOWN_COMPLETE, 0u);
             break;
         }
 
-
-        /**********************************************************************
-         * GAP events
-         *********************************************************************/
-
         /* This event is generated at the GAP Peripheral end after connection
          * is completed with peer Central device
          */
         case CY_BLE_EVT_GAP_DEVICE_CONNECTED:
         {
-            printf("[INFO] : GAP device connected \r\n");
+            APP_LOG_INFO(GAP_CONNECTED, 0u);
             break;
         }
+
         /* This event is triggered instead of 'CY_BLE_EVT_GAP_DEVICE_CONNECTED',
          * if Link Layer Privacy is enabled in component customizer
          */
         case CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE:
         {
-            printf("[INFO] : GAP enhanced connection complete \r\n");
+            APP_LOG_INFO(GAP_ENHANCE_CONN, 0u);
             break;
         }
 
-        /* This event is generated when disconnected from remote device or
-         * failed to establish connection
-         */
-        case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:
+        /* This event indicates that the 'GATT MTU Exchange Request' is received */
+        case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
         {
-            if(CY_BLE_CONN_STATE_DISCONNECTED ==
-               Cy_BLE_GetConnectionState(app_conn_handle))
-            {
-                printf("[INFO] : GAP device disconnected\r\n");
-                alert_level = CY_BLE_NO_ALERT;
-                ble_start_advertisement();
-            }
+            APP_LOG_INFO(GATT_MTU_REQ, 0u);
             break;
         }
 
-        /* This event indicates that the GAP Peripheral device has
-         * started/stopped advertising
+        /* This event received when GATT read characteristic request received */
+        case CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
+        {
+            APP_LOG_INFO(GATT_READ_REQ, 0u);
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: ble_evt_gap_disconnected
+********************************************************************************
+* Summary:
+*  This event is generated when disconnected from remote device or failed to
+*  establish connection.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_gap_disconnected(uint32_t event, void* eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    APP_LOG_INFO(GAP_DISCONNECTED, 0u);
+
+    /* A slot is free again; the remaining links keep their alert levels.
+     * With bonded Centrals, advertise directed to the Central that just left
+     * and then to the whitelist before opening up to any Central.
+     */
+    adv_policy_restart((0u != bond_mgr_count()) ? ADV_PROFILE_RECONNECT :
+                                                  ADV_PROFILE_STANDARD);
+    ble_start_advertisement();
+    ble_update_status();
+}
+
+
+/*******************************************************************************
+* Function Name: ble_evt_adv_start_stop
+********************************************************************************
+* Summary:
+*  This event indicates that the GAP Peripheral device has started/stopped
+*  advertising.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_adv_start_stop(uint32_t event, void* eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    if(CY_BLE_ADV_STATE_ADVERTISING == Cy_BLE_GetAdvertisementState())
+    {
+        APP_LOG_INFO(ADV_STARTED, 0u);
+        boot_profile_mark(BOOT_STAGE_FIRST_ADV);
+        boot_profile_mark(BOOT_STAGE_READY);
+    }
+    else
+    {
+        APP_LOG_INFO(ADV_STOPPED, 0u);
+
+        /* Step down to the next, slower advertising stage. Shut down when
+         * the last stage has timed out and no link is left; the device then
+         * hibernates. A long button press restarts from the first stage.
          */
-        case CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+        if(0u == conn_table_count())
         {
-            if(CY_BLE_ADV_STATE_ADVERTISING == Cy_BLE_GetAdvertisementState())
+            if(ble_adv_restart)
             {
-                printf("[INFO] : BLE advertisement started\r\n");
+                ble_adv_restart = false;
+                ble_start_advertisement();
+            }
+            else if(adv_policy_next_stage())
+            {
+                ble_start_advertisement();
             }
             else
             {
-                printf("[INFO] : BLE advertisement stopped\r\n");
-
                 Cy_BLE_Disable();
             }
-            break;
         }
+    }
 
+    ble_update_status();
+}
 
-        /**********************************************************************
-         * GATT events
-         *********************************************************************/
 
-        /* This event is generated at the GAP Peripheral end after connection
-         * is completed with peer Central device
-         */
-        case CY_BLE_EVT_GATT_CONNECT_IND:
-        {
-            app_conn_handle = *(cy_stc_ble_conn_handle_t *)eventParam;
-            printf("[INFO] : GATT device connected\r\n");
-            break;
-        }
+/*******************************************************************************
+* Function Name: ble_evt_gatt_connect
+********************************************************************************
+* Summary:
+*  This event is generated at the GAP Peripheral end after connection is
+*  completed with peer Central device.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_gatt_connect(uint32_t event, void* eventParam)
+{
+    (void)event;
 
-        /* This event is generated at the GAP Peripheral end after disconnection */
-        case CY_BLE_EVT_GATT_DISCONNECT_IND:
-        {
-            printf("[INFO] : GATT device disconnected\r\n");
-            break;
-        }
+    (void)conn_table_add(*(cy_stc_ble_conn_handle_t *)eventParam);
+    APP_LOG_INFO(GATT_CONNECTED, 0u);
+    ble_set_tx_power(CY_BLE_LL_CONN_CH_TYPE,
+                     ((cy_stc_ble_conn_handle_t *)eventParam)->bdHandle);
 
-        /* This event indicates that the 'GATT MTU Exchange Request' is received */
-        case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
-        {
-            printf("[INFO] : GATT MTU Exchange Request received \r\n");
-            break;
-        }
+    /* Keep advertising while more Centrals can connect */
+    adv_policy_restart(ADV_PROFILE_STANDARD);
+    ble_start_advertisement();
+    ble_update_status();
+}
 
-        /* This event received when GATT read characteristic request received */
-        case CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
-        {
-            printf("[INFO] : GATT read characteristic request received \r\n");
-            break;
-        }
 
-        default:
-        {
-            printf("[INFO] : BLE Event 0x%lX\r\n", (unsigned long) event);
-        }
-    }
+/*******************************************************************************
+* Function Name: ble_evt_gatt_disconnect
+********************************************************************************
+* Summary:
+*  This event is generated at the GAP Peripheral end after disconnection.
+*  Only the entry of the disconnected link is removed.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_gatt_disconnect(uint32_t event, void* eventParam)
+{
+    (void)event;
+
+    conn_table_remove(*(cy_stc_ble_conn_handle_t *)eventParam);
+    APP_LOG_INFO(GATT_DISCONNECTED, 0u);
+    ble_update_status();
 }
 
 
 /*******************************************************************************
-* Function Name: ble_ias_callback
+* Function Name: ble_evt_ias_write
 ********************************************************************************
 * Summary:
-*  This is an event callback function to receive events from the BLE, which are
-*  specific to Immediate Alert Service.
+*  This event is received when the peer writes the Alert Level Characteristic
+*  of the Immediate Alert Service. The level is taken from the event and the
+*  outputs change before the handler returns, in the same pass as the write.
 *
 * Parameters:
-*  uint32 event:      event from the BLE component
-*  void* eventParams: parameters related to the event
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
 *
 *******************************************************************************/
-void ble_ias_callback(uint32 event, void *eventParam)
+static void ble_evt_ias_write(uint32_t event, void* eventParam)
 {
-    /* Alert Level Characteristic write event */
-    if(event == CY_BLE_EVT_IASS_WRITE_CHAR_CMD)
+    cy_stc_ble_ias_char_value_t *char_value = (cy_stc_ble_ias_char_value_t *)eventParam;
+    conn_entry_t *entry = conn_table_find(char_value->connHandle);
+    uint32_t latency;
+
+    (void)event;
+
+    /* The GATT database holds a single Alert Level for all links, so the
+     * value of this link is taken from the write itself
+     */
+    if((NULL != entry) && (CY_BLE_IAS_ALERT_LEVEL == char_value->charIndex) &&
+       (NULL != char_value->value) && (char_value->value->len >= 1u) &&
+       (char_value->value->val[0] <= CY_BLE_HIGH_ALERT))
     {
-        /* Read the updated Alert Level value from the GATT database */
-        Cy_BLE_IASS_GetCharacteristicValue(CY_BLE_IAS_ALERT_LEVEL,
-                                           sizeof(alert_level), &alert_level);
+        entry->alert_level = char_value->value->val[0];
+        ble_update_status();
+
+        /* The outputs have changed; time the write from its interrupt. A
+         * replayed write has no interrupt and is not timed.
+         */
+        if(ble_pass_stamped)
+        {
+            latency = cycle_counter_read() - ble_pass_cycles;
+            ble_pass_stamped = false;
+
+            profiler_record(PROFILER_SCOPE_ALERT_LATENCY, latency);
+            APP_LOG_INFO(ALERT_LATENCY, latency / (SystemCoreClock / 1000000u));
+        }
     }
+}
+
 
-    /* Remove warning for unused parameter */
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+/*******************************************************************************
+* Function Name: ble_evt_unhandled
+********************************************************************************
+* Summary:
+*  Called by the dispatcher for events that have no registered handler.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void ble_evt_unhandled(uint32_t event, void* eventParam)
+{
     (void)eventParam;
+
+    APP_LOG_INFO(BLE_EVENT, event);
 }
+#endif
 
 
 /******************************************************************************
 * Function Name: ble_start_advertisement
 *******************************************************************************
 * Summary:
-*  This function starts the advertisement.
+*  This function starts the advertisement. A stage that fails to start, such
+*  as directed advertising to a peer the controller rejects, gives way to
+*  the next stage, so the device never ends up neither advertising nor
+*  hibernating. When no stage starts and no link is left, BLE is shut down
+*  and the device hibernates.
 *
 ******************************************************************************/
 static void ble_start_advertisement(void)
 {
     cy_en_ble_api_result_t ble_api_result;
 
-    if((CY_BLE_ADV_STATE_ADVERTISING != Cy_BLE_GetAdvertisementState()) &&
+    /* The Locator build scans instead (findme_locator.c) */
+    if((0u == FINDME_LOCATOR) &&
+       (CY_BLE_ADV_STATE_ADVERTISING != Cy_BLE_GetAdvertisementState()) &&
        (Cy_BLE_GetNumOfActiveConn() < CY_BLE_CONN_COUNT))
     {
-        ble_api_result = Cy_BLE_GAPP_StartAdvertisement(
-                            CY_BLE_ADVERTISING_FAST,
-                            CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+        do
+        {
+            /* Advertise with the interval and timeout of the current stage */
+            adv_policy_apply();
+            APP_LOG_INFO(ADV_INTERVAL, adv_policy_current_stage()->interval_min);
+            APP_LOG_INFO(ADV_MODE, adv_policy_current_stage()->mode);
 
-        if(CY_BLE_SUCCESS != ble_api_result)
+            ble_api_result = Cy_BLE_GAPP_StartAdvertisement(
+                                CY_BLE_ADVERTISING_FAST,
+                                CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+
+            if(CY_BLE_SUCCESS != ble_api_result)
+            {
+                APP_LOG_ERROR(ADV_START_FAILED, ble_api_result);
+            }
+        } while((CY_BLE_SUCCESS != ble_api_result) && adv_policy_next_stage());
+
+        if((CY_BLE_SUCCESS != ble_api_result) && (0u == conn_table_count()))
         {
-            printf("[ERROR] : Failed to start advertisement \r\n");
+            Cy_BLE_Disable();
         }
     }
 }
 
 
 /*******************************************************************************
-* Function Name: wakeup_timer_interrupt_handler
+* Function Name: ble_update_status
 ********************************************************************************
 * Summary:
-*  wakeup_timer interrupt handler.
-*
-* Parameters:
-*  void *handler_arg (unused)
-*  cyhal_lptimer_irq_event_t event (unused)
+*  Shows the current BLE link state and the highest alert level across all
+*  links on the user LEDs. Called from the event handlers that change either
+*  of them, and when a link goes out of range or comes back. A connected
+*  device shows the connected state even while it keeps advertising for more
+*  Centrals.
 *
 *******************************************************************************/
-void wakeup_timer_interrupt_handler(void *handler_arg, cyhal_lptimer_event_t event)
+static void ble_update_status(void)
 {
-    /* Set the interrupt flag */
-    wakeup_intr_flag = true;
+    status_link_t link = STATUS_LINK_IDLE;
+    uint8_t alert_level;
+
+    if(0u != conn_table_count())
+    {
+        link = STATUS_LINK_CONNECTED;
+    }
+    else if(CY_BLE_ADV_STATE_ADVERTISING == Cy_BLE_GetAdvertisementState())
+    {
+        link = STATUS_LINK_ADVERTISING;
+    }
+    else
+    {
+        link = STATUS_LINK_IDLE;
+    }
+
+    /* A link out of range raises a local alert of its own */
+    alert_level = conn_table_max_alert();
+    if(proximity_alert_level() > alert_level)
+    {
+        alert_level = proximity_alert_level();
+    }
 
-    /* Reload the timer to get periodic interrupt */
-    cyhal_lptimer_reload(&wakeup_timer);
-    cyhal_lptimer_set_match(&wakeup_timer, WAKEUP_TIMER_MATCH_VALUE);
+    status_led_update(link, alert_level);
 }
 
 
 /*******************************************************************************
-* Function Name: wakeup_timer_init
+* Function Name: ble_set_tx_power
 ********************************************************************************
 * Summary:
-*  Initialize deep sleep wakeup timer for generating interrupt.
+*  Applies the TX power level of the settings, if one is set, to the
+*  advertising channels or to one connection.
+*
+* Parameters:
+*  cy_en_ble_bless_ch_type_t channel: advertising or connection channels
+*  uint8_t bd_handle:                 connection, for connection channels
 *
 *******************************************************************************/
-static void wakeup_timer_init(void)
+static void ble_set_tx_power(cy_en_ble_bless_ch_type_t channel, uint8_t bd_handle)
 {
-    cyhal_lptimer_init(&wakeup_timer);
-    cyhal_lptimer_set_match(&wakeup_timer, WAKEUP_TIMER_MATCH_VALUE);
-    cyhal_lptimer_reload(&wakeup_timer);
-    cyhal_lptimer_register_callback(&wakeup_timer, wakeup_timer_interrupt_handler, NULL);
-    cyhal_lptimer_enable_event(&wakeup_timer, CYHAL_LPTIMER_COMPARE_MATCH,
-                               WAKEUP_INTR_PRIORITY, true);
+    cy_stc_ble_tx_pwr_lvl_info_t tx_power;
+    uint32_t level = settings_get(SETTINGS_TX_POWER_LEVEL);
+
+    if(0u != level)
+    {
+        tx_power.pwrConfigParam.bleSsChId = channel;
+        tx_power.pwrConfigParam.bdHandle = bd_handle;
+        tx_power.blePwrLevel = (cy_en_ble_bless_pwr_lvl_t)level;
+        (void)Cy_BLE_SetTxPowerLevel(&tx_power);
+    }
 }
 
 
@@ -502,8 +951,13 @@ static void wakeup_timer_init(void)
 * Summary:
 *  Configures the device to enter low power mode.
 *
-*  The function configures the device to enter deep sleep - whenever the
-*  BLE is idle and the UART transmission/reception is not happening.
+*  The mode is picked by sleep_policy.c: deep sleep whenever the BLE is
+*  idle and no timer is due within the break-even time, else CPU sleep.
+*  Log records that are still pending stay in RAM across deep sleep.
+*
+*  The event queue is checked with interrupts disabled. An interrupt that
+*  posts an event after the check still wakes the CPU from WFI, and its
+*  handler runs once interrupts are enabled again.
 *
 *  In case if BLE is  turned off, the function configures the device to
 *  enter hibernate mode.
@@ -511,22 +965,138 @@ static void wakeup_timer_init(void)
 *******************************************************************************/
 static void enter_low_power_mode(void)
 {
-    /* Enter hibernate mode if BLE is turned off  */
-    if(CY_BLE_STATE_STOPPED == Cy_BLE_GetState())
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    sleep_mode_t mode = SLEEP_MODE_SLEEP;
+    bool idle = !app_event_pending();
+
+    if(idle)
+    {
+        mode = sleep_policy_select();
+    }
+
+    if(idle && (SLEEP_MODE_DEEPSLEEP == mode))
     {
-        printf("[INFO] : Entering hibernate mode\r\n");
+        /* The deep sleep is only accounted once it has happened */
+        uint32_t start = app_timer_now();
 
-        /* Turn of user LEDs */
-        cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED1, CYBSP_LED_STATE_OFF);
-        cyhal_gpio_write((cyhal_gpio_t)CYBSP_USER_LED2, CYBSP_LED_STATE_OFF);
+        /* The cycle counter stops in deep sleep, so the profile holds the
+         * entry and exit time only
+         */
+        PROFILER_BEGIN(DEEPSLEEP);
 
-        /* Wait until UART transfer complete  */
-        while(1UL == cyhal_uart_is_tx_active(&cy_retarget_io_uart_obj));
-        cyhal_syspm_hibernate(CYHAL_SYSPM_HIBERNATE_PINB_LOW);
+        /* Deep sleep is refused while a peripheral that needs the
+         * high-frequency clock (the buzzer PWM) is running
+         */
+        if(CY_RSLT_SUCCESS == cyhal_syspm_deepsleep())
+        {
+            PROFILER_END(DEEPSLEEP);
+            power_stats_enter_at(POWER_STATE_DEEPSLEEP, start);
+            sleep_policy_entered(SLEEP_MODE_DEEPSLEEP);
+        }
+        else
+        {
+            power_stats_enter(POWER_STATE_SLEEP);
+            (void)cyhal_syspm_sleep();
+            sleep_policy_entered(SLEEP_MODE_SLEEP);
+        }
+        power_stats_enter(POWER_STATE_ACTIVE);
+    }
+    else if(idle && (SLEEP_MODE_SLEEP == mode))
+    {
+        power_stats_enter(POWER_STATE_SLEEP);
+        (void)cyhal_syspm_sleep();
+        sleep_policy_entered(SLEEP_MODE_SLEEP);
+        power_stats_enter(POWER_STATE_ACTIVE);
     }
     else
     {
-        cyhal_syspm_deepsleep();
+        /* An event is pending, or hibernate below */
+    }
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    /* Enter hibernate mode if BLE is turned off  */
+    if(idle && (SLEEP_MODE_HIBERNATE == mode))
+    {
+        APP_LOG_INFO(HIBERNATE, 0u);
+
+        /* Turn off user LEDs */
+        status_led_off();
+
+        /* Keep the state needed after the wakeup in the backup registers */
+        adv_policy_save();
+
+        /* Write out the pending log records before the UART is powered off */
+        app_log_flush();
+        power_stats_enter(POWER_STATE_HIBERNATE);
+        cyhal_syspm_hibernate(adv_policy_hibernate_wake_sources());
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ble_button_gesture
+********************************************************************************
+* Summary:
+*  Handles the user button gestures: a short press silences the alerts
+*  written by the Locators, a long press restarts advertising from the fast
+*  stage, and a double press logs the link count and the alert level.
+*
+* Parameters:
+*  button_gesture_t gesture: recognized gesture
+*
+*******************************************************************************/
+static void ble_button_gesture(button_gesture_t gesture)
+{
+    button_stats_t stats;
+    uint32_t wakeups;
+
+    button_get_stats(&stats);
+    wakeups = stats.edges + stats.timer_runs;
+    APP_LOG_INFO(BUTTON_GESTURE, gesture);
+    APP_LOG_INFO(BUTTON_WAKEUPS, wakeups - ble_button_wakeups);
+    ble_button_wakeups = wakeups;
+
+    switch(gesture)
+    {
+        case BUTTON_GESTURE_SHORT:
+        {
+            conn_table_clear_alerts();
+            ble_update_status();
+            break;
+        }
+
+        case BUTTON_GESTURE_LONG:
+        {
+            if(0u == conn_table_count())
+            {
+                adv_policy_restart(ADV_PROFILE_STANDARD);
+
+                /* A running advertisement is restarted from its stop event */
+                if(CY_BLE_ADV_STATE_ADVERTISING == Cy_BLE_GetAdvertisementState())
+                {
+                    ble_adv_restart = true;
+                    (void)Cy_BLE_GAPP_StopAdvertisement();
+                }
+                else
+                {
+                    ble_start_advertisement();
+                }
+            }
+            break;
+        }
+
+        case BUTTON_GESTURE_DOUBLE:
+        {
+            APP_LOG_INFO(STATUS_LINKS, conn_table_count());
+            APP_LOG_INFO(STATUS_ALERT, conn_table_max_alert());
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
     }
 }
 
@@ -46,11 +46,21 @@
 #define BLE_FIND_ME_H
 
 
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Set to 1u by the Makefile (BLE_CORE=DUAL) when the link layer controller
+ * runs on CM0+ and the host and application on CM4
+ */
+#ifndef BLE_DUAL_CORE
+#define BLE_DUAL_CORE             (0u)
+#endif
+
+
 /******************************************************************************
  * Function prototypes
  *****************************************************************************/
 void ble_findme_init(void);
-void ble_findme_process(void);
 
 
 #endif  /* BLE_FIND_ME_H */
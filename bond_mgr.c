@@ -0,0 +1,469 @@
+/******************************************************************************
+* File Name: bond_mgr.c
+*
+* Description: This file contains the bond manager. Centrals pair with Just
+*              Works and are bonded; the bonding data is written to flash by
+*              the BLE stack and every bonded Central is added to the
+*              whitelist. The manager also remembers the last bonded Central
+*              that disconnected, so that advertising can be directed to it.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "bond_mgr.h"
+#include "app_log.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* Identity address of a connected Central */
+typedef struct
+{
+    cy_stc_ble_gap_bd_addr_t addr;
+    uint8_t                  bd_handle;
+    bool                     in_use;
+} bond_peer_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void bond_evt_stack_on(uint32_t event, void *eventParam);
+static void bond_evt_connected(uint32_t event, void *eventParam);
+static void bond_evt_disconnected(uint32_t event, void *eventParam);
+static void bond_evt_auth_req(uint32_t event, void *eventParam);
+static void bond_evt_auth_result(uint32_t event, void *eventParam);
+static void bond_mgr_request_security(uint8_t bd_handle);
+static bool bond_mgr_is_bonded(uint8_t bd_handle);
+static void bond_mgr_update_whitelist(void);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const ble_dispatch_entry_t bond_event_table[] =
+{
+    { CY_BLE_EVT_STACK_ON,                  bond_evt_stack_on },
+    { CY_BLE_EVT_GAP_DEVICE_CONNECTED,      bond_evt_connected },
+    { CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE, bond_evt_connected },
+    { CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,   bond_evt_disconnected },
+    { CY_BLE_EVT_GAP_AUTH_REQ,              bond_evt_auth_req },
+    { CY_BLE_EVT_GAP_AUTH_COMPLETE,         bond_evt_auth_result },
+    { CY_BLE_EVT_GAP_AUTH_FAILED,           bond_evt_auth_result },
+};
+
+static bond_peer_t bond_peers[CY_BLE_CONN_COUNT];
+
+/* Last bonded Central that disconnected */
+static cy_stc_ble_gap_bd_addr_t reconnect_peer;
+static bool reconnect_valid = false;
+
+/* Disconnect time, for the reconnect latency */
+static uint32_t disconnect_ticks;
+static bool disconnect_pending = false;
+static uint32_t reconnect_ms = 0u;
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_init
+********************************************************************************
+* Summary:
+*  Registers the GAP event handlers. Must be called after ble_dispatch_init()
+*  and before the handlers of ble_findme.c are registered, so that the peer
+*  of a disconnected link is known when advertising is restarted.
+*
+*******************************************************************************/
+void bond_mgr_init(void)
+{
+    (void)memset(bond_peers, 0, sizeof(bond_peers));
+    reconnect_valid = false;
+    disconnect_pending = false;
+
+    if(!ble_dispatch_register(bond_event_table,
+                              BLE_DISPATCH_COUNT(bond_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_process
+********************************************************************************
+* Summary:
+*  Writes new bonding data to flash. Called from the main loop; the BLE stack
+*  writes one flash row per call while a write is pending.
+*
+*******************************************************************************/
+void bond_mgr_process(void)
+{
+    if(0u != cy_ble_pendingFlashWrite)
+    {
+        (void)Cy_BLE_StoreBondingData();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_count
+********************************************************************************
+* Summary:
+*  Returns the number of bonded Centrals.
+*
+*******************************************************************************/
+uint32_t bond_mgr_count(void)
+{
+    cy_stc_ble_gap_peer_addr_info_t devices[CY_BLE_MAX_BONDED_DEVICES];
+    cy_stc_ble_gap_bonded_device_list_info_t list = { .bdHandleAddrList = devices };
+
+    if(CY_BLE_SUCCESS != Cy_BLE_GAP_GetBondList(&list))
+    {
+        return 0u;
+    }
+
+    return list.noOfDevices;
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_get_reconnect_peer
+********************************************************************************
+* Summary:
+*  Returns the address of the last bonded Central that disconnected, for
+*  directed advertising.
+*
+* Parameters:
+*  cy_stc_ble_gap_bd_addr_t *peer: destination
+*
+* Return:
+*  bool: false if no bonded Central has disconnected since boot
+*
+*******************************************************************************/
+bool bond_mgr_get_reconnect_peer(cy_stc_ble_gap_bd_addr_t *peer)
+{
+    if(reconnect_valid)
+    {
+        *peer = reconnect_peer;
+    }
+
+    return reconnect_valid;
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_get_reconnect_ms
+********************************************************************************
+* Summary:
+*  Returns the time from the last disconnection to the next connection, in
+*  milliseconds.
+*
+*******************************************************************************/
+uint32_t bond_mgr_get_reconnect_ms(void)
+{
+    return reconnect_ms;
+}
+
+
+/*******************************************************************************
+* Function Name: bond_evt_stack_on
+********************************************************************************
+* Summary:
+*  Loads the Centrals bonded in previous sessions into the whitelist.
+*
+*******************************************************************************/
+static void bond_evt_stack_on(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    bond_mgr_update_whitelist();
+}
+
+
+/*******************************************************************************
+* Function Name: bond_evt_connected
+********************************************************************************
+* Summary:
+*  Records the address of the connected Central. With link layer privacy the
+*  enhanced event carries the resolved identity address. On a link where this
+*  device is the Peripheral, pairing is started with a security request.
+*
+*******************************************************************************/
+static void bond_evt_connected(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gap_bd_addr_t addr;
+    uint8_t bd_handle;
+    uint8_t role;
+    uint32_t i;
+
+    if(CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE == event)
+    {
+        cy_stc_ble_gap_enhance_conn_complete_param_t *param =
+            (cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam;
+
+        if(0u != param->status)
+        {
+            return;
+        }
+        bd_handle = param->bdHandle;
+        role = param->role;
+
+        /* A peer resolved by link layer privacy is reported with the
+         * identity address types 0x02/0x03; directed advertising and the
+         * whitelist only take the public/random type in bit 0
+         */
+        addr.type = param->peerBdAddrType & 0x01u;
+        (void)memcpy(addr.bdAddr, param->peerBdAddr, CY_BLE_BD_ADDR_SIZE);
+    }
+    else
+    {
+        cy_stc_ble_gap_connected_param_t *param =
+            (cy_stc_ble_gap_connected_param_t *)eventParam;
+
+        if(0u != param->status)
+        {
+            return;
+        }
+        bd_handle = param->bdHandle;
+        role = param->role;
+        addr.type = param->peerAddrType;
+        (void)memcpy(addr.bdAddr, param->peerAddr, CY_BLE_BD_ADDR_SIZE);
+    }
+
+    if(disconnect_pending)
+    {
+        disconnect_pending = false;
+        reconnect_ms = (uint32_t)(((uint64_t)(app_timer_now() - disconnect_ticks) * 1000u) /
+                                  APP_TIMER_TICKS_PER_SEC);
+        APP_LOG_INFO(RECONNECT_MS, reconnect_ms);
+    }
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(!bond_peers[i].in_use)
+        {
+            bond_peers[i].addr = addr;
+            bond_peers[i].bd_handle = bd_handle;
+            bond_peers[i].in_use = true;
+            break;
+        }
+    }
+
+    if(CY_BLE_GAP_LL_ROLE_SLAVE == role)
+    {
+        bond_mgr_request_security(bd_handle);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_evt_disconnected
+********************************************************************************
+* Summary:
+*  Remembers the disconnected Central as the reconnect target if it is
+*  bonded.
+*
+*******************************************************************************/
+static void bond_evt_disconnected(uint32_t event, void *eventParam)
+{
+    uint8_t bd_handle = ((cy_stc_ble_gap_disconnect_param_t *)eventParam)->bdHandle;
+    uint32_t i;
+
+    (void)event;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(bond_peers[i].in_use && (bond_peers[i].bd_handle == bd_handle))
+        {
+            if(bond_mgr_is_bonded(bd_handle))
+            {
+                reconnect_peer = bond_peers[i].addr;
+                reconnect_valid = true;
+            }
+            bond_peers[i].in_use = false;
+            break;
+        }
+    }
+
+    disconnect_ticks = app_timer_now();
+    disconnect_pending = true;
+}
+
+
+/*******************************************************************************
+* Function Name: bond_evt_auth_req
+********************************************************************************
+* Summary:
+*  Accepts a pairing request: unauthenticated pairing with encryption (Just
+*  Works) and bonding.
+*
+*******************************************************************************/
+static void bond_evt_auth_req(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gap_auth_info_t *auth_info =
+        &cy_ble_config.authInfo[CY_BLE_SECURITY_CONFIGURATION_0_INDEX];
+
+    (void)event;
+
+    auth_info->security = CY_BLE_GAP_SEC_MODE_1 | CY_BLE_GAP_SEC_LEVEL_2;
+    auth_info->bonding = CY_BLE_GAP_BONDING;
+    auth_info->authErr = CY_BLE_GAP_AUTH_ERROR_NONE;
+    auth_info->bdHandle = ((cy_stc_ble_gap_auth_info_t *)eventParam)->bdHandle;
+
+    if(CY_BLE_SUCCESS != Cy_BLE_GAPP_AuthReqReply(auth_info))
+    {
+        APP_LOG_ERROR(AUTH_FAILED, 0xFFu);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_evt_auth_result
+********************************************************************************
+* Summary:
+*  Logs the result of pairing. A new bond is added to the whitelist; the
+*  bonding data itself is written by bond_mgr_process().
+*
+*******************************************************************************/
+static void bond_evt_auth_result(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gap_auth_info_t *auth_info = (cy_stc_ble_gap_auth_info_t *)eventParam;
+
+    /* Only read by the log */
+    (void)auth_info;
+
+    if(CY_BLE_EVT_GAP_AUTH_COMPLETE == event)
+    {
+        APP_LOG_INFO(BONDED, auth_info->bdHandle);
+        bond_mgr_update_whitelist();
+    }
+    else
+    {
+        APP_LOG_ERROR(AUTH_FAILED, auth_info->authErr);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_request_security
+********************************************************************************
+* Summary:
+*  Sends a security request to the Central, asking for unauthenticated
+*  pairing with encryption (Just Works) and bonding. A bonded Central
+*  answers by encrypting the link with the stored keys; a new one pairs and
+*  the request is accepted in bond_evt_auth_req().
+*
+*******************************************************************************/
+static void bond_mgr_request_security(uint8_t bd_handle)
+{
+    cy_stc_ble_gap_auth_info_t *auth_info =
+        &cy_ble_config.authInfo[CY_BLE_SECURITY_CONFIGURATION_0_INDEX];
+    cy_en_ble_api_result_t result;
+
+    auth_info->security = CY_BLE_GAP_SEC_MODE_1 | CY_BLE_GAP_SEC_LEVEL_2;
+    auth_info->bonding = CY_BLE_GAP_BONDING;
+    auth_info->authErr = CY_BLE_GAP_AUTH_ERROR_NONE;
+    auth_info->bdHandle = bd_handle;
+
+    result = Cy_BLE_GAP_AuthReq(auth_info);
+    if(CY_BLE_SUCCESS != result)
+    {
+        APP_LOG_ERROR(SECURITY_REQ_FAILED, result);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_is_bonded
+********************************************************************************
+* Summary:
+*  Returns true if the device with this BD handle is in the bond list.
+*
+*******************************************************************************/
+static bool bond_mgr_is_bonded(uint8_t bd_handle)
+{
+    cy_stc_ble_gap_peer_addr_info_t devices[CY_BLE_MAX_BONDED_DEVICES];
+    cy_stc_ble_gap_bonded_device_list_info_t list = { .bdHandleAddrList = devices };
+    uint32_t i;
+
+    if(CY_BLE_SUCCESS == Cy_BLE_GAP_GetBondList(&list))
+    {
+        for(i = 0u; i < list.noOfDevices; i++)
+        {
+            if(devices[i].bdHandle == bd_handle)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: bond_mgr_update_whitelist
+********************************************************************************
+* Summary:
+*  Adds every bonded Central to the whitelist. Centrals already in the list
+*  are rejected by the stack, which is harmless.
+*
+*******************************************************************************/
+static void bond_mgr_update_whitelist(void)
+{
+    cy_stc_ble_gap_peer_addr_info_t devices[CY_BLE_MAX_BONDED_DEVICES];
+    cy_stc_ble_gap_bonded_device_list_info_t list = { .bdHandleAddrList = devices };
+    uint32_t i;
+
+    if(CY_BLE_SUCCESS == Cy_BLE_GAP_GetBondList(&list))
+    {
+        for(i = 0u; i < list.noOfDevices; i++)
+        {
+            (void)Cy_BLE_AddDeviceToWhiteList(&devices[i].bdAddr);
+        }
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,213 @@
+/******************************************************************************
+* File Name: boot_profile.c
+*
+* Description: This file contains the boot profiler. Stage times are in
+*              microseconds since main() was entered. The DWT cycle counter
+*              is used until the wakeup timer runs; from then on the wakeup
+*              timer is used, because the cycle counter stops in deep sleep.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "boot_profile.h"
+#include "app_log.h"
+#include "app_timer.h"
+#include "cycle_counter.h"
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static uint32_t boot_stage_us[BOOT_STAGE_COUNT];
+static uint32_t boot_marked = 0u;
+
+/* Cycle counter time base. The CPU clock changes in cybsp_init(), so the
+ * cycles are converted with the clock of the previous reading.
+ */
+static uint32_t boot_cycles_last;
+static uint32_t boot_cycles_per_us;
+static uint32_t boot_cycles_us;
+
+/* Wakeup timer time base */
+static bool boot_timer_used = false;
+static uint32_t boot_timer_ticks;
+static uint32_t boot_timer_us;
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+#define BOOT_STAGE_LOG_ID(name)   APP_LOG_ID_BOOT_##name,
+
+static const app_log_id_t boot_stage_log_id[BOOT_STAGE_COUNT] =
+{
+    BOOT_PROFILE_STAGES(BOOT_STAGE_LOG_ID)
+};
+
+#undef BOOT_STAGE_LOG_ID
+#endif
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t boot_profile_now_us(void);
+
+
+/*******************************************************************************
+* Function Name: boot_profile_start
+********************************************************************************
+* Summary:
+*  Starts the boot time base. Must be the first call in main().
+*
+*******************************************************************************/
+void boot_profile_start(void)
+{
+    cycle_counter_init();
+
+    boot_cycles_last = cycle_counter_read();
+    boot_cycles_per_us = SystemCoreClock / 1000000u;
+    boot_cycles_us = 0u;
+    boot_timer_used = false;
+    boot_marked = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_use_timer
+********************************************************************************
+* Summary:
+*  Switches the time base to the wakeup timer. Must be called after
+*  app_timer_init() and before the device first enters deep sleep.
+*
+*******************************************************************************/
+void boot_profile_use_timer(void)
+{
+    boot_timer_us = boot_profile_now_us();
+    boot_timer_ticks = app_timer_now();
+    boot_timer_used = true;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_mark
+********************************************************************************
+* Summary:
+*  Records the time at which a stage completed and logs it. Only the first
+*  mark of each stage is kept.
+*
+* Parameters:
+*  boot_stage_t stage: completed stage
+*
+*******************************************************************************/
+void boot_profile_mark(boot_stage_t stage)
+{
+    uint32_t bit = 1u << (uint32_t)stage;
+
+    if(0u != (boot_marked & bit))
+    {
+        return;
+    }
+
+    boot_marked |= bit;
+    boot_stage_us[stage] = boot_profile_now_us();
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+    app_log_write(APP_LOG_LEVEL_INFO, boot_stage_log_id[stage], boot_stage_us[stage]);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_is_done
+********************************************************************************
+* Summary:
+*  Returns true once the device has started advertising, or scanning in the
+*  Locator build.
+*
+*******************************************************************************/
+bool boot_profile_is_done(void)
+{
+    return (0u != (boot_marked & (1u << (uint32_t)BOOT_STAGE_READY)));
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_get_us
+********************************************************************************
+* Summary:
+*  Returns the time of a stage in microseconds since main() was entered, or 0
+*  if the stage has not completed yet.
+*
+*******************************************************************************/
+uint32_t boot_profile_get_us(boot_stage_t stage)
+{
+    return (0u != (boot_marked & (1u << (uint32_t)stage))) ? boot_stage_us[stage] : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_profile_now_us
+********************************************************************************
+* Summary:
+*  Returns the microseconds since boot_profile_start().
+*
+*******************************************************************************/
+static uint32_t boot_profile_now_us(void)
+{
+    uint32_t cycles;
+    uint32_t us;
+
+    if(boot_timer_used)
+    {
+        return boot_timer_us +
+               (uint32_t)(((uint64_t)(app_timer_now() - boot_timer_ticks) * 1000000u) /
+                          APP_TIMER_TICKS_PER_SEC);
+    }
+
+    cycles = cycle_counter_read() - boot_cycles_last;
+    us = cycles / boot_cycles_per_us;
+
+    /* Keep the remainder for the next reading */
+    boot_cycles_last += us * boot_cycles_per_us;
+    boot_cycles_us += us;
+    boot_cycles_per_us = SystemCoreClock / 1000000u;
+
+    return boot_cycles_us;
+}
+
+
+/* [] END OF FILE */
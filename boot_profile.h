@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name: boot_profile.h
+*
+* Description: This file is the public interface of boot_profile.c, which
+*              timestamps the init stages from reset to the first
+*              advertisement.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Init stages in boot order. Each stage NAME is logged with the message
+ * BOOT_NAME of app_log.h.
+ */
+#define BOOT_PROFILE_STAGES(X)                                                \
+    X(BSP)                    /* cybsp_init() done, clocks running */         \
+    X(GPIO)                   /* LEDs and user button configured */           \
+    X(BLE_ENABLED)            /* Cy_BLE_Enable() returned */                  \
+    X(STACK_ON)               /* CY_BLE_EVT_STACK_ON received */              \
+    X(FIRST_ADV)              /* first advertisement started */               \
+    X(READY)                  /* advertising or scanning started */
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+#define BOOT_STAGE_ENUM(name)     BOOT_STAGE_##name,
+
+typedef enum
+{
+    BOOT_PROFILE_STAGES(BOOT_STAGE_ENUM)
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+#undef BOOT_STAGE_ENUM
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void boot_profile_start(void);
+void boot_profile_use_timer(void);
+void boot_profile_mark(boot_stage_t stage);
+bool boot_profile_is_done(void);
+uint32_t boot_profile_get_us(boot_stage_t stage);
+
+
+#endif  /* BOOT_PROFILE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,189 @@
+/******************************************************************************
+* File Name: boot_state.c
+*
+* Description: This file determines why the device booted and keeps a few
+*              bytes of application state in the backup registers, which
+*              are retained in hibernate while SRAM is not.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "boot_state.h"
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Backup registers used. The last backup register is used by the RTC HAL. */
+#define BOOT_STATE_BREG_MAGIC     (0u)
+#define BOOT_STATE_BREG_DATA      (1u)
+
+/* Marks the backup registers as written by this firmware; change it when the
+ * layout of the data register changes.
+ */
+#define BOOT_STATE_MAGIC          (0xF1DE0002u)
+
+/* RTC alarms that can wake the device from hibernate */
+#define BOOT_STATE_RTC_ALARMS     (CY_RTC_INTR_ALARM1 | CY_RTC_INTR_ALARM2)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static boot_reason_t boot_reason = BOOT_REASON_COLD;
+static bool boot_warm = false;
+static boot_state_t boot_retained;
+
+
+/*******************************************************************************
+* Function Name: boot_state_init
+********************************************************************************
+* Summary:
+*  Reads the reset reason and the retained state. Must be called once at
+*  boot, before the RTC is initialized.
+*
+*  The wakeup source of a hibernate wakeup is told from the RTC alarm
+*  interrupt, which is latched in the backup domain, rather than from the
+*  level of the button pin: a short press may be released by the time the
+*  pin is read. Any other wakeup is the user button.
+*
+*******************************************************************************/
+void boot_state_init(void)
+{
+    uint32_t data;
+    uint32_t alarms = Cy_RTC_GetInterruptStatus() & BOOT_STATE_RTC_ALARMS;
+
+    if(0u != (Cy_SysLib_GetResetReason() & CY_SYSLIB_RESET_HIB_WAKEUP))
+    {
+        boot_reason = (0u != alarms) ? BOOT_REASON_TIMER : BOOT_REASON_BUTTON;
+    }
+    else
+    {
+        boot_reason = BOOT_REASON_COLD;
+    }
+
+    /* An alarm left pending would report the next button wakeup as a timer */
+    Cy_RTC_ClearInterrupt(alarms);
+
+    /* The retained state is only trusted after a hibernate wakeup */
+    boot_warm = (BOOT_REASON_COLD != boot_reason) &&
+                (BOOT_STATE_MAGIC == BACKUP->BREG[BOOT_STATE_BREG_MAGIC]);
+
+    if(boot_warm)
+    {
+        data = BACKUP->BREG[BOOT_STATE_BREG_DATA];
+        boot_retained.adv_profile = (uint8_t)data;
+        boot_retained.adv_stage = (uint8_t)(data >> 8u);
+        boot_retained.hibernate_count = (uint16_t)(data >> 16u);
+    }
+    else
+    {
+        boot_retained.adv_profile = 0u;
+        boot_retained.adv_stage = 0u;
+        boot_retained.hibernate_count = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: boot_state_reason
+********************************************************************************
+* Summary:
+*  Returns the boot reason.
+*
+*******************************************************************************/
+boot_reason_t boot_state_reason(void)
+{
+    return boot_reason;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_state_is_warm
+********************************************************************************
+* Summary:
+*  Returns true if this boot resumes from hibernate with valid retained
+*  state.
+*
+*******************************************************************************/
+bool boot_state_is_warm(void)
+{
+    return boot_warm;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_state_get
+********************************************************************************
+* Summary:
+*  Returns the state retained by the previous hibernate entry. All fields are
+*  zero after a cold boot.
+*
+*******************************************************************************/
+const boot_state_t* boot_state_get(void)
+{
+    return &boot_retained;
+}
+
+
+/*******************************************************************************
+* Function Name: boot_state_save
+********************************************************************************
+* Summary:
+*  Writes the application state to the backup registers. Called just before
+*  entering hibernate.
+*
+* Parameters:
+*  uint8_t adv_profile: advertising profile to resume after a button wakeup
+*  uint8_t adv_stage:   index of the last stage of that profile
+*
+*******************************************************************************/
+void boot_state_save(uint8_t adv_profile, uint8_t adv_stage)
+{
+    uint32_t count = (uint32_t)boot_retained.hibernate_count + 1u;
+
+    BACKUP->BREG[BOOT_STATE_BREG_DATA] = (uint32_t)adv_profile |
+                                         ((uint32_t)adv_stage << 8u) |
+                                         ((count & 0xFFFFu) << 16u);
+    BACKUP->BREG[BOOT_STATE_BREG_MAGIC] = BOOT_STATE_MAGIC;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name: boot_state.h
+*
+* Description: This file is the public interface of boot_state.c, the boot
+*              reason and the application state retained across hibernate.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef BOOT_STATE_H
+#define BOOT_STATE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    BOOT_REASON_COLD,         /* Power-on, reset button or debugger */
+    BOOT_REASON_BUTTON,       /* Hibernate wakeup by the user button */
+    BOOT_REASON_TIMER         /* Hibernate wakeup by the RTC alarm */
+} boot_reason_t;
+
+/* Application state kept in the backup registers while hibernating */
+typedef struct
+{
+    uint8_t adv_profile;      /* advertising profile to resume */
+    uint8_t adv_stage;        /* stage of that profile reached last */
+    uint16_t hibernate_count; /* hibernate cycles since the last cold boot */
+} boot_state_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void boot_state_init(void);
+boot_reason_t boot_state_reason(void);
+bool boot_state_is_warm(void);
+const boot_state_t* boot_state_get(void);
+void boot_state_save(uint8_t adv_profile, uint8_t adv_stage);
+
+
+#endif  /* BOOT_STATE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,189 @@
+/******************************************************************************
+* File Name: button.c
+*
+* Description: This file contains the user button driver. Both edges of the
+*              button pin raise an interrupt. The first edge masks the pin
+*              and hands over to the state machine in button_gesture.c, which
+*              samples the level once a debounce timer on the wakeup timer
+*              has expired, so the bounce of one edge costs a single
+*              interrupt and the CPU sleeps while the contacts settle.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "button.h"
+#include "app_event.h"
+#include "cyhal.h"
+#include "cybsp.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define BUTTON_INTR_PRIORITY      (7u)
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void button_interrupt_handler(void *handler_arg, cyhal_gpio_event_t event);
+static bool button_is_pressed(void);
+static void button_enable_edges(bool enable);
+
+static const button_backend_t button_pin_backend =
+{
+    .is_pressed   = button_is_pressed,
+    .enable_edges = button_enable_edges
+};
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static volatile uint32_t button_edges;
+
+
+/*******************************************************************************
+* Function Name: button_init
+********************************************************************************
+* Summary:
+*  Enables the edge interrupt of the user button. The pin must already be
+*  configured as an input with a pull-up. Must be called after
+*  app_timer_init().
+*
+* Parameters:
+*  button_callback_t callback: called for each recognized gesture
+*
+*******************************************************************************/
+void button_init(button_callback_t callback)
+{
+    button_edges = 0u;
+    button_gesture_init(&button_pin_backend, callback);
+
+    cyhal_gpio_register_callback(CYBSP_USER_BTN, button_interrupt_handler, NULL);
+    button_enable_edges(true);
+}
+
+
+/*******************************************************************************
+* Function Name: button_process_edge
+********************************************************************************
+* Summary:
+*  Starts the debounce timer. Called from the main loop for each
+*  APP_EVENT_BUTTON event.
+*
+*******************************************************************************/
+void button_process_edge(void)
+{
+    button_gesture_edge();
+}
+
+
+/*******************************************************************************
+* Function Name: button_get_stats
+********************************************************************************
+* Summary:
+*  Copies the number of interrupts, timer expiries, presses and gestures.
+*  Their sum over the gestures is the number of wakeups per gesture.
+*
+* Parameters:
+*  button_stats_t *stats: destination
+*
+*******************************************************************************/
+void button_get_stats(button_stats_t *stats)
+{
+    button_gesture_get_stats(stats);
+    stats->edges = button_edges;
+}
+
+
+/*******************************************************************************
+* Function Name: button_interrupt_handler
+********************************************************************************
+* Summary:
+*  Button pin interrupt handler. Masks the pin until the debounce timer has
+*  expired and posts a button event.
+*
+* Parameters:
+*  void *handler_arg (unused)
+*  cyhal_gpio_event_t event (unused)
+*
+*******************************************************************************/
+static void button_interrupt_handler(void *handler_arg, cyhal_gpio_event_t event)
+{
+    (void)handler_arg;
+    (void)event;
+
+    button_enable_edges(false);
+    button_edges++;
+
+    (void)app_event_post(APP_EVENT_BUTTON, (uint32_t)cyhal_gpio_read(CYBSP_USER_BTN), true);
+}
+
+
+/*******************************************************************************
+* Function Name: button_is_pressed
+********************************************************************************
+* Summary:
+*  Pin backend: returns true if the button is pressed.
+*
+*******************************************************************************/
+static bool button_is_pressed(void)
+{
+    return (CYBSP_BTN_PRESSED == cyhal_gpio_read(CYBSP_USER_BTN));
+}
+
+
+/*******************************************************************************
+* Function Name: button_enable_edges
+********************************************************************************
+* Summary:
+*  Pin backend: unmasks or masks the edge interrupt of the button pin.
+*
+* Parameters:
+*  bool enable: true to unmask
+*
+*******************************************************************************/
+static void button_enable_edges(bool enable)
+{
+    cyhal_gpio_enable_event(CYBSP_USER_BTN, CYHAL_GPIO_IRQ_BOTH, BUTTON_INTR_PRIORITY, enable);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,269 @@
+/******************************************************************************
+* File Name: button_gesture.c
+*
+* Description: This file contains the debounce and gesture state machine of
+*              the user button. The driver in button.c reports the first edge
+*              of a press or release; a debounce timer on the wakeup timer
+*              then samples the settled level through the pin backend. The
+*              debounced presses and releases are turned into short, long
+*              and double press gestures. A short press is only reported
+*              once the double press gap has passed.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "button_gesture.h"
+#include "app_timer.h"
+#include <stddef.h>
+#include <string.h>
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void button_debounce_callback(void *arg);
+static void button_gap_callback(void *arg);
+static void button_release(uint32_t duration);
+static void button_report(button_gesture_t gesture);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const button_backend_t *button_backend = NULL;
+static button_callback_t button_callback;
+
+static app_timer_t button_debounce_timer;
+static app_timer_t button_gap_timer;
+
+/* Debounced level, and whether the current press started while the driver
+ * ran. The press that woke the device from hibernate is not a gesture.
+ */
+static bool button_pressed;
+static bool button_tracking;
+static uint32_t button_press_tick;
+
+/* A short press waits for a second one until the gap timer expires */
+static bool button_short_pending;
+
+static button_stats_t button_stats;
+
+
+/*******************************************************************************
+* Function Name: button_gesture_init
+********************************************************************************
+* Summary:
+*  Takes the current pin level as the debounced level and clears the
+*  statistics. Must be called after app_timer_init(), before the edge
+*  interrupt is enabled.
+*
+* Parameters:
+*  const button_backend_t *backend: pin backend
+*  button_callback_t callback:      called for each recognized gesture
+*
+*******************************************************************************/
+void button_gesture_init(const button_backend_t *backend, button_callback_t callback)
+{
+    button_backend = backend;
+    button_callback = callback;
+    app_timer_stop(&button_debounce_timer);
+    app_timer_stop(&button_gap_timer);
+
+    button_pressed = button_backend->is_pressed();
+    button_tracking = false;
+    button_short_pending = false;
+    (void)memset(&button_stats, 0, sizeof(button_stats));
+}
+
+
+/*******************************************************************************
+* Function Name: button_gesture_edge
+********************************************************************************
+* Summary:
+*  Starts the debounce timer. Called from the main loop for each edge that
+*  the driver has seen; the driver keeps the pin masked until the timer has
+*  expired.
+*
+*******************************************************************************/
+void button_gesture_edge(void)
+{
+    app_timer_start(&button_debounce_timer, APP_TIMER_MS_TO_TICKS(BUTTON_DEBOUNCE_MS), 0u,
+                    button_debounce_callback, NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: button_gesture_get_stats
+********************************************************************************
+* Summary:
+*  Copies the number of timer expiries, presses and gestures. The edge
+*  count is left at zero; it is kept by the driver.
+*
+* Parameters:
+*  button_stats_t *stats: destination
+*
+*******************************************************************************/
+void button_gesture_get_stats(button_stats_t *stats)
+{
+    *stats = button_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: button_debounce_callback
+********************************************************************************
+* Summary:
+*  Unmasks the pin and takes its level as the debounced state. The pin is
+*  unmasked before it is read, so an edge after the read raises a new
+*  interrupt instead of being lost.
+*
+*******************************************************************************/
+static void button_debounce_callback(void *arg)
+{
+    uint32_t now = app_timer_now();
+    bool pressed;
+
+    (void)arg;
+
+    button_stats.timer_runs++;
+
+    button_backend->enable_edges(true);
+    pressed = button_backend->is_pressed();
+
+    if(pressed == button_pressed)
+    {
+        /* The contacts bounced back to the previous level */
+        return;
+    }
+
+    button_pressed = pressed;
+
+    if(pressed)
+    {
+        button_press_tick = now;
+        button_tracking = true;
+        button_stats.presses++;
+    }
+    else if(button_tracking)
+    {
+        button_tracking = false;
+        button_release(now - button_press_tick);
+    }
+    else
+    {
+        /* Release of the press that woke the device */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: button_gap_callback
+********************************************************************************
+* Summary:
+*  No second press followed a short press: reports the short press.
+*
+*******************************************************************************/
+static void button_gap_callback(void *arg)
+{
+    (void)arg;
+
+    button_stats.timer_runs++;
+
+    button_short_pending = false;
+    button_report(BUTTON_GESTURE_SHORT);
+}
+
+
+/*******************************************************************************
+* Function Name: button_release
+********************************************************************************
+* Summary:
+*  Classifies a press by its length and by the press before it.
+*
+* Parameters:
+*  uint32_t duration: press length in wakeup timer ticks
+*
+*******************************************************************************/
+static void button_release(uint32_t duration)
+{
+    if(duration >= APP_TIMER_MS_TO_TICKS(BUTTON_LONG_MS))
+    {
+        /* A short press still waiting for its gap came first */
+        if(button_short_pending)
+        {
+            app_timer_stop(&button_gap_timer);
+            button_short_pending = false;
+            button_report(BUTTON_GESTURE_SHORT);
+        }
+        button_report(BUTTON_GESTURE_LONG);
+    }
+    else if(button_short_pending)
+    {
+        app_timer_stop(&button_gap_timer);
+        button_short_pending = false;
+        button_report(BUTTON_GESTURE_DOUBLE);
+    }
+    else
+    {
+        button_short_pending = true;
+        app_timer_start(&button_gap_timer, APP_TIMER_MS_TO_TICKS(BUTTON_DOUBLE_MS), 0u,
+                        button_gap_callback, NULL);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: button_report
+********************************************************************************
+* Summary:
+*  Counts a gesture and passes it to the application.
+*
+*******************************************************************************/
+static void button_report(button_gesture_t gesture)
+{
+    button_stats.gestures++;
+
+    if(NULL != button_callback)
+    {
+        button_callback(gesture);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,118 @@
+/******************************************************************************
+* File Name: button_gesture.h
+*
+* Description: This file is the public interface of button_gesture.c, the
+*              debounce and gesture state machine of the user button.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef BUTTON_GESTURE_H
+#define BUTTON_GESTURE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Time the pin must be left alone after an edge before its level counts */
+#ifndef BUTTON_DEBOUNCE_MS
+#define BUTTON_DEBOUNCE_MS        (20u)
+#endif
+
+/* A press held at least this long is a long press */
+#ifndef BUTTON_LONG_MS
+#define BUTTON_LONG_MS            (1500u)
+#endif
+
+/* Largest gap between two short presses of a double press */
+#ifndef BUTTON_DOUBLE_MS
+#define BUTTON_DOUBLE_MS          (400u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    BUTTON_GESTURE_SHORT,
+    BUTTON_GESTURE_LONG,
+    BUTTON_GESTURE_DOUBLE
+} button_gesture_t;
+
+/* Called from the main loop when a gesture is recognized */
+typedef void (*button_callback_t)(button_gesture_t gesture);
+
+typedef struct
+{
+    uint32_t edges;           /* pin interrupts */
+    uint32_t timer_runs;      /* debounce and gap timer expiries */
+    uint32_t presses;         /* debounced presses */
+    uint32_t gestures;        /* gestures reported */
+} button_stats_t;
+
+/* Pin backend. The state machine only decides when the pin is sampled; the
+ * backend reads it and masks its edge interrupt.
+ */
+typedef struct
+{
+    bool (*is_pressed)(void);
+    void (*enable_edges)(bool enable);
+} button_backend_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void button_gesture_init(const button_backend_t *backend, button_callback_t callback);
+void button_gesture_edge(void);
+void button_gesture_get_stats(button_stats_t *stats);
+
+
+#endif  /* BUTTON_GESTURE_H */
+
+
+/* [] END OF FILE */
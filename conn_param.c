@@ -0,0 +1,706 @@
+/******************************************************************************
+* File Name: conn_param.c
+*
+* Description: This file contains the connection parameter manager. A link
+*              that has been quiet for CONN_PARAM_IDLE_AFTER_MS is moved to a
+*              long connection interval with peripheral latency, so the radio
+*              wakes about once a second. An alert write, or a telemetry
+*              subscription, moves it back to a short interval until the link
+*              is quiet again. The Central may reject a request; after
+*              CONN_PARAM_MAX_REJECTS the link keeps its parameters.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "conn_param.h"
+#include "app_log.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Connection interval unit in us */
+#define CONN_PARAM_INTV_US        (1250u)
+
+/* Time the Central has to answer an update request: the L2CAP signaling
+ * response timeout (RTX) of the Core specification
+ */
+#define CONN_PARAM_RESPONSE_MS    (30000u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef enum
+{
+    CONN_PARAM_ACTIVE,
+    CONN_PARAM_IDLE,
+    CONN_PARAM_NONE
+} conn_param_profile_t;
+
+typedef struct
+{
+    uint16_t intv_min;
+    uint16_t intv_max;
+    uint16_t latency;
+    uint16_t timeout;
+} conn_param_set_t;
+
+/* Connection that is being set up, from either connection event */
+typedef struct
+{
+    uint8_t  status;
+    uint8_t  role;
+    uint16_t interval;
+    uint16_t latency;
+} conn_param_pending_t;
+
+/* Parameter state of one link, indexed like the connection table */
+typedef struct
+{
+    app_sched_task_t task;             /* idle timeout */
+    app_sched_task_t response_task;    /* response timeout of the request */
+    uint32_t         since;            /* ticks at the last parameter change */
+    uint16_t         interval;         /* 1.25 ms */
+    uint16_t         latency;
+    uint16_t         central_interval; /* interval picked by the Central */
+    uint8_t          bd_handle;
+    uint8_t          rejects;
+    uint8_t          requested;        /* profile of the request in flight */
+    uint8_t          queued;           /* profile to request after the response */
+    bool             held;
+    bool             in_use;
+} conn_param_link_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void conn_param_evt_conn_complete(uint32_t event, void *eventParam);
+static void conn_param_evt_connect(uint32_t event, void *eventParam);
+static void conn_param_evt_disconnect(uint32_t event, void *eventParam);
+static void conn_param_evt_update(uint32_t event, void *eventParam);
+static void conn_param_evt_response(uint32_t event, void *eventParam);
+static void conn_param_evt_ias_write(uint32_t event, void *eventParam);
+static bool conn_param_idle_task(void *arg);
+static bool conn_param_response_task(void *arg);
+static void conn_param_finish(conn_param_link_t *link);
+static void conn_param_idle_after(conn_param_link_t *link);
+static void conn_param_request(conn_param_link_t *link, conn_param_profile_t profile);
+static bool conn_param_satisfies(const conn_param_link_t *link, conn_param_profile_t profile);
+static void conn_param_account(conn_param_link_t *link);
+static conn_param_link_t* conn_param_find(uint8_t bd_handle);
+
+
+/*******************************************************************************
+* BLE event handler table
+********************************************************************************/
+static const ble_dispatch_entry_t conn_param_event_table[] =
+{
+    { CY_BLE_EVT_GAP_DEVICE_CONNECTED,           conn_param_evt_conn_complete },
+    { CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE,      conn_param_evt_conn_complete },
+    { CY_BLE_EVT_GATT_CONNECT_IND,               conn_param_evt_connect },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND,            conn_param_evt_disconnect },
+    { CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE, conn_param_evt_update },
+    { CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP,    conn_param_evt_response },
+    { CY_BLE_EVT_IASS_WRITE_CHAR_CMD,            conn_param_evt_ias_write },
+};
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const conn_param_set_t conn_param_sets[CONN_PARAM_NONE] =
+{
+    {
+        CONN_PARAM_ACTIVE_INTV_MIN, CONN_PARAM_ACTIVE_INTV_MAX,
+        CONN_PARAM_ACTIVE_LATENCY,  CONN_PARAM_ACTIVE_TIMEOUT
+    },
+    {
+        CONN_PARAM_IDLE_INTV_MIN,   CONN_PARAM_IDLE_INTV_MAX,
+        CONN_PARAM_IDLE_LATENCY,    CONN_PARAM_IDLE_TIMEOUT
+    }
+};
+
+static conn_param_link_t conn_param_links[CY_BLE_CONN_COUNT];
+
+/* Parameters of the connection that is being set up, until its GATT
+ * connection indicates the link index
+ */
+static conn_param_pending_t conn_param_pending;
+
+/* Connection events since boot, summed over all links */
+static uint64_t conn_param_radio_events;
+static uint64_t conn_param_central_events;
+
+static conn_param_stats_t conn_param_stats;
+
+
+/*******************************************************************************
+* Function Name: conn_param_init
+********************************************************************************
+* Summary:
+*  Registers the connection event handlers and adds the idle timeout task
+*  of each link to the scheduler. Must be called after ble_dispatch_init()
+*  and app_sched_init().
+*
+*******************************************************************************/
+void conn_param_init(void)
+{
+    uint32_t i;
+
+    (void)memset(conn_param_links, 0, sizeof(conn_param_links));
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        app_sched_add(&conn_param_links[i].task, conn_param_idle_task, &conn_param_links[i],
+                      APP_SCHED_PRIO_LINK, false);
+        app_sched_add(&conn_param_links[i].response_task, conn_param_response_task,
+                      &conn_param_links[i], APP_SCHED_PRIO_LINK, false);
+    }
+
+    (void)memset(&conn_param_stats, 0, sizeof(conn_param_stats));
+    conn_param_radio_events = 0u;
+    conn_param_central_events = 0u;
+
+    if(!ble_dispatch_register(conn_param_event_table,
+                              BLE_DISPATCH_COUNT(conn_param_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_kick
+********************************************************************************
+* Summary:
+*  Reports activity on a link: requests the active parameters if the link is
+*  idle, and restarts the idle timeout.
+*
+* Parameters:
+*  cy_stc_ble_conn_handle_t handle: link with activity
+*
+*******************************************************************************/
+void conn_param_kick(cy_stc_ble_conn_handle_t handle)
+{
+    conn_param_link_t *link;
+
+    if((handle.attId >= CY_BLE_CONN_COUNT) || !conn_param_links[handle.attId].in_use)
+    {
+        return;
+    }
+
+    link = &conn_param_links[handle.attId];
+    conn_param_request(link, CONN_PARAM_ACTIVE);
+
+    if(link->held)
+    {
+        app_sched_cancel(&link->task);
+    }
+    else
+    {
+        conn_param_idle_after(link);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_hold
+********************************************************************************
+* Summary:
+*  Keeps a link on the active parameters while a transfer is in progress.
+*  The idle timeout starts when the hold is released.
+*
+* Parameters:
+*  cy_stc_ble_conn_handle_t handle: link
+*  bool hold:                       true to hold, false to release
+*
+*******************************************************************************/
+void conn_param_hold(cy_stc_ble_conn_handle_t handle, bool hold)
+{
+    if((handle.attId < CY_BLE_CONN_COUNT) && conn_param_links[handle.attId].in_use)
+    {
+        conn_param_links[handle.attId].held = hold;
+        conn_param_kick(handle);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_interval
+********************************************************************************
+* Summary:
+*  Returns the connection interval of a link in 1.25 ms units, or 0 for a
+*  link that is not managed.
+*
+*******************************************************************************/
+uint16_t conn_param_interval(cy_stc_ble_conn_handle_t handle)
+{
+    if((handle.attId < CY_BLE_CONN_COUNT) && conn_param_links[handle.attId].in_use)
+    {
+        return conn_param_links[handle.attId].interval;
+    }
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_get_stats
+********************************************************************************
+* Summary:
+*  Copies the request counters and the wakeup accounting: the connection
+*  events the radio listened to, against the events it would have listened
+*  to at the parameters picked by the Central.
+*
+* Parameters:
+*  conn_param_stats_t *stats: destination
+*
+*******************************************************************************/
+void conn_param_get_stats(conn_param_stats_t *stats)
+{
+    uint32_t latency_ms;
+    uint32_t i;
+
+    conn_param_stats.alert_latency_ms = 0u;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(conn_param_links[i].in_use)
+        {
+            conn_param_account(&conn_param_links[i]);
+
+            latency_ms = ((uint32_t)conn_param_links[i].latency + 1u) *
+                         conn_param_links[i].interval * CONN_PARAM_INTV_US / 1000u;
+            if(latency_ms > conn_param_stats.alert_latency_ms)
+            {
+                conn_param_stats.alert_latency_ms = latency_ms;
+            }
+        }
+    }
+
+    conn_param_stats.radio_events = (uint32_t)conn_param_radio_events;
+    conn_param_stats.central_events = (uint32_t)conn_param_central_events;
+
+    *stats = conn_param_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_conn_complete
+********************************************************************************
+* Summary:
+*  Keeps the parameters and the role of a new connection until its link
+*  index is known. With link layer privacy the stack reports the enhanced
+*  event instead of the plain one.
+*
+*******************************************************************************/
+static void conn_param_evt_conn_complete(uint32_t event, void *eventParam)
+{
+    if(CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE == event)
+    {
+        cy_stc_ble_gap_enhance_conn_complete_param_t *param =
+            (cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam;
+
+        conn_param_pending.status = param->status;
+        conn_param_pending.role = param->role;
+        conn_param_pending.interval = param->connIntv;
+        conn_param_pending.latency = param->connLatency;
+    }
+    else
+    {
+        cy_stc_ble_gap_connected_param_t *param =
+            (cy_stc_ble_gap_connected_param_t *)eventParam;
+
+        conn_param_pending.status = param->status;
+        conn_param_pending.role = param->role;
+        conn_param_pending.interval = param->connIntv;
+        conn_param_pending.latency = param->connLatency;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_connect
+********************************************************************************
+* Summary:
+*  Starts managing a link on which the device is the Peripheral. The link
+*  starts on the parameters of the Central and goes idle after the timeout.
+*
+*******************************************************************************/
+static void conn_param_evt_connect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+    conn_param_link_t *link;
+
+    (void)event;
+
+    if((handle->attId >= CY_BLE_CONN_COUNT) || (0u != conn_param_pending.status) ||
+       (CY_BLE_GAP_LL_ROLE_SLAVE != conn_param_pending.role))
+    {
+        return;
+    }
+
+    link = &conn_param_links[handle->attId];
+    link->since = app_timer_now();
+    link->interval = conn_param_pending.interval;
+    link->latency = conn_param_pending.latency;
+    link->central_interval = conn_param_pending.interval;
+    link->bd_handle = handle->bdHandle;
+    link->rejects = 0u;
+    link->requested = (uint8_t)CONN_PARAM_NONE;
+    link->queued = (uint8_t)CONN_PARAM_NONE;
+    link->held = false;
+    link->in_use = true;
+
+    conn_param_idle_after(link);
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_disconnect
+********************************************************************************
+* Summary:
+*  Closes the wakeup accounting of a link and stops its timer.
+*
+*******************************************************************************/
+static void conn_param_evt_disconnect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+
+    (void)event;
+
+    if((handle->attId < CY_BLE_CONN_COUNT) && conn_param_links[handle->attId].in_use)
+    {
+        conn_param_account(&conn_param_links[handle->attId]);
+        app_sched_cancel(&conn_param_links[handle->attId].task);
+        app_sched_cancel(&conn_param_links[handle->attId].response_task);
+        conn_param_links[handle->attId].in_use = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_update
+********************************************************************************
+* Summary:
+*  Records the parameters applied by the controller. The Central may pick
+*  any interval in the requested range, or change the parameters on its own.
+*  Whatever the status, the update ends the request in flight, in case the
+*  L2CAP response never arrives.
+*
+*******************************************************************************/
+static void conn_param_evt_update(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gap_conn_param_updated_in_controller_t *param =
+        (cy_stc_ble_gap_conn_param_updated_in_controller_t *)eventParam;
+    conn_param_link_t *link = conn_param_find(param->bdHandle);
+
+    (void)event;
+
+    if((NULL != link) && (0u == param->status))
+    {
+        conn_param_account(link);
+        link->interval = param->connIntv;
+        link->latency = param->connLatency;
+
+        APP_LOG_INFO(CONN_INTERVAL, param->connIntv);
+        APP_LOG_INFO(CONN_LATENCY, param->connLatency);
+    }
+
+    if((NULL != link) && ((uint8_t)CONN_PARAM_NONE != link->requested))
+    {
+        conn_param_finish(link);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_response
+********************************************************************************
+* Summary:
+*  Handles the answer of the Central to an update request.
+*
+*******************************************************************************/
+static void conn_param_evt_response(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_l2cap_conn_update_rsp_param_t *rsp =
+        (cy_stc_ble_l2cap_conn_update_rsp_param_t *)eventParam;
+    conn_param_link_t *link = conn_param_find(rsp->bdHandle);
+
+    (void)event;
+
+    if((NULL == link) || ((uint8_t)CONN_PARAM_NONE == link->requested))
+    {
+        return;
+    }
+
+    /* Result 0 is accepted, 1 is rejected */
+    if(0u == rsp->result)
+    {
+        conn_param_stats.accepted++;
+    }
+    else
+    {
+        conn_param_stats.rejected++;
+        link->rejects++;
+        APP_LOG_INFO(CONN_PARAM_REJECTED, link->bd_handle);
+    }
+
+    conn_param_finish(link);
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_finish
+********************************************************************************
+* Summary:
+*  Ends the request in flight on a link, then sends the request that was
+*  queued behind it, if any.
+*
+*******************************************************************************/
+static void conn_param_finish(conn_param_link_t *link)
+{
+    conn_param_profile_t queued;
+
+    app_sched_cancel(&link->response_task);
+    link->requested = (uint8_t)CONN_PARAM_NONE;
+
+    queued = (conn_param_profile_t)link->queued;
+    link->queued = (uint8_t)CONN_PARAM_NONE;
+    if(CONN_PARAM_NONE != queued)
+    {
+        conn_param_request(link, queued);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_evt_ias_write
+********************************************************************************
+* Summary:
+*  Treats an alert write as activity: a follow-up write, such as the one that
+*  clears the alert, gets through on the short interval.
+*
+*******************************************************************************/
+static void conn_param_evt_ias_write(uint32_t event, void *eventParam)
+{
+    (void)event;
+
+    conn_param_kick(((cy_stc_ble_ias_char_value_t *)eventParam)->connHandle);
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_idle_task
+********************************************************************************
+* Summary:
+*  Requests the idle parameters once a link has been quiet for
+*  CONN_PARAM_IDLE_AFTER_MS.
+*
+*******************************************************************************/
+static bool conn_param_idle_task(void *arg)
+{
+    conn_param_link_t *link = (conn_param_link_t *)arg;
+
+    if(link->in_use && !link->held)
+    {
+        conn_param_request(link, CONN_PARAM_IDLE);
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_response_task
+********************************************************************************
+* Summary:
+*  Gives up on a request the Central has not answered within
+*  CONN_PARAM_RESPONSE_MS, so that later requests are not blocked.
+*
+*******************************************************************************/
+static bool conn_param_response_task(void *arg)
+{
+    conn_param_link_t *link = (conn_param_link_t *)arg;
+
+    if(link->in_use && ((uint8_t)CONN_PARAM_NONE != link->requested))
+    {
+        APP_LOG_INFO(CONN_PARAM_TIMEOUT, link->bd_handle);
+        conn_param_finish(link);
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_idle_after
+********************************************************************************
+* Summary:
+*  Restarts the idle timeout of a link. The request may wait for another
+*  wakeup for up to a quarter of the timeout.
+*
+*******************************************************************************/
+static void conn_param_idle_after(conn_param_link_t *link)
+{
+    uint32_t delay = APP_TIMER_MS_TO_TICKS(CONN_PARAM_IDLE_AFTER_MS);
+
+    app_sched_wake(&link->task, delay, APP_SCHED_SLACK(delay));
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_request
+********************************************************************************
+* Summary:
+*  Sends an L2CAP connection parameter update request, unless the link
+*  already runs on parameters of the profile or the Central has rejected
+*  too many requests. Only one request is in flight per link; a later one
+*  waits for the response.
+*
+*******************************************************************************/
+static void conn_param_request(conn_param_link_t *link, conn_param_profile_t profile)
+{
+    const conn_param_set_t *set = &conn_param_sets[profile];
+    cy_stc_ble_l2cap_conn_update_param_info_t param =
+    {
+        .connIntvMin        = set->intv_min,
+        .connIntvMax        = set->intv_max,
+        .connLatency        = set->latency,
+        .supervisionTimeout = set->timeout,
+        .bdHandle           = link->bd_handle
+    };
+
+    if(link->rejects >= CONN_PARAM_MAX_REJECTS)
+    {
+        return;
+    }
+
+    if((uint8_t)CONN_PARAM_NONE != link->requested)
+    {
+        link->queued = (uint8_t)profile;
+        return;
+    }
+
+    if(conn_param_satisfies(link, profile))
+    {
+        return;
+    }
+
+    if(CY_BLE_SUCCESS == Cy_BLE_L2CAP_LeConnectionParamUpdateRequest(&param))
+    {
+        link->requested = (uint8_t)profile;
+        conn_param_stats.requests++;
+        app_sched_wake(&link->response_task, APP_TIMER_MS_TO_TICKS(CONN_PARAM_RESPONSE_MS), 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_satisfies
+********************************************************************************
+* Summary:
+*  Returns true if the current parameters of a link belong to a profile.
+*
+*******************************************************************************/
+static bool conn_param_satisfies(const conn_param_link_t *link, conn_param_profile_t profile)
+{
+    const conn_param_set_t *set = &conn_param_sets[profile];
+
+    return (link->interval >= set->intv_min) && (link->interval <= set->intv_max) &&
+           (link->latency == set->latency);
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_account
+********************************************************************************
+* Summary:
+*  Adds the connection events of a link since its last parameter change: the
+*  events the radio listened to, (latency + 1) intervals apart, and the
+*  events at the interval the Central picked, without latency.
+*
+*******************************************************************************/
+static void conn_param_account(conn_param_link_t *link)
+{
+    uint32_t now = app_timer_now();
+    uint64_t elapsed_us = ((uint64_t)(now - link->since) * 1000000u) / APP_TIMER_TICKS_PER_SEC;
+
+    if((0u != link->interval) && (0u != link->central_interval))
+    {
+        conn_param_radio_events += elapsed_us /
+            ((uint64_t)link->interval * CONN_PARAM_INTV_US * ((uint32_t)link->latency + 1u));
+        conn_param_central_events += elapsed_us /
+            ((uint64_t)link->central_interval * CONN_PARAM_INTV_US);
+    }
+
+    link->since = now;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_param_find
+********************************************************************************
+* Summary:
+*  Returns the managed link with a BD handle, or NULL.
+*
+*******************************************************************************/
+static conn_param_link_t* conn_param_find(uint8_t bd_handle)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(conn_param_links[i].in_use && (conn_param_links[i].bd_handle == bd_handle))
+        {
+            return &conn_param_links[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,116 @@
+/******************************************************************************
+* File Name: conn_param.h
+*
+* Description: This file is the public interface of conn_param.c, the
+*              connection parameter manager.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CONN_PARAM_H
+#define CONN_PARAM_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cycfg_ble.h"
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Active parameters, requested after an alert write and while telemetry is
+ * streaming: 15-30 ms interval, no peripheral latency, 4 s supervision
+ * timeout. Intervals are in 1.25 ms units, timeouts in 10 ms units.
+ */
+#define CONN_PARAM_ACTIVE_INTV_MIN    (12u)
+#define CONN_PARAM_ACTIVE_INTV_MAX    (24u)
+#define CONN_PARAM_ACTIVE_LATENCY     (0u)
+#define CONN_PARAM_ACTIVE_TIMEOUT     (400u)
+
+/* Idle parameters: 100-125 ms interval and a peripheral latency of 7, so the
+ * radio listens about once a second. An alert write waits at most
+ * (latency + 1) x interval. The supervision timeout is more than three
+ * times that, as the Apple accessory guidelines require.
+ */
+#define CONN_PARAM_IDLE_INTV_MIN      (80u)
+#define CONN_PARAM_IDLE_INTV_MAX      (100u)
+#define CONN_PARAM_IDLE_LATENCY       (7u)
+#define CONN_PARAM_IDLE_TIMEOUT       (600u)
+
+/* Time without activity before the idle parameters are requested */
+#ifndef CONN_PARAM_IDLE_AFTER_MS
+#define CONN_PARAM_IDLE_AFTER_MS      (5000u)
+#endif
+
+/* Rejections after which a link keeps the parameters of the Central */
+#define CONN_PARAM_MAX_REJECTS        (2u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef struct
+{
+    uint32_t requests;        /* update requests sent */
+    uint32_t accepted;        /* requests accepted by the Central */
+    uint32_t rejected;        /* requests rejected by the Central */
+    uint32_t radio_events;    /* connection events the radio listened to */
+    uint32_t central_events;  /* events at the Central's initial parameters */
+    uint32_t alert_latency_ms;/* worst-case alert write delay, current links */
+} conn_param_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void conn_param_init(void);
+void conn_param_kick(cy_stc_ble_conn_handle_t handle);
+void conn_param_hold(cy_stc_ble_conn_handle_t handle, bool hold);
+uint16_t conn_param_interval(cy_stc_ble_conn_handle_t handle);
+void conn_param_get_stats(conn_param_stats_t *stats);
+
+
+#endif  /* CONN_PARAM_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,219 @@
+/******************************************************************************
+* File Name: conn_table.c
+*
+* Description: This file contains the table of active connections. Each link
+*              keeps its own Immediate Alert Service alert level; the level
+*              shown to the user is the highest one across all links.
+*
+*              The table is indexed by the ATT connection ID assigned by the
+*              BLE stack, which is always less than CY_BLE_CONN_COUNT.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "conn_table.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static conn_entry_t conn_table[CY_BLE_CONN_COUNT];
+
+
+/*******************************************************************************
+* Function Name: conn_table_init
+********************************************************************************
+* Summary:
+*  Marks all entries as free.
+*
+*******************************************************************************/
+void conn_table_init(void)
+{
+    (void)memset(conn_table, 0, sizeof(conn_table));
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_add
+********************************************************************************
+* Summary:
+*  Claims the entry of a new link. The alert level starts at no alert.
+*
+* Parameters:
+*  cy_stc_ble_conn_handle_t handle: connection handle of the link
+*
+* Return:
+*  conn_entry_t*: entry of the link, or NULL if the handle is out of range
+*
+*******************************************************************************/
+conn_entry_t* conn_table_add(cy_stc_ble_conn_handle_t handle)
+{
+    conn_entry_t *entry = NULL;
+
+    if(handle.attId < CY_BLE_CONN_COUNT)
+    {
+        entry = &conn_table[handle.attId];
+        entry->handle = handle;
+        entry->alert_level = CY_BLE_NO_ALERT;
+        entry->in_use = true;
+    }
+
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_remove
+********************************************************************************
+* Summary:
+*  Frees the entry of a link. The other links are not affected.
+*
+* Parameters:
+*  cy_stc_ble_conn_handle_t handle: connection handle of the link
+*
+*******************************************************************************/
+void conn_table_remove(cy_stc_ble_conn_handle_t handle)
+{
+    conn_entry_t *entry = conn_table_find(handle);
+
+    if(NULL != entry)
+    {
+        entry->in_use = false;
+        entry->alert_level = CY_BLE_NO_ALERT;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_find
+********************************************************************************
+* Summary:
+*  Returns the entry of a link.
+*
+* Parameters:
+*  cy_stc_ble_conn_handle_t handle: connection handle of the link
+*
+* Return:
+*  conn_entry_t*: entry of the link, or NULL if the link is not in the table
+*
+*******************************************************************************/
+conn_entry_t* conn_table_find(cy_stc_ble_conn_handle_t handle)
+{
+    conn_entry_t *entry = NULL;
+
+    if((handle.attId < CY_BLE_CONN_COUNT) &&
+       conn_table[handle.attId].in_use &&
+       (conn_table[handle.attId].handle.bdHandle == handle.bdHandle))
+    {
+        entry = &conn_table[handle.attId];
+    }
+
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_count
+********************************************************************************
+* Summary:
+*  Returns the number of links in the table.
+*
+*******************************************************************************/
+uint32_t conn_table_count(void)
+{
+    uint32_t count = 0u;
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(conn_table[i].in_use)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_max_alert
+********************************************************************************
+* Summary:
+*  Returns the highest alert level across all links.
+*
+*******************************************************************************/
+uint8_t conn_table_max_alert(void)
+{
+    uint8_t level = CY_BLE_NO_ALERT;
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(conn_table[i].in_use && (conn_table[i].alert_level > level))
+        {
+            level = conn_table[i].alert_level;
+        }
+    }
+
+    return level;
+}
+
+
+/*******************************************************************************
+* Function Name: conn_table_clear_alerts
+********************************************************************************
+* Summary:
+*  Sets the alert level of all links to no alert. A Locator raises the alert
+*  again with a new write.
+*
+*******************************************************************************/
+void conn_table_clear_alerts(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        conn_table[i].alert_level = CY_BLE_NO_ALERT;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,84 @@
+/******************************************************************************
+* File Name: conn_table.h
+*
+* Description: This file is the public interface of conn_table.c
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CONN_TABLE_H
+#define CONN_TABLE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cycfg_ble.h"
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* State of one link. Kept compact: the table has CY_BLE_CONN_COUNT entries. */
+typedef struct
+{
+    cy_stc_ble_conn_handle_t handle;
+    uint8_t                  alert_level;
+    bool                     in_use;
+} conn_entry_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void conn_table_init(void);
+conn_entry_t* conn_table_add(cy_stc_ble_conn_handle_t handle);
+void conn_table_remove(cy_stc_ble_conn_handle_t handle);
+conn_entry_t* conn_table_find(cy_stc_ble_conn_handle_t handle);
+uint32_t conn_table_count(void);
+uint8_t conn_table_max_alert(void);
+void conn_table_clear_alerts(void);
+
+
+#endif  /* CONN_TABLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name: console.c
+*
+* Description: This file contains the command console of the debug UART.
+*              Modules register tables of single-key commands; the main loop
+*              reads at most one key per pass and calls its handler.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "console.h"
+
+#if (CONSOLE_ENABLE != 0u)
+
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    const console_entry_t *table;
+    uint32_t               count;
+} console_table_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static console_table_t console_tables[CONSOLE_MAX_TABLES];
+static uint32_t console_table_count = 0u;
+
+
+/*******************************************************************************
+* Function Name: console_register
+********************************************************************************
+* Summary:
+*  Adds a command table. A key registered by two tables runs the handler of
+*  the first one.
+*
+* Parameters:
+*  const console_entry_t *table: command table, kept in const memory
+*  uint32_t count:               number of rows in the table
+*
+* Return:
+*  bool: false if CONSOLE_MAX_TABLES tables are already registered
+*
+*******************************************************************************/
+bool console_register(const console_entry_t *table, uint32_t count)
+{
+    if(console_table_count >= CONSOLE_MAX_TABLES)
+    {
+        return false;
+    }
+
+    console_tables[console_table_count].table = table;
+    console_tables[console_table_count].count = count;
+    console_table_count++;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: console_poll
+********************************************************************************
+* Summary:
+*  Handles a key received on the debug UART. Called from the main loop once
+*  the debug UART is initialized. The UART does not receive in deep sleep, so
+*  a key typed while the device sleeps may have to be repeated.
+*
+*******************************************************************************/
+void console_poll(void)
+{
+    uint8_t command;
+    size_t length = 1u;
+    uint32_t i;
+    uint32_t j;
+
+    if((0u == cyhal_uart_readable(&cy_retarget_io_uart_obj)) ||
+       (CY_RSLT_SUCCESS != cyhal_uart_read(&cy_retarget_io_uart_obj, &command, &length)) ||
+       (1u != length))
+    {
+        return;
+    }
+
+    for(i = 0u; i < console_table_count; i++)
+    {
+        for(j = 0u; j < console_tables[i].count; j++)
+        {
+            if(console_tables[i].table[j].command == command)
+            {
+                console_tables[i].table[j].handler(command);
+                return;
+            }
+        }
+    }
+}
+
+#endif  /* (CONSOLE_ENABLE != 0u) */
+
+
+/* [] END OF FILE */
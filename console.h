@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: console.h
+*
+* Description: This file is the public interface of console.c, the
+*              single-key commands of the debug UART.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Set to 0 to leave out the debug UART: neither retarget-io nor the banner
+ * is initialized and key commands are ignored. The log and the trace write
+ * to the debug UART, so they must be compiled out as well.
+ */
+#ifndef CONSOLE_ENABLE
+#define CONSOLE_ENABLE            (1u)
+#endif
+
+/* Number of command tables that modules can register */
+#ifndef CONSOLE_MAX_TABLES
+#define CONSOLE_MAX_TABLES        (4u)
+#endif
+
+/* Number of elements in a command table */
+#define CONSOLE_COUNT(table)      (sizeof(table) / sizeof((table)[0]))
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef void (*console_handler_t)(uint8_t command);
+
+/* One row of a module's command table: the key and its handler */
+typedef struct
+{
+    uint8_t           command;
+    console_handler_t handler;
+} console_entry_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+#if (CONSOLE_ENABLE != 0u)
+bool console_register(const console_entry_t *table, uint32_t count);
+void console_poll(void);
+#else
+#define console_register(table, count)    ((void)(table), (void)(count), false)
+#define console_poll()            ((void)0)
+#endif
+
+
+#endif  /* CONSOLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name: cycle_counter.h
+*
+* Description: This file provides access to the Cortex-M DWT cycle counter,
+*              used to measure the CPU cost of code paths in CPU cycles.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "cy_pdl.h"
+
+
+/*******************************************************************************
+* Function Name: cycle_counter_init
+********************************************************************************
+* Summary:
+*  Enables the DWT cycle counter. The counter runs at the CPU clock and stops
+*  while the CPU is in deep sleep. The count is not reset, so every user can
+*  call this function.
+*
+*******************************************************************************/
+static inline void cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+
+/*******************************************************************************
+* Function Name: cycle_counter_read
+********************************************************************************
+* Summary:
+*  Returns the current value of the free-running cycle counter. Differences
+*  between two readings are correct across a single counter wrap.
+*
+*******************************************************************************/
+static inline uint32_t cycle_counter_read(void)
+{
+    return DWT->CYCCNT;
+}
+
+
+#endif  /* CYCLE_COUNTER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,516 @@
+/******************************************************************************
+* File Name: findme_locator.c
+*
+* Description: This file contains the Find Me Locator role. The Locator scans
+*              continuously and keeps every advertising device in the scan
+*              table. Periodically it picks the strongest Find Me Target
+*              (a device that advertises the Immediate Alert Service) that
+*              has not been alerted yet, connects to it, writes the Alert
+*              Level Characteristic, disconnects and resumes scanning.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "findme_locator.h"
+
+#if (FINDME_LOCATOR != 0u)
+
+#include "scan_table.h"
+#include "app_log.h"
+#include "app_timer.h"
+#include "boot_profile.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Advertising data types that list 16-bit service UUIDs */
+#define AD_TYPE_UUID16_INCOMPLETE (0x02u)
+#define AD_TYPE_UUID16_COMPLETE   (0x03u)
+
+/* 16-bit UUID of the Immediate Alert Service */
+#define IAS_UUID16                (0x1802u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef enum
+{
+    LOCATOR_IDLE,             /* stack not started */
+    LOCATOR_SCANNING,         /* scanning, scan table is updated */
+    LOCATOR_CONNECTING,       /* scan stop or connection pending */
+    LOCATOR_CONNECTED         /* discovering the tag and writing the alert */
+} locator_state_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void locator_evt_stack_on(uint32_t event, void *eventParam);
+static void locator_evt_adv_report(uint32_t event, void *eventParam);
+static void locator_evt_scan_start_stop(uint32_t event, void *eventParam);
+static void locator_evt_gatt_connect(uint32_t event, void *eventParam);
+static void locator_evt_discovery_complete(uint32_t event, void *eventParam);
+static void locator_evt_disconnected(uint32_t event, void *eventParam);
+static void locator_timer_callback(void *arg);
+static void locator_disconnect_callback(void *arg);
+static void locator_disconnect(void);
+static void locator_start_scan(void);
+static void locator_mark_peer(uint8_t flags);
+static bool locator_has_ias(const uint8_t *data, uint32_t length);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const ble_dispatch_entry_t locator_event_table[] =
+{
+    { CY_BLE_EVT_STACK_ON,                  locator_evt_stack_on },
+    { CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT, locator_evt_adv_report },
+    { CY_BLE_EVT_GAPC_SCAN_START_STOP,      locator_evt_scan_start_stop },
+    { CY_BLE_EVT_GATT_CONNECT_IND,          locator_evt_gatt_connect },
+    { CY_BLE_EVT_GATTC_DISCOVERY_COMPLETE,  locator_evt_discovery_complete },
+    { CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,   locator_evt_disconnected },
+};
+
+static locator_state_t locator_state = LOCATOR_IDLE;
+static app_timer_t locator_timer;
+static app_timer_t locator_disconnect_timer;
+
+/* Tag being alerted */
+static cy_stc_ble_gap_bd_addr_t locator_peer;
+static cy_stc_ble_conn_handle_t locator_conn;
+
+
+/*******************************************************************************
+* Function Name: findme_locator_init
+********************************************************************************
+* Summary:
+*  Empties the scan table and registers the Central event handlers. Must be
+*  called after ble_dispatch_init().
+*
+*******************************************************************************/
+void findme_locator_init(void)
+{
+    scan_table_init();
+    locator_state = LOCATOR_IDLE;
+
+    if(!ble_dispatch_register(locator_event_table,
+                              BLE_DISPATCH_COUNT(locator_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_stack_on
+********************************************************************************
+* Summary:
+*  Starts scanning and the periodic tag selection once the stack is on.
+*
+*******************************************************************************/
+static void locator_evt_stack_on(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    app_timer_start(&locator_timer, APP_TIMER_MS_TO_TICKS(LOCATOR_SELECT_PERIOD_MS),
+                    APP_TIMER_MS_TO_TICKS(LOCATOR_SELECT_PERIOD_MS),
+                    locator_timer_callback, NULL);
+    locator_start_scan();
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_adv_report
+********************************************************************************
+* Summary:
+*  Records an advertising report in the scan table. The advertising data is
+*  only parsed the first time a device is seen; repeated reports of a known
+*  device update its entry and are not passed on.
+*
+*******************************************************************************/
+static void locator_evt_adv_report(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gapc_adv_report_param_t *report =
+        (cy_stc_ble_gapc_adv_report_param_t *)eventParam;
+    scan_entry_t *entry;
+    bool is_new;
+
+    (void)event;
+
+    entry = scan_table_update(report->peerBdAddr, report->peerAddrType,
+                              report->rssi, app_timer_now(), &is_new);
+
+    /* A scan response of a known device may carry the service list too */
+    if((is_new || (CY_BLE_GAPC_SCAN_RSP == report->eventType)) &&
+       (0u == (entry->flags & SCAN_TABLE_FLAG_TARGET)) &&
+       locator_has_ias(report->data, report->dataLen))
+    {
+        entry->flags |= SCAN_TABLE_FLAG_TARGET;
+        APP_LOG_INFO(LOCATOR_TAG_FOUND, (int32_t)report->rssi);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_scan_start_stop
+********************************************************************************
+* Summary:
+*  Connects to the selected tag once scanning has stopped. Scanning that
+*  stopped on its own (scan timeout) is restarted. The first scan ends the
+*  boot, so the console comes up as it does after the first advertisement
+*  of the Target.
+*
+*******************************************************************************/
+static void locator_evt_scan_start_stop(uint32_t event, void *eventParam)
+{
+    cy_en_ble_api_result_t result;
+
+    (void)event;
+    (void)eventParam;
+
+    if(CY_BLE_SCAN_STATE_SCANNING == Cy_BLE_GetScanState())
+    {
+        boot_profile_mark(BOOT_STAGE_READY);
+    }
+
+    if(CY_BLE_SCAN_STATE_STOPPED != Cy_BLE_GetScanState())
+    {
+        return;
+    }
+
+    if(LOCATOR_CONNECTING == locator_state)
+    {
+        result = Cy_BLE_GAPC_ConnectDevice(&locator_peer,
+                                           CY_BLE_CENTRAL_CONFIGURATION_0_INDEX);
+        if(CY_BLE_SUCCESS != result)
+        {
+            APP_LOG_ERROR(LOCATOR_CONN_FAILED, result);
+            locator_mark_peer(SCAN_TABLE_FLAG_ALERTED);
+            locator_start_scan();
+        }
+    }
+    else if(LOCATOR_SCANNING == locator_state)
+    {
+        locator_start_scan();
+    }
+    else
+    {
+        /* Connected; scanning resumes after the disconnection */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_gatt_connect
+********************************************************************************
+* Summary:
+*  Starts the discovery of the tag's services once the link is up.
+*
+*******************************************************************************/
+static void locator_evt_gatt_connect(uint32_t event, void *eventParam)
+{
+    (void)event;
+
+    if(LOCATOR_CONNECTING == locator_state)
+    {
+        locator_conn = *(cy_stc_ble_conn_handle_t *)eventParam;
+        locator_state = LOCATOR_CONNECTED;
+        (void)Cy_BLE_GATTC_StartDiscovery(locator_conn);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_discovery_complete
+********************************************************************************
+* Summary:
+*  Writes the alert level to the tag. The Alert Level Characteristic only
+*  takes a write without response, so there is no event when the write has
+*  gone out; the link is closed LOCATOR_WRITE_HOLD_MS later. A failed
+*  write closes the link at once.
+*
+*******************************************************************************/
+static void locator_evt_discovery_complete(uint32_t event, void *eventParam)
+{
+    uint8_t alert_level = LOCATOR_ALERT_LEVEL;
+    scan_entry_t *entry;
+    cy_en_ble_api_result_t result;
+
+    (void)event;
+    (void)eventParam;
+
+    if(LOCATOR_CONNECTED != locator_state)
+    {
+        return;
+    }
+
+    result = Cy_BLE_IASC_SetCharacteristicValue(locator_conn, CY_BLE_IAS_ALERT_LEVEL,
+                                                sizeof(alert_level), &alert_level);
+    if(CY_BLE_SUCCESS == result)
+    {
+        entry = scan_table_find(locator_peer.bdAddr, locator_peer.type);
+        APP_LOG_INFO(LOCATOR_ALERTED, (NULL != entry) ?
+                     (int32_t)SCAN_TABLE_RSSI_DBM(entry->rssi_q4) : 0);
+    }
+    else
+    {
+        APP_LOG_ERROR(LOCATOR_CONN_FAILED, result);
+    }
+
+    /* Do not select the same tag again while it stays in range */
+    locator_mark_peer(SCAN_TABLE_FLAG_ALERTED);
+
+    if(CY_BLE_SUCCESS == result)
+    {
+        app_timer_start(&locator_disconnect_timer,
+                        APP_TIMER_MS_TO_TICKS(LOCATOR_WRITE_HOLD_MS), 0u,
+                        locator_disconnect_callback, NULL);
+    }
+    else
+    {
+        locator_disconnect();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_evt_disconnected
+********************************************************************************
+* Summary:
+*  Resumes scanning after the link to the tag is closed, or after the
+*  connection could not be established.
+*
+*******************************************************************************/
+static void locator_evt_disconnected(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    app_timer_stop(&locator_disconnect_timer);
+
+    if((LOCATOR_CONNECTED == locator_state) || (LOCATOR_CONNECTING == locator_state))
+    {
+        locator_start_scan();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_timer_callback
+********************************************************************************
+* Summary:
+*  Runs every LOCATOR_SELECT_PERIOD_MS from the main loop. Removes the devices
+*  that are out of range, cancels a connection attempt that did not complete
+*  within one period, and selects the next tag to alert.
+*
+*******************************************************************************/
+static void locator_timer_callback(void *arg)
+{
+    scan_entry_t *entry;
+
+    (void)arg;
+
+    (void)scan_table_age(app_timer_now(), APP_TIMER_MS_TO_TICKS(LOCATOR_DEVICE_MAX_AGE_MS));
+    APP_LOG_INFO(SCAN_DEVICES, scan_table_count());
+
+    if((LOCATOR_CONNECTING == locator_state) &&
+       (CY_BLE_SCAN_STATE_STOPPED == Cy_BLE_GetScanState()))
+    {
+        /* The tag left before the connection was established */
+        (void)Cy_BLE_GAPC_CancelDeviceConnection();
+        locator_mark_peer(SCAN_TABLE_FLAG_ALERTED);
+        locator_start_scan();
+    }
+    else if(LOCATOR_SCANNING == locator_state)
+    {
+        entry = scan_table_strongest(SCAN_TABLE_FLAG_TARGET, SCAN_TABLE_FLAG_ALERTED);
+
+        if((NULL != entry) && (SCAN_TABLE_RSSI_DBM(entry->rssi_q4) >= LOCATOR_RSSI_MIN))
+        {
+            (void)memcpy(locator_peer.bdAddr, entry->addr, sizeof(locator_peer.bdAddr));
+            locator_peer.type = entry->addr_type;
+            locator_state = LOCATOR_CONNECTING;
+
+            /* The connection is started once scanning has stopped */
+            (void)Cy_BLE_GAPC_StopScan();
+        }
+    }
+    else
+    {
+        /* Busy with a tag */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_disconnect_callback
+********************************************************************************
+* Summary:
+*  Closes the link to the tag once the alert level write has had time to go
+*  out. Runs from the main loop.
+*
+*******************************************************************************/
+static void locator_disconnect_callback(void *arg)
+{
+    (void)arg;
+
+    if(LOCATOR_CONNECTED == locator_state)
+    {
+        locator_disconnect();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_disconnect
+********************************************************************************
+* Summary:
+*  Closes the link to the tag. Scanning resumes on the disconnection event.
+*
+*******************************************************************************/
+static void locator_disconnect(void)
+{
+    cy_stc_ble_gap_disconnect_info_t disconnect_info;
+
+    disconnect_info.bdHandle = locator_conn.bdHandle;
+    disconnect_info.reason = CY_BLE_HCI_ERROR_OTHER_END_TERMINATED_USER;
+    (void)Cy_BLE_GAP_Disconnect(&disconnect_info);
+}
+
+
+/*******************************************************************************
+* Function Name: locator_start_scan
+********************************************************************************
+* Summary:
+*  Starts scanning with the fast scan parameters of design.cybt.
+*
+*******************************************************************************/
+static void locator_start_scan(void)
+{
+    cy_en_ble_api_result_t result;
+
+    locator_state = LOCATOR_SCANNING;
+
+    if(CY_BLE_SCAN_STATE_STOPPED == Cy_BLE_GetScanState())
+    {
+        result = Cy_BLE_GAPC_StartScan(CY_BLE_SCANNING_FAST,
+                                       CY_BLE_CENTRAL_CONFIGURATION_0_INDEX);
+        if(CY_BLE_SUCCESS != result)
+        {
+            APP_LOG_ERROR(SCAN_START_FAILED, result);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_mark_peer
+********************************************************************************
+* Summary:
+*  Sets flags on the scan table entry of the selected tag, if it is still in
+*  the table.
+*
+*******************************************************************************/
+static void locator_mark_peer(uint8_t flags)
+{
+    scan_entry_t *entry = scan_table_find(locator_peer.bdAddr, locator_peer.type);
+
+    if(NULL != entry)
+    {
+        entry->flags |= flags;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: locator_has_ias
+********************************************************************************
+* Summary:
+*  Tells if advertising or scan response data lists the Immediate Alert
+*  Service among its 16-bit service UUIDs.
+*
+* Parameters:
+*  const uint8_t *data:  advertising data (length, type, value structures)
+*  uint32_t length:      length of the data
+*
+*******************************************************************************/
+static bool locator_has_ias(const uint8_t *data, uint32_t length)
+{
+    uint32_t pos = 0u;
+    uint32_t ad_length;
+    uint32_t i;
+
+    while((pos + 1u) < length)
+    {
+        ad_length = data[pos];
+        if((0u == ad_length) || ((pos + 1u + ad_length) > length))
+        {
+            break;
+        }
+
+        if((AD_TYPE_UUID16_INCOMPLETE == data[pos + 1u]) ||
+           (AD_TYPE_UUID16_COMPLETE == data[pos + 1u]))
+        {
+            for(i = pos + 2u; (i + 1u) < (pos + 1u + ad_length); i += 2u)
+            {
+                if(IAS_UUID16 == ((uint32_t)data[i] | ((uint32_t)data[i + 1u] << 8u)))
+                {
+                    return true;
+                }
+            }
+        }
+
+        pos += 1u + ad_length;
+    }
+
+    return false;
+}
+
+#endif  /* (FINDME_LOCATOR != 0u) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name: findme_locator.h
+*
+* Description: This file is the public interface of findme_locator.c, the
+*              Find Me Locator role (GAP Central, IAS client).
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef FINDME_LOCATOR_H
+#define FINDME_LOCATOR_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* 1 builds the Find Me Locator instead of the Find Me Target. Set through
+ * FINDME_ROLE in the Makefile.
+ */
+#ifndef FINDME_LOCATOR
+#define FINDME_LOCATOR            (0u)
+#endif
+
+/* Period of the tag selection and of the scan table aging */
+#ifndef LOCATOR_SELECT_PERIOD_MS
+#define LOCATOR_SELECT_PERIOD_MS  (2000u)
+#endif
+
+/* A device not heard from for this long is removed from the scan table */
+#ifndef LOCATOR_DEVICE_MAX_AGE_MS
+#define LOCATOR_DEVICE_MAX_AGE_MS (10000u)
+#endif
+
+/* Tags with a weaker smoothed RSSI (dBm) are not alerted */
+#ifndef LOCATOR_RSSI_MIN
+#define LOCATOR_RSSI_MIN          (-70)
+#endif
+
+/* Alert level written to the tag: 1 mild, 2 high */
+#ifndef LOCATOR_ALERT_LEVEL
+#define LOCATOR_ALERT_LEVEL       (1u)
+#endif
+
+/* Time the link is kept after the alert level is written. The write has no
+ * response; this covers several connection events at the longest interval
+ * of design.cybt (50 ms), so that the packet is sent, and resent if lost,
+ * before the link is closed.
+ */
+#ifndef LOCATOR_WRITE_HOLD_MS
+#define LOCATOR_WRITE_HOLD_MS     (200u)
+#endif
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+#if (FINDME_LOCATOR != 0u)
+void findme_locator_init(void);
+#else
+#define findme_locator_init()     ((void)0)
+#endif
+
+
+#endif  /* FINDME_LOCATOR_H */
+
+
+/* [] END OF FILE */
@@ -48,12 +48,38 @@
 #include "cybsp.h"
 #include "cyhal.h"
 #include "ble_findme.h"
+#include "app_log.h"
+#include "boot_state.h"
+#include "boot_profile.h"
+#include "app_sched.h"
+#include "console.h"
+#include "trace.h"
+
+
+/******************************************************************************
+* Function Prototypes
+******************************************************************************/
+#if (CONSOLE_ENABLE != 0u)
+static bool console_task(void *arg);
+static void console_init(void);
+#endif
+
+
+/******************************************************************************
+* Global Variables
+******************************************************************************/
+#if (CONSOLE_ENABLE != 0u)
+static app_sched_task_t console_task_desc;
+#endif
 
 
 int main(void)
 {
     cy_rslt_t result;
 
+    /* Time the boot from here to the first advertisement */
+    boot_profile_start();
+
     /* Initialize the device and board peripherals */
     result = cybsp_init();
 
@@ -62,15 +88,7 @@ int main(void)
     {
         CY_ASSERT(0);
     }
-
-    /* Initialize retarget-io to use the debug UART port */
-    result = cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
-                                 CY_RETARGET_IO_BAUDRATE);
-    /* retarget-io init failed. Stop program execution */
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
+    boot_profile_mark(BOOT_STAGE_BSP);
 
     /* Initialize the User LEDs */
     result = cyhal_gpio_init(CYBSP_USER_LED1, CYHAL_GPIO_DIR_OUTPUT,
@@ -87,19 +105,91 @@ int main(void)
     {
         CY_ASSERT(0);
     }
+    boot_profile_mark(BOOT_STAGE_GPIO);
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
-    printf("PSoC 6 MCU With BLE Connectivity Find Me\r\n\n");
+    /* Find out whether this is a cold boot or a wakeup from hibernate */
+    boot_state_init();
+    APP_LOG_INFO(BOOT_REASON, boot_state_reason());
 
     ble_findme_init();
 
-    for(;;)
+#if (CONSOLE_ENABLE != 0u)
+    app_sched_add(&console_task_desc, console_task, NULL, APP_SCHED_PRIO_CONSOLE, true);
+#endif
+
+    /* Run the tasks; the device sleeps whenever none is ready */
+    app_sched_run();
+}
+
+
+#if (CONSOLE_ENABLE != 0u)
+/******************************************************************************
+* Function Name: console_task
+*******************************************************************************
+* Summary:
+*  Brings up the debug console once advertising or scanning has started,
+*  then runs the console commands and continues a trace dump. The console is
+*  not needed to advertise; the log records written until then are kept in
+*  RAM.
+*
+******************************************************************************/
+static bool console_task(void *arg)
+{
+    static bool console_ready = false;
+
+    (void)arg;
+
+    if(!console_ready && boot_profile_is_done())
+    {
+        console_init();
+        console_ready = true;
+    }
+
+    if(console_ready)
     {
-        ble_findme_process();
+        console_poll();
+        trace_process();
     }
+
+    return false;
 }
 
 
-/* END OF FILE */
+/******************************************************************************
+* Function Name: console_init
+*******************************************************************************
+* Summary:
+*  Initializes the debug UART and starts the log output. The banner is only
+*  printed after a cold boot, not after a wakeup from hibernate, and only
+*  with the text log.
+*
+******************************************************************************/
+static void console_init(void)
+{
+    cy_rslt_t result;
+
+    /* Initialize retarget-io to use the debug UART port */
+    result = cy_retarget_io_init(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
+                                 CY_RETARGET_IO_BAUDRATE);
+    /* retarget-io init failed. Stop program execution */
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
 
+#if (APP_LOG_TEXT != 0u)
+    /* The banner is text; a binary log build does not link printf */
+    if(!boot_state_is_warm())
+    {
+        /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+        printf("\x1b[2J\x1b[;H");
+        printf("PSoC 6 MCU With BLE Connectivity Find Me\r\n\n");
+    }
+#endif
+
+    app_log_start();
+}
+#endif  /* (CONSOLE_ENABLE != 0u) */
+
+
+/* END OF FILE */
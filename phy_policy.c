@@ -0,0 +1,527 @@
+/******************************************************************************
+* File Name: phy_policy.c
+*
+* Description: This file contains the link layer PHY policy. Each new link is
+*              asked to move to the LE 2M PHY, which halves the time the
+*              radio is on for each packet. The controller only runs the PHY
+*              update procedure if the peer supports 2M; a peer without it
+*              refuses once and its link stays on 1M. The filtered RSSI of
+*              proximity.c moves a weak link back to 1M, whose receiver is
+*              more sensitive, and a link that recovers back to 2M. Only one
+*              request is in flight at a time, as the stack reports the
+*              command status without the link it belongs to.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "phy_policy.h"
+#include "proximity.h"
+#include "app_log.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* HCI status of a peer or controller without the requested PHY */
+#define PHY_POLICY_HCI_UNSUPPORTED_FEATURE    (0x11u)
+#define PHY_POLICY_HCI_UNSUPPORTED_REMOTE     (0x1Au)
+#define PHY_POLICY_HCI_UNSUPPORTED_LL_PARAM   (0x20u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* PHY state of one link */
+typedef struct
+{
+    app_timer_t timer;            /* retry delay */
+    uint32_t    since;            /* ticks at the last PHY change */
+    uint8_t     bd_handle;
+    uint8_t     phy;              /* PHY in use, CY_BLE_PHY_MASK_LE_xx */
+    uint8_t     wanted;           /* PHY the policy asks for */
+    uint8_t     retries;
+    bool        capable;          /* the peer has not refused 2M */
+    bool        in_flight;        /* update procedure running */
+    bool        in_use;
+} phy_policy_link_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void phy_policy_evt_connected(uint32_t event, void *eventParam);
+static void phy_policy_evt_disconnected(uint32_t event, void *eventParam);
+static void phy_policy_evt_set_phy(uint32_t event, void *eventParam);
+static void phy_policy_evt_phy_update(uint32_t event, void *eventParam);
+static void phy_policy_evt_rssi(uint32_t event, void *eventParam);
+static void phy_policy_timer_callback(void *arg);
+static void phy_policy_apply(void);
+static void phy_policy_failed(phy_policy_link_t *link, uint8_t status);
+static void phy_policy_account(phy_policy_link_t *link);
+static phy_policy_link_t* phy_policy_find(uint8_t bd_handle);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const ble_dispatch_entry_t phy_policy_event_table[] =
+{
+    { CY_BLE_EVT_GAP_DEVICE_CONNECTED,      phy_policy_evt_connected },
+    { CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE, phy_policy_evt_connected },
+    { CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,   phy_policy_evt_disconnected },
+    { CY_BLE_EVT_SET_PHY_COMPLETE,          phy_policy_evt_set_phy },
+    { CY_BLE_EVT_PHY_UPDATE_COMPLETE,       phy_policy_evt_phy_update },
+    { CY_BLE_EVT_GET_RSSI_COMPLETE,         phy_policy_evt_rssi },
+};
+
+static phy_policy_link_t phy_policy_links[CY_BLE_CONN_COUNT];
+
+/* Link whose Cy_BLE_SetPhy() waits for CY_BLE_EVT_SET_PHY_COMPLETE */
+static phy_policy_link_t *phy_policy_command = NULL;
+
+/* Link time on each PHY since boot, summed over all links */
+static uint64_t phy_policy_ticks_1m;
+static uint64_t phy_policy_ticks_2m;
+
+static phy_policy_stats_t phy_policy_stats;
+
+
+/*******************************************************************************
+* Function Name: phy_policy_init
+********************************************************************************
+* Summary:
+*  Registers the link event handlers. Must be called after proximity_init(),
+*  so that an RSSI sample is filtered before the policy reads it.
+*
+*******************************************************************************/
+void phy_policy_init(void)
+{
+    (void)memset(phy_policy_links, 0, sizeof(phy_policy_links));
+    (void)memset(&phy_policy_stats, 0, sizeof(phy_policy_stats));
+    phy_policy_command = NULL;
+    phy_policy_ticks_1m = 0u;
+    phy_policy_ticks_2m = 0u;
+
+    if(!ble_dispatch_register(phy_policy_event_table,
+                              BLE_DISPATCH_COUNT(phy_policy_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_get_stats
+********************************************************************************
+* Summary:
+*  Copies the request counters and the link time spent on each PHY. The
+*  radio-on time of a connection event on each PHY is given by
+*  tools/airtime_model.py.
+*
+* Parameters:
+*  phy_policy_stats_t *stats: destination
+*
+*******************************************************************************/
+void phy_policy_get_stats(phy_policy_stats_t *stats)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(phy_policy_links[i].in_use)
+        {
+            phy_policy_account(&phy_policy_links[i]);
+        }
+    }
+
+    phy_policy_stats.ms_1m = (uint32_t)((phy_policy_ticks_1m * 1000u) / APP_TIMER_TICKS_PER_SEC);
+    phy_policy_stats.ms_2m = (uint32_t)((phy_policy_ticks_2m * 1000u) / APP_TIMER_TICKS_PER_SEC);
+
+    *stats = phy_policy_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_evt_connected
+********************************************************************************
+* Summary:
+*  Starts a new link on 1M and asks for 2M. With link layer privacy the
+*  stack reports the enhanced event instead of the plain one.
+*
+*******************************************************************************/
+static void phy_policy_evt_connected(uint32_t event, void *eventParam)
+{
+    phy_policy_link_t *link = NULL;
+    uint8_t bd_handle;
+    uint8_t status;
+    uint32_t i;
+
+    if(CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE == event)
+    {
+        status = ((cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam)->status;
+        bd_handle = ((cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam)->bdHandle;
+    }
+    else
+    {
+        status = ((cy_stc_ble_gap_connected_param_t *)eventParam)->status;
+        bd_handle = ((cy_stc_ble_gap_connected_param_t *)eventParam)->bdHandle;
+    }
+
+    if(0u != status)
+    {
+        return;
+    }
+
+    for(i = 0u; (i < CY_BLE_CONN_COUNT) && (NULL == link); i++)
+    {
+        if(!phy_policy_links[i].in_use)
+        {
+            link = &phy_policy_links[i];
+        }
+    }
+
+    if(NULL == link)
+    {
+        return;
+    }
+
+    link->since = app_timer_now();
+    link->bd_handle = bd_handle;
+    link->phy = CY_BLE_PHY_MASK_LE_1M;
+    link->wanted = CY_BLE_PHY_MASK_LE_2M;
+    link->retries = 0u;
+    link->capable = true;
+    link->in_flight = false;
+    link->in_use = true;
+
+    phy_policy_apply();
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_evt_disconnected
+********************************************************************************
+* Summary:
+*  Closes the time accounting of a link and stops its retry timer. A
+*  command still waiting for its status is cleared when the status arrives.
+*
+*******************************************************************************/
+static void phy_policy_evt_disconnected(uint32_t event, void *eventParam)
+{
+    phy_policy_link_t *link =
+        phy_policy_find(((cy_stc_ble_gap_disconnect_param_t *)eventParam)->bdHandle);
+
+    (void)event;
+
+    if(NULL != link)
+    {
+        phy_policy_account(link);
+        app_timer_stop(&link->timer);
+        link->in_use = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_evt_set_phy
+********************************************************************************
+* Summary:
+*  Handles the command status of Cy_BLE_SetPhy(). On success the result
+*  follows with CY_BLE_EVT_PHY_UPDATE_COMPLETE; a failed command is retried
+*  or ends the requests of the link. Sends the next request, if any.
+*
+*******************************************************************************/
+static void phy_policy_evt_set_phy(uint32_t event, void *eventParam)
+{
+    uint8_t status = ((cy_stc_ble_events_param_generic_t *)eventParam)->status;
+    phy_policy_link_t *link = phy_policy_command;
+
+    (void)event;
+
+    phy_policy_command = NULL;
+
+    if((NULL != link) && link->in_use && (0u != status))
+    {
+        link->in_flight = false;
+        phy_policy_failed(link, status);
+    }
+
+    phy_policy_apply();
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_evt_phy_update
+********************************************************************************
+* Summary:
+*  Records the PHY applied by the controller. The peer may also start the
+*  procedure on its own, so the event is taken as the PHY of the link
+*  whether or not it answers a request.
+*
+*******************************************************************************/
+static void phy_policy_evt_phy_update(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_events_param_generic_t *generic = (cy_stc_ble_events_param_generic_t *)eventParam;
+    cy_stc_ble_phy_param_t *param = (cy_stc_ble_phy_param_t *)generic->eventParams;
+    phy_policy_link_t *link = phy_policy_find(param->bdHandle);
+
+    (void)event;
+
+    if(NULL == link)
+    {
+        return;
+    }
+
+    link->in_flight = false;
+
+    if(0u == generic->status)
+    {
+        phy_policy_account(link);
+        link->retries = 0u;
+
+        if(param->txPhyMask != link->phy)
+        {
+            link->phy = param->txPhyMask;
+            if(CY_BLE_PHY_MASK_LE_2M == link->phy)
+            {
+                phy_policy_stats.upgrades++;
+            }
+            APP_LOG_INFO(PHY_UPDATE, link->phy);
+        }
+    }
+    else
+    {
+        phy_policy_failed(link, generic->status);
+    }
+
+    phy_policy_apply();
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_evt_rssi
+********************************************************************************
+* Summary:
+*  Applies the PHY hysteresis to the filtered RSSI of a link.
+*
+*******************************************************************************/
+static void phy_policy_evt_rssi(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_rssi_info_t *info = (cy_stc_ble_rssi_info_t *)eventParam;
+    phy_policy_link_t *link = phy_policy_find(info->bdHandle);
+    int8_t rssi;
+
+    (void)event;
+
+    if((NULL == link) || !link->capable || !proximity_link_dbm(info->bdHandle, &rssi))
+    {
+        return;
+    }
+
+    if((CY_BLE_PHY_MASK_LE_2M == link->wanted) && (rssi < PHY_POLICY_FALLBACK_DBM))
+    {
+        link->wanted = CY_BLE_PHY_MASK_LE_1M;
+        phy_policy_stats.fallbacks++;
+        APP_LOG_INFO(PHY_FALLBACK, (int32_t)rssi);
+        phy_policy_apply();
+    }
+    else if((CY_BLE_PHY_MASK_LE_1M == link->wanted) && (rssi > PHY_POLICY_RESTORE_DBM))
+    {
+        link->wanted = CY_BLE_PHY_MASK_LE_2M;
+        phy_policy_apply();
+    }
+    else
+    {
+        /* No change of PHY */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_timer_callback
+********************************************************************************
+* Summary:
+*  End of the retry delay of a link.
+*
+*******************************************************************************/
+static void phy_policy_timer_callback(void *arg)
+{
+    (void)arg;
+
+    phy_policy_apply();
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_apply
+********************************************************************************
+* Summary:
+*  Sends a PHY update request for the first link whose PHY differs from the
+*  one the policy asks for. Does nothing while a command waits for its
+*  status.
+*
+*******************************************************************************/
+static void phy_policy_apply(void)
+{
+    cy_stc_ble_set_phy_info_t phy_info;
+    phy_policy_link_t *link;
+    uint32_t i;
+
+    if(NULL != phy_policy_command)
+    {
+        return;
+    }
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        link = &phy_policy_links[i];
+
+        if(!link->in_use || link->in_flight || (link->wanted == link->phy) ||
+           app_timer_is_active(&link->timer))
+        {
+            continue;
+        }
+
+        (void)memset(&phy_info, 0, sizeof(phy_info));
+        phy_info.bdHandle = link->bd_handle;
+        phy_info.allPhyMask = CY_BLE_PHY_NO_PREF_MASK_NONE;
+        phy_info.txPhyMask = link->wanted;
+        phy_info.rxPhyMask = link->wanted;
+
+        if(CY_BLE_SUCCESS == Cy_BLE_SetPhy(&phy_info))
+        {
+            phy_policy_command = link;
+            link->in_flight = true;
+            phy_policy_stats.requests++;
+            return;
+        }
+
+        /* The stack is busy; try again after the retry delay */
+        phy_policy_failed(link, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_failed
+********************************************************************************
+* Summary:
+*  Handles a request that did not change the PHY. A peer without 2M ends the
+*  upgrade requests of its link; other failures, such as a collision with
+*  another link layer procedure, are retried after PHY_POLICY_RETRY_MS.
+*
+* Parameters:
+*  phy_policy_link_t *link: link
+*  uint8_t status:          HCI status, or 0 if the stack refused the call
+*
+*******************************************************************************/
+static void phy_policy_failed(phy_policy_link_t *link, uint8_t status)
+{
+    bool unsupported = (PHY_POLICY_HCI_UNSUPPORTED_FEATURE == status) ||
+                       (PHY_POLICY_HCI_UNSUPPORTED_REMOTE == status) ||
+                       (PHY_POLICY_HCI_UNSUPPORTED_LL_PARAM == status);
+
+    if(unsupported || (++link->retries >= PHY_POLICY_MAX_RETRIES))
+    {
+        link->capable = false;
+        link->wanted = link->phy;
+        phy_policy_stats.refused++;
+        APP_LOG_INFO(PHY_REFUSED, status);
+    }
+    else
+    {
+        app_timer_start(&link->timer, APP_TIMER_MS_TO_TICKS(PHY_POLICY_RETRY_MS), 0u,
+                        phy_policy_timer_callback, link);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_account
+********************************************************************************
+* Summary:
+*  Adds the time since the last PHY change to the total of the PHY in use.
+*
+*******************************************************************************/
+static void phy_policy_account(phy_policy_link_t *link)
+{
+    uint32_t now = app_timer_now();
+
+    if(CY_BLE_PHY_MASK_LE_2M == link->phy)
+    {
+        phy_policy_ticks_2m += now - link->since;
+    }
+    else
+    {
+        phy_policy_ticks_1m += now - link->since;
+    }
+
+    link->since = now;
+}
+
+
+/*******************************************************************************
+* Function Name: phy_policy_find
+********************************************************************************
+* Summary:
+*  Returns the link with a BD handle, or NULL.
+*
+*******************************************************************************/
+static phy_policy_link_t* phy_policy_find(uint8_t bd_handle)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(phy_policy_links[i].in_use && (phy_policy_links[i].bd_handle == bd_handle))
+        {
+            return &phy_policy_links[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/* [] END OF FILE */
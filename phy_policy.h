@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: phy_policy.h
+*
+* Description: This file is the public interface of phy_policy.c, the link
+*              layer PHY policy that moves each link to the LE 2M PHY and
+*              back to 1M when the link weakens.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef PHY_POLICY_H
+#define PHY_POLICY_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Hysteresis thresholds on the filtered RSSI in dBm. The 2M receiver is
+ * about 3 dB less sensitive, so a link falls back to 1M below
+ * PHY_POLICY_FALLBACK_DBM, well before PROXIMITY_FAR_DBM, and returns to 2M
+ * above PHY_POLICY_RESTORE_DBM.
+ */
+#ifndef PHY_POLICY_FALLBACK_DBM
+#define PHY_POLICY_FALLBACK_DBM   (-80)
+#endif
+
+#ifndef PHY_POLICY_RESTORE_DBM
+#define PHY_POLICY_RESTORE_DBM    (-72)
+#endif
+
+/* Delay before a request that collided with another link layer procedure
+ * is sent again, and the number of attempts before a link stays on 1M
+ */
+#define PHY_POLICY_RETRY_MS       (1000u)
+#define PHY_POLICY_MAX_RETRIES    (3u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef struct
+{
+    uint32_t requests;        /* PHY update requests sent */
+    uint32_t upgrades;        /* updates that moved a link to 2M */
+    uint32_t fallbacks;       /* links moved back to 1M on a weak signal */
+    uint32_t refused;         /* links whose peer does not support 2M */
+    uint32_t ms_1m;           /* link time on the 1M PHY, all links */
+    uint32_t ms_2m;           /* link time on the 2M PHY, all links */
+} phy_policy_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void phy_policy_init(void);
+void phy_policy_get_stats(phy_policy_stats_t *stats);
+
+
+#endif  /* PHY_POLICY_H */
+
+
+/* [] END OF FILE */
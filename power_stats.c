@@ -0,0 +1,423 @@
+/******************************************************************************
+* File Name: power_stats.c
+*
+* Description: This file accumulates the time spent in each power state and
+*              the number of transitions, and estimates the charge consumed
+*              from a per-state current model. The results are served through
+*              the read-only Residency characteristic of the vendor Power
+*              Stats service, refreshed at connection and then periodically
+*              while a Central is connected.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "power_stats.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "conn_table.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const uint32_t power_model_na[POWER_STATE_COUNT] =
+{
+    POWER_MODEL_ACTIVE_NA,
+    POWER_MODEL_ACTIVE_NA,
+    POWER_MODEL_SLEEP_NA,
+    POWER_MODEL_DEEPSLEEP_NA,
+    POWER_MODEL_HIBERNATE_NA
+};
+
+static uint64_t residency_ticks[POWER_STATE_COUNT];
+static uint16_t transition_count[POWER_STATE_COUNT];
+
+/* Deep sleep entries since init, for their charge. The 16-bit transition
+ * counts of the report wrap within hours on a connected link.
+ */
+static uint32_t deepsleep_entries = 0u;
+static power_state_t current_state = POWER_STATE_ACTIVE;
+static uint32_t state_start = 0u;
+
+static app_sched_task_t power_stats_task;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void power_stats_read_handler(uint32_t event, void *eventParam);
+static void power_stats_evt_connect(uint32_t event, void *eventParam);
+static void power_stats_evt_disconnect(uint32_t event, void *eventParam);
+static bool power_stats_refresh_task(void *arg);
+static void power_stats_refresh(void);
+static uint8_t* power_stats_put_u32(uint8_t *dst, uint32_t value);
+static uint8_t* power_stats_put_u16(uint8_t *dst, uint16_t value);
+
+
+/*******************************************************************************
+* BLE event handler table
+********************************************************************************/
+static const ble_dispatch_entry_t power_stats_event_table[] =
+{
+    { CY_BLE_EVT_GATT_CONNECT_IND,               power_stats_evt_connect },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND,            power_stats_evt_disconnect },
+    { CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ, power_stats_read_handler },
+};
+
+
+/*******************************************************************************
+* Function Name: power_stats_init
+********************************************************************************
+* Summary:
+*  Clears the statistics and starts accounting in the active state. Must be
+*  called after app_timer_init(), app_sched_init() and ble_dispatch_init(),
+*  and after the connection table handlers are registered.
+*
+*******************************************************************************/
+void power_stats_init(void)
+{
+    (void)memset(residency_ticks, 0, sizeof(residency_ticks));
+    (void)memset(transition_count, 0, sizeof(transition_count));
+    deepsleep_entries = 0u;
+
+    current_state = POWER_STATE_ACTIVE;
+    state_start = app_timer_now();
+
+    app_sched_add(&power_stats_task, power_stats_refresh_task, NULL,
+                  APP_SCHED_PRIO_OUTPUT, false);
+
+    if(!ble_dispatch_register(power_stats_event_table,
+                              BLE_DISPATCH_COUNT(power_stats_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_enter
+********************************************************************************
+* Summary:
+*  Closes the residency interval of the current state and switches to a new
+*  one. Called right before entering and right after leaving a low power
+*  mode, and around the BLE event path.
+*
+* Parameters:
+*  power_state_t state: state being entered
+*
+*******************************************************************************/
+void power_stats_enter(power_state_t state)
+{
+    power_stats_enter_at(state, app_timer_now());
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_enter_at
+********************************************************************************
+* Summary:
+*  Like power_stats_enter(), for a switch that happened at an earlier time.
+*  Used for a mode that is only known to have been entered once it has been
+*  left, such as a deep sleep request the power mode callbacks may refuse.
+*
+* Parameters:
+*  power_state_t state: state entered
+*  uint32_t now:        wakeup timer ticks at the switch, not before the
+*                       previous switch
+*
+*******************************************************************************/
+void power_stats_enter_at(power_state_t state, uint32_t now)
+{
+
+    residency_ticks[current_state] += (uint32_t)(now - state_start);
+    state_start = now;
+
+    if(state != current_state)
+    {
+        transition_count[state]++;
+        current_state = state;
+
+        if(POWER_STATE_DEEPSLEEP == state)
+        {
+            deepsleep_entries++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_get
+********************************************************************************
+* Summary:
+*  Returns the residency per state and the charge estimate up to now.
+*
+* Parameters:
+*  power_stats_t *stats: destination
+*
+*******************************************************************************/
+void power_stats_get(power_stats_t *stats)
+{
+    uint64_t total_ticks = 0u;
+    uint64_t charge_nas = 0u;
+    uint32_t i;
+
+    /* Account the time spent in the current state so far */
+    power_stats_enter(current_state);
+
+    for(i = 0u; i < (uint32_t)POWER_STATE_COUNT; i++)
+    {
+        total_ticks += residency_ticks[i];
+        charge_nas += residency_ticks[i] * power_model_na[i];
+
+        stats->residency_ms[i] =
+            (uint32_t)((residency_ticks[i] * 1000u) / APP_TIMER_TICKS_PER_SEC);
+        stats->transitions[i] = transition_count[i];
+    }
+
+    charge_nas /= APP_TIMER_TICKS_PER_SEC;
+    charge_nas += (uint64_t)deepsleep_entries * POWER_MODEL_DEEPSLEEP_CHARGE_NC;
+
+    stats->uptime_ms = (uint32_t)((total_ticks * 1000u) / APP_TIMER_TICKS_PER_SEC);
+    stats->charge_nah = (uint32_t)(charge_nas / 3600u);
+
+    /* nAs over the elapsed seconds gives the mean current in nA; 24 h of that
+     * current in uAh is nA * 24 / 1000.
+     */
+    if(total_ticks >= APP_TIMER_TICKS_PER_SEC)
+    {
+        uint64_t mean_na = charge_nas / (total_ticks / APP_TIMER_TICKS_PER_SEC);
+
+        stats->uah_per_day = (uint32_t)((mean_na * 24u) / 1000u);
+    }
+    else
+    {
+        stats->uah_per_day = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_serialize
+********************************************************************************
+* Summary:
+*  Writes the statistics in the little-endian layout of the Residency
+*  characteristic: uptime (ms), residency per state (ms), transitions per
+*  state, charge (nAh) and the estimated consumption per day (uAh).
+*
+* Parameters:
+*  uint8_t *buffer: destination, POWER_STATS_REPORT_SIZE bytes
+*
+* Return:
+*  uint32_t: number of bytes written
+*
+*******************************************************************************/
+uint32_t power_stats_serialize(uint8_t *buffer)
+{
+    power_stats_t stats;
+    uint8_t *dst = buffer;
+    uint32_t i;
+
+    power_stats_get(&stats);
+
+    dst = power_stats_put_u32(dst, stats.uptime_ms);
+    for(i = 0u; i < (uint32_t)POWER_STATE_COUNT; i++)
+    {
+        dst = power_stats_put_u32(dst, stats.residency_ms[i]);
+    }
+    for(i = 0u; i < (uint32_t)POWER_STATE_COUNT; i++)
+    {
+        dst = power_stats_put_u16(dst, stats.transitions[i]);
+    }
+    dst = power_stats_put_u32(dst, stats.charge_nah);
+    dst = power_stats_put_u32(dst, stats.uah_per_day);
+
+    return (uint32_t)(dst - buffer);
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_read_handler
+********************************************************************************
+* Summary:
+*  Refreshes the Residency characteristic in the GATT database before the
+*  stack answers a read request for it. The stack only reports the read if
+*  the read access event is enabled for the characteristic; otherwise the
+*  periodic refresh keeps the value current.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void power_stats_read_handler(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatts_char_val_read_req_t *read_req =
+        (cy_stc_ble_gatts_char_val_read_req_t *)eventParam;
+
+    (void)event;
+
+    if(CY_BLE_POWER_STATS_RESIDENCY_CHAR_HANDLE == read_req->attrHandle)
+    {
+        power_stats_refresh();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_evt_connect
+********************************************************************************
+* Summary:
+*  Refreshes the Residency characteristic for the new Central and starts the
+*  periodic refresh.
+*
+*******************************************************************************/
+static void power_stats_evt_connect(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    (void)power_stats_refresh_task(NULL);
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_evt_disconnect
+********************************************************************************
+* Summary:
+*  Stops the periodic refresh once the last Central has left, so that it
+*  neither wakes the device nor holds off hibernate.
+*
+*******************************************************************************/
+static void power_stats_evt_disconnect(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    if(0u == conn_table_count())
+    {
+        app_sched_cancel(&power_stats_task);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_refresh_task
+********************************************************************************
+* Summary:
+*  Refreshes the Residency characteristic and schedules the next refresh
+*  POWER_STATS_REFRESH_MS later while a Central is connected. The slack lets
+*  the refresh ride on a connection event wakeup.
+*
+*******************************************************************************/
+static bool power_stats_refresh_task(void *arg)
+{
+    uint32_t period = APP_TIMER_MS_TO_TICKS(POWER_STATS_REFRESH_MS);
+
+    (void)arg;
+
+    if(0u != conn_table_count())
+    {
+        power_stats_refresh();
+        app_sched_wake(&power_stats_task, period, APP_SCHED_SLACK(period));
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_refresh
+********************************************************************************
+* Summary:
+*  Writes the current report to the Residency characteristic in the GATT
+*  database.
+*
+*******************************************************************************/
+static void power_stats_refresh(void)
+{
+    static uint8_t report[POWER_STATS_REPORT_SIZE];
+    cy_stc_ble_gatt_handle_value_pair_t handle_value;
+
+    handle_value.attrHandle = CY_BLE_POWER_STATS_RESIDENCY_CHAR_HANDLE;
+    handle_value.value.val = report;
+    handle_value.value.len = (uint16_t)power_stats_serialize(report);
+
+    (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handle_value);
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_put_u32
+********************************************************************************
+* Summary:
+*  Stores a 32-bit value in little-endian order.
+*
+*******************************************************************************/
+static uint8_t* power_stats_put_u32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value);
+    dst[1] = (uint8_t)(value >> 8u);
+    dst[2] = (uint8_t)(value >> 16u);
+    dst[3] = (uint8_t)(value >> 24u);
+
+    return &dst[4];
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_put_u16
+********************************************************************************
+* Summary:
+*  Stores a 16-bit value in little-endian order.
+*
+*******************************************************************************/
+static uint8_t* power_stats_put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)(value);
+    dst[1] = (uint8_t)(value >> 8u);
+
+    return &dst[2];
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name: power_stats.h
+*
+* Description: This file is the public interface of power_stats.c
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef POWER_STATS_H
+#define POWER_STATS_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Current model in nA per power state. The values are the MCU system current
+ * at 3.3 V; override them from the Makefile (DEFINES) with the figures
+ * measured on the actual board. Radio TX/RX current is not included.
+ */
+#ifndef POWER_MODEL_ACTIVE_NA
+#define POWER_MODEL_ACTIVE_NA     (2000000u)
+#endif
+#ifndef POWER_MODEL_SLEEP_NA
+#define POWER_MODEL_SLEEP_NA      (1000000u)
+#endif
+#ifndef POWER_MODEL_DEEPSLEEP_NA
+#define POWER_MODEL_DEEPSLEEP_NA  (7000u)
+#endif
+#ifndef POWER_MODEL_HIBERNATE_NA
+#define POWER_MODEL_HIBERNATE_NA  (300u)
+#endif
+
+/* Charge in nC of one deep sleep entry and exit: the system power mode
+ * callbacks, the regulator switch and the clock restore after the wakeup
+ */
+#ifndef POWER_MODEL_DEEPSLEEP_CHARGE_NC
+#define POWER_MODEL_DEEPSLEEP_CHARGE_NC (200u)
+#endif
+
+/* Period at which the Residency characteristic is refreshed in the GATT
+ * database while a Central is connected. The value a Central reads is at
+ * most this old; its uptime field tells when it was taken.
+ */
+#ifndef POWER_STATS_REFRESH_MS
+#define POWER_STATS_REFRESH_MS    (10000u)
+#endif
+
+/* Size of the report returned by power_stats_serialize() */
+#define POWER_STATS_REPORT_SIZE   (4u + (POWER_STATE_COUNT * 6u) + 8u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    POWER_STATE_ACTIVE,       /* CPU running application code */
+    POWER_STATE_BLE,          /* CPU running the BLE event path */
+    POWER_STATE_SLEEP,        /* CPU sleep */
+    POWER_STATE_DEEPSLEEP,    /* System deep sleep */
+    POWER_STATE_HIBERNATE,    /* System hibernate */
+    POWER_STATE_COUNT
+} power_state_t;
+
+typedef struct
+{
+    uint32_t uptime_ms;
+    uint32_t residency_ms[POWER_STATE_COUNT];
+    uint16_t transitions[POWER_STATE_COUNT];
+    uint32_t charge_nah;          /* Estimated charge since init */
+    uint32_t uah_per_day;         /* Charge extrapolated to 24 hours */
+} power_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void power_stats_init(void);
+void power_stats_enter(power_state_t state);
+void power_stats_enter_at(power_state_t state, uint32_t now);
+void power_stats_get(power_stats_t *stats);
+uint32_t power_stats_serialize(uint8_t *buffer);
+
+
+#endif  /* POWER_STATS_H */
+
+
+/* [] END OF FILE */
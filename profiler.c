@@ -0,0 +1,454 @@
+/******************************************************************************
+* File Name: profiler.c
+*
+* Description: This file contains the latency histograms of the hot paths.
+*              Each profiling scope adds its duration to a static histogram
+*              with four logarithmic buckets per power of two. The summaries
+*              (count, min, p50, p99, max) are printed on the debug UART when
+*              'p' is received, and can be read from the Histograms
+*              characteristic of the vendor Profiler service.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "profiler.h"
+
+#if (PROFILER_ENABLE != 0u)
+
+#include "app_sched.h"
+#include "sleep_policy.h"
+#include "ble_dispatch.h"
+#include "console.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <stdio.h>
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Console commands */
+#define PROFILER_CMD_PRINT        ('p')
+#define PROFILER_CMD_RESET        ('r')
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    uint32_t buckets[PROFILER_BUCKET_COUNT];
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+} profiler_histogram_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t profiler_bucket(uint32_t ticks);
+static uint32_t profiler_bucket_upper(uint32_t bucket);
+static uint32_t profiler_percentile(const profiler_histogram_t *histogram,
+                                    uint32_t percent);
+static void profiler_read_handler(uint32_t event, void *eventParam);
+static void profiler_console_handler(uint8_t command);
+static uint8_t* profiler_put_u32(uint8_t *dst, uint32_t value);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const ble_dispatch_entry_t profiler_event_table[] =
+{
+    { CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ, profiler_read_handler },
+};
+
+static const console_entry_t profiler_console_table[] =
+{
+    { PROFILER_CMD_PRINT, profiler_console_handler },
+    { PROFILER_CMD_RESET, profiler_console_handler },
+};
+
+/* Written from the main loop and, for BLESS_ISR, from the interrupt */
+static profiler_histogram_t profiler_histograms[PROFILER_SCOPE_COUNT];
+
+#define PROFILER_SCOPE_NAME(name)     #name,
+
+static const char * const profiler_names[PROFILER_SCOPE_COUNT] =
+{
+    PROFILER_SCOPES(PROFILER_SCOPE_NAME)
+};
+
+#undef PROFILER_SCOPE_NAME
+
+
+/*******************************************************************************
+* Function Name: profiler_init
+********************************************************************************
+* Summary:
+*  Clears the histograms, enables the cycle counter and registers the GATT
+*  read handler and the console commands. Must be called after
+*  ble_dispatch_init().
+*
+*******************************************************************************/
+void profiler_init(void)
+{
+#if defined(__arm__)
+    cycle_counter_init();
+#endif
+
+    profiler_reset();
+
+    if(!ble_dispatch_register(profiler_event_table,
+                              BLE_DISPATCH_COUNT(profiler_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+    (void)console_register(profiler_console_table, CONSOLE_COUNT(profiler_console_table));
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_record
+********************************************************************************
+* Summary:
+*  Adds one duration to the histogram of a scope. Called by PROFILER_END.
+*
+* Parameters:
+*  profiler_scope_t scope: profiled scope
+*  uint32_t ticks:         duration in CPU cycles
+*
+*******************************************************************************/
+void profiler_record(profiler_scope_t scope, uint32_t ticks)
+{
+    profiler_histogram_t *histogram = &profiler_histograms[scope];
+
+    histogram->buckets[profiler_bucket(ticks)]++;
+
+    if((0u == histogram->count) || (ticks < histogram->min))
+    {
+        histogram->min = ticks;
+    }
+    if(ticks > histogram->max)
+    {
+        histogram->max = ticks;
+    }
+    histogram->count++;
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_summarize
+********************************************************************************
+* Summary:
+*  Computes the summary of a scope. The histogram is copied with interrupts
+*  disabled, so a sample recorded by an interrupt does not tear it.
+*
+* Parameters:
+*  profiler_scope_t scope:       profiled scope
+*  profiler_summary_t *summary:  destination
+*
+*******************************************************************************/
+void profiler_summarize(profiler_scope_t scope, profiler_summary_t *summary)
+{
+    static profiler_histogram_t snapshot;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    snapshot = profiler_histograms[scope];
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    summary->count = snapshot.count;
+    summary->min = snapshot.min;
+    summary->max = snapshot.max;
+    summary->p50 = profiler_percentile(&snapshot, 50u);
+    summary->p99 = profiler_percentile(&snapshot, 99u);
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_serialize
+********************************************************************************
+* Summary:
+*  Writes the summaries of all scopes, in scope order, as little-endian
+*  uint32 values: count, min, p50, p99 and max.
+*
+* Parameters:
+*  uint8_t *report: destination, PROFILER_REPORT_SIZE bytes
+*
+* Return:
+*  uint32_t: number of bytes written
+*
+*******************************************************************************/
+uint32_t profiler_serialize(uint8_t *report)
+{
+    profiler_summary_t summary;
+    uint8_t *dst = report;
+    uint32_t scope;
+
+    for(scope = 0u; scope < (uint32_t)PROFILER_SCOPE_COUNT; scope++)
+    {
+        profiler_summarize((profiler_scope_t)scope, &summary);
+        dst = profiler_put_u32(dst, summary.count);
+        dst = profiler_put_u32(dst, summary.min);
+        dst = profiler_put_u32(dst, summary.p50);
+        dst = profiler_put_u32(dst, summary.p99);
+        dst = profiler_put_u32(dst, summary.max);
+    }
+
+    return (uint32_t)(dst - report);
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_reset
+********************************************************************************
+* Summary:
+*  Clears the histograms of all scopes.
+*
+*******************************************************************************/
+void profiler_reset(void)
+{
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    (void)memset(profiler_histograms, 0, sizeof(profiler_histograms));
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_console_handler
+********************************************************************************
+* Summary:
+*  Handles the console commands: 'p' prints the summaries, the scheduler
+*  overhead per dispatch and the sleep mode choices with the charge
+*  estimate, 'r' clears the histograms.
+*
+*******************************************************************************/
+static void profiler_console_handler(uint8_t command)
+{
+    profiler_summary_t summary;
+    app_sched_stats_t sched;
+    sleep_policy_stats_t sleep;
+    power_stats_t power;
+    uint32_t picks;
+    uint32_t scope;
+
+    if(PROFILER_CMD_PRINT == command)
+    {
+        printf("Profile (CPU cycles at %lu Hz):\r\n", (unsigned long)SystemCoreClock);
+        for(scope = 0u; scope < (uint32_t)PROFILER_SCOPE_COUNT; scope++)
+        {
+            profiler_summarize((profiler_scope_t)scope, &summary);
+            printf("%-16s n=%lu min=%lu p50=%lu p99=%lu max=%lu\r\n",
+                   profiler_names[scope], (unsigned long)summary.count,
+                   (unsigned long)summary.min, (unsigned long)summary.p50,
+                   (unsigned long)summary.p99, (unsigned long)summary.max);
+        }
+
+        /* Every task dispatch and every idle call costs one pick */
+        app_sched_get_stats(&sched);
+        picks = sched.dispatches + sched.idles;
+        printf("%-16s n=%lu idle=%lu avg=%lu max=%lu\r\n", "SCHEDULER",
+               (unsigned long)sched.dispatches, (unsigned long)sched.idles,
+               (unsigned long)((0u == picks) ? 0u : (sched.cycles_total / picks)),
+               (unsigned long)sched.cycles_max);
+
+        sleep_policy_get_stats(&sleep);
+        power_stats_get(&power);
+        printf("%-16s deep=%lu sleep=%lu timer=%lu ble=%lu uAh/day=%lu\r\n", "SLEEP",
+               (unsigned long)sleep.deepsleeps, (unsigned long)sleep.sleeps,
+               (unsigned long)sleep.timer_near, (unsigned long)sleep.ble_busy,
+               (unsigned long)power.uah_per_day);
+    }
+    else
+    {
+        profiler_reset();
+        printf("Profile cleared\r\n");
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_bucket
+********************************************************************************
+* Summary:
+*  Returns the histogram bucket of a duration. Values below 4 have their own
+*  bucket; larger values are split by their most significant bit and the two
+*  bits below it.
+*
+*******************************************************************************/
+static uint32_t profiler_bucket(uint32_t ticks)
+{
+    uint32_t msb;
+
+    if(ticks < 4u)
+    {
+        return ticks;
+    }
+
+#if defined(__arm__)
+    msb = 31u - (uint32_t)__CLZ(ticks);
+#else
+    msb = 31u - (uint32_t)__builtin_clz(ticks);
+#endif
+
+    return ((msb - 1u) << 2u) + ((ticks >> (msb - 2u)) & 3u);
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_bucket_upper
+********************************************************************************
+* Summary:
+*  Returns the largest duration that falls in a bucket.
+*
+*******************************************************************************/
+static uint32_t profiler_bucket_upper(uint32_t bucket)
+{
+    uint32_t msb;
+    uint32_t lower;
+
+    if(bucket < 4u)
+    {
+        return bucket;
+    }
+
+    msb = (bucket >> 2u) + 1u;
+    lower = (4u + (bucket & 3u)) << (msb - 2u);
+
+    return lower + ((1u << (msb - 2u)) - 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_percentile
+********************************************************************************
+* Summary:
+*  Returns the upper bound of the bucket that holds a percentile, capped to
+*  the largest recorded value. The result is at most 25% above the exact
+*  percentile.
+*
+* Parameters:
+*  const profiler_histogram_t *histogram: histogram
+*  uint32_t percent:                      percentile, 1 to 100
+*
+*******************************************************************************/
+static uint32_t profiler_percentile(const profiler_histogram_t *histogram,
+                                    uint32_t percent)
+{
+    uint64_t rank = (((uint64_t)histogram->count * percent) + 99u) / 100u;
+    uint64_t seen = 0u;
+    uint32_t bucket;
+    uint32_t upper;
+
+    if(0u == histogram->count)
+    {
+        return 0u;
+    }
+
+    for(bucket = 0u; bucket < PROFILER_BUCKET_COUNT; bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if(seen >= rank)
+        {
+            break;
+        }
+    }
+
+    upper = profiler_bucket_upper(bucket);
+
+    return (upper < histogram->max) ? upper : histogram->max;
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_read_handler
+********************************************************************************
+* Summary:
+*  Refreshes the Histograms characteristic in the GATT database before the
+*  stack answers a read request for it.
+*
+* Parameters:
+*  uint32_t event:    event from the BLE component
+*  void* eventParam:  parameters related to the event
+*
+*******************************************************************************/
+static void profiler_read_handler(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatts_char_val_read_req_t *read_req =
+        (cy_stc_ble_gatts_char_val_read_req_t *)eventParam;
+    static uint8_t report[PROFILER_REPORT_SIZE];
+    cy_stc_ble_gatt_handle_value_pair_t handle_value;
+
+    (void)event;
+
+    if(CY_BLE_PROFILER_HISTOGRAMS_CHAR_HANDLE == read_req->attrHandle)
+    {
+        handle_value.attrHandle = CY_BLE_PROFILER_HISTOGRAMS_CHAR_HANDLE;
+        handle_value.value.val = report;
+        handle_value.value.len = (uint16_t)profiler_serialize(report);
+
+        (void)Cy_BLE_GATTS_WriteAttributeValueLocal(&handle_value);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: profiler_put_u32
+********************************************************************************
+* Summary:
+*  Stores a 32-bit value in little-endian order.
+*
+*******************************************************************************/
+static uint8_t* profiler_put_u32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value);
+    dst[1] = (uint8_t)(value >> 8u);
+    dst[2] = (uint8_t)(value >> 16u);
+    dst[3] = (uint8_t)(value >> 24u);
+
+    return &dst[4];
+}
+
+#endif  /* (PROFILER_ENABLE != 0u) */
+
+
+/* [] END OF FILE */
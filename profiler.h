@@ -0,0 +1,171 @@
+/******************************************************************************
+* File Name: profiler.h
+*
+* Description: This file is the public interface of profiler.c, the latency
+*              histograms of the hot paths.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Debug builds profile; Release builds compile every scope out */
+#ifndef PROFILER_ENABLE
+#if defined(NDEBUG)
+#define PROFILER_ENABLE           (0u)
+#else
+#define PROFILER_ENABLE           (1u)
+#endif
+#endif
+
+/* Profiled scopes: Cy_BLE_ProcessEvents(), one BLE event through
+ * ble_dispatch_event(), the BLESS interrupt handler, the deep sleep entry
+ * and exit (the DWT counter stops while the CPU sleeps), and the delay from
+ * the BLESS interrupt that delivered an Alert Level write to the change of
+ * the alert outputs. Append new scopes at the end to keep the layout of the
+ * GATT report stable.
+ */
+#define PROFILER_SCOPES(X)                                                    \
+    X(PROCESS_EVENTS)                                                         \
+    X(BLE_DISPATCH)                                                           \
+    X(BLESS_ISR)                                                              \
+    X(DEEPSLEEP)                                                              \
+    X(ALERT_LATENCY)
+
+/* Four buckets per power of two: values below 4 have a bucket of their own,
+ * larger values fall in 124 buckets up to 2^32
+ */
+#define PROFILER_BUCKET_COUNT     (124u)
+
+/* Size of one scope in the report returned by profiler_serialize(): count,
+ * min, p50, p99 and max as little-endian uint32
+ */
+#define PROFILER_SUMMARY_SIZE     (20u)
+#define PROFILER_REPORT_SIZE      (PROFILER_SCOPE_COUNT * PROFILER_SUMMARY_SIZE)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+#define PROFILER_SCOPE_ENUM(name)     PROFILER_SCOPE_##name,
+
+typedef enum
+{
+    PROFILER_SCOPES(PROFILER_SCOPE_ENUM)
+    PROFILER_SCOPE_COUNT
+} profiler_scope_t;
+
+#undef PROFILER_SCOPE_ENUM
+
+/* Latencies in CPU cycles on the target, in ns on a host build. The
+ * percentiles are the upper bound of the bucket they fall in.
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+} profiler_summary_t;
+
+
+/******************************************************************************
+ * Profiling scopes
+ *****************************************************************************/
+#if (PROFILER_ENABLE != 0u)
+
+#if defined(__arm__)
+#include "cycle_counter.h"
+#define profiler_now()            cycle_counter_read()
+#else
+#include <time.h>
+
+/* Host builds time the scopes with the monotonic clock, in ns */
+static inline uint32_t profiler_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec);
+}
+#endif
+
+/* A scope starts with PROFILER_BEGIN and ends with PROFILER_END of the same
+ * name in the same block. Neither allocates; the end adds one sample to the
+ * histogram of the scope.
+ */
+#define PROFILER_BEGIN(scope)                                                 \
+    uint32_t profiler_start_##scope = profiler_now()
+#define PROFILER_END(scope)                                                   \
+    profiler_record(PROFILER_SCOPE_##scope, profiler_now() - profiler_start_##scope)
+
+void profiler_init(void);
+void profiler_record(profiler_scope_t scope, uint32_t ticks);
+void profiler_summarize(profiler_scope_t scope, profiler_summary_t *summary);
+uint32_t profiler_serialize(uint8_t *report);
+void profiler_reset(void);
+
+#else
+
+#define PROFILER_BEGIN(scope)     ((void)0)
+#define PROFILER_END(scope)       ((void)0)
+#define profiler_init()           ((void)0)
+#define profiler_record(scope, ticks)     ((void)(ticks))
+#define profiler_reset()          ((void)0)
+
+#endif  /* (PROFILER_ENABLE != 0u) */
+
+
+#endif  /* PROFILER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,419 @@
+/******************************************************************************
+* File Name: proximity.c
+*
+* Description: This file contains the connection RSSI monitor. The RSSI of
+*              each link is sampled periodically and smoothed by
+*              rssi_filter.c. A link whose filtered RSSI falls below a
+*              threshold is reported out of range, so that the device raises
+*              a local alert before the link is lost. The sampling period
+*              grows while the RSSI is stable, so a steady link adds few
+*              wakeups.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "proximity.h"
+#include "rssi_filter.h"
+#include "app_log.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "cycle_counter.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* RSSI state of one link, indexed like the connection table */
+typedef struct
+{
+    app_sched_task_t task;
+    rssi_filter_t    filter;
+    uint32_t         period_ms;
+    uint8_t          bd_handle;
+    uint8_t          stable;
+    bool             in_use;
+    bool             far;
+} proximity_link_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void proximity_evt_connect(uint32_t event, void *eventParam);
+static void proximity_evt_disconnect(uint32_t event, void *eventParam);
+static void proximity_evt_rssi(uint32_t event, void *eventParam);
+static bool proximity_sample_task(void *arg);
+static void proximity_schedule(proximity_link_t *link);
+static void proximity_adapt_period(proximity_link_t *link, int32_t innovation);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const ble_dispatch_entry_t proximity_event_table[] =
+{
+    { CY_BLE_EVT_GATT_CONNECT_IND,    proximity_evt_connect },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND, proximity_evt_disconnect },
+    { CY_BLE_EVT_GET_RSSI_COMPLETE,   proximity_evt_rssi },
+};
+
+static proximity_link_t proximity_links[CY_BLE_CONN_COUNT];
+static proximity_callback_t proximity_changed;
+static proximity_stats_t proximity_stats;
+
+
+/*******************************************************************************
+* Function Name: proximity_init
+********************************************************************************
+* Summary:
+*  Registers the link event handlers and adds the sampling task of each
+*  link to the scheduler. Must be called after ble_dispatch_init() and
+*  app_sched_init(), and before the handlers of ble_findme.c are registered,
+*  so that the range state of a closed link is cleared before the LEDs are
+*  updated.
+*
+* Parameters:
+*  proximity_callback_t changed: called when a link changes range
+*
+*******************************************************************************/
+void proximity_init(proximity_callback_t changed)
+{
+    uint32_t i;
+
+    (void)memset(proximity_links, 0, sizeof(proximity_links));
+    (void)memset(&proximity_stats, 0, sizeof(proximity_stats));
+    proximity_changed = changed;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        app_sched_add(&proximity_links[i].task, proximity_sample_task, &proximity_links[i],
+                      APP_SCHED_PRIO_LINK, false);
+    }
+
+    cycle_counter_init();
+
+    if(!ble_dispatch_register(proximity_event_table,
+                              BLE_DISPATCH_COUNT(proximity_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_alert_level
+********************************************************************************
+* Summary:
+*  Returns the local alert level: PROXIMITY_ALERT_LEVEL while any link is out
+*  of range, else no alert.
+*
+*******************************************************************************/
+uint8_t proximity_alert_level(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(proximity_links[i].in_use && proximity_links[i].far)
+        {
+            return PROXIMITY_ALERT_LEVEL;
+        }
+    }
+
+    return CY_BLE_NO_ALERT;
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_link_dbm
+********************************************************************************
+* Summary:
+*  Returns the filtered RSSI of a link. Handlers registered after
+*  proximity_init() see the estimate that includes the sample of the current
+*  CY_BLE_EVT_GET_RSSI_COMPLETE event.
+*
+* Parameters:
+*  uint8_t bd_handle:  BD handle of the link
+*  int8_t *dbm:        destination
+*
+* Return:
+*  bool: false if the link is not sampled or has no sample yet
+*
+*******************************************************************************/
+bool proximity_link_dbm(uint8_t bd_handle, int8_t *dbm)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(proximity_links[i].in_use && (proximity_links[i].bd_handle == bd_handle) &&
+           proximity_links[i].filter.primed)
+        {
+            *dbm = rssi_filter_dbm(&proximity_links[i].filter);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_get_stats
+********************************************************************************
+* Summary:
+*  Copies the number of samples and the CPU cycles spent in the filter.
+*
+* Parameters:
+*  proximity_stats_t *stats: destination
+*
+*******************************************************************************/
+void proximity_get_stats(proximity_stats_t *stats)
+{
+    *stats = proximity_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_evt_connect
+********************************************************************************
+* Summary:
+*  Starts sampling the RSSI of a new link at the shortest period.
+*
+*******************************************************************************/
+static void proximity_evt_connect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+    proximity_link_t *link;
+
+    (void)event;
+
+    if(handle->attId < CY_BLE_CONN_COUNT)
+    {
+        link = &proximity_links[handle->attId];
+        link->bd_handle = handle->bdHandle;
+        link->period_ms = PROXIMITY_SAMPLE_MIN_MS;
+        link->stable = 0u;
+        link->far = false;
+        link->in_use = true;
+        rssi_filter_init(&link->filter);
+
+        proximity_schedule(link);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_evt_disconnect
+********************************************************************************
+* Summary:
+*  Stops sampling a closed link. Its range state no longer counts.
+*
+*******************************************************************************/
+static void proximity_evt_disconnect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+
+    (void)event;
+
+    if(handle->attId < CY_BLE_CONN_COUNT)
+    {
+        app_sched_cancel(&proximity_links[handle->attId].task);
+        proximity_links[handle->attId].in_use = false;
+        proximity_links[handle->attId].far = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_evt_rssi
+********************************************************************************
+* Summary:
+*  Filters a new RSSI sample, applies the range hysteresis and schedules the
+*  next sample.
+*
+*******************************************************************************/
+static void proximity_evt_rssi(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_rssi_info_t *info = (cy_stc_ble_rssi_info_t *)eventParam;
+    proximity_link_t *link = NULL;
+    int32_t innovation;
+    int8_t rssi;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t i;
+
+    (void)event;
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        if(proximity_links[i].in_use && (proximity_links[i].bd_handle == info->bdHandle))
+        {
+            link = &proximity_links[i];
+        }
+    }
+
+    if(NULL == link)
+    {
+        return;
+    }
+
+    if(0u == info->status)
+    {
+        start = cycle_counter_read();
+        innovation = rssi_filter_update(&link->filter, info->rssi);
+        cycles = cycle_counter_read() - start;
+
+        proximity_stats.samples++;
+        proximity_stats.cycles_total += cycles;
+        if(cycles > proximity_stats.cycles_max)
+        {
+            proximity_stats.cycles_max = cycles;
+        }
+
+        proximity_adapt_period(link, innovation);
+
+        rssi = rssi_filter_dbm(&link->filter);
+        if(!link->far && (rssi < PROXIMITY_FAR_DBM))
+        {
+            link->far = true;
+            APP_LOG_INFO(PROXIMITY_FAR, (int32_t)rssi);
+            proximity_changed();
+        }
+        else if(link->far && (rssi > PROXIMITY_NEAR_DBM))
+        {
+            link->far = false;
+            APP_LOG_INFO(PROXIMITY_NEAR, (int32_t)rssi);
+            proximity_changed();
+        }
+        else
+        {
+            /* No change of range */
+        }
+    }
+
+    proximity_schedule(link);
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_sample_task
+********************************************************************************
+* Summary:
+*  Requests the RSSI of a link. The sample arrives with
+*  CY_BLE_EVT_GET_RSSI_COMPLETE.
+*
+*******************************************************************************/
+static bool proximity_sample_task(void *arg)
+{
+    proximity_link_t *link = (proximity_link_t *)arg;
+
+    if(link->in_use && (CY_BLE_SUCCESS != Cy_BLE_GetRssiPeer(link->bd_handle)))
+    {
+        proximity_schedule(link);
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_schedule
+********************************************************************************
+* Summary:
+*  Schedules the next sample of a link. The sample may wait for another
+*  wakeup for up to a quarter of the period, so the links and the other
+*  periodic work share wakeups. The task is only woken again once the
+*  previous request has completed, so requests never overlap.
+*
+*******************************************************************************/
+static void proximity_schedule(proximity_link_t *link)
+{
+    uint32_t period = APP_TIMER_MS_TO_TICKS(link->period_ms);
+
+    app_sched_wake(&link->task, period, APP_SCHED_SLACK(period));
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_adapt_period
+********************************************************************************
+* Summary:
+*  Doubles the sampling period after a run of stable samples, and returns to
+*  the shortest period when the RSSI moves.
+*
+* Parameters:
+*  proximity_link_t *link: link
+*  int32_t innovation:     sample minus the previous estimate, 1/256 dBm
+*
+*******************************************************************************/
+static void proximity_adapt_period(proximity_link_t *link, int32_t innovation)
+{
+    uint32_t period = link->period_ms;
+
+    if((innovation > (PROXIMITY_STABLE_DB * RSSI_FILTER_ONE)) ||
+       (innovation < -(PROXIMITY_STABLE_DB * RSSI_FILTER_ONE)))
+    {
+        link->stable = 0u;
+        period = PROXIMITY_SAMPLE_MIN_MS;
+    }
+    else if(++link->stable >= PROXIMITY_STABLE_COUNT)
+    {
+        link->stable = 0u;
+        period = ((2u * period) < PROXIMITY_SAMPLE_MAX_MS) ? (2u * period) :
+                                                               PROXIMITY_SAMPLE_MAX_MS;
+    }
+    else
+    {
+        /* Keep the period until the run is long enough */
+    }
+
+    if(period != link->period_ms)
+    {
+        link->period_ms = period;
+        APP_LOG_INFO(RSSI_PERIOD, period);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name: proximity.h
+*
+* Description: This file is the public interface of proximity.c, the
+*              connection RSSI monitor that raises a local alert when a peer
+*              drifts out of range.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef PROXIMITY_H
+#define PROXIMITY_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Hysteresis thresholds on the filtered RSSI in dBm. A link is out of range
+ * below PROXIMITY_FAR_DBM and back in range above PROXIMITY_NEAR_DBM.
+ */
+#ifndef PROXIMITY_FAR_DBM
+#define PROXIMITY_FAR_DBM         (-85)
+#endif
+
+#ifndef PROXIMITY_NEAR_DBM
+#define PROXIMITY_NEAR_DBM        (-78)
+#endif
+
+/* Local alert level shown while a link is out of range: 1 mild, 2 high */
+#ifndef PROXIMITY_ALERT_LEVEL
+#define PROXIMITY_ALERT_LEVEL     (1u)
+#endif
+
+/* RSSI sampling period. It doubles, up to the maximum, after
+ * PROXIMITY_STABLE_COUNT samples within PROXIMITY_STABLE_DB of the estimate,
+ * and falls back to the minimum on a larger change.
+ */
+#ifndef PROXIMITY_SAMPLE_MIN_MS
+#define PROXIMITY_SAMPLE_MIN_MS   (500u)
+#endif
+
+#ifndef PROXIMITY_SAMPLE_MAX_MS
+#define PROXIMITY_SAMPLE_MAX_MS   (8000u)
+#endif
+
+#ifndef PROXIMITY_STABLE_DB
+#define PROXIMITY_STABLE_DB       (4)
+#endif
+
+#ifndef PROXIMITY_STABLE_COUNT
+#define PROXIMITY_STABLE_COUNT    (4u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* Called when a link goes out of range or comes back */
+typedef void (*proximity_callback_t)(void);
+
+typedef struct
+{
+    uint32_t samples;         /* RSSI samples filtered */
+    uint32_t cycles_total;    /* CPU cycles spent in the filter */
+    uint32_t cycles_max;      /* longest filter update */
+} proximity_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void proximity_init(proximity_callback_t changed);
+uint8_t proximity_alert_level(void);
+bool proximity_link_dbm(uint8_t bd_handle, int8_t *dbm);
+void proximity_get_stats(proximity_stats_t *stats);
+
+
+#endif  /* PROXIMITY_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,141 @@
+/******************************************************************************
+* File Name: rssi_filter.c
+*
+* Description: This file contains a one-dimensional Kalman filter for RSSI
+*              samples in integer arithmetic, so that it does not depend on
+*              the FPU. It has no hardware dependency.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "rssi_filter.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* The Kalman gain is kept in 1/4096, so that the gain times the innovation
+ * (at most 2^16 in 1/256 dBm) fits in 32 bits
+ */
+#define RSSI_FILTER_GAIN_ONE      (4096)
+
+
+/*******************************************************************************
+* Function Name: rssi_filter_init
+********************************************************************************
+* Summary:
+*  Resets the filter. The first sample is taken as the estimate.
+*
+* Parameters:
+*  rssi_filter_t *filter: filter state
+*
+*******************************************************************************/
+void rssi_filter_init(rssi_filter_t *filter)
+{
+    filter->estimate = 0;
+    filter->variance = RSSI_FILTER_SAMPLE_NOISE;
+    filter->primed = false;
+}
+
+
+/*******************************************************************************
+* Function Name: rssi_filter_update
+********************************************************************************
+* Summary:
+*  Adds one RSSI sample. The estimate moves towards the sample by the Kalman
+*  gain, which falls as the estimate variance settles and rises again through
+*  the process noise.
+*
+* Parameters:
+*  rssi_filter_t *filter: filter state
+*  int8_t rssi:           sample in dBm
+*
+* Return:
+*  int32_t: difference between the sample and the previous estimate, in
+*           1/256 dBm (0 for the first sample)
+*
+*******************************************************************************/
+int32_t rssi_filter_update(rssi_filter_t *filter, int8_t rssi)
+{
+    int32_t sample = (int32_t)rssi * RSSI_FILTER_ONE;
+    int32_t innovation;
+    int32_t gain;
+
+    if(!filter->primed)
+    {
+        filter->estimate = sample;
+        filter->variance = RSSI_FILTER_SAMPLE_NOISE;
+        filter->primed = true;
+        return 0;
+    }
+
+    /* Predict: the true RSSI may have drifted since the last sample */
+    filter->variance += RSSI_FILTER_PROCESS_NOISE;
+
+    /* Update */
+    gain = (filter->variance * RSSI_FILTER_GAIN_ONE) /
+           (filter->variance + RSSI_FILTER_SAMPLE_NOISE);
+    innovation = sample - filter->estimate;
+
+    filter->estimate += (gain * innovation) / RSSI_FILTER_GAIN_ONE;
+    filter->variance -= (gain * filter->variance) / RSSI_FILTER_GAIN_ONE;
+
+    return innovation;
+}
+
+
+/*******************************************************************************
+* Function Name: rssi_filter_dbm
+********************************************************************************
+* Summary:
+*  Returns the filtered RSSI rounded to the nearest dBm.
+*
+* Parameters:
+*  const rssi_filter_t *filter: filter state
+*
+*******************************************************************************/
+int8_t rssi_filter_dbm(const rssi_filter_t *filter)
+{
+    int32_t half = (filter->estimate < 0) ? -(RSSI_FILTER_ONE / 2) : (RSSI_FILTER_ONE / 2);
+
+    return (int8_t)((filter->estimate + half) / RSSI_FILTER_ONE);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,102 @@
+/******************************************************************************
+* File Name: rssi_filter.h
+*
+* Description: This file is the public interface of rssi_filter.c, the
+*              fixed-point filter that smooths connection RSSI samples.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef RSSI_FILTER_H
+#define RSSI_FILTER_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* The estimate and its variance are kept in 1/256 dBm and 1/256 dB^2 */
+#define RSSI_FILTER_FRAC_BITS     (8u)
+#define RSSI_FILTER_ONE           (1 << RSSI_FILTER_FRAC_BITS)
+
+/* Variance of the RSSI change between two samples, in 1/256 dB^2. A larger
+ * value follows a moving peer faster.
+ */
+#ifndef RSSI_FILTER_PROCESS_NOISE
+#define RSSI_FILTER_PROCESS_NOISE (128)      /* 0.5 dB^2 */
+#endif
+
+/* Variance of one RSSI sample around the true value, in 1/256 dB^2. A
+ * larger value smooths more.
+ */
+#ifndef RSSI_FILTER_SAMPLE_NOISE
+#define RSSI_FILTER_SAMPLE_NOISE  (4096)     /* 16 dB^2 */
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* State of a one-dimensional Kalman filter with a constant-value model */
+typedef struct
+{
+    int32_t estimate;         /* 1/256 dBm */
+    int32_t variance;         /* 1/256 dB^2 */
+    bool    primed;           /* set by the first sample */
+} rssi_filter_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void rssi_filter_init(rssi_filter_t *filter);
+int32_t rssi_filter_update(rssi_filter_t *filter, int8_t rssi);
+int8_t rssi_filter_dbm(const rssi_filter_t *filter);
+
+
+#endif  /* RSSI_FILTER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,440 @@
+/******************************************************************************
+* File Name: scan_table.c
+*
+* Description: This file contains the table of the devices seen while
+*              scanning. It is an open-addressing hash table keyed by device
+*              address, with linear probing and backward-shift deletion, in a
+*              static array. A repeated advertising report of a known device
+*              only updates its entry: the smoothed RSSI, the time it was last
+*              seen and its report count.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "scan_table.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SCAN_TABLE_MASK           (SCAN_TABLE_SIZE - 1u)
+
+#if ((SCAN_TABLE_SIZE & SCAN_TABLE_MASK) != 0u) || (SCAN_TABLE_SIZE > 65536u)
+#error "SCAN_TABLE_SIZE must be a power of two, at most 65536"
+#endif
+
+#if (SCAN_TABLE_EVICT_WINDOW > SCAN_TABLE_SIZE)
+#error "SCAN_TABLE_EVICT_WINDOW must not exceed SCAN_TABLE_SIZE"
+#endif
+
+/* A slot with no reports is free */
+#define SCAN_TABLE_SLOT_USED(slot)    (0u != scan_table[(slot)].reports)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static scan_entry_t scan_table[SCAN_TABLE_SIZE];
+static uint32_t scan_count;
+static scan_table_stats_t scan_stats;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t scan_table_home(const uint8_t addr[6], uint8_t addr_type);
+static bool scan_table_match(uint32_t slot, const uint8_t addr[6], uint8_t addr_type);
+static void scan_table_remove_slot(uint32_t hole);
+static void scan_table_evict(uint32_t home, uint32_t now);
+
+
+/*******************************************************************************
+* Function Name: scan_table_init
+********************************************************************************
+* Summary:
+*  Empties the table and clears the statistics.
+*
+*******************************************************************************/
+void scan_table_init(void)
+{
+    (void)memset(scan_table, 0, sizeof(scan_table));
+    (void)memset(&scan_stats, 0, sizeof(scan_stats));
+    scan_count = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_update
+********************************************************************************
+* Summary:
+*  Records one advertising report. A known device has its smoothed RSSI, last
+*  seen time and report count updated; an unknown device is inserted, after
+*  evicting the least recently seen device near its home slot if the table is
+*  full.
+*
+*  The returned entry is valid until the next call that inserts or removes
+*  devices, which may move entries.
+*
+* Parameters:
+*  const uint8_t addr[6]: device address
+*  uint8_t addr_type:     public or random address
+*  int8_t rssi:           RSSI of the report in dBm
+*  uint32_t now:          app_timer_now() at the report
+*  bool *is_new:          set to true if the device was not in the table
+*
+* Return:
+*  scan_entry_t*: entry of the device
+*
+*******************************************************************************/
+scan_entry_t* scan_table_update(const uint8_t addr[6], uint8_t addr_type,
+                                int8_t rssi, uint32_t now, bool *is_new)
+{
+    uint32_t home = scan_table_home(addr, addr_type);
+    uint32_t slot = home;
+    uint32_t probe = 0u;
+    scan_entry_t *entry;
+
+    scan_stats.reports++;
+    *is_new = false;
+
+    while(SCAN_TABLE_SLOT_USED(slot))
+    {
+        if(scan_table_match(slot, addr, addr_type))
+        {
+            entry = &scan_table[slot];
+
+            /* Exponential moving average in 1/16 dBm */
+            entry->rssi_q4 += (int16_t)((((int32_t)rssi << SCAN_TABLE_RSSI_FRAC_BITS) -
+                                         entry->rssi_q4) / SCAN_TABLE_RSSI_WEIGHT);
+            entry->last_seen = now;
+            if(entry->reports < UINT16_MAX)
+            {
+                entry->reports++;
+            }
+
+            if(probe > scan_stats.max_probe)
+            {
+                scan_stats.max_probe = probe;
+            }
+            return entry;
+        }
+
+        slot = (slot + 1u) & SCAN_TABLE_MASK;
+        probe++;
+    }
+
+    if(scan_count >= SCAN_TABLE_MAX_ENTRIES)
+    {
+        /* Entries may shift back into the probe sequence; search again */
+        scan_table_evict(home, now);
+
+        slot = home;
+        while(SCAN_TABLE_SLOT_USED(slot))
+        {
+            slot = (slot + 1u) & SCAN_TABLE_MASK;
+        }
+    }
+
+    entry = &scan_table[slot];
+    (void)memcpy(entry->addr, addr, sizeof(entry->addr));
+    entry->addr_type = addr_type;
+    entry->flags = 0u;
+    entry->rssi_q4 = (int16_t)((int32_t)rssi << SCAN_TABLE_RSSI_FRAC_BITS);
+    entry->last_seen = now;
+    entry->reports = 1u;
+
+    scan_count++;
+    scan_stats.inserts++;
+    *is_new = true;
+
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_find
+********************************************************************************
+* Summary:
+*  Looks up a device.
+*
+* Parameters:
+*  const uint8_t addr[6]: device address
+*  uint8_t addr_type:     public or random address
+*
+* Return:
+*  scan_entry_t*: entry of the device, or NULL if it is not in the table
+*
+*******************************************************************************/
+scan_entry_t* scan_table_find(const uint8_t addr[6], uint8_t addr_type)
+{
+    uint32_t slot = scan_table_home(addr, addr_type);
+
+    while(SCAN_TABLE_SLOT_USED(slot))
+    {
+        if(scan_table_match(slot, addr, addr_type))
+        {
+            return &scan_table[slot];
+        }
+        slot = (slot + 1u) & SCAN_TABLE_MASK;
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_age
+********************************************************************************
+* Summary:
+*  Removes the devices that have not been seen for longer than max_age.
+*  Called periodically from the main loop.
+*
+* Parameters:
+*  uint32_t now:      app_timer_now()
+*  uint32_t max_age:  age limit in app_timer ticks
+*
+* Return:
+*  uint32_t: number of devices removed
+*
+*******************************************************************************/
+uint32_t scan_table_age(uint32_t now, uint32_t max_age)
+{
+    uint32_t removed = 0u;
+    uint32_t slot = 0u;
+
+    while(slot < SCAN_TABLE_SIZE)
+    {
+        if(SCAN_TABLE_SLOT_USED(slot) && ((now - scan_table[slot].last_seen) > max_age))
+        {
+            /* An entry shifted into this slot is checked on the next pass */
+            scan_table_remove_slot(slot);
+            removed++;
+        }
+        else
+        {
+            slot++;
+        }
+    }
+
+    scan_stats.expired += removed;
+
+    return removed;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_strongest
+********************************************************************************
+* Summary:
+*  Returns the device with the highest smoothed RSSI among those that have
+*  all of flags_set and none of flags_clear.
+*
+* Parameters:
+*  uint8_t flags_set:    flags the device must have
+*  uint8_t flags_clear:  flags the device must not have
+*
+* Return:
+*  scan_entry_t*: entry of the device, or NULL if no device qualifies
+*
+*******************************************************************************/
+scan_entry_t* scan_table_strongest(uint8_t flags_set, uint8_t flags_clear)
+{
+    scan_entry_t *best = NULL;
+    uint32_t slot;
+
+    for(slot = 0u; slot < SCAN_TABLE_SIZE; slot++)
+    {
+        if(SCAN_TABLE_SLOT_USED(slot) &&
+           ((scan_table[slot].flags & flags_set) == flags_set) &&
+           (0u == (scan_table[slot].flags & flags_clear)) &&
+           ((NULL == best) || (scan_table[slot].rssi_q4 > best->rssi_q4)))
+        {
+            best = &scan_table[slot];
+        }
+    }
+
+    return best;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_count
+********************************************************************************
+* Summary:
+*  Returns the number of devices in the table.
+*
+*******************************************************************************/
+uint32_t scan_table_count(void)
+{
+    return scan_count;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_get_stats
+********************************************************************************
+* Summary:
+*  Copies the table statistics.
+*
+* Parameters:
+*  scan_table_stats_t *stats: destination
+*
+*******************************************************************************/
+void scan_table_get_stats(scan_table_stats_t *stats)
+{
+    *stats = scan_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_home
+********************************************************************************
+* Summary:
+*  Returns the home slot of a device: a multiplicative hash of its address.
+*
+* Parameters:
+*  const uint8_t addr[6]: device address
+*  uint8_t addr_type:     public or random address
+*
+*******************************************************************************/
+static uint32_t scan_table_home(const uint8_t addr[6], uint8_t addr_type)
+{
+    uint32_t low = (uint32_t)addr[0] | ((uint32_t)addr[1] << 8u) |
+                   ((uint32_t)addr[2] << 16u) | ((uint32_t)addr[3] << 24u);
+    uint32_t high = (uint32_t)addr[4] | ((uint32_t)addr[5] << 8u) |
+                    ((uint32_t)addr_type << 16u);
+
+    return (((low ^ (high * 0x85EBCA6Bu)) * 0x9E3779B1u) >> 16u) & SCAN_TABLE_MASK;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_match
+********************************************************************************
+* Summary:
+*  Tells if a used slot holds the given device.
+*
+*******************************************************************************/
+static bool scan_table_match(uint32_t slot, const uint8_t addr[6], uint8_t addr_type)
+{
+    return (scan_table[slot].addr_type == addr_type) &&
+           (0 == memcmp(scan_table[slot].addr, addr, sizeof(scan_table[slot].addr)));
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_remove_slot
+********************************************************************************
+* Summary:
+*  Frees a slot and moves the following entries of the cluster back, so that
+*  every entry stays reachable from its home slot without tombstones.
+*
+* Parameters:
+*  uint32_t hole: slot to free
+*
+*******************************************************************************/
+static void scan_table_remove_slot(uint32_t hole)
+{
+    uint32_t next = (hole + 1u) & SCAN_TABLE_MASK;
+    uint32_t home;
+
+    while(SCAN_TABLE_SLOT_USED(next))
+    {
+        home = scan_table_home(scan_table[next].addr, scan_table[next].addr_type);
+
+        /* The entry may fill the hole unless its home lies after the hole */
+        if(((next - home) & SCAN_TABLE_MASK) >= ((next - hole) & SCAN_TABLE_MASK))
+        {
+            scan_table[hole] = scan_table[next];
+            hole = next;
+        }
+        next = (next + 1u) & SCAN_TABLE_MASK;
+    }
+
+    (void)memset(&scan_table[hole], 0, sizeof(scan_table[hole]));
+    scan_count--;
+}
+
+
+/*******************************************************************************
+* Function Name: scan_table_evict
+********************************************************************************
+* Summary:
+*  Removes the least recently seen device among the SCAN_TABLE_EVICT_WINDOW
+*  slots from a home slot. If all of them are free, the first used slot after
+*  them is removed instead.
+*
+* Parameters:
+*  uint32_t home: home slot of the device to insert
+*  uint32_t now:  app_timer_now()
+*
+*******************************************************************************/
+static void scan_table_evict(uint32_t home, uint32_t now)
+{
+    uint32_t victim = SCAN_TABLE_SIZE;
+    uint32_t victim_age = 0u;
+    uint32_t slot;
+    uint32_t i;
+
+    for(i = 0u; i < SCAN_TABLE_SIZE; i++)
+    {
+        if((i >= SCAN_TABLE_EVICT_WINDOW) && (SCAN_TABLE_SIZE != victim))
+        {
+            break;
+        }
+
+        slot = (home + i) & SCAN_TABLE_MASK;
+        if(SCAN_TABLE_SLOT_USED(slot) &&
+           ((SCAN_TABLE_SIZE == victim) || ((now - scan_table[slot].last_seen) > victim_age)))
+        {
+            victim = slot;
+            victim_age = now - scan_table[slot].last_seen;
+        }
+    }
+
+    if(SCAN_TABLE_SIZE != victim)
+    {
+        scan_table_remove_slot(victim);
+        scan_stats.evictions++;
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,129 @@
+/******************************************************************************
+* File Name: scan_table.h
+*
+* Description: This file is the public interface of scan_table.c, the
+*              fixed-capacity table of the devices seen while scanning.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef SCAN_TABLE_H
+#define SCAN_TABLE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Number of slots. Must be a power of two. Each slot takes 16 bytes of RAM. */
+#ifndef SCAN_TABLE_SIZE
+#define SCAN_TABLE_SIZE           (256u)
+#endif
+
+/* Devices kept at most, so that probe sequences stay short (75% load) */
+#define SCAN_TABLE_MAX_ENTRIES    ((SCAN_TABLE_SIZE * 3u) / 4u)
+
+/* A full table evicts the least recently seen device among this many slots
+ * from the home slot of the new device
+ */
+#ifndef SCAN_TABLE_EVICT_WINDOW
+#define SCAN_TABLE_EVICT_WINDOW   (8u)
+#endif
+
+/* Weight of the newest report in the smoothed RSSI: 1/SCAN_TABLE_RSSI_WEIGHT */
+#ifndef SCAN_TABLE_RSSI_WEIGHT
+#define SCAN_TABLE_RSSI_WEIGHT    (4)
+#endif
+
+/* The smoothed RSSI is kept in 1/16 dBm */
+#define SCAN_TABLE_RSSI_FRAC_BITS (4u)
+#define SCAN_TABLE_RSSI_DBM(q)    ((int8_t)((q) / (1 << SCAN_TABLE_RSSI_FRAC_BITS)))
+
+/* Application flags of an entry */
+#define SCAN_TABLE_FLAG_TARGET    (0x01u)   /* advertises the IAS */
+#define SCAN_TABLE_FLAG_ALERTED   (0x02u)   /* alert level written */
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* One device. Kept at 16 bytes: the table holds hundreds of them. */
+typedef struct
+{
+    uint32_t last_seen;       /* app_timer_now() of the last report */
+    uint8_t  addr[6];
+    uint8_t  addr_type;
+    uint8_t  flags;
+    int16_t  rssi_q4;         /* smoothed RSSI in 1/16 dBm */
+    uint16_t reports;         /* saturates at 0xFFFF */
+} scan_entry_t;
+
+typedef struct
+{
+    uint32_t reports;         /* advertising reports processed */
+    uint32_t inserts;         /* new devices */
+    uint32_t evictions;       /* devices dropped because the table was full */
+    uint32_t expired;         /* devices dropped by scan_table_age() */
+    uint32_t max_probe;       /* longest probe sequence seen */
+} scan_table_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void scan_table_init(void);
+scan_entry_t* scan_table_update(const uint8_t addr[6], uint8_t addr_type,
+                                int8_t rssi, uint32_t now, bool *is_new);
+scan_entry_t* scan_table_find(const uint8_t addr[6], uint8_t addr_type);
+uint32_t scan_table_age(uint32_t now, uint32_t max_age);
+scan_entry_t* scan_table_strongest(uint8_t flags_set, uint8_t flags_clear);
+uint32_t scan_table_count(void);
+void scan_table_get_stats(scan_table_stats_t *stats);
+
+
+#endif  /* SCAN_TABLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,458 @@
+/******************************************************************************
+* File Name: settings.c
+*
+* Description: This file contains the settings store. Settings are kept in
+*              a ring of flash rows in the emulated EEPROM region. Every
+*              commit writes a complete snapshot with the next sequence
+*              number to the next row of the ring, so the writes are spread
+*              over all rows and an interrupted write leaves the previous
+*              snapshot intact. At boot the row with the highest sequence
+*              number and a valid CRC is loaded into a RAM table indexed by
+*              key.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "settings.h"
+#include "app_log.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SETTINGS_ROW_SIZE         (CY_FLASH_SIZEOF_ROW)
+
+/* Number of rows in the ring */
+#ifndef SETTINGS_ROW_COUNT
+#define SETTINGS_ROW_COUNT        (8u)
+#endif
+
+/* "STG1"; change it when the row layout changes */
+#define SETTINGS_MAGIC            (0x53544731u)
+
+#define SETTINGS_MAX_RECORDS      ((SETTINGS_ROW_SIZE - sizeof(settings_header_t)) / \
+                                   sizeof(settings_record_t))
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t sequence;        /* increases with every commit */
+    uint32_t count;           /* number of records */
+    uint32_t crc;             /* CRC-32 of the records */
+} settings_header_t;
+
+typedef struct
+{
+    uint32_t key;
+    uint32_t value;
+} settings_record_t;
+
+typedef struct
+{
+    uint32_t def;
+    uint32_t min;
+    uint32_t max;
+} settings_limits_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool settings_row_valid(uint32_t row);
+static uint32_t settings_crc32(const uint8_t *data, uint32_t length);
+static void settings_write_handler(uint32_t event, void *eventParam);
+
+
+/*******************************************************************************
+* BLE event handler table
+********************************************************************************/
+static const ble_dispatch_entry_t settings_event_table[] =
+{
+    { CY_BLE_EVT_GATTS_WRITE_REQ, settings_write_handler },
+};
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+#define SETTINGS_LIMITS_ENTRY(name, def, min, max)   { (def), (min), (max) },
+
+static const settings_limits_t settings_limits[SETTINGS_KEY_COUNT] =
+{
+    SETTINGS_KEYS(SETTINGS_LIMITS_ENTRY)
+};
+
+#undef SETTINGS_LIMITS_ENTRY
+
+/* Flash ring. Erased rows read as zero and are ignored. */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t settings_flash[SETTINGS_ROW_COUNT][SETTINGS_ROW_SIZE] = {{0u}};
+
+/* RAM index: the current value of every key */
+static uint32_t settings_values[SETTINGS_KEY_COUNT];
+
+/* Row buffer of the commit in progress; it must stay unchanged until the
+ * BLE stack has written it.
+ */
+CY_ALIGN(4)
+static uint8_t settings_row[SETTINGS_ROW_SIZE];
+static cy_stc_ble_app_flash_param_t settings_flash_param;
+
+static uint32_t settings_sequence = 0u;
+static uint32_t settings_next_row = 0u;
+static bool settings_dirty = false;
+static bool settings_writing = false;
+
+
+/*******************************************************************************
+* Function Name: settings_init
+********************************************************************************
+* Summary:
+*  Loads the newest valid snapshot from flash; keys that are not stored keep
+*  their defaults. At most SETTINGS_ROW_COUNT headers and, if rows are
+*  corrupt, as many CRCs are checked. Also registers the handler of the
+*  Setting characteristic; must be called after ble_dispatch_init().
+*
+*******************************************************************************/
+void settings_init(void)
+{
+    uint32_t rejected = 0u;
+    uint32_t best;
+    uint32_t i;
+
+    for(i = 0u; i < (uint32_t)SETTINGS_KEY_COUNT; i++)
+    {
+        settings_values[i] = settings_limits[i].def;
+    }
+
+    settings_sequence = 0u;
+    settings_next_row = 0u;
+    settings_dirty = false;
+    settings_writing = false;
+
+    /* Try the rows from the newest sequence number down until one passes
+     * its CRC check
+     */
+    do
+    {
+        best = SETTINGS_ROW_COUNT;
+
+        for(i = 0u; i < SETTINGS_ROW_COUNT; i++)
+        {
+            const settings_header_t *header = (const settings_header_t *)settings_flash[i];
+
+            if((0u == (rejected & (1u << i))) && (SETTINGS_MAGIC == header->magic) &&
+               ((SETTINGS_ROW_COUNT == best) ||
+                (header->sequence > ((const settings_header_t *)settings_flash[best])->sequence)))
+            {
+                best = i;
+            }
+        }
+
+        if((SETTINGS_ROW_COUNT != best) && !settings_row_valid(best))
+        {
+            rejected |= 1u << best;
+            best = SETTINGS_ROW_COUNT;
+            continue;
+        }
+        break;
+    } while(true);
+
+    if(SETTINGS_ROW_COUNT != best)
+    {
+        const settings_header_t *header = (const settings_header_t *)settings_flash[best];
+        const settings_record_t *records = (const settings_record_t *)&header[1];
+
+        for(i = 0u; i < header->count; i++)
+        {
+            /* Records of unknown keys or out of range are ignored */
+            (void)settings_set((settings_key_t)records[i].key, records[i].value);
+        }
+
+        settings_sequence = header->sequence;
+        settings_next_row = (best + 1u) % SETTINGS_ROW_COUNT;
+        settings_dirty = false;
+    }
+
+    if(!ble_dispatch_register(settings_event_table,
+                              BLE_DISPATCH_COUNT(settings_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: settings_get
+********************************************************************************
+* Summary:
+*  Returns the current value of a setting.
+*
+*******************************************************************************/
+uint32_t settings_get(settings_key_t key)
+{
+    return settings_values[key];
+}
+
+
+/*******************************************************************************
+* Function Name: settings_set
+********************************************************************************
+* Summary:
+*  Changes a setting in RAM. The change is written to flash by
+*  settings_process().
+*
+* Parameters:
+*  settings_key_t key: setting
+*  uint32_t value:     new value
+*
+* Return:
+*  bool: false if the key is unknown or the value is out of range
+*
+*******************************************************************************/
+bool settings_set(settings_key_t key, uint32_t value)
+{
+    if(((uint32_t)key >= (uint32_t)SETTINGS_KEY_COUNT) ||
+       (value < settings_limits[key].min) || (value > settings_limits[key].max))
+    {
+        return false;
+    }
+
+    if(value != settings_values[key])
+    {
+        settings_values[key] = value;
+        settings_dirty = true;
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: settings_process
+********************************************************************************
+* Summary:
+*  Writes changed settings to flash. Called from the main loop; the BLE stack
+*  writes the row in steps, so the call returns while the write is in
+*  progress. Settings changed during a write are committed by the next one.
+*
+*******************************************************************************/
+void settings_process(void)
+{
+    settings_header_t *header = (settings_header_t *)settings_row;
+    settings_record_t *records = (settings_record_t *)&header[1];
+    cy_en_ble_api_result_t result;
+    uint32_t count = 0u;
+    uint32_t i;
+
+    if(!settings_writing)
+    {
+        /* Bonding data has priority over the settings */
+        if(!settings_dirty || (0u != cy_ble_pendingFlashWrite))
+        {
+            return;
+        }
+
+        /* Only values that differ from the defaults are stored */
+        for(i = 0u; i < (uint32_t)SETTINGS_KEY_COUNT; i++)
+        {
+            if((settings_values[i] != settings_limits[i].def) && (count < SETTINGS_MAX_RECORDS))
+            {
+                records[count].key = i;
+                records[count].value = settings_values[i];
+                count++;
+            }
+        }
+
+        (void)memset(&records[count], 0, SETTINGS_ROW_SIZE - sizeof(settings_header_t) -
+                                         (count * sizeof(settings_record_t)));
+
+        header->magic = SETTINGS_MAGIC;
+        header->sequence = settings_sequence + 1u;
+        header->count = count;
+        header->crc = settings_crc32((const uint8_t *)records,
+                                     count * (uint32_t)sizeof(settings_record_t));
+
+        settings_flash_param.srcBuff = settings_row;
+        settings_flash_param.destAddr = settings_flash[settings_next_row];
+        settings_flash_param.buffLen = SETTINGS_ROW_SIZE;
+
+        settings_dirty = false;
+        settings_writing = true;
+    }
+
+    result = Cy_BLE_StoreAppData(&settings_flash_param);
+
+    if(CY_BLE_INFO_FLASH_WRITE_IN_PROGRESS != result)
+    {
+        settings_writing = false;
+
+        if(CY_BLE_SUCCESS == result)
+        {
+            settings_sequence = header->sequence;
+            settings_next_row = (settings_next_row + 1u) % SETTINGS_ROW_COUNT;
+        }
+        else
+        {
+            /* Retry with the next call; the previous snapshot is intact */
+            APP_LOG_ERROR(SETTINGS_WR_FAILED, result);
+            settings_dirty = true;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: settings_pending
+********************************************************************************
+* Summary:
+*  Returns true while changed settings wait for, or are in, a flash write.
+*
+*******************************************************************************/
+bool settings_pending(void)
+{
+    return settings_dirty || settings_writing;
+}
+
+
+/*******************************************************************************
+* Function Name: settings_row_valid
+********************************************************************************
+* Summary:
+*  Returns true if the records of a flash row match the CRC in its header.
+*
+*******************************************************************************/
+static bool settings_row_valid(uint32_t row)
+{
+    const settings_header_t *header = (const settings_header_t *)settings_flash[row];
+
+    if(header->count > SETTINGS_MAX_RECORDS)
+    {
+        return false;
+    }
+
+    return (header->crc == settings_crc32((const uint8_t *)&header[1],
+                                          header->count * (uint32_t)sizeof(settings_record_t)));
+}
+
+
+/*******************************************************************************
+* Function Name: settings_crc32
+********************************************************************************
+* Summary:
+*  Computes the CRC-32 (IEEE 802.3) of a buffer, bit by bit. Only the used
+*  part of one row is checked per boot, so no table is needed.
+*
+*******************************************************************************/
+static uint32_t settings_crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t i;
+    uint32_t bit;
+
+    for(i = 0u; i < length; i++)
+    {
+        crc ^= data[i];
+
+        for(bit = 0u; bit < 8u; bit++)
+        {
+            crc = (crc >> 1u) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+
+    return ~crc;
+}
+
+
+/*******************************************************************************
+* Function Name: settings_write_handler
+********************************************************************************
+* Summary:
+*  Handles writes to the Setting characteristic: a key byte followed by a
+*  32-bit little-endian value. Out-of-range values are rejected.
+*
+*******************************************************************************/
+static void settings_write_handler(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatts_write_cmd_req_param_t *write_req =
+        (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParam;
+    const cy_stc_ble_gatt_value_t *value = &write_req->handleValPair.value;
+    cy_stc_ble_gatt_err_param_t error =
+    {
+        .errInfo.opCode     = CY_BLE_GATT_WRITE_REQ,
+        .errInfo.attrHandle = CY_BLE_SETTINGS_SETTING_CHAR_HANDLE,
+        .connHandle         = write_req->connHandle
+    };
+
+    (void)event;
+
+    if(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE != write_req->handleValPair.attrHandle)
+    {
+        return;
+    }
+
+    if(SETTINGS_WRITE_SIZE != value->len)
+    {
+        error.errInfo.errorCode = CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+        (void)Cy_BLE_GATTS_ErrorRsp(&error);
+    }
+    else if(!settings_set((settings_key_t)value->val[0],
+                          (uint32_t)value->val[1] | ((uint32_t)value->val[2] << 8u) |
+                          ((uint32_t)value->val[3] << 16u) | ((uint32_t)value->val[4] << 24u)))
+    {
+        error.errInfo.errorCode = CY_BLE_GATT_ERR_OUT_OF_RANGE;
+        (void)Cy_BLE_GATTS_ErrorRsp(&error);
+    }
+    else
+    {
+        APP_LOG_INFO(SETTING_CHANGED, value->val[0]);
+        (void)Cy_BLE_GATTS_WriteRsp(write_req->connHandle);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name: settings.h
+*
+* Description: This file is the public interface of settings.c, the flash
+*              store of the runtime-tunable parameters.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef SETTINGS_H
+#define SETTINGS_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "adv_policy.h"
+#include "status_led.h"
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Tunable parameters: name, default, minimum and maximum. The key of a
+ * setting is its position in this list; append new settings at the end to
+ * keep stored values valid. Advertising intervals are in 0.625 ms units and
+ * advertising timeouts in seconds. TX_POWER_LEVEL is a
+ * cy_en_ble_bless_pwr_lvl_t value; 0 keeps the level of design.cybt.
+ */
+#define SETTINGS_KEYS(X)                                                      \
+    X(ADV_FAST_INTERVAL,     ADV_FAST_INTERVAL_MIN,   32u, 16000u)            \
+    X(ADV_FAST_TIMEOUT,      ADV_FAST_TIMEOUT_S,      1u,  16383u)            \
+    X(ADV_MEDIUM_INTERVAL,   ADV_MEDIUM_INTERVAL_MIN, 32u, 16000u)            \
+    X(ADV_MEDIUM_TIMEOUT,    ADV_MEDIUM_TIMEOUT_S,    1u,  16383u)            \
+    X(ADV_SLOW_INTERVAL,     ADV_SLOW_INTERVAL_MIN,   32u, 16000u)            \
+    X(ADV_SLOW_TIMEOUT,      ADV_SLOW_TIMEOUT_S,      1u,  16383u)            \
+    X(ADV_WHITELIST_TIMEOUT, ADV_WHITELIST_TIMEOUT_S, 1u,  16383u)            \
+    X(ALERT_MILD_ON_MS,      STATUS_LED_MILD_ON_MS,   10u, 10000u)            \
+    X(ALERT_MILD_OFF_MS,     STATUS_LED_MILD_OFF_MS,  10u, 10000u)            \
+    X(TX_POWER_LEVEL,        0u,                      0u,  9u)
+
+/* Size of a write to the Setting characteristic: key and 32-bit value */
+#define SETTINGS_WRITE_SIZE       (5u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+#define SETTINGS_KEY_ENUM(name, def, min, max)   SETTINGS_##name,
+
+typedef enum
+{
+    SETTINGS_KEYS(SETTINGS_KEY_ENUM)
+    SETTINGS_KEY_COUNT
+} settings_key_t;
+
+#undef SETTINGS_KEY_ENUM
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void settings_init(void);
+uint32_t settings_get(settings_key_t key);
+bool settings_set(settings_key_t key, uint32_t value);
+void settings_process(void);
+bool settings_pending(void);
+
+
+#endif  /* SETTINGS_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,213 @@
+/******************************************************************************
+* File Name: sleep_policy.c
+*
+* Description: This file contains the sleep policy of the idle hook. With
+*              Bluetooth LE off the device hibernates. Otherwise it deep
+*              sleeps, unless the next timer deadline is closer than the
+*              break-even time or the BLE subsystem is about to run or is
+*              running a radio event: the deep sleep entry and exit would
+*              then cost more than they save, and the BLE power mode
+*              callback would refuse the transition after the other
+*              callbacks had already run. The CPU sleeps instead.
+*              Hibernate ends in a reset, so it waits until no flash write
+*              or scheduled task is pending.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "sleep_policy.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_findme.h"
+#include "cycfg_ble.h"
+#include "settings.h"
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Break-even time in wakeup timer ticks, rounded up */
+#define SLEEP_POLICY_BREAK_EVEN_TICKS                                         \
+    ((uint32_t)((((uint64_t)SLEEP_POLICY_BREAK_EVEN_US * APP_TIMER_TICKS_PER_SEC) +   \
+                 999999u) / 1000000u))
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool sleep_policy_ble_busy(void);
+static bool sleep_policy_work_pending(void);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static sleep_policy_stats_t sleep_stats;
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_select
+********************************************************************************
+* Summary:
+*  Picks the low power mode for the coming idle period. Must be called with
+*  interrupts disabled, right before the mode is entered. The idle period
+*  is counted by sleep_policy_entered() once the mode is known to have been
+*  entered.
+*
+* Return:
+*  sleep_mode_t: mode to enter
+*
+*******************************************************************************/
+sleep_mode_t sleep_policy_select(void)
+{
+    uint32_t delay = 0u;
+    bool timed = app_timer_next_delay(&delay);
+
+    if(CY_BLE_STATE_STOPPED == Cy_BLE_GetState())
+    {
+        if((timed && (delay < APP_TIMER_MS_TO_TICKS(SLEEP_POLICY_HIBERNATE_MIN_MS))) ||
+           sleep_policy_work_pending())
+        {
+            sleep_stats.hibernate_held++;
+            return SLEEP_MODE_DEEPSLEEP;
+        }
+
+        return SLEEP_MODE_HIBERNATE;
+    }
+
+    if(timed && (delay < SLEEP_POLICY_BREAK_EVEN_TICKS))
+    {
+        sleep_stats.timer_near++;
+        return SLEEP_MODE_SLEEP;
+    }
+
+    if((0u != SLEEP_POLICY_BREAK_EVEN_US) && sleep_policy_ble_busy())
+    {
+        sleep_stats.ble_busy++;
+        return SLEEP_MODE_SLEEP;
+    }
+
+    return SLEEP_MODE_DEEPSLEEP;
+}
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_entered
+********************************************************************************
+* Summary:
+*  Counts an idle period in the mode that was actually entered. A deep sleep
+*  request that the power mode callbacks refuse ends up in CPU sleep.
+*
+* Parameters:
+*  sleep_mode_t mode: SLEEP_MODE_SLEEP or SLEEP_MODE_DEEPSLEEP
+*
+*******************************************************************************/
+void sleep_policy_entered(sleep_mode_t mode)
+{
+    if(SLEEP_MODE_DEEPSLEEP == mode)
+    {
+        sleep_stats.deepsleeps++;
+    }
+    else
+    {
+        sleep_stats.sleeps++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_get_stats
+********************************************************************************
+* Summary:
+*  Copies the number of idle periods per mode and the reasons for CPU
+*  sleep.
+*
+* Parameters:
+*  sleep_policy_stats_t *stats: destination
+*
+*******************************************************************************/
+void sleep_policy_get_stats(sleep_policy_stats_t *stats)
+{
+    *stats = sleep_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_work_pending
+********************************************************************************
+* Summary:
+*  Returns true if work would be lost by a hibernate: bonding data or
+*  settings not yet in flash, or a task of the scheduler still due, however
+*  far away.
+*
+*******************************************************************************/
+static bool sleep_policy_work_pending(void)
+{
+    return (0u != cy_ble_pendingFlashWrite) || settings_pending() || app_sched_pending();
+}
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_ble_busy
+********************************************************************************
+* Summary:
+*  Returns true if the BLE subsystem is in or close to a radio event. The
+*  stack does not report the time of its next event, but it starts the
+*  crystal oscillator shortly before each one, so a subsystem that has left
+*  its sleep states is about to wake the CPU. With the controller on CM0+,
+*  radio events do not wake this core and do not hold it awake.
+*
+*******************************************************************************/
+static bool sleep_policy_ble_busy(void)
+{
+#if (BLE_DUAL_CORE == 0u)
+    cy_en_ble_bless_state_t state = Cy_BLE_StackGetBleSsState();
+
+    return (CY_BLE_BLESS_STATE_ACTIVE == state) ||
+           (CY_BLE_BLESS_STATE_EVENT_CLOSE == state) ||
+           (CY_BLE_BLESS_STATE_ECO_ON == state) ||
+           (CY_BLE_BLESS_STATE_ECO_STABLE == state);
+#else
+    return false;
+#endif
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: sleep_policy.h
+*
+* Description: This file is the public interface of sleep_policy.c, which
+*              picks the low power mode for each idle period.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef SLEEP_POLICY_H
+#define SLEEP_POLICY_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include "power_stats.h"
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Shortest idle period worth a deep sleep, in us. Below it the charge of the
+ * deep sleep entry and exit exceeds what deep sleep saves over CPU sleep.
+ * The default follows from the current model of power_stats.h. Set it to 0
+ * to deep sleep on every idle period, as before the policy.
+ */
+#ifndef SLEEP_POLICY_BREAK_EVEN_US
+#define SLEEP_POLICY_BREAK_EVEN_US                                            \
+    ((POWER_MODEL_DEEPSLEEP_CHARGE_NC * 1000000u) /                           \
+     (POWER_MODEL_SLEEP_NA - POWER_MODEL_DEEPSLEEP_NA))
+#endif
+
+/* With Bluetooth LE off, the device deep sleeps instead of hibernating
+ * while a timer is due within this time, so that a debounce completes
+ * first. Pending flash writes and scheduled tasks hold off hibernate
+ * whatever their time.
+ */
+#ifndef SLEEP_POLICY_HIBERNATE_MIN_MS
+#define SLEEP_POLICY_HIBERNATE_MIN_MS (2000u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    SLEEP_MODE_SLEEP,         /* CPU sleep, peripherals and clocks running */
+    SLEEP_MODE_DEEPSLEEP,     /* System deep sleep */
+    SLEEP_MODE_HIBERNATE      /* System hibernate; wakes through a reset */
+} sleep_mode_t;
+
+typedef struct
+{
+    uint32_t sleeps;          /* idle periods spent in CPU sleep */
+    uint32_t deepsleeps;      /* idle periods spent in deep sleep */
+    uint32_t timer_near;      /* sleeps picked for a close timer deadline */
+    uint32_t ble_busy;        /* sleeps picked for an imminent radio event */
+    uint32_t hibernate_held;  /* deep sleeps picked instead of hibernate */
+} sleep_policy_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+sleep_mode_t sleep_policy_select(void);
+void sleep_policy_entered(sleep_mode_t mode);
+void sleep_policy_get_stats(sleep_policy_stats_t *stats);
+
+
+#endif  /* SLEEP_POLICY_H */
+
+
+/* [] END OF FILE */
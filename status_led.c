@@ -0,0 +1,279 @@
+/******************************************************************************
+* File Name: status_led.c
+*
+* Description: This file drives the user LEDs from the BLE link state and the
+*              alert level. The blink timer runs only while an LED is blinking;
+*              steady states do not wake the CPU at all.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "status_led.h"
+#include "alert_pattern.h"
+#include "settings.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cycfg_ble.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Define STATUS_LED_BUZZER_PIN to a TCPWM-capable pin to sound a buzzer with
+ * the high alert. The tone is generated by the TCPWM, which stops in deep
+ * sleep, so the CPU only uses sleep mode while the buzzer sounds.
+ */
+#ifndef STATUS_LED_BUZZER_HZ
+#define STATUS_LED_BUZZER_HZ      (2700u)
+#endif
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const cyhal_gpio_t status_led_pins[ALERT_CHANNEL_COUNT] =
+{
+    (cyhal_gpio_t)CYBSP_USER_LED1,
+    (cyhal_gpio_t)CYBSP_USER_LED2
+};
+
+/* Pattern tables. Short flashes with long gaps keep the number of wakeups
+ * per second low.
+ */
+static const alert_step_t steps_off[] =
+{
+    { 0u,    0u }
+};
+
+static const alert_step_t steps_on[] =
+{
+    { 0u,    ALERT_OUTPUT_LED }
+};
+
+/* Advertising: 50 ms flash every 1 s */
+static const alert_step_t steps_advertising[] =
+{
+    { 50u,   ALERT_OUTPUT_LED },
+    { 950u,  0u }
+};
+
+/* Mild alert: on and off times are loaded from the settings at init */
+static alert_step_t steps_mild[] =
+{
+    { STATUS_LED_MILD_ON_MS,  ALERT_OUTPUT_LED },
+    { STATUS_LED_MILD_OFF_MS, 0u }
+};
+
+/* High alert: LED on, buzzer beeping 500 ms on, 500 ms off */
+static const alert_step_t steps_high[] =
+{
+    { 500u,  ALERT_OUTPUT_LED | ALERT_OUTPUT_BUZZER },
+    { 500u,  ALERT_OUTPUT_LED }
+};
+
+static const alert_pattern_t pattern_off =
+    { steps_off, ALERT_PATTERN_STEPS(steps_off), false };
+static const alert_pattern_t pattern_on =
+    { steps_on, ALERT_PATTERN_STEPS(steps_on), false };
+static const alert_pattern_t pattern_advertising =
+    { steps_advertising, ALERT_PATTERN_STEPS(steps_advertising), true };
+static const alert_pattern_t pattern_mild =
+    { steps_mild, ALERT_PATTERN_STEPS(steps_mild), true };
+static const alert_pattern_t pattern_high =
+    { steps_high, ALERT_PATTERN_STEPS(steps_high), true };
+
+#if defined(STATUS_LED_BUZZER_PIN)
+static cyhal_pwm_t buzzer_pwm;
+static bool buzzer_on = false;
+#endif
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void status_led_set_outputs(alert_channel_t channel, uint8_t outputs);
+
+static const alert_backend_t status_led_backend =
+{
+    .set_outputs = status_led_set_outputs
+};
+
+
+/*******************************************************************************
+* Function Name: status_led_init
+********************************************************************************
+* Summary:
+*  Turns both LEDs off. The LED GPIOs are initialized in main(); the buzzer
+*  PWM, if configured, is initialized here. Must be called after
+*  app_timer_init() and settings_init().
+*
+*******************************************************************************/
+void status_led_init(void)
+{
+#if defined(STATUS_LED_BUZZER_PIN)
+    (void)cyhal_pwm_init(&buzzer_pwm, (cyhal_gpio_t)STATUS_LED_BUZZER_PIN, NULL);
+    (void)cyhal_pwm_set_duty_cycle(&buzzer_pwm, 50.0f, STATUS_LED_BUZZER_HZ);
+#endif
+
+    steps_mild[0].duration_ms = (uint16_t)settings_get(SETTINGS_ALERT_MILD_ON_MS);
+    steps_mild[1].duration_ms = (uint16_t)settings_get(SETTINGS_ALERT_MILD_OFF_MS);
+
+    alert_pattern_init(&status_led_backend);
+}
+
+
+/*******************************************************************************
+* Function Name: status_led_update
+********************************************************************************
+* Summary:
+*  Selects the patterns shown for the link state and the alert level. Must be
+*  called whenever one of them changes.
+*
+*  CYBSP_USER_LED1: flashing while advertising, ON while connected, else OFF.
+*  CYBSP_USER_LED2: OFF, blinking and ON for no, mild and high alert.
+*
+* Parameters:
+*  status_link_t link:  current BLE link state
+*  uint8_t alert_level: current Alert Level of the Immediate Alert Service
+*
+*******************************************************************************/
+void status_led_update(status_link_t link, uint8_t alert_level)
+{
+    const alert_pattern_t *pattern;
+
+    switch(link)
+    {
+        case STATUS_LINK_ADVERTISING:
+        {
+            pattern = &pattern_advertising;
+            break;
+        }
+        case STATUS_LINK_CONNECTED:
+        {
+            pattern = &pattern_on;
+            break;
+        }
+        default:
+        {
+            pattern = &pattern_off;
+            break;
+        }
+    }
+    alert_pattern_play(ALERT_CHANNEL_LINK, pattern);
+
+    switch(alert_level)
+    {
+        case CY_BLE_MILD_ALERT:
+        {
+            pattern = &pattern_mild;
+            break;
+        }
+        case CY_BLE_HIGH_ALERT:
+        {
+            pattern = &pattern_high;
+            break;
+        }
+        default:
+        {
+            pattern = &pattern_off;
+            break;
+        }
+    }
+    alert_pattern_play(ALERT_CHANNEL_ALERT, pattern);
+}
+
+
+/*******************************************************************************
+* Function Name: status_led_off
+********************************************************************************
+* Summary:
+*  Turns both LEDs and the buzzer off and stops the pattern timer.
+*
+*******************************************************************************/
+void status_led_off(void)
+{
+    status_led_update(STATUS_LINK_IDLE, CY_BLE_NO_ALERT);
+}
+
+
+/*******************************************************************************
+* Function Name: status_led_set_outputs
+********************************************************************************
+* Summary:
+*  Pattern engine backend. Drives the LED of a channel and the buzzer.
+*
+* Parameters:
+*  alert_channel_t channel: channel
+*  uint8_t outputs:         ALERT_OUTPUT_* bits to turn on
+*
+*******************************************************************************/
+static void status_led_set_outputs(alert_channel_t channel, uint8_t outputs)
+{
+    cyhal_gpio_write(status_led_pins[channel],
+                     (0u != (outputs & ALERT_OUTPUT_LED)) ?
+                     CYBSP_LED_STATE_ON : CYBSP_LED_STATE_OFF);
+
+#if defined(STATUS_LED_BUZZER_PIN)
+    if(ALERT_CHANNEL_ALERT == channel)
+    {
+        bool on = (0u != (outputs & ALERT_OUTPUT_BUZZER));
+
+        if(on && !buzzer_on)
+        {
+            /* The TCPWM needs the high-frequency clock */
+            cyhal_syspm_lock_deepsleep();
+            (void)cyhal_pwm_start(&buzzer_pwm);
+        }
+        else if(!on && buzzer_on)
+        {
+            (void)cyhal_pwm_stop(&buzzer_pwm);
+            cyhal_syspm_unlock_deepsleep();
+        }
+        else
+        {
+            /* No change */
+        }
+
+        buzzer_on = on;
+    }
+#endif
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name: status_led.h
+*
+* Description: This file is the public interface of status_led.c
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef STATUS_LED_H
+#define STATUS_LED_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Default on and off time of the mild alert blink; tunable through the
+ * settings store
+ */
+#ifndef STATUS_LED_MILD_ON_MS
+#define STATUS_LED_MILD_ON_MS     (250u)
+#endif
+
+#ifndef STATUS_LED_MILD_OFF_MS
+#define STATUS_LED_MILD_OFF_MS    (750u)
+#endif
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* BLE link state shown on CYBSP_USER_LED1 */
+typedef enum
+{
+    STATUS_LINK_IDLE,
+    STATUS_LINK_ADVERTISING,
+    STATUS_LINK_CONNECTED
+} status_link_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void status_led_init(void);
+void status_led_update(status_link_t link, uint8_t alert_level);
+void status_led_off(void);
+
+
+#endif  /* STATUS_LED_H */
+
+
+/* [] END OF FILE */
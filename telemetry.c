@@ -0,0 +1,777 @@
+/******************************************************************************
+* File Name: telemetry.c
+*
+* Description: This file contains the telemetry stream. While a Central is
+*              subscribed to the Stream characteristic of the vendor Telemetry
+*              service, snapshots of the device statistics and every log
+*              record are framed into a byte ring and sent as notifications
+*              that are packed up to the negotiated ATT MTU. The stack's
+*              buffer status paces the stream, so the application never waits
+*              on the radio.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "telemetry.h"
+#include "app_log.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "conn_param.h"
+#include "phy_policy.h"
+#include "power_stats.h"
+#include "profiler.h"
+#include "proximity.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TELEMETRY_RING_MASK       (TELEMETRY_RING_SIZE - 1u)
+
+#if ((TELEMETRY_RING_SIZE & TELEMETRY_RING_MASK) != 0u)
+#error "TELEMETRY_RING_SIZE must be a power of two"
+#endif
+
+/* ATT header of a notification: opcode and attribute handle */
+#define TELEMETRY_ATT_HEADER      (3u)
+
+/* Largest notification value; the first byte is a sequence number */
+#define TELEMETRY_NTF_MAX         (CY_BLE_GATT_MTU - TELEMETRY_ATT_HEADER)
+
+/* Fill bytes streamed after each subscription to measure the throughput.
+ * 0 disables the benchmark.
+ */
+#ifndef TELEMETRY_BENCHMARK_BYTES
+#define TELEMETRY_BENCHMARK_BYTES (0u)
+#endif
+
+#define TELEMETRY_FILL_CHUNK      (64u)
+
+/* Connection interval unit in us */
+#define TELEMETRY_CONN_INTV_US    (1250u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    uint16_t mtu;
+    bool     in_use;
+} telemetry_link_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void telemetry_evt_connect(uint32_t event, void *eventParam);
+static void telemetry_evt_disconnect(uint32_t event, void *eventParam);
+static void telemetry_evt_data_length(uint32_t event, void *eventParam);
+static void telemetry_evt_mtu(uint32_t event, void *eventParam);
+static void telemetry_evt_write(uint32_t event, void *eventParam);
+static void telemetry_evt_busy(uint32_t event, void *eventParam);
+static void telemetry_subscribe(cy_stc_ble_conn_handle_t peer);
+static void telemetry_unsubscribe(void);
+static bool telemetry_snapshot_task(void *arg);
+static void telemetry_snapshot(void);
+static void telemetry_log_tap(uint8_t level, app_log_id_t id, uint32_t arg);
+static bool telemetry_push(telemetry_frame_t type, const uint8_t *payload, uint32_t length);
+static void telemetry_fill(void);
+static void telemetry_update_rates(void);
+static uint8_t* telemetry_put_u32(uint8_t *dst, uint32_t value);
+
+
+/*******************************************************************************
+* BLE event handler table
+********************************************************************************/
+static const ble_dispatch_entry_t telemetry_event_table[] =
+{
+    { CY_BLE_EVT_GATT_CONNECT_IND,               telemetry_evt_connect },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND,            telemetry_evt_disconnect },
+    { CY_BLE_EVT_DATA_LENGTH_CHANGE,             telemetry_evt_data_length },
+    { CY_BLE_EVT_GATTS_XCNHG_MTU_REQ,            telemetry_evt_mtu },
+    { CY_BLE_EVT_GATTC_XCHNG_MTU_RSP,            telemetry_evt_mtu },
+    { CY_BLE_EVT_GATTS_WRITE_REQ,                telemetry_evt_write },
+    { CY_BLE_EVT_STACK_BUSY_STATUS,              telemetry_evt_busy },
+};
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static telemetry_link_t telemetry_links[CY_BLE_CONN_COUNT];
+
+/* Stream ring. Written by the snapshot timer and the log tap, read by
+ * telemetry_process(), all from the main loop.
+ */
+static uint8_t telemetry_ring[TELEMETRY_RING_SIZE];
+static uint32_t telemetry_wr;
+static uint32_t telemetry_rd;
+
+static cy_stc_ble_conn_handle_t telemetry_peer;
+static bool telemetry_subscribed;
+static bool telemetry_busy;
+static uint8_t telemetry_sequence;
+static uint32_t telemetry_fill_left;
+static bool telemetry_benchmark;
+static app_sched_task_t telemetry_task;
+
+/* Ticks of the first and the last notification of the subscription */
+static uint32_t telemetry_first_ticks;
+static uint32_t telemetry_last_ticks;
+
+static telemetry_stats_t telemetry_stats;
+
+
+/*******************************************************************************
+* Function Name: telemetry_init
+********************************************************************************
+* Summary:
+*  Registers the link and GATT event handlers and adds the snapshot task to
+*  the scheduler. Must be called after ble_dispatch_init() and
+*  app_sched_init().
+*
+*******************************************************************************/
+void telemetry_init(void)
+{
+    (void)memset(telemetry_links, 0, sizeof(telemetry_links));
+    (void)memset(&telemetry_stats, 0, sizeof(telemetry_stats));
+    telemetry_subscribed = false;
+    telemetry_busy = false;
+
+    app_sched_add(&telemetry_task, telemetry_snapshot_task, NULL, APP_SCHED_PRIO_OUTPUT, false);
+
+    if(!ble_dispatch_register(telemetry_event_table,
+                              BLE_DISPATCH_COUNT(telemetry_event_table)))
+    {
+        CY_ASSERT(0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_process
+********************************************************************************
+* Summary:
+*  Sends the buffered stream as notifications. Each notification carries a
+*  sequence number followed by as many stream bytes as the MTU of the link
+*  allows; frames may span notifications. Sending stops as soon as the stack
+*  reports its buffers full and resumes with CY_BLE_EVT_STACK_BUSY_STATUS, so
+*  the stack is kept fed on every connection event without polling.
+*
+*******************************************************************************/
+void telemetry_process(void)
+{
+    static uint8_t value[TELEMETRY_NTF_MAX];
+    cy_stc_ble_gatts_handle_value_ntf_t ntf;
+    uint32_t capacity;
+    uint32_t length;
+    uint32_t i;
+
+    if(!telemetry_subscribed)
+    {
+        return;
+    }
+
+    capacity = (uint32_t)telemetry_links[telemetry_peer.attId].mtu - TELEMETRY_ATT_HEADER;
+
+    while(!telemetry_busy)
+    {
+        telemetry_fill();
+
+        length = telemetry_wr - telemetry_rd;
+        if(0u == length)
+        {
+            break;
+        }
+
+        if(length > (capacity - 1u))
+        {
+            length = capacity - 1u;
+        }
+
+        value[0] = telemetry_sequence;
+        for(i = 0u; i < length; i++)
+        {
+            value[1u + i] = telemetry_ring[(telemetry_rd + i) & TELEMETRY_RING_MASK];
+        }
+
+        ntf.connHandle = telemetry_peer;
+        ntf.handleValPair.attrHandle = CY_BLE_TELEMETRY_STREAM_CHAR_HANDLE;
+        ntf.handleValPair.value.val = value;
+        ntf.handleValPair.value.len = (uint16_t)(1u + length);
+
+        if(CY_BLE_SUCCESS != Cy_BLE_GATTS_Notification(&ntf))
+        {
+            break;
+        }
+
+        telemetry_rd += length;
+        telemetry_sequence++;
+
+        telemetry_last_ticks = app_timer_now();
+        if(0u == telemetry_stats.notifications)
+        {
+            telemetry_first_ticks = telemetry_last_ticks;
+        }
+        telemetry_stats.notifications++;
+        telemetry_stats.bytes += 1u + length;
+
+        if(CY_BLE_STACK_STATE_BUSY == Cy_BLE_GATT_GetBusyStatus(telemetry_peer.attId))
+        {
+            telemetry_busy = true;
+            telemetry_stats.busy++;
+        }
+    }
+
+#if (TELEMETRY_BENCHMARK_BYTES != 0u)
+    if(telemetry_benchmark && (0u == telemetry_fill_left) && (telemetry_wr == telemetry_rd))
+    {
+        /* All fill bytes are with the stack */
+        telemetry_benchmark = false;
+        telemetry_update_rates();
+        APP_LOG_INFO(TELEMETRY_RATE, telemetry_stats.bytes_per_sec);
+        APP_LOG_INFO(TELEMETRY_NTF_EVT, telemetry_stats.ntf_per_100_evt);
+    }
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_get_stats
+********************************************************************************
+* Summary:
+*  Copies the stream counters and the throughput measured from the first to
+*  the last notification of the current or last subscription.
+*
+* Parameters:
+*  telemetry_stats_t *stats: destination
+*
+*******************************************************************************/
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    if(telemetry_subscribed)
+    {
+        telemetry_update_rates();
+    }
+
+    *stats = telemetry_stats;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_connect
+********************************************************************************
+* Summary:
+*  Starts a link at the default MTU and asks the controller for the longest
+*  link layer payload. The MTU is raised by the exchange that the Central
+*  usually starts, or by telemetry_subscribe().
+*
+*******************************************************************************/
+static void telemetry_evt_connect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+    cy_stc_ble_set_data_length_info_t data_length =
+    {
+        .bdHandle        = handle->bdHandle,
+        .connMaxTxOctets = TELEMETRY_DLE_OCTETS,
+        .connMaxTxTime   = TELEMETRY_DLE_TIME_US
+    };
+
+    (void)event;
+
+    if(handle->attId < CY_BLE_CONN_COUNT)
+    {
+        telemetry_links[handle->attId].mtu = CY_BLE_GATT_DEFAULT_MTU;
+        telemetry_links[handle->attId].in_use = true;
+
+        (void)Cy_BLE_SetDataLength(&data_length);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_disconnect
+********************************************************************************
+* Summary:
+*  Ends the subscription of a closed link.
+*
+*******************************************************************************/
+static void telemetry_evt_disconnect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+
+    (void)event;
+
+    if(handle->attId < CY_BLE_CONN_COUNT)
+    {
+        telemetry_links[handle->attId].in_use = false;
+
+        if(telemetry_subscribed && (telemetry_peer.attId == handle->attId))
+        {
+            telemetry_unsubscribe();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_data_length
+********************************************************************************
+* Summary:
+*  Reports the link layer payload agreed with the peer.
+*
+*******************************************************************************/
+static void telemetry_evt_data_length(uint32_t event, void *eventParam)
+{
+    (void)event;
+    (void)eventParam;
+
+    APP_LOG_INFO(DATA_LENGTH,
+                 ((cy_stc_ble_data_length_change_info_t *)eventParam)->connMaxTxOctets);
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_mtu
+********************************************************************************
+* Summary:
+*  Records the MTU of a link after an exchange started by either side. The
+*  stack answers a request with the MTU of the configuration; the MTU in use
+*  is the smaller of the two.
+*
+*******************************************************************************/
+static void telemetry_evt_mtu(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatt_xchg_mtu_param_t *param = (cy_stc_ble_gatt_xchg_mtu_param_t *)eventParam;
+    uint16_t mtu = (param->mtu < CY_BLE_GATT_MTU) ? param->mtu : (uint16_t)CY_BLE_GATT_MTU;
+
+    (void)event;
+
+    if((param->connHandle.attId < CY_BLE_CONN_COUNT) && (mtu >= CY_BLE_GATT_DEFAULT_MTU))
+    {
+        telemetry_links[param->connHandle.attId].mtu = mtu;
+        APP_LOG_INFO(ATT_MTU, mtu);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_write
+********************************************************************************
+* Summary:
+*  Handles writes to the client configuration of the Stream characteristic.
+*  One link at a time can subscribe; a second one is refused until the first
+*  unsubscribes or disconnects.
+*
+*******************************************************************************/
+static void telemetry_evt_write(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatts_write_cmd_req_param_t *write_req =
+        (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParam;
+    cy_stc_ble_gatts_db_attr_val_info_t cccd =
+    {
+        .handleValuePair = write_req->handleValPair,
+        .connHandle      = write_req->connHandle,
+        .offset          = 0u,
+        .flags           = CY_BLE_GATT_DB_PEER_INITIATED
+    };
+    cy_stc_ble_gatt_err_param_t error =
+    {
+        .errInfo.opCode     = CY_BLE_GATT_WRITE_REQ,
+        .errInfo.attrHandle = CY_BLE_TELEMETRY_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE,
+        .connHandle         = write_req->connHandle
+    };
+    bool enable;
+    bool other;
+
+    (void)event;
+
+    if(CY_BLE_TELEMETRY_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE !=
+       write_req->handleValPair.attrHandle)
+    {
+        return;
+    }
+
+    enable = (write_req->handleValPair.value.len > 0u) &&
+             (0u != (write_req->handleValPair.value.val[0] & CY_BLE_CCCD_NOTIFICATION));
+    other = telemetry_subscribed && (telemetry_peer.attId != write_req->connHandle.attId);
+
+    if(enable && other)
+    {
+        error.errInfo.errorCode = CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+        (void)Cy_BLE_GATTS_ErrorRsp(&error);
+        return;
+    }
+
+    if(CY_BLE_GATT_ERR_NONE != Cy_BLE_GATTS_WriteAttributeValueCCCD(&cccd))
+    {
+        error.errInfo.errorCode = CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+        (void)Cy_BLE_GATTS_ErrorRsp(&error);
+        return;
+    }
+
+    (void)Cy_BLE_GATTS_WriteRsp(write_req->connHandle);
+
+    if(enable && !telemetry_subscribed)
+    {
+        telemetry_subscribe(write_req->connHandle);
+    }
+    else if(!enable && telemetry_subscribed && !other)
+    {
+        telemetry_unsubscribe();
+    }
+    else
+    {
+        /* No change of subscription */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_evt_busy
+********************************************************************************
+* Summary:
+*  Pauses the stream while the stack buffers are full. The stream resumes
+*  on the next telemetry_process() after the buffers drain.
+*
+*******************************************************************************/
+static void telemetry_evt_busy(uint32_t event, void *eventParam)
+{
+    (void)event;
+
+    telemetry_busy = (CY_BLE_STACK_STATE_BUSY == *(uint8_t *)eventParam);
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_subscribe
+********************************************************************************
+* Summary:
+*  Starts streaming to a link: raises the MTU if the Central has not done
+*  so, queues a first snapshot, and forwards the log from now on.
+*
+*******************************************************************************/
+static void telemetry_subscribe(cy_stc_ble_conn_handle_t peer)
+{
+    cy_stc_ble_gatt_xchg_mtu_param_t mtu_req =
+    {
+        .connHandle = peer,
+        .mtu        = CY_BLE_GATT_MTU
+    };
+
+    if(CY_BLE_GATT_DEFAULT_MTU == telemetry_links[peer.attId].mtu)
+    {
+        (void)Cy_BLE_GATTC_ExchangeMtuReq(&mtu_req);
+    }
+
+    telemetry_peer = peer;
+    telemetry_subscribed = true;
+    telemetry_wr = 0u;
+    telemetry_rd = 0u;
+    telemetry_sequence = 0u;
+    telemetry_fill_left = TELEMETRY_BENCHMARK_BYTES;
+    telemetry_benchmark = (0u != TELEMETRY_BENCHMARK_BYTES);
+    telemetry_stats.bytes = 0u;
+    telemetry_stats.notifications = 0u;
+    telemetry_stats.bytes_per_sec = 0u;
+    telemetry_stats.ntf_per_100_evt = 0u;
+
+    (void)telemetry_snapshot_task(NULL);
+    app_log_set_tap(telemetry_log_tap);
+
+    /* Stream on the short interval */
+    conn_param_hold(peer, true);
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_unsubscribe
+********************************************************************************
+* Summary:
+*  Stops the stream and reports its throughput.
+*
+*******************************************************************************/
+static void telemetry_unsubscribe(void)
+{
+    conn_param_hold(telemetry_peer, false);
+    app_log_set_tap(NULL);
+    app_sched_cancel(&telemetry_task);
+    telemetry_update_rates();
+    telemetry_subscribed = false;
+    telemetry_busy = false;
+
+    APP_LOG_INFO(TELEMETRY_RATE, telemetry_stats.bytes_per_sec);
+    APP_LOG_INFO(TELEMETRY_NTF_EVT, telemetry_stats.ntf_per_100_evt);
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_snapshot_task
+********************************************************************************
+* Summary:
+*  Queues a snapshot and schedules the next one TELEMETRY_PERIOD_MS later.
+*  The snapshot may wait for another wakeup for up to a quarter of the
+*  period, so it does not add wakeups of its own while the link is busy.
+*
+*******************************************************************************/
+static bool telemetry_snapshot_task(void *arg)
+{
+    uint32_t period = APP_TIMER_MS_TO_TICKS(TELEMETRY_PERIOD_MS);
+
+    (void)arg;
+
+    telemetry_snapshot();
+    app_sched_wake(&telemetry_task, period, APP_SCHED_SLACK(period));
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_snapshot
+********************************************************************************
+* Summary:
+*  Queues the power statistics, the profiler summaries, the RSSI filter
+*  statistics, the connection parameter statistics and the PHY statistics.
+*  The statistics are written field by field in little-endian order, in the
+*  frame layouts of telemetry.h. Called at subscription and every
+*  TELEMETRY_PERIOD_MS.
+*
+*******************************************************************************/
+static void telemetry_snapshot(void)
+{
+    static uint8_t report[POWER_STATS_REPORT_SIZE];
+#if (PROFILER_ENABLE != 0u)
+    static uint8_t histograms[PROFILER_REPORT_SIZE];
+#endif
+    uint8_t stats[TELEMETRY_STATS_MAX_SIZE];
+    uint8_t *dst;
+    proximity_stats_t proximity;
+    conn_param_stats_t conn;
+    phy_policy_stats_t phy;
+    uint32_t length;
+
+    length = power_stats_serialize(report);
+    (void)telemetry_push(TELEMETRY_FRAME_POWER, report, length);
+
+#if (PROFILER_ENABLE != 0u)
+    length = profiler_serialize(histograms);
+    (void)telemetry_push(TELEMETRY_FRAME_PROFILER, histograms, length);
+#endif
+
+    proximity_get_stats(&proximity);
+    dst = stats;
+    dst = telemetry_put_u32(dst, proximity.samples);
+    dst = telemetry_put_u32(dst, proximity.cycles_total);
+    dst = telemetry_put_u32(dst, proximity.cycles_max);
+    (void)telemetry_push(TELEMETRY_FRAME_PROXIMITY, stats, (uint32_t)(dst - stats));
+
+    conn_param_get_stats(&conn);
+    dst = stats;
+    dst = telemetry_put_u32(dst, conn.requests);
+    dst = telemetry_put_u32(dst, conn.accepted);
+    dst = telemetry_put_u32(dst, conn.rejected);
+    dst = telemetry_put_u32(dst, conn.radio_events);
+    dst = telemetry_put_u32(dst, conn.central_events);
+    dst = telemetry_put_u32(dst, conn.alert_latency_ms);
+    (void)telemetry_push(TELEMETRY_FRAME_CONN_PARAM, stats, (uint32_t)(dst - stats));
+
+    phy_policy_get_stats(&phy);
+    dst = stats;
+    dst = telemetry_put_u32(dst, phy.requests);
+    dst = telemetry_put_u32(dst, phy.upgrades);
+    dst = telemetry_put_u32(dst, phy.fallbacks);
+    dst = telemetry_put_u32(dst, phy.refused);
+    dst = telemetry_put_u32(dst, phy.ms_1m);
+    dst = telemetry_put_u32(dst, phy.ms_2m);
+    (void)telemetry_push(TELEMETRY_FRAME_PHY, stats, (uint32_t)(dst - stats));
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_log_tap
+********************************************************************************
+* Summary:
+*  Queues a log record in the same binary format as the debug UART, so that
+*  tools/app_log_decode.py decodes both.
+*
+*******************************************************************************/
+static void telemetry_log_tap(uint8_t level, app_log_id_t id, uint32_t arg)
+{
+    uint8_t wire[APP_LOG_WIRE_SIZE];
+    uint32_t length = app_log_encode(level, id, arg, wire);
+
+    (void)telemetry_push(TELEMETRY_FRAME_LOG, wire, length);
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_push
+********************************************************************************
+* Summary:
+*  Appends a frame to the stream ring. A frame that does not fit is dropped
+*  whole, so the Central never sees a partial frame.
+*
+* Parameters:
+*  telemetry_frame_t type:  frame type
+*  const uint8_t *payload:  frame payload, at most 255 bytes
+*  uint32_t length:         payload length
+*
+* Return:
+*  bool: true if the frame was queued
+*
+*******************************************************************************/
+static bool telemetry_push(telemetry_frame_t type, const uint8_t *payload, uint32_t length)
+{
+    uint32_t i;
+
+    if((TELEMETRY_RING_SIZE - (telemetry_wr - telemetry_rd)) < (TELEMETRY_FRAME_HEADER + length))
+    {
+        telemetry_stats.dropped++;
+        return false;
+    }
+
+    telemetry_ring[telemetry_wr & TELEMETRY_RING_MASK] = (uint8_t)type;
+    telemetry_ring[(telemetry_wr + 1u) & TELEMETRY_RING_MASK] = (uint8_t)length;
+
+    for(i = 0u; i < length; i++)
+    {
+        telemetry_ring[(telemetry_wr + TELEMETRY_FRAME_HEADER + i) & TELEMETRY_RING_MASK] = payload[i];
+    }
+
+    telemetry_wr += TELEMETRY_FRAME_HEADER + length;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_fill
+********************************************************************************
+* Summary:
+*  Tops up the ring with the fill frames of the throughput benchmark. The
+*  fill only uses the free space, so statistics and log frames are not
+*  crowded out.
+*
+*******************************************************************************/
+static void telemetry_fill(void)
+{
+#if (TELEMETRY_BENCHMARK_BYTES != 0u)
+    static uint8_t pattern[TELEMETRY_FILL_CHUNK];
+    uint32_t length;
+    uint32_t i;
+
+    while(0u != telemetry_fill_left)
+    {
+        length = (telemetry_fill_left < TELEMETRY_FILL_CHUNK) ? telemetry_fill_left :
+                                                                 TELEMETRY_FILL_CHUNK;
+        for(i = 0u; i < length; i++)
+        {
+            pattern[i] = (uint8_t)(telemetry_fill_left - i);
+        }
+
+        if((TELEMETRY_RING_SIZE - (telemetry_wr - telemetry_rd)) < (TELEMETRY_FRAME_HEADER + length))
+        {
+            break;
+        }
+
+        (void)telemetry_push(TELEMETRY_FRAME_FILL, pattern, length);
+        telemetry_fill_left -= length;
+    }
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_update_rates
+********************************************************************************
+* Summary:
+*  Computes the throughput from the first to the last notification, and the
+*  average number of notifications per connection event from the current
+*  connection interval of the subscribed link.
+*
+*******************************************************************************/
+static void telemetry_update_rates(void)
+{
+    uint32_t ticks = telemetry_last_ticks - telemetry_first_ticks;
+    uint32_t conn_intv = conn_param_interval(telemetry_peer);
+    uint64_t events;
+
+    if((0u == ticks) || (0u == telemetry_stats.notifications))
+    {
+        return;
+    }
+
+    telemetry_stats.bytes_per_sec =
+        (uint32_t)(((uint64_t)telemetry_stats.bytes * APP_TIMER_TICKS_PER_SEC) / ticks);
+
+    if(0u != conn_intv)
+    {
+        events = ((uint64_t)ticks * 1000000u) /
+                 ((uint64_t)APP_TIMER_TICKS_PER_SEC * conn_intv * TELEMETRY_CONN_INTV_US);
+        telemetry_stats.ntf_per_100_evt = (0u == events) ? 0u :
+            (uint32_t)(((uint64_t)telemetry_stats.notifications * 100u) / events);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: telemetry_put_u32
+********************************************************************************
+* Summary:
+*  Stores a 32-bit value in little-endian order.
+*
+*******************************************************************************/
+static uint8_t* telemetry_put_u32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)(value);
+    dst[1] = (uint8_t)(value >> 8u);
+    dst[2] = (uint8_t)(value >> 16u);
+    dst[3] = (uint8_t)(value >> 24u);
+
+    return &dst[4];
+}
+
+
+/* [] END OF FILE */
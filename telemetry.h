@@ -0,0 +1,128 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Description: This file is the public interface of telemetry.c, the
+*              notification stream of device statistics and log records.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Period of the statistics snapshots while a Central is subscribed */
+#ifndef TELEMETRY_PERIOD_MS
+#define TELEMETRY_PERIOD_MS       (1000u)
+#endif
+
+/* Bytes buffered for the stream. Must be a power of two. */
+#ifndef TELEMETRY_RING_SIZE
+#define TELEMETRY_RING_SIZE       (1024u)
+#endif
+
+/* Link layer payload requested on every link: 251 octets, and the time to
+ * send them on the 1M PHY, (251 + 14) x 8 us
+ */
+#define TELEMETRY_DLE_OCTETS      (251u)
+#define TELEMETRY_DLE_TIME_US     (2120u)
+
+/* Every frame of the stream is a type byte, a length byte and the payload */
+#define TELEMETRY_FRAME_HEADER    (2u)
+
+/* Largest payload of the statistics frames below */
+#define TELEMETRY_STATS_MAX_SIZE  (24u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+/* Frame types and payloads. All fields are little-endian and packed, in the
+ * order given, independent of the layout of the C structures:
+ *
+ *  PROXIMITY   samples, cycles_total, cycles_max (3 x uint32)
+ *  CONN_PARAM  requests, accepted, rejected, radio_events, central_events,
+ *              alert_latency_ms (6 x uint32)
+ *  PHY         requests, upgrades, fallbacks, refused, ms_1m, ms_2m
+ *              (6 x uint32)
+ */
+typedef enum
+{
+    TELEMETRY_FRAME_POWER = 1,    /* power_stats_serialize() report */
+    TELEMETRY_FRAME_PROFILER,     /* profiler_serialize() report */
+    TELEMETRY_FRAME_PROXIMITY,    /* proximity_stats_t fields */
+    TELEMETRY_FRAME_LOG,          /* app_log_encode() records */
+    TELEMETRY_FRAME_FILL,         /* throughput benchmark filler */
+    TELEMETRY_FRAME_CONN_PARAM,   /* conn_param_stats_t fields */
+    TELEMETRY_FRAME_PHY           /* phy_policy_stats_t fields */
+} telemetry_frame_t;
+
+typedef struct
+{
+    uint32_t bytes;           /* stream bytes notified */
+    uint32_t notifications;   /* notifications sent */
+    uint32_t busy;            /* times the stack buffers were full */
+    uint32_t dropped;         /* frames lost because the ring was full */
+    uint32_t bytes_per_sec;   /* over the current or last subscription */
+    uint32_t ntf_per_100_evt; /* notifications per 100 connection events */
+} telemetry_stats_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+void telemetry_init(void);
+void telemetry_process(void);
+void telemetry_get_stats(telemetry_stats_t *stats);
+
+
+#endif  /* TELEMETRY_H */
+
+
+/* [] END OF FILE */
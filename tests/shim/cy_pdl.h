@@ -0,0 +1,229 @@
+/******************************************************************************
+* File Name: cy_pdl.h
+*
+* Description: This file stands in for the PDL header in the host tests. It
+*              only provides what the modules under test use: the exclusive
+*              load/store pair and barrier of app_event.c, emulated with
+*              compiler atomics, the flash row and section macros of
+*              settings.c, the DWT cycle counter of cycle_counter.h, the
+*              critical sections and core clock of profiler.c,
+*              CY_ASSERT, and the interrupt, reset reason, backup register
+*              and RTC calls of ble_findme.c and boot_state.c, which the
+*              simulation of test_findme.c implements.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CY_PDL_H
+#define CY_PDL_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <assert.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define CY_FLASH_SIZEOF_ROW       (512u)
+
+/* The flash ring of settings.c is const in the firmware and written by the
+ * BLE stack. Placing it in a .data section keeps it writable on the host.
+ */
+#define CY_SECTION(name)          __attribute__((section(".data" name)))
+#define CY_ALIGN(align)           __attribute__((aligned(align)))
+
+/* Aborts the test program, so that a failed registration is not missed */
+#define CY_ASSERT(x)              assert(x)
+
+
+/******************************************************************************
+ * Exclusive access
+ *****************************************************************************/
+/* Value seen by the last exclusive load of this thread. The store succeeds
+ * only if the word still holds it, which stands in for the exclusive
+ * monitor: another producer that claimed the word in between makes the
+ * store fail and the caller retry.
+ */
+static __thread uint32_t shim_exclusive_value;
+
+static inline uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    shim_exclusive_value = __atomic_load_n(addr, __ATOMIC_SEQ_CST);
+    return shim_exclusive_value;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    uint32_t expected = shim_exclusive_value;
+
+    return __atomic_compare_exchange_n(addr, &expected, value, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 0u : 1u;
+}
+
+static inline void __CLREX(void)
+{
+}
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+
+/******************************************************************************
+ * Cycle counter
+ *****************************************************************************/
+#define CoreDebug_DEMCR_TRCENA_Msk    (1uL << 24u)
+#define DWT_CTRL_CYCCNTENA_Msk        (1uL)
+
+typedef struct
+{
+    uint32_t DEMCR;
+} shim_core_debug_t;
+
+typedef struct
+{
+    uint32_t CTRL;
+    uint32_t CYCCNT;
+} shim_dwt_t;
+
+static inline shim_core_debug_t* shim_core_debug(void)
+{
+    static shim_core_debug_t regs;
+
+    return &regs;
+}
+
+/* CYCCNT counts host nanoseconds, so the cycle figures that the modules
+ * collect read as ns in the host tests.
+ */
+static inline shim_dwt_t* shim_dwt(void)
+{
+    static shim_dwt_t regs;
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    regs.CYCCNT = (uint32_t)(((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+
+    return &regs;
+}
+
+#define CoreDebug                 (shim_core_debug())
+#define DWT                       (shim_dwt())
+
+
+/******************************************************************************
+ * System
+ *****************************************************************************/
+/* Defined by the tests that print it */
+extern uint32_t SystemCoreClock;
+
+/* The modules under test run on one thread, with no interrupt to mask */
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+static inline void __enable_irq(void)
+{
+}
+
+#define CY_SYSLIB_RESET_HIB_WAKEUP    (0x40000uL)
+
+uint32_t Cy_SysLib_GetResetReason(void);
+
+
+/******************************************************************************
+ * Interrupts
+ *****************************************************************************/
+typedef enum
+{
+    bless_interrupt_IRQn = 24
+} IRQn_Type;
+
+typedef enum
+{
+    CY_SYSINT_SUCCESS = 0x00,
+    CY_SYSINT_BAD_PARAM = 0x01
+} cy_en_sysint_status_t;
+
+typedef struct
+{
+    IRQn_Type intrSrc;
+    uint32_t  intrPriority;
+} cy_stc_sysint_t;
+
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, void (*userIsr)(void));
+
+
+/******************************************************************************
+ * Backup domain
+ *****************************************************************************/
+#define CY_RTC_INTR_ALARM1            (0x1u)
+#define CY_RTC_INTR_ALARM2            (0x2u)
+
+typedef struct
+{
+    volatile uint32_t BREG[16];
+} BACKUP_Type;
+
+/* Defined by the tests that retain state across a hibernate */
+extern BACKUP_Type shim_backup;
+
+#define BACKUP                        (&shim_backup)
+
+uint32_t Cy_RTC_GetInterruptStatus(void);
+void Cy_RTC_ClearInterrupt(uint32_t clearMask);
+
+
+#endif  /* CY_PDL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,573 @@
+/******************************************************************************
+* File Name: cycfg_ble.h
+*
+* Description: This file stands in for the generated BLE configuration and
+*              the BLE stack API in the host tests. It only declares what
+*              the application uses; the tests implement the functions, and
+*              test_findme.c implements all of them on a virtual stack.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CYCFG_BLE_H
+#define CYCFG_BLE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "cy_pdl.h"
+#include <stdint.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+#define CY_BLE_EVT_STACK_ON                     (0x01u)
+#define CY_BLE_EVT_TIMEOUT                      (0x02u)
+#define CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE   (0x05u)
+#define CY_BLE_EVT_STACK_BUSY_STATUS            (0x07u)
+#define CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE     (0x08u)
+#define CY_BLE_EVT_SET_TX_PWR_COMPLETE          (0x09u)
+#define CY_BLE_EVT_STACK_SHUTDOWN_COMPLETE      (0x0Au)
+#define CY_BLE_EVT_GET_RSSI_COMPLETE            (0x0Du)
+#define CY_BLE_EVT_DATA_LENGTH_CHANGE           (0x0Eu)
+#define CY_BLE_EVT_SET_PHY_COMPLETE             (0x10u)
+#define CY_BLE_EVT_PHY_UPDATE_COMPLETE          (0x11u)
+#define CY_BLE_EVT_GAP_DEVICE_CONNECTED         (0x20u)
+#define CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE    (0x21u)
+#define CY_BLE_EVT_GAP_DEVICE_DISCONNECTED      (0x22u)
+#define CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP    (0x23u)
+#define CY_BLE_EVT_GAP_AUTH_REQ                 (0x24u)
+#define CY_BLE_EVT_GAP_AUTH_COMPLETE            (0x25u)
+#define CY_BLE_EVT_GAP_AUTH_FAILED              (0x26u)
+#define CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE   (0x29u)
+#define CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT    (0x2Au)
+#define CY_BLE_EVT_GAPC_SCAN_START_STOP         (0x2Bu)
+#define CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP  (0x2Du)
+#define CY_BLE_EVT_GATT_CONNECT_IND             (0x40u)
+#define CY_BLE_EVT_GATT_DISCONNECT_IND          (0x41u)
+#define CY_BLE_EVT_GATTS_XCNHG_MTU_REQ          (0x42u)
+#define CY_BLE_EVT_GATTS_WRITE_REQ              (0x47u)
+#define CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ   (0x4Bu)
+#define CY_BLE_EVT_GATTC_XCHNG_MTU_RSP          (0x4Cu)
+#define CY_BLE_EVT_GATTC_DISCOVERY_COMPLETE     (0x4Du)
+#define CY_BLE_EVT_IASS_WRITE_CHAR_CMD          (0x100u)
+#define CY_BLE_GATT_WRITE_REQ                   (0x12u)
+#define CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN   (0x0Du)
+#define CY_BLE_GATT_ERR_OUT_OF_RANGE            (0xFFu)
+#define CY_BLE_GATT_ERR_NONE                    (0x00u)
+#define CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE   (0x11u)
+#define CY_BLE_GATT_DEFAULT_MTU                 (23u)
+#define CY_BLE_GATT_MTU                         (247u)
+#define CY_BLE_GATT_DB_PEER_INITIATED           (0x02u)
+#define CY_BLE_CCCD_NOTIFICATION                (0x01u)
+#define CY_BLE_STACK_STATE_FREE                 (0x00u)
+#define CY_BLE_STACK_STATE_BUSY                 (0x01u)
+
+/* Attribute handles of the GATT database of design.cybt */
+#define CY_BLE_SETTINGS_SETTING_CHAR_HANDLE     (0x0030u)
+#define CY_BLE_POWER_STATS_RESIDENCY_CHAR_HANDLE    (0x0032u)
+#define CY_BLE_PROFILER_HISTOGRAMS_CHAR_HANDLE  (0x0034u)
+#define CY_BLE_TELEMETRY_STREAM_CHAR_HANDLE     (0x0037u)
+#define CY_BLE_TELEMETRY_STREAM_CLIENT_CHARACTERISTIC_CONFIGURATION_DESC_HANDLE (0x0038u)
+
+/* Configuration indexes of design.cybt */
+#define CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX (0u)
+#define CY_BLE_CENTRAL_CONFIGURATION_0_INDEX    (0u)
+#define CY_BLE_SECURITY_CONFIGURATION_0_INDEX   (0u)
+#define CY_BLE_ADVERTISING_FAST                 (0x00u)
+#define CY_BLE_SCANNING_FAST                    (0x00u)
+
+/* GAP */
+#define CY_BLE_BD_ADDR_SIZE                     (6u)
+#define CY_BLE_MAX_BONDED_DEVICES               (16u)
+#define CY_BLE_GAP_PERIPHERAL                   (0x01u)
+#define CY_BLE_GAP_CENTRAL                      (0x02u)
+#define CY_BLE_GAP_LL_ROLE_MASTER               (0x00u)
+#define CY_BLE_GAP_LL_ROLE_SLAVE                (0x01u)
+#define CY_BLE_GAP_SEC_MODE_1                   (0x10u)
+#define CY_BLE_GAP_SEC_LEVEL_2                  (0x01u)
+#define CY_BLE_GAP_BONDING                      (0x01u)
+#define CY_BLE_GAP_AUTH_ERROR_NONE              (0x00u)
+#define CY_BLE_GAPP_CONNECTABLE_UNDIRECTED_ADV  (0x00u)
+#define CY_BLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV    (0x01u)
+#define CY_BLE_GAPP_SCAN_ANY_CONN_ANY           (0x00u)
+#define CY_BLE_GAPP_SCAN_CONN_WHITELIST_ONLY    (0x02u)
+#define CY_BLE_GAPC_SCAN_RSP                    (0x04u)
+#define CY_BLE_HCI_ERROR_OTHER_END_TERMINATED_USER  (0x13u)
+#define CY_BLE_PHY_MASK_LE_1M                   (0x01u)
+#define CY_BLE_PHY_MASK_LE_2M                   (0x02u)
+#define CY_BLE_PHY_MASK_LE_CODED                (0x04u)
+#define CY_BLE_PHY_NO_PREF_MASK_NONE            (0x00u)
+
+/* Connections of the configuration: the PSoC 6 stack limit */
+#ifndef CY_BLE_CONN_COUNT
+#define CY_BLE_CONN_COUNT                       (4u)
+#endif
+
+/* Immediate Alert Service levels */
+#define CY_BLE_IAS_ALERT_LEVEL                  (0u)
+#define CY_BLE_NO_ALERT                         (0u)
+#define CY_BLE_MILD_ALERT                       (1u)
+#define CY_BLE_HIGH_ALERT                       (2u)
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef enum
+{
+    CY_BLE_SUCCESS                      = 0x00,
+    CY_BLE_ERROR_INVALID_PARAMETER      = 0x01,
+    CY_BLE_ERROR_INVALID_OPERATION      = 0x02,
+    CY_BLE_ERROR_FLASH_WRITE            = 0x0F,
+    CY_BLE_INFO_FLASH_WRITE_IN_PROGRESS = 0x10
+} cy_en_ble_api_result_t;
+
+typedef enum
+{
+    CY_BLE_STATE_STOPPED,
+    CY_BLE_STATE_INITIALIZING,
+    CY_BLE_STATE_ON
+} cy_en_ble_state_t;
+
+typedef enum
+{
+    CY_BLE_ADV_STATE_STOPPED,
+    CY_BLE_ADV_STATE_ADV_INITIATED,
+    CY_BLE_ADV_STATE_ADVERTISING,
+    CY_BLE_ADV_STATE_STOP_INITIATED
+} cy_en_ble_adv_state_t;
+
+typedef enum
+{
+    CY_BLE_SCAN_STATE_STOPPED,
+    CY_BLE_SCAN_STATE_SCAN_INITIATED,
+    CY_BLE_SCAN_STATE_SCANNING,
+    CY_BLE_SCAN_STATE_STOP_INITIATED
+} cy_en_ble_scan_state_t;
+
+typedef enum
+{
+    CY_BLE_GENERIC_TO,
+    CY_BLE_GAP_ADV_TO,
+    CY_BLE_GAP_SCAN_TO,
+    CY_BLE_GATT_RSP_TO,
+    CY_BLE_GENERIC_APP_TO
+} cy_en_ble_to_reason_code_t;
+
+typedef enum
+{
+    CY_BLE_LL_ADV_CH_TYPE,
+    CY_BLE_LL_SCAN_CH_TYPE,
+    CY_BLE_LL_CONN_CH_TYPE
+} cy_en_ble_bless_ch_type_t;
+
+typedef enum
+{
+    CY_BLE_LL_PWR_LVL_NEG_20_DBM = 0x01,
+    CY_BLE_LL_PWR_LVL_0_DBM      = 0x07,
+    CY_BLE_LL_PWR_LVL_MAX        = 0x08
+} cy_en_ble_bless_pwr_lvl_t;
+
+typedef enum
+{
+    CY_BLE_BLESS_STATE_ACTIVE = 0x01,
+    CY_BLE_BLESS_STATE_EVENT_CLOSE,
+    CY_BLE_BLESS_STATE_SLEEP,
+    CY_BLE_BLESS_STATE_ECO_ON,
+    CY_BLE_BLESS_STATE_ECO_STABLE,
+    CY_BLE_BLESS_STATE_DEEPSLEEP,
+    CY_BLE_BLESS_STATE_HIBERNATE,
+    CY_BLE_BLESS_STATE_INVALID = 0xFF
+} cy_en_ble_bless_state_t;
+
+typedef struct
+{
+    const uint8_t *srcBuff;
+    const uint8_t *destAddr;
+    uint32_t       buffLen;
+} cy_stc_ble_app_flash_param_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint8_t  attId;
+} cy_stc_ble_conn_handle_t;
+
+typedef struct
+{
+    uint8_t  status;
+    int8_t   rssi;
+    uint8_t  bdHandle;
+} cy_stc_ble_rssi_info_t;
+
+typedef struct
+{
+    uint32_t reasonCode;
+} cy_stc_ble_timeout_param_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint16_t connMaxTxOctets;
+    uint16_t connMaxTxTime;
+    uint16_t connMaxRxOctets;
+    uint16_t connMaxRxTime;
+} cy_stc_ble_data_length_change_info_t;
+
+typedef struct
+{
+    uint8_t  status;
+    uint8_t  role;
+    uint8_t  bdHandle;
+    uint8_t  peerAddrType;
+    uint8_t  peerAddr[6];
+    uint16_t connIntv;
+    uint16_t connLatency;
+    uint16_t supervisionTO;
+    uint8_t  masterClockAccuracy;
+} cy_stc_ble_gap_connected_param_t;
+
+typedef struct
+{
+    uint8_t  status;
+    uint8_t  bdHandle;
+    uint8_t  role;
+    uint8_t  peerBdAddrType;
+    uint8_t  peerBdAddr[6];
+    uint8_t  localResolvablePvtAddr[6];
+    uint8_t  peerResolvablePvtAddr[6];
+    uint16_t connIntv;
+    uint16_t connLatency;
+    uint16_t supervisionTo;
+    uint8_t  masterClockAccuracy;
+} cy_stc_ble_gap_enhance_conn_complete_param_t;
+
+typedef struct
+{
+    uint8_t  status;
+    uint8_t  reason;
+    uint8_t  bdHandle;
+} cy_stc_ble_gap_disconnect_param_t;
+
+typedef struct
+{
+    uint8_t  security;
+    uint8_t  bonding;
+    uint8_t  ekeySize;
+    uint8_t  authErr;
+    uint8_t  pairingProperties;
+    uint8_t  bdHandle;
+} cy_stc_ble_gap_auth_info_t;
+
+typedef struct
+{
+    uint8_t  status;
+    uint8_t  bdHandle;
+    uint16_t connIntv;
+    uint16_t connLatency;
+    uint16_t supervisionTo;
+} cy_stc_ble_gap_conn_param_updated_in_controller_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint16_t result;
+} cy_stc_ble_l2cap_conn_update_rsp_param_t;
+
+typedef struct
+{
+    cy_stc_ble_conn_handle_t connHandle;
+    uint16_t                 mtu;
+} cy_stc_ble_gatt_xchg_mtu_param_t;
+
+typedef struct
+{
+    uint8_t  eventType;
+    uint8_t  peerAddrType;
+    uint8_t  *peerBdAddr;
+    uint8_t  dataLen;
+    uint8_t  *data;
+    int8_t   rssi;
+} cy_stc_ble_gapc_adv_report_param_t;
+
+typedef struct
+{
+    uint8_t  *val;
+    uint16_t len;
+    uint16_t actualLen;
+} cy_stc_ble_gatt_value_t;
+
+typedef struct
+{
+    cy_stc_ble_gatt_value_t value;
+    uint16_t                attrHandle;
+} cy_stc_ble_gatt_handle_value_pair_t;
+
+typedef struct
+{
+    cy_stc_ble_conn_handle_t connHandle;
+    uint8_t                  charIndex;
+    cy_stc_ble_gatt_value_t  *value;
+} cy_stc_ble_ias_char_value_t;
+
+typedef struct
+{
+    cy_stc_ble_conn_handle_t            connHandle;
+    cy_stc_ble_gatt_handle_value_pair_t handleValPair;
+} cy_stc_ble_gatts_write_cmd_req_param_t;
+
+typedef struct
+{
+    cy_stc_ble_conn_handle_t connHandle;
+    uint16_t                 attrHandle;
+    uint8_t                  gattErrorCode;
+} cy_stc_ble_gatts_char_val_read_req_t;
+
+typedef struct
+{
+    uint16_t attrHandle;
+    uint8_t  opCode;
+    uint8_t  errorCode;
+} cy_stc_ble_gatt_err_info_t;
+
+typedef struct
+{
+    cy_stc_ble_gatt_err_info_t errInfo;
+    cy_stc_ble_conn_handle_t   connHandle;
+} cy_stc_ble_gatt_err_param_t;
+
+typedef struct
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValPair;
+    cy_stc_ble_conn_handle_t            connHandle;
+} cy_stc_ble_gatts_handle_value_ntf_t;
+
+typedef struct
+{
+    cy_stc_ble_gatt_handle_value_pair_t handleValuePair;
+    cy_stc_ble_conn_handle_t            connHandle;
+    uint16_t                            offset;
+    uint8_t                             flags;
+} cy_stc_ble_gatts_db_attr_val_info_t;
+
+typedef struct
+{
+    uint8_t  bdAddr[6];
+    uint8_t  type;
+} cy_stc_ble_gap_bd_addr_t;
+
+typedef struct
+{
+    cy_stc_ble_gap_bd_addr_t bdAddr;
+    uint8_t                  bdHandle;
+} cy_stc_ble_gap_peer_addr_info_t;
+
+typedef struct
+{
+    cy_stc_ble_gap_peer_addr_info_t *bdHandleAddrList;
+    uint8_t                         noOfDevices;
+} cy_stc_ble_gap_bonded_device_list_info_t;
+
+typedef struct
+{
+    uint8_t  reason;
+    uint8_t  bdHandle;
+} cy_stc_ble_gap_disconnect_info_t;
+
+typedef struct
+{
+    uint16_t connIntvMin;
+    uint16_t connIntvMax;
+    uint16_t connLatency;
+    uint16_t supervisionTimeout;
+    uint8_t  bdHandle;
+} cy_stc_ble_l2cap_conn_update_param_info_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint16_t connMaxTxOctets;
+    uint16_t connMaxTxTime;
+} cy_stc_ble_set_data_length_info_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint8_t  allPhyMask;
+    uint8_t  txPhyMask;
+    uint8_t  rxPhyMask;
+    uint8_t  phyOption;
+} cy_stc_ble_set_phy_info_t;
+
+typedef struct
+{
+    uint8_t  bdHandle;
+    uint8_t  txPhyMask;
+    uint8_t  rxPhyMask;
+} cy_stc_ble_phy_param_t;
+
+typedef struct
+{
+    uint8_t  status;
+    void     *eventParams;
+} cy_stc_ble_events_param_generic_t;
+
+typedef struct
+{
+    cy_en_ble_bless_ch_type_t bleSsChId;
+    uint8_t                   bdHandle;
+} cy_stc_ble_bless_pwr_config_param_t;
+
+typedef struct
+{
+    cy_stc_ble_bless_pwr_config_param_t pwrConfigParam;
+    cy_en_ble_bless_pwr_lvl_t           blePwrLevel;
+} cy_stc_ble_tx_pwr_lvl_info_t;
+
+typedef void (*cy_ble_callback_t)(uint32_t eventCode, void *eventParam);
+typedef void (*cy_ble_app_notify_callback_t)(void);
+
+/* The parts of the configuration of design.cybt that the application
+ * reads or changes
+ */
+typedef struct
+{
+    uint8_t  gapRole;
+} cy_stc_ble_params_t;
+
+typedef struct
+{
+    const cy_stc_sysint_t *blessIsrConfig;
+} cy_stc_ble_hw_config_t;
+
+typedef struct
+{
+    uint16_t fastAdvIntervalMin;
+    uint16_t fastAdvIntervalMax;
+    uint16_t fastAdvTimeOut;
+    uint8_t  slowAdvEnable;
+    uint16_t slowAdvIntervalMin;
+    uint16_t slowAdvIntervalMax;
+    uint16_t slowAdvTimeOut;
+} cy_stc_ble_gapp_adv_params_t;
+
+typedef struct
+{
+    uint16_t advIntvMin;
+    uint16_t advIntvMax;
+    uint8_t  advType;
+    uint8_t  ownAddrType;
+    uint8_t  directAddrType;
+    uint8_t  directAddr[6];
+    uint8_t  advChannelMap;
+    uint8_t  advFilterPolicy;
+} cy_stc_ble_gapp_disc_param_t;
+
+typedef struct
+{
+    uint8_t                      discMode;
+    cy_stc_ble_gapp_disc_param_t *advParam;
+    uint16_t                     advTo;
+} cy_stc_ble_gapp_disc_mode_info_t;
+
+typedef struct
+{
+    const cy_stc_ble_params_t        *params;
+    cy_stc_ble_gap_auth_info_t       *authInfo;
+    cy_stc_ble_hw_config_t           *hw;
+    cy_stc_ble_gapp_adv_params_t     *gappAdvParams;
+    cy_stc_ble_gapp_disc_mode_info_t *discoveryModeInfo;
+} cy_stc_ble_config_t;
+
+
+/******************************************************************************
+ * Global variables and functions
+ *****************************************************************************/
+extern volatile uint8_t cy_ble_pendingFlashWrite;
+extern cy_stc_ble_config_t cy_ble_config;
+
+/* Stack */
+cy_en_ble_api_result_t Cy_BLE_Init(cy_stc_ble_config_t *config);
+cy_en_ble_api_result_t Cy_BLE_Enable(void);
+cy_en_ble_api_result_t Cy_BLE_Disable(void);
+cy_en_ble_api_result_t Cy_BLE_EnableLowPowerMode(void);
+void Cy_BLE_BlessIsrHandler(void);
+void Cy_BLE_ProcessEvents(void);
+void Cy_BLE_RegisterEventCallback(cy_ble_callback_t callbackFunc);
+void Cy_BLE_RegisterAppHostCallback(cy_ble_app_notify_callback_t callbackFunc);
+void Cy_BLE_IAS_RegisterAttrCallback(cy_ble_callback_t callbackFunc);
+cy_en_ble_state_t Cy_BLE_GetState(void);
+cy_en_ble_bless_state_t Cy_BLE_StackGetBleSsState(void);
+cy_en_ble_api_result_t Cy_BLE_StoreAppData(const cy_stc_ble_app_flash_param_t *param);
+cy_en_ble_api_result_t Cy_BLE_StoreBondingData(void);
+cy_en_ble_api_result_t Cy_BLE_SetTxPowerLevel(const cy_stc_ble_tx_pwr_lvl_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_GetRssiPeer(uint8_t bdHandle);
+cy_en_ble_api_result_t Cy_BLE_SetPhy(cy_stc_ble_set_phy_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_SetDataLength(cy_stc_ble_set_data_length_info_t *param);
+
+/* GAP */
+uint8_t Cy_BLE_GetNumOfActiveConn(void);
+cy_en_ble_adv_state_t Cy_BLE_GetAdvertisementState(void);
+cy_en_ble_api_result_t Cy_BLE_GAPP_StartAdvertisement(uint8_t advertisingIntervalType,
+                                                      uint8_t advIndex);
+cy_en_ble_api_result_t Cy_BLE_GAPP_StopAdvertisement(void);
+cy_en_ble_api_result_t Cy_BLE_GAP_AuthReq(cy_stc_ble_gap_auth_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_GAPP_AuthReqReply(cy_stc_ble_gap_auth_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_GAP_GetBondList(cy_stc_ble_gap_bonded_device_list_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_AddDeviceToWhiteList(cy_stc_ble_gap_bd_addr_t *param);
+cy_en_ble_api_result_t Cy_BLE_L2CAP_LeConnectionParamUpdateRequest(
+                                    cy_stc_ble_l2cap_conn_update_param_info_t *param);
+
+/* GATT */
+cy_en_ble_api_result_t Cy_BLE_GATTS_ErrorRsp(cy_stc_ble_gatt_err_param_t *param);
+cy_en_ble_api_result_t Cy_BLE_GATTS_WriteRsp(cy_stc_ble_conn_handle_t connHandle);
+uint8_t Cy_BLE_GATTS_WriteAttributeValueLocal(const cy_stc_ble_gatt_handle_value_pair_t *param);
+uint8_t Cy_BLE_GATTS_WriteAttributeValueCCCD(cy_stc_ble_gatts_db_attr_val_info_t *param);
+cy_en_ble_api_result_t Cy_BLE_GATTS_Notification(cy_stc_ble_gatts_handle_value_ntf_t *param);
+cy_en_ble_api_result_t Cy_BLE_GATTC_ExchangeMtuReq(cy_stc_ble_gatt_xchg_mtu_param_t *param);
+cy_en_ble_api_result_t Cy_BLE_GATT_GetBusyStatus(uint8_t attId);
+
+
+#endif  /* CYCFG_BLE_H */
+
+
+/* [] END OF FILE */
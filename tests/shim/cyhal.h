@@ -0,0 +1,182 @@
+/******************************************************************************
+* File Name: cyhal.h
+*
+* Description: This file stands in for the HAL header in the host tests. It
+*              declares the debug UART calls of app_log.c, trace.c and
+*              console.c, which the tests implement on a fake FIFO, and the
+*              GPIO, low power timer, RTC, PWM and system power calls that
+*              the simulation of test_findme.c implements on its virtual
+*              clock.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef CYHAL_H
+#define CYHAL_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "cy_pdl.h"
+#include <stddef.h>
+
+
+/******************************************************************************
+ * Data types
+ *****************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS           ((cy_rslt_t)0u)
+
+/* Pin, as port * 8 + pin */
+typedef uint32_t cyhal_gpio_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DIR_INPUT,
+    CYHAL_GPIO_DIR_OUTPUT,
+    CYHAL_GPIO_DIR_BIDIRECTIONAL
+} cyhal_gpio_direction_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DRIVE_NONE,
+    CYHAL_GPIO_DRIVE_PULLUP,
+    CYHAL_GPIO_DRIVE_PULLDOWN,
+    CYHAL_GPIO_DRIVE_STRONG
+} cyhal_gpio_drive_mode_t;
+
+typedef enum
+{
+    CYHAL_GPIO_IRQ_NONE = 0,
+    CYHAL_GPIO_IRQ_RISE = 1,
+    CYHAL_GPIO_IRQ_FALL = 2,
+    CYHAL_GPIO_IRQ_BOTH = 3
+} cyhal_gpio_event_t;
+
+typedef void (*cyhal_gpio_event_callback_t)(void *callback_arg, cyhal_gpio_event_t event);
+
+typedef enum
+{
+    CYHAL_LPTIMER_COMPARE_MATCH
+} cyhal_lptimer_event_t;
+
+typedef void (*cyhal_lptimer_event_callback_t)(void *callback_arg, cyhal_lptimer_event_t event);
+
+typedef enum
+{
+    CYHAL_RTC_ALARM
+} cyhal_rtc_event_t;
+
+/* Wakeup sources of cyhal_syspm_hibernate() */
+#define CYHAL_SYSPM_HIBERNATE_LPCOMP0_LOW   (0x01u)
+#define CYHAL_SYSPM_HIBERNATE_PINA_LOW      (0x10u)
+#define CYHAL_SYSPM_HIBERNATE_PINB_LOW      (0x40u)
+#define CYHAL_SYSPM_HIBERNATE_RTC_ALARM     (0x80u)
+
+typedef struct
+{
+    uint32_t unused;
+} cyhal_uart_t;
+
+typedef struct
+{
+    uint32_t unused;
+} cyhal_lptimer_t;
+
+typedef struct
+{
+    uint32_t unused;
+} cyhal_rtc_t;
+
+typedef struct
+{
+    cyhal_gpio_t pin;
+} cyhal_pwm_t;
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+uint32_t cyhal_uart_writable(cyhal_uart_t *obj);
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length);
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj);
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj);
+cy_rslt_t cyhal_uart_read(cyhal_uart_t *obj, void *rx, size_t *rx_length);
+
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode, bool init_val);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+bool cyhal_gpio_read(cyhal_gpio_t pin);
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_event_callback_t callback,
+                                  void *callback_arg);
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event,
+                             uint8_t intr_priority, bool enable);
+
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj);
+cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay);
+uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj);
+void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj,
+                                     cyhal_lptimer_event_callback_t callback,
+                                     void *callback_arg);
+void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event,
+                                uint8_t intr_priority, bool enable);
+
+cy_rslt_t cyhal_rtc_init(cyhal_rtc_t *obj);
+cy_rslt_t cyhal_rtc_set_alarm_by_seconds(cyhal_rtc_t *obj, uint32_t seconds);
+void cyhal_rtc_enable_event(cyhal_rtc_t *obj, cyhal_rtc_event_t event,
+                            uint8_t intr_priority, bool enable);
+
+cy_rslt_t cyhal_pwm_init(cyhal_pwm_t *obj, cyhal_gpio_t pin, const void *clk);
+cy_rslt_t cyhal_pwm_set_duty_cycle(cyhal_pwm_t *obj, float duty_cycle, uint32_t frequencyhal_hz);
+cy_rslt_t cyhal_pwm_start(cyhal_pwm_t *obj);
+cy_rslt_t cyhal_pwm_stop(cyhal_pwm_t *obj);
+
+cy_rslt_t cyhal_syspm_sleep(void);
+cy_rslt_t cyhal_syspm_deepsleep(void);
+cy_rslt_t cyhal_syspm_hibernate(uint32_t wakeup_source);
+void cyhal_syspm_lock_deepsleep(void);
+void cyhal_syspm_unlock_deepsleep(void);
+
+
+#endif  /* CYHAL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name: test.h
+*
+* Description: This file contains the checks shared by the host tests. A
+*              failed check prints its location and the test continues, so
+*              that one run reports every failure; the exit status of the
+*              test program tells whether any check failed.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef TEST_H
+#define TEST_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* Defined in each test program */
+extern unsigned int test_failures;
+
+#define TEST_CHECK(cond)                                                      \
+    do                                                                        \
+    {                                                                         \
+        if(!(cond))                                                           \
+        {                                                                     \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+            test_failures++;                                                  \
+        }                                                                     \
+    } while(0)
+
+#define TEST_CHECK_EQ(actual, expected)                                       \
+    do                                                                        \
+    {                                                                         \
+        long long test_a = (long long)(actual);                               \
+        long long test_e = (long long)(expected);                             \
+        if(test_a != test_e)                                                  \
+        {                                                                     \
+            printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__,  \
+                   #actual, test_a, test_e);                                  \
+            test_failures++;                                                  \
+        }                                                                     \
+    } while(0)
+
+#define TEST_RUN(test)                                                        \
+    do                                                                        \
+    {                                                                         \
+        printf("  %s\n", #test);                                              \
+        test();                                                               \
+    } while(0)
+
+/* Exit status of a test program */
+#define TEST_RESULT()             ((0u == test_failures) ? 0 : 1)
+
+
+/*******************************************************************************
+* Function Name: test_now_ns
+********************************************************************************
+* Summary:
+*  Returns a monotonic time stamp in ns, for the benchmarks.
+*
+*******************************************************************************/
+static inline uint64_t test_now_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+
+#endif  /* TEST_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,454 @@
+/******************************************************************************
+* File Name: test_alert_pattern.c
+*
+* Description: This file contains the host tests of alert_pattern.c. The
+*              pattern engine runs on a virtual wakeup timer and drives a
+*              recording backend in place of the LED pins and the buzzer
+*              PWM. The tests check the recorded waveform, held and one-shot
+*              patterns, the shared timer of the two channels and the
+*              recovery from a late wakeup, and report the wakeups per hour
+*              of the status patterns.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "alert_pattern.h"
+#include "app_timer.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define EDGE_LOG_SIZE             (64u)
+
+#define TICKS_PER_HOUR            (3600u * APP_TIMER_TICKS_PER_SEC)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* One output change seen by the backend */
+typedef struct
+{
+    uint32_t        time;
+    alert_channel_t channel;
+    uint8_t         outputs;
+} edge_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* Virtual wakeup timer */
+static uint32_t sim_now;
+static app_timer_t *sim_timer;
+static uint32_t sim_wakeups;
+
+/* Recording backend: the first edges, the number of edges and the current
+ * outputs of each channel
+ */
+static edge_t edge_log[EDGE_LOG_SIZE];
+static uint32_t edge_count;
+static uint8_t outputs_now[ALERT_CHANNEL_COUNT];
+
+/* Patterns as status_led.c defines them */
+static const alert_step_t steps_on[] =
+{
+    { 0u,    ALERT_OUTPUT_LED }
+};
+
+static const alert_step_t steps_advertising[] =
+{
+    { 50u,   ALERT_OUTPUT_LED },
+    { 950u,  0u }
+};
+
+static const alert_step_t steps_mild[] =
+{
+    { 500u,  ALERT_OUTPUT_LED },
+    { 500u,  0u }
+};
+
+static const alert_step_t steps_high[] =
+{
+    { 500u,  ALERT_OUTPUT_LED | ALERT_OUTPUT_BUZZER },
+    { 500u,  ALERT_OUTPUT_LED }
+};
+
+/* Three short beeps, then the buzzer stays off */
+static const alert_step_t steps_chirp[] =
+{
+    { 100u,  ALERT_OUTPUT_BUZZER },
+    { 100u,  0u },
+    { 100u,  ALERT_OUTPUT_BUZZER },
+    { 100u,  0u },
+    { 100u,  ALERT_OUTPUT_BUZZER },
+    { 0u,    0u }
+};
+
+static const alert_pattern_t pattern_on =
+    { steps_on, ALERT_PATTERN_STEPS(steps_on), false };
+static const alert_pattern_t pattern_advertising =
+    { steps_advertising, ALERT_PATTERN_STEPS(steps_advertising), true };
+static const alert_pattern_t pattern_mild =
+    { steps_mild, ALERT_PATTERN_STEPS(steps_mild), true };
+static const alert_pattern_t pattern_high =
+    { steps_high, ALERT_PATTERN_STEPS(steps_high), true };
+static const alert_pattern_t pattern_chirp =
+    { steps_chirp, ALERT_PATTERN_STEPS(steps_chirp), false };
+
+
+/*******************************************************************************
+* Function Name: app_timer_start
+********************************************************************************
+* Summary:
+*  Virtual wakeup timer. The engine only uses one timer.
+*
+*******************************************************************************/
+void app_timer_start(app_timer_t *timer, uint32_t delay_ticks, uint32_t period_ticks,
+                     app_timer_callback_t callback, void *arg)
+{
+    timer->deadline = sim_now + delay_ticks;
+    timer->period = period_ticks;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->active = true;
+    sim_timer = timer;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_stop
+********************************************************************************
+* Summary:
+*  Stops the virtual wakeup timer.
+*
+*******************************************************************************/
+void app_timer_stop(app_timer_t *timer)
+{
+    timer->active = false;
+    sim_timer = timer;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_now
+********************************************************************************
+* Summary:
+*  Returns the virtual time in ticks.
+*
+*******************************************************************************/
+uint32_t app_timer_now(void)
+{
+    return sim_now;
+}
+
+
+/*******************************************************************************
+* Function Name: record_outputs
+********************************************************************************
+* Summary:
+*  Recording backend in place of the LED pins and the buzzer PWM.
+*
+*******************************************************************************/
+static void record_outputs(alert_channel_t channel, uint8_t outputs)
+{
+    if(edge_count < EDGE_LOG_SIZE)
+    {
+        edge_log[edge_count].time = sim_now;
+        edge_log[edge_count].channel = channel;
+        edge_log[edge_count].outputs = outputs;
+    }
+    edge_count++;
+    outputs_now[channel] = outputs;
+}
+
+static const alert_backend_t record_backend =
+{
+    .set_outputs = record_outputs
+};
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Advances the virtual time by a number of ticks, waking up at every
+*  deadline of the timer on the way.
+*
+*******************************************************************************/
+static void sim_run(uint32_t ticks)
+{
+    uint32_t end = sim_now + ticks;
+
+    while((NULL != sim_timer) && sim_timer->active &&
+          ((int32_t)(end - sim_timer->deadline) >= 0))
+    {
+        sim_now = sim_timer->deadline;
+        sim_timer->active = false;
+        sim_wakeups++;
+        sim_timer->callback(sim_timer->arg);
+    }
+
+    sim_now = end;
+}
+
+
+/*******************************************************************************
+* Function Name: reset
+********************************************************************************
+* Summary:
+*  Restarts the engine, the virtual clock and the recording.
+*
+*******************************************************************************/
+static void reset(void)
+{
+    sim_now = 1000u;
+    sim_timer = NULL;
+    alert_pattern_init(&record_backend);
+    sim_wakeups = 0u;
+    edge_count = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: test_waveform
+********************************************************************************
+* Summary:
+*  A repeating pattern produces its steps back to back, with each step
+*  starting at the end of the previous one.
+*
+*******************************************************************************/
+static void test_waveform(void)
+{
+    const uint32_t on = APP_TIMER_MS_TO_TICKS(50u);
+    const uint32_t off = APP_TIMER_MS_TO_TICKS(950u);
+    uint32_t start;
+    uint32_t i;
+
+    reset();
+    start = sim_now;
+    alert_pattern_play(ALERT_CHANNEL_LINK, &pattern_advertising);
+    sim_run(5u * APP_TIMER_TICKS_PER_SEC);
+
+    TEST_CHECK_EQ(edge_count, 11u);
+    TEST_CHECK_EQ(sim_wakeups, 10u);
+
+    for(i = 0u; i < edge_count; i++)
+    {
+        uint32_t period = i / 2u;
+        uint32_t expected = start + (period * (on + off)) + (((i % 2u) != 0u) ? on : 0u);
+
+        TEST_CHECK_EQ(edge_log[i].time, expected);
+        TEST_CHECK_EQ(edge_log[i].channel, ALERT_CHANNEL_LINK);
+        TEST_CHECK_EQ(edge_log[i].outputs, ((i % 2u) == 0u) ? ALERT_OUTPUT_LED : 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_held
+********************************************************************************
+* Summary:
+*  A held step needs no wakeup, and a one-shot pattern stops the timer
+*  after its last timed step.
+*
+*******************************************************************************/
+static void test_held(void)
+{
+    reset();
+    alert_pattern_play(ALERT_CHANNEL_LINK, &pattern_on);
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_LINK], ALERT_OUTPUT_LED);
+    TEST_CHECK(!sim_timer->active);
+    sim_run(TICKS_PER_HOUR);
+    TEST_CHECK_EQ(sim_wakeups, 0u);
+
+    reset();
+    alert_pattern_play(ALERT_CHANNEL_ALERT, &pattern_chirp);
+    sim_run(10u * APP_TIMER_TICKS_PER_SEC);
+    TEST_CHECK_EQ(edge_count, ALERT_PATTERN_STEPS(steps_chirp));
+    TEST_CHECK_EQ(sim_wakeups, ALERT_PATTERN_STEPS(steps_chirp) - 1u);
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_ALERT], 0u);
+    TEST_CHECK(!sim_timer->active);
+}
+
+
+/*******************************************************************************
+* Function Name: test_replay
+********************************************************************************
+* Summary:
+*  Playing the running pattern again keeps its phase; another pattern starts
+*  at its first step.
+*
+*******************************************************************************/
+static void test_replay(void)
+{
+    reset();
+    alert_pattern_play(ALERT_CHANNEL_ALERT, &pattern_mild);
+    sim_run(APP_TIMER_MS_TO_TICKS(700u));
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_ALERT], 0u);
+
+    alert_pattern_play(ALERT_CHANNEL_ALERT, &pattern_mild);
+    TEST_CHECK_EQ(edge_count, 2u);
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_ALERT], 0u);
+
+    alert_pattern_play(ALERT_CHANNEL_ALERT, &pattern_high);
+    TEST_CHECK_EQ(edge_count, 3u);
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_ALERT], ALERT_OUTPUT_LED | ALERT_OUTPUT_BUZZER);
+    TEST_CHECK_EQ(sim_timer->deadline, sim_now + APP_TIMER_MS_TO_TICKS(500u));
+}
+
+
+/*******************************************************************************
+* Function Name: test_shared_timer
+********************************************************************************
+* Summary:
+*  Both channels share the timer: step changes that fall on the same tick
+*  take one wakeup.
+*
+*******************************************************************************/
+static void test_shared_timer(void)
+{
+    reset();
+    alert_pattern_play(ALERT_CHANNEL_LINK, &pattern_mild);
+    alert_pattern_play(ALERT_CHANNEL_ALERT, &pattern_high);
+    sim_run(10u * APP_TIMER_TICKS_PER_SEC);
+
+    /* Two edges per wakeup, one on each channel */
+    TEST_CHECK_EQ(sim_wakeups, 20u);
+    TEST_CHECK_EQ(edge_count, 2u + (2u * sim_wakeups));
+}
+
+
+/*******************************************************************************
+* Function Name: test_late_wakeup
+********************************************************************************
+* Summary:
+*  A wakeup that comes later than a whole step restarts the step timing
+*  from the wakeup instead of replaying the missed steps.
+*
+*******************************************************************************/
+static void test_late_wakeup(void)
+{
+    uint32_t late;
+
+    reset();
+    alert_pattern_play(ALERT_CHANNEL_LINK, &pattern_advertising);
+
+    /* The wakeup comes 3 s after the end of the 50 ms flash */
+    late = sim_timer->deadline + (3u * APP_TIMER_TICKS_PER_SEC);
+    sim_timer->deadline = late;
+    sim_run(late - sim_now);
+
+    TEST_CHECK_EQ(edge_count, 2u);
+    TEST_CHECK_EQ(outputs_now[ALERT_CHANNEL_LINK], 0u);
+    TEST_CHECK(sim_timer->active);
+    TEST_CHECK_EQ(sim_timer->deadline, late + APP_TIMER_MS_TO_TICKS(950u));
+}
+
+
+/*******************************************************************************
+* Function Name: bench_wakeups
+********************************************************************************
+* Summary:
+*  Reports the wakeups per hour of the status patterns, alone and with both
+*  channels playing.
+*
+*******************************************************************************/
+static void bench_wakeups(void)
+{
+    static const struct
+    {
+        const char            *name;
+        const alert_pattern_t *link;
+        const alert_pattern_t *alert;
+    } cases[] =
+    {
+        { "advertising",          &pattern_advertising, NULL },
+        { "mild alert",           NULL,                 &pattern_mild },
+        { "high alert",           NULL,                 &pattern_high },
+        { "advertising and high", &pattern_advertising, &pattern_high },
+    };
+    uint32_t i;
+
+    for(i = 0u; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        reset();
+        if(NULL != cases[i].link)
+        {
+            alert_pattern_play(ALERT_CHANNEL_LINK, cases[i].link);
+        }
+        if(NULL != cases[i].alert)
+        {
+            alert_pattern_play(ALERT_CHANNEL_ALERT, cases[i].alert);
+        }
+        sim_run(TICKS_PER_HOUR);
+
+        printf("    %-21s: %5lu wakeups/hour, %5lu edges\n", cases[i].name,
+               (unsigned long)sim_wakeups, (unsigned long)edge_count);
+        TEST_CHECK(sim_wakeups <= edge_count);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("alert_pattern\n");
+    TEST_RUN(test_waveform);
+    TEST_RUN(test_held);
+    TEST_RUN(test_replay);
+    TEST_RUN(test_shared_timer);
+    TEST_RUN(test_late_wakeup);
+    TEST_RUN(bench_wakeups);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
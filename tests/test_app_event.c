@@ -0,0 +1,377 @@
+/******************************************************************************
+* File Name: test_app_event.c
+*
+* Description: This file contains the host tests of app_event.c: ordering,
+*              coalescing and the full queue in one thread, and a stress test
+*              in which producer threads stand in for interrupt handlers and
+*              the main thread drains the queue, checking that no queued event
+*              is lost, duplicated or reordered.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "app_event.h"
+#include <pthread.h>
+#include <sched.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define STRESS_EVENTS             (200000u)
+#define STRESS_BURSTS             (200000u)
+
+/* Coalescing posts between two yields of their producer */
+#define STRESS_BURST_LEN          (8u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    app_event_type_t type;
+    uint32_t         count;   /* events to post */
+    bool             coalesce;
+    uint32_t         posted;  /* posts that returned true */
+    volatile bool    done;
+} producer_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+
+/*******************************************************************************
+* Function Name: test_order
+********************************************************************************
+* Summary:
+*  Events come out in the order they were posted, with their data.
+*
+*******************************************************************************/
+static void test_order(void)
+{
+    app_event_t event;
+    uint32_t i;
+
+    app_event_init();
+    TEST_CHECK(!app_event_pending());
+    TEST_CHECK(!app_event_get(&event));
+
+    /* Several rounds so that the positions wrap around the ring */
+    for(i = 0u; i < (APP_EVENT_QUEUE_SIZE * 5u); i++)
+    {
+        TEST_CHECK(app_event_post((app_event_type_t)(i % (uint32_t)APP_EVENT_TYPE_COUNT), i, false));
+        TEST_CHECK(app_event_post(APP_EVENT_BUTTON, i + 1000u, false));
+        TEST_CHECK(app_event_pending());
+
+        TEST_CHECK(app_event_get(&event));
+        TEST_CHECK_EQ(event.type, i % (uint32_t)APP_EVENT_TYPE_COUNT);
+        TEST_CHECK_EQ(event.data, i);
+        TEST_CHECK(app_event_get(&event));
+        TEST_CHECK_EQ(event.type, APP_EVENT_BUTTON);
+        TEST_CHECK_EQ(event.data, i + 1000u);
+    }
+
+    TEST_CHECK(!app_event_pending());
+}
+
+
+/*******************************************************************************
+* Function Name: test_coalesce
+********************************************************************************
+* Summary:
+*  A coalescing event is merged while one of its type is queued, is queued
+*  again once that one was read, and does not merge other types or events
+*  posted without coalescing.
+*
+*******************************************************************************/
+static void test_coalesce(void)
+{
+    app_event_t event;
+
+    app_event_init();
+
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 1u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 2u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 3u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_TIMER, 4u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 5u, false));
+    TEST_CHECK_EQ(app_event_get_coalesced(), 2u);
+
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (1u == event.data));
+
+    /* Read: the next one is queued again */
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 6u, true));
+
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_TIMER == event.type) && (4u == event.data));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (5u == event.data));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (6u == event.data));
+    TEST_CHECK(!app_event_get(&event));
+    TEST_CHECK_EQ(app_event_get_coalesced(), 2u);
+
+    /* Reading an event posted without coalescing leaves a queued
+     * coalescing one of the same type marked, so the next post merges
+     */
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 7u, false));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 8u, true));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (7u == event.data));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 9u, true));
+    TEST_CHECK_EQ(app_event_get_coalesced(), 3u);
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (8u == event.data));
+    TEST_CHECK(!app_event_get(&event));
+}
+
+
+/*******************************************************************************
+* Function Name: test_full
+********************************************************************************
+* Summary:
+*  A full queue rejects and counts new events and keeps the queued ones. A
+*  coalescing event that finds it full, and the posts merged into it, are
+*  delivered after the queued events.
+*
+*******************************************************************************/
+static void test_full(void)
+{
+    app_event_t event;
+    uint32_t i;
+
+    app_event_init();
+
+    for(i = 0u; i < APP_EVENT_QUEUE_SIZE; i++)
+    {
+        TEST_CHECK(app_event_post(APP_EVENT_TIMER, i, false));
+    }
+    TEST_CHECK(!app_event_post(APP_EVENT_TIMER, 99u, false));
+    TEST_CHECK_EQ(app_event_get_dropped(), 1u);
+
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 98u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 99u, true));
+    TEST_CHECK(app_event_post(APP_EVENT_BUTTON, 97u, true));
+    TEST_CHECK_EQ(app_event_get_dropped(), 1u);
+    TEST_CHECK_EQ(app_event_get_coalesced(), 1u);
+
+    for(i = 0u; i < APP_EVENT_QUEUE_SIZE; i++)
+    {
+        TEST_CHECK(app_event_get(&event));
+        TEST_CHECK_EQ(event.data, i);
+    }
+
+    /* The overflow set, by type */
+    TEST_CHECK(app_event_pending());
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BUTTON == event.type) && (97u == event.data));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (98u == event.data));
+    TEST_CHECK(!app_event_pending());
+    TEST_CHECK(!app_event_get(&event));
+
+    /* Delivered: the next BLE event is queued again */
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 7u, true));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK((APP_EVENT_BLE == event.type) && (7u == event.data));
+    TEST_CHECK_EQ(app_event_get_coalesced(), 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: producer_thread
+********************************************************************************
+* Summary:
+*  Posts numbered events as fast as possible. An event rejected by a full
+*  queue is posted again, so the consumer must see every number once. The
+*  coalescing producer yields after each burst of posts, so that on a host
+*  with few cores the consumer drains while it posts.
+*
+*******************************************************************************/
+static void* producer_thread(void *arg)
+{
+    producer_t *producer = (producer_t *)arg;
+    uint32_t i;
+
+    for(i = 0u; i < producer->count; i++)
+    {
+        if(producer->coalesce)
+        {
+            if(app_event_post(producer->type, i, true))
+            {
+                producer->posted++;
+            }
+            if(0u == (i % STRESS_BURST_LEN))
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            while(!app_event_post(producer->type, i, false))
+            {
+                sched_yield();
+            }
+            producer->posted++;
+        }
+    }
+
+    producer->done = true;
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: test_stress
+********************************************************************************
+* Summary:
+*  Two producers post numbered timer and button events and a third posts
+*  coalescing BLE events, while this thread drains the queue. The numbers of
+*  each numbered producer arrive once each and in order. Every BLE post is
+*  accepted and either received or merged into a received one, and no BLE
+*  event is left marked as waiting once the queue is drained.
+*
+*******************************************************************************/
+static void test_stress(void)
+{
+    producer_t producers[3] =
+    {
+        { APP_EVENT_TIMER,  STRESS_EVENTS, false, 0u, false },
+        { APP_EVENT_BUTTON, STRESS_EVENTS, false, 0u, false },
+        { APP_EVENT_BLE,    STRESS_BURSTS, true,  0u, false },
+    };
+    pthread_t threads[3];
+    uint32_t expected[APP_EVENT_TYPE_COUNT] = { 0u };
+    uint32_t received_ble = 0u;
+    uint32_t out_of_order = 0u;
+    app_event_t event;
+    uint64_t start;
+    uint32_t i;
+
+    app_event_init();
+
+    start = test_now_ns();
+    for(i = 0u; i < 3u; i++)
+    {
+        TEST_CHECK(0 == pthread_create(&threads[i], NULL, producer_thread, &producers[i]));
+    }
+
+    while(!producers[0].done || !producers[1].done || !producers[2].done ||
+          app_event_pending())
+    {
+        if(!app_event_get(&event))
+        {
+            /* Let a producer that was preempted between claiming and
+             * publishing its slot finish on a single core host
+             */
+            sched_yield();
+            continue;
+        }
+
+        if(APP_EVENT_BLE == event.type)
+        {
+            received_ble++;
+        }
+        else
+        {
+            if(event.data != expected[event.type])
+            {
+                out_of_order++;
+            }
+            expected[event.type] = event.data + 1u;
+        }
+    }
+
+    for(i = 0u; i < 3u; i++)
+    {
+        (void)pthread_join(threads[i], NULL);
+    }
+    while(app_event_get(&event))
+    {
+        received_ble += (APP_EVENT_BLE == event.type) ? 1u : 0u;
+    }
+
+    printf("    %lu events in %.1f ms: %lu BLE received, %lu merged, %lu dropped\n",
+           (unsigned long)((2u * STRESS_EVENTS) + STRESS_BURSTS),
+           (double)(test_now_ns() - start) / 1e6, (unsigned long)received_ble,
+           (unsigned long)app_event_get_coalesced(), (unsigned long)app_event_get_dropped());
+
+    TEST_CHECK_EQ(out_of_order, 0u);
+    TEST_CHECK_EQ(expected[APP_EVENT_TIMER], STRESS_EVENTS);
+    TEST_CHECK_EQ(expected[APP_EVENT_BUTTON], STRESS_EVENTS);
+    TEST_CHECK_EQ(producers[2].posted, STRESS_BURSTS);
+    TEST_CHECK_EQ(producers[2].posted, received_ble + app_event_get_coalesced());
+
+    /* The consumer must have read BLE events while they were posted */
+    TEST_CHECK(received_ble > (STRESS_BURSTS / 100u));
+    TEST_CHECK(app_event_get_coalesced() > 0u);
+
+    /* Not stranded: the next BLE event is queued, not merged */
+    TEST_CHECK(app_event_post(APP_EVENT_BLE, 0u, true));
+    TEST_CHECK(app_event_get(&event));
+    TEST_CHECK(APP_EVENT_BLE == event.type);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("app_event\n");
+    TEST_RUN(test_order);
+    TEST_RUN(test_coalesce);
+    TEST_RUN(test_full);
+    TEST_RUN(test_stress);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
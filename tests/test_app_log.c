@@ -0,0 +1,422 @@
+/******************************************************************************
+* File Name: test_app_log.c
+*
+* Description: This file contains the host tests of the text mode of
+*              app_log.c: the line format, the output of whole lines only
+*              while the UART FIFO has room, the overflow record and the
+*              flush. The debug UART is a fake FIFO that is emptied by the
+*              test. A benchmark compares the cost of a log call and of
+*              draining a record with formatting the same line with printf.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "app_log.h"
+#include "cy_retarget_io.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* TX FIFO of the SCB in byte mode */
+#define UART_FIFO_SIZE            (128u)
+
+#define CAPTURE_SIZE              (4096u)
+
+/* Time to shift out one byte at 115200 baud, 8N1, in ns */
+#define UART_BYTE_NS              (86806u)
+
+#define BENCH_CALLS               (200000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+/* Fake UART: free FIFO entries, the bytes written since the last reset and
+ * the number of write calls. With auto_empty set, the FIFO is empty every
+ * time its free space is read.
+ */
+static uint32_t uart_free = UART_FIFO_SIZE;
+static char uart_capture[CAPTURE_SIZE + 1u];
+static uint32_t uart_length = 0u;
+static uint32_t uart_writes = 0u;
+static bool uart_auto_empty = false;
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_writable
+********************************************************************************
+* Summary:
+*  Returns the free entries of the fake FIFO.
+*
+*******************************************************************************/
+uint32_t cyhal_uart_writable(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    if(uart_auto_empty)
+    {
+        uart_free = UART_FIFO_SIZE;
+    }
+
+    return uart_free;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_write
+********************************************************************************
+* Summary:
+*  Appends bytes to the capture. Writing more than the FIFO holds is a
+*  check failure, since the firmware would then wait on the UART.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length)
+{
+    size_t length = *tx_length;
+
+    (void)obj;
+    TEST_CHECK(length <= uart_free);
+
+    uart_free -= (uint32_t)length;
+    uart_writes++;
+
+    if((uart_length + length) > CAPTURE_SIZE)
+    {
+        length = CAPTURE_SIZE - uart_length;
+    }
+    (void)memcpy(&uart_capture[uart_length], tx, length);
+    uart_length += (uint32_t)length;
+    uart_capture[uart_length] = '\0';
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_is_tx_active
+********************************************************************************
+* Summary:
+*  The fake UART shifts out immediately.
+*
+*******************************************************************************/
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    (void)obj;
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: uart_reset
+********************************************************************************
+* Summary:
+*  Empties the fake FIFO and the capture.
+*
+*******************************************************************************/
+static void uart_reset(uint32_t free_entries)
+{
+    uart_free = free_entries;
+    uart_length = 0u;
+    uart_capture[0] = '\0';
+    uart_writes = 0u;
+    uart_auto_empty = false;
+}
+
+
+/*******************************************************************************
+* Function Name: test_before_start
+********************************************************************************
+* Summary:
+*  Records written before the UART is started are kept and written with the
+*  first drain after the start.
+*
+*******************************************************************************/
+static void test_before_start(void)
+{
+    uart_reset(UART_FIFO_SIZE);
+
+    APP_LOG_INFO(STACK_ON, 0u);
+    TEST_CHECK(app_log_drain());
+    TEST_CHECK_EQ(uart_writes, 0u);
+
+    app_log_start();
+    TEST_CHECK(!app_log_drain());
+    TEST_CHECK(0 == strcmp(uart_capture, "[INFO] : BLE stack started\r\n"));
+    TEST_CHECK_EQ(uart_writes, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_format
+********************************************************************************
+* Summary:
+*  Each record is one line with its level prefix and argument, written with
+*  one UART call.
+*
+*******************************************************************************/
+static void test_format(void)
+{
+    uart_reset(UART_FIFO_SIZE);
+
+    APP_LOG_INFO(SETTING_CHANGED, 5u);
+    APP_LOG_ERROR(SETTINGS_WR_FAILED, 0x1Fu);
+    TEST_CHECK(!app_log_drain());
+    TEST_CHECK(0 == strcmp(uart_capture,
+                           "[INFO] : Setting 5 changed\r\n"
+                           "[ERROR] : Settings flash write failed: 0x1F\r\n"));
+    TEST_CHECK_EQ(uart_writes, 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_gated
+********************************************************************************
+* Summary:
+*  A line is written only once the FIFO has room for all of it.
+*
+*******************************************************************************/
+static void test_gated(void)
+{
+    static const char line[] = "[INFO] : Setting 7 changed\r\n";
+
+    uart_reset(sizeof(line) - 2u);
+
+    APP_LOG_INFO(SETTING_CHANGED, 7u);
+    TEST_CHECK(app_log_drain());
+    TEST_CHECK(app_log_drain());
+    TEST_CHECK_EQ(uart_writes, 0u);
+
+    uart_free = sizeof(line) - 1u;
+    TEST_CHECK(!app_log_drain());
+    TEST_CHECK(0 == strcmp(uart_capture, line));
+    TEST_CHECK_EQ(uart_free, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_bounded
+********************************************************************************
+* Summary:
+*  One drain writes only the whole lines that fit in the FIFO, and the next
+*  drain goes on where it stopped.
+*
+*******************************************************************************/
+static void test_bounded(void)
+{
+    static const char line[] = "[INFO] : Setting 1 changed\r\n";
+    const uint32_t per_drain = UART_FIFO_SIZE / (uint32_t)(sizeof(line) - 1u);
+    uint32_t drains = 0u;
+    uint32_t i;
+
+    uart_reset(UART_FIFO_SIZE);
+
+    for(i = 0u; i < 10u; i++)
+    {
+        APP_LOG_INFO(SETTING_CHANGED, 1u);
+    }
+
+    TEST_CHECK(app_log_drain());
+    TEST_CHECK_EQ(uart_writes, per_drain);
+    TEST_CHECK_EQ(uart_length, per_drain * (sizeof(line) - 1u));
+
+    do
+    {
+        uart_free = UART_FIFO_SIZE;
+        drains++;
+    } while(app_log_drain() && (drains < 10u));
+
+    TEST_CHECK_EQ(uart_writes, 10u);
+    TEST_CHECK_EQ(drains + 1u, (10u + per_drain - 1u) / per_drain);
+    TEST_CHECK_EQ(uart_length, 10u * (sizeof(line) - 1u));
+}
+
+
+/*******************************************************************************
+* Function Name: test_overflow
+********************************************************************************
+* Summary:
+*  Records written to a full ring are counted, and the count is written
+*  before the records that were kept.
+*
+*******************************************************************************/
+static void test_overflow(void)
+{
+    uint32_t i;
+
+    uart_reset(UART_FIFO_SIZE);
+
+    for(i = 0u; i < (APP_LOG_RING_SIZE + 3u); i++)
+    {
+        APP_LOG_INFO(SETTING_CHANGED, i);
+    }
+
+    TEST_CHECK(app_log_drain());
+    TEST_CHECK(0 == strncmp(uart_capture, "[ERROR] : 3 log records dropped\r\n"
+                                          "[INFO] : Setting 0 changed\r\n",
+                            strlen("[ERROR] : 3 log records dropped\r\n"
+                                   "[INFO] : Setting 0 changed\r\n")));
+
+    uart_auto_empty = true;
+    TEST_CHECK(!app_log_drain());
+    TEST_CHECK_EQ(uart_writes, APP_LOG_RING_SIZE + 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_flush
+********************************************************************************
+* Summary:
+*  The flush writes every pending line.
+*
+*******************************************************************************/
+static void test_flush(void)
+{
+    uint32_t i;
+
+    uart_reset(UART_FIFO_SIZE);
+    uart_auto_empty = true;
+
+    for(i = 0u; i < APP_LOG_RING_SIZE; i++)
+    {
+        APP_LOG_INFO(ADV_INTERVAL, i);
+    }
+
+    app_log_flush();
+    TEST_CHECK(!app_log_drain());
+    TEST_CHECK_EQ(uart_writes, APP_LOG_RING_SIZE);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_cost
+********************************************************************************
+* Summary:
+*  Reports the time per log call and per drained line, and the time to
+*  format the same line with printf. On the target, printf through
+*  retarget-io also waits for every byte to be shifted out, which is added
+*  as the UART time of one line.
+*
+*******************************************************************************/
+static void bench_cost(void)
+{
+    FILE *null = fopen("/dev/null", "w");
+    uint64_t start;
+    uint64_t log_ns = 0u;
+    uint64_t drain_ns = 0u;
+    uint64_t printf_ns;
+    uint32_t line_length = 0u;
+    uint32_t i;
+
+    TEST_CHECK(NULL != null);
+    if(NULL == null)
+    {
+        return;
+    }
+
+    uart_reset(UART_FIFO_SIZE);
+    uart_auto_empty = true;
+
+    for(i = 0u; i < BENCH_CALLS; i += APP_LOG_RING_SIZE)
+    {
+        uint32_t j;
+
+        start = test_now_ns();
+        for(j = 0u; j < APP_LOG_RING_SIZE; j++)
+        {
+            APP_LOG_INFO(RECONNECT_MS, i + j);
+        }
+        log_ns += test_now_ns() - start;
+
+        uart_length = 0u;
+        start = test_now_ns();
+        (void)app_log_drain();
+        drain_ns += test_now_ns() - start;
+    }
+    line_length = uart_length / APP_LOG_RING_SIZE;
+
+    start = test_now_ns();
+    for(i = 0u; i < BENCH_CALLS; i++)
+    {
+        fprintf(null, "%s", "[INFO] : ");
+        fprintf(null, "Connected %lu ms after the last disconnection", (unsigned long)i);
+        fprintf(null, "\r\n");
+    }
+    printf_ns = test_now_ns() - start;
+    (void)fclose(null);
+
+    printf("    log call     : %6.1f ns\n", (double)log_ns / BENCH_CALLS);
+    printf("    drain a line : %6.1f ns\n", (double)drain_ns / BENCH_CALLS);
+    printf("    printf a line: %6.1f ns, plus %lu us of UART time when blocking\n",
+           (double)printf_ns / BENCH_CALLS,
+           (unsigned long)((line_length * UART_BYTE_NS) / 1000u));
+
+    TEST_CHECK(log_ns < printf_ns);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("app_log\n");
+    TEST_RUN(test_before_start);
+    TEST_RUN(test_format);
+    TEST_RUN(test_gated);
+    TEST_RUN(test_bounded);
+    TEST_RUN(test_overflow);
+    TEST_RUN(test_flush);
+    TEST_RUN(bench_cost);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,503 @@
+/******************************************************************************
+* File Name: test_app_sched.c
+*
+* Description: This file contains the host tests of app_sched.c on a virtual
+*              wakeup timer: priority order, re-runs, tasks woken by other
+*              tasks, timed tasks sharing a wakeup inside their slack, and a
+*              benchmark of the time spent picking a task and of the wakeups
+*              that periodic tasks cost with and without slack.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include <setjmp.h>
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define LOG_SIZE                  (32u)
+#define BENCH_TASKS               (12u)
+#define BENCH_POLL_TASKS          (4u)
+#define BENCH_TICKS               (APP_TIMER_TICKS_PER_SEC * 3600u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef struct
+{
+    app_sched_task_t task;
+    char             name;
+    uint32_t         reruns;       /* times to ask for another run */
+    app_sched_task_t *wakes;       /* task to wake without delay */
+    uint32_t         period;       /* re-arm delay of a periodic task */
+    uint32_t         slack;
+    uint32_t         last_run;
+} test_task_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* Virtual wakeup timer: the clock only moves while the scheduler idles */
+static uint32_t sim_now;
+static app_timer_t *sim_timer;
+static uint32_t sim_wakeups;
+static uint32_t sim_end;
+static jmp_buf sim_exit;
+
+static char run_log[LOG_SIZE + 1u];
+static uint32_t run_count;
+
+
+/*******************************************************************************
+* Function Name: app_timer_start
+********************************************************************************
+* Summary:
+*  Virtual wakeup timer. The scheduler only uses one timer.
+*
+*******************************************************************************/
+void app_timer_start(app_timer_t *timer, uint32_t delay_ticks, uint32_t period_ticks,
+                     app_timer_callback_t callback, void *arg)
+{
+    timer->deadline = sim_now + delay_ticks;
+    timer->period = period_ticks;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->active = true;
+    sim_timer = timer;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_stop
+********************************************************************************
+* Summary:
+*  Stops the virtual wakeup timer.
+*
+*******************************************************************************/
+void app_timer_stop(app_timer_t *timer)
+{
+    timer->active = false;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_is_active
+********************************************************************************
+* Summary:
+*  Returns true if the timer is running.
+*
+*******************************************************************************/
+bool app_timer_is_active(const app_timer_t *timer)
+{
+    return timer->active;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_now
+********************************************************************************
+* Summary:
+*  Returns the virtual time in ticks.
+*
+*******************************************************************************/
+uint32_t app_timer_now(void)
+{
+    return sim_now;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_idle
+********************************************************************************
+* Summary:
+*  Idle function of the scheduler: sleeps until the armed deadline. With no
+*  deadline, or one after the end of the run, app_sched_run() is left.
+*
+*******************************************************************************/
+static void sim_idle(void)
+{
+    if((NULL == sim_timer) || !sim_timer->active ||
+       ((int32_t)(sim_timer->deadline - sim_end) > 0))
+    {
+        longjmp(sim_exit, 1);
+    }
+
+    sim_now = sim_timer->deadline;
+    sim_timer->active = false;
+    sim_wakeups++;
+    sim_timer->callback(sim_timer->arg);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Runs the scheduler until it has nothing left to do before end_ticks.
+*
+*******************************************************************************/
+static void sim_run(uint32_t end_ticks)
+{
+    sim_end = end_ticks;
+
+    if(0 == setjmp(sim_exit))
+    {
+        app_sched_run();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_reset
+********************************************************************************
+* Summary:
+*  Starts a test with the virtual clock at zero and an empty scheduler.
+*
+*******************************************************************************/
+static void sim_reset(void)
+{
+    sim_now = 0u;
+    sim_wakeups = 0u;
+    run_count = 0u;
+    (void)memset(run_log, 0, sizeof(run_log));
+
+    app_sched_init(sim_idle);
+}
+
+
+/*******************************************************************************
+* Function Name: test_task_run
+********************************************************************************
+* Summary:
+*  Body of the test tasks: logs its name and applies its script.
+*
+*******************************************************************************/
+static bool test_task_run(void *arg)
+{
+    test_task_t *task = (test_task_t *)arg;
+
+    if(run_count < LOG_SIZE)
+    {
+        run_log[run_count] = task->name;
+    }
+    run_count++;
+    task->last_run = sim_now;
+
+    if(NULL != task->wakes)
+    {
+        app_sched_wake(task->wakes, 0u, 0u);
+        task->wakes = NULL;
+    }
+
+    if(0u != task->period)
+    {
+        app_sched_wake(&task->task, task->period, task->slack);
+    }
+
+    if(0u != task->reruns)
+    {
+        task->reruns--;
+        return true;
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: add_task
+********************************************************************************
+* Summary:
+*  Adds a test task.
+*
+*******************************************************************************/
+static void add_task(test_task_t *task, char name, uint8_t priority, bool poll)
+{
+    (void)memset(task, 0, sizeof(*task));
+    task->name = name;
+    app_sched_add(&task->task, test_task_run, task, priority, poll);
+}
+
+
+/*******************************************************************************
+* Function Name: test_priority_order
+********************************************************************************
+* Summary:
+*  After a wakeup, poll tasks run by priority, and in the order they were
+*  added within a priority.
+*
+*******************************************************************************/
+static void test_priority_order(void)
+{
+    test_task_t tasks[4];
+
+    sim_reset();
+    add_task(&tasks[0], 'c', 2u, true);
+    add_task(&tasks[1], 'a', 0u, true);
+    add_task(&tasks[2], 'b', 1u, true);
+    add_task(&tasks[3], 'A', 0u, true);
+
+    sim_run(0u);
+    TEST_CHECK(0 == strcmp(run_log, "aAbc"));
+}
+
+
+/*******************************************************************************
+* Function Name: test_rerun
+********************************************************************************
+* Summary:
+*  A task that has more work runs again before tasks of lower priority.
+*
+*******************************************************************************/
+static void test_rerun(void)
+{
+    test_task_t tasks[2];
+
+    sim_reset();
+    add_task(&tasks[0], 'b', 1u, true);
+    add_task(&tasks[1], 'a', 0u, true);
+    tasks[1].reruns = 2u;
+
+    sim_run(0u);
+    TEST_CHECK(0 == strcmp(run_log, "aaab"));
+}
+
+
+/*******************************************************************************
+* Function Name: test_wake_now
+********************************************************************************
+* Summary:
+*  A task woken without delay by another task runs next if its priority is
+*  higher than that of the remaining ready tasks, without a wakeup.
+*
+*******************************************************************************/
+static void test_wake_now(void)
+{
+    test_task_t tasks[3];
+
+    sim_reset();
+    add_task(&tasks[0], 'h', 0u, false);
+    add_task(&tasks[1], 'm', 1u, true);
+    add_task(&tasks[2], 'l', 2u, true);
+    tasks[1].wakes = &tasks[0].task;
+
+    sim_run(0u);
+    TEST_CHECK(0 == strcmp(run_log, "mhl"));
+    TEST_CHECK_EQ(sim_wakeups, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_timed_slack
+********************************************************************************
+* Summary:
+*  The wakeup is armed for the earliest deadline, and every task released by
+*  then runs on that wakeup: two tasks with overlapping windows cost one
+*  wakeup. A task without slack gets a wakeup of its own.
+*
+*******************************************************************************/
+static void test_timed_slack(void)
+{
+    test_task_t tasks[3];
+
+    sim_reset();
+    add_task(&tasks[0], 'a', 1u, false);
+    add_task(&tasks[1], 'b', 0u, false);
+    add_task(&tasks[2], 'c', 2u, false);
+
+    app_sched_wake(&tasks[0].task, 100u, 50u);
+    app_sched_wake(&tasks[1].task, 120u, 200u);
+    app_sched_wake(&tasks[2].task, 400u, 0u);
+
+    sim_run(1000u);
+
+    TEST_CHECK(0 == strcmp(run_log, "bac"));
+    TEST_CHECK_EQ(tasks[0].last_run, 150u);
+    TEST_CHECK_EQ(tasks[1].last_run, 150u);
+    TEST_CHECK_EQ(tasks[2].last_run, 400u);
+    TEST_CHECK_EQ(sim_wakeups, 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_cancel
+********************************************************************************
+* Summary:
+*  A cancelled task does not run, and the wakeup follows the remaining
+*  deadlines. Only tasks still due count as pending.
+*
+*******************************************************************************/
+static void test_cancel(void)
+{
+    test_task_t tasks[2];
+
+    sim_reset();
+    add_task(&tasks[0], 'a', 0u, false);
+    add_task(&tasks[1], 'b', 0u, false);
+
+    TEST_CHECK(!app_sched_pending());
+    app_sched_wake(&tasks[0].task, 100u, 0u);
+    app_sched_wake(&tasks[1].task, 50u, 0u);
+    app_sched_cancel(&tasks[1].task);
+    TEST_CHECK(app_sched_pending());
+
+    sim_run(1000u);
+    TEST_CHECK(0 == strcmp(run_log, "a"));
+    TEST_CHECK_EQ(tasks[0].last_run, 100u);
+    TEST_CHECK_EQ(sim_wakeups, 1u);
+    TEST_CHECK(!app_sched_pending());
+
+    /* Cancelling the only timed task leaves nothing to wake for, and
+     * nothing that holds off hibernate
+     */
+    sim_reset();
+    add_task(&tasks[0], 'a', 0u, false);
+    app_sched_wake(&tasks[0].task, 100u, 0u);
+    app_sched_cancel(&tasks[0].task);
+    TEST_CHECK(!app_sched_pending());
+
+    sim_run(1000u);
+    TEST_CHECK_EQ(run_count, 0u);
+    TEST_CHECK_EQ(sim_wakeups, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_periodic
+********************************************************************************
+* Summary:
+*  Runs periodic tasks with unrelated periods, like the RSSI sampling of
+*  several links and the telemetry snapshots, next to poll tasks for one
+*  virtual hour. Reports the wakeups and the host time per pick, and
+*  returns the wakeups.
+*
+*******************************************************************************/
+static uint32_t bench_periodic(uint32_t slack_div)
+{
+    static test_task_t tasks[BENCH_TASKS + BENCH_POLL_TASKS];
+    app_sched_stats_t stats;
+    uint32_t late = 0u;
+    uint32_t i;
+
+    sim_reset();
+
+    for(i = 0u; i < BENCH_TASKS; i++)
+    {
+        add_task(&tasks[i], (char)('a' + i), (uint8_t)(1u + (i % 3u)), false);
+        tasks[i].period = APP_TIMER_MS_TO_TICKS(1000u + (i * 370u));
+        tasks[i].slack = (0u == slack_div) ? 0u : (tasks[i].period / slack_div);
+        app_sched_wake(&tasks[i].task, tasks[i].period, tasks[i].slack);
+    }
+    for(i = 0u; i < BENCH_POLL_TASKS; i++)
+    {
+        add_task(&tasks[BENCH_TASKS + i], 'p', (uint8_t)i, true);
+    }
+
+    sim_run(BENCH_TICKS);
+
+    app_sched_get_stats(&stats);
+
+    /* Every periodic task kept running to the end of the hour */
+    for(i = 0u; i < BENCH_TASKS; i++)
+    {
+        late += ((BENCH_TICKS - tasks[i].last_run) > (tasks[i].period + tasks[i].slack)) ? 1u : 0u;
+    }
+
+    printf("    %s: %lu wakeups/hour, %.2f timed runs per wakeup, "
+           "%.1f ns per pick, %lu ns max\n",
+           (0u == slack_div) ? "no slack     " : "quarter slack", (unsigned long)sim_wakeups,
+           (double)(stats.dispatches - ((sim_wakeups + 1u) * BENCH_POLL_TASKS)) / sim_wakeups,
+           (double)stats.cycles_total / (stats.dispatches + stats.idles),
+           (unsigned long)stats.cycles_max);
+
+    TEST_CHECK_EQ(late, 0u);
+    TEST_CHECK_EQ(stats.idles, sim_wakeups + 1u);
+
+    return sim_wakeups;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_overhead
+********************************************************************************
+* Summary:
+*  Compares the wakeups of the periodic tasks without slack and with the
+*  quarter period of APP_SCHED_SLACK().
+*
+*******************************************************************************/
+static void bench_overhead(void)
+{
+    uint32_t strict = bench_periodic(0u);
+    uint32_t slack = bench_periodic(4u);
+
+    TEST_CHECK(slack < strict);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("app_sched\n");
+    TEST_RUN(test_priority_order);
+    TEST_RUN(test_rerun);
+    TEST_RUN(test_wake_now);
+    TEST_RUN(test_timed_slack);
+    TEST_RUN(test_cancel);
+    TEST_RUN(bench_overhead);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,408 @@
+/******************************************************************************
+* File Name: test_ble_dispatch.c
+*
+* Description: This file contains the host tests of ble_dispatch.c: handler
+*              order, the default handler, a full handler list, running out
+*              of slots and windows, and the per-event statistics. The
+*              Makefile builds the dispatcher with a small index so that the
+*              limits are reached with a few registrations.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "ble_dispatch.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Event codes in two windows, and one in a third window */
+#define EVENT_A                   (0x01u)
+#define EVENT_B                   (0x02u)
+#define EVENT_C                   (BLE_DISPATCH_RANGE_SIZE + 0x05u)
+#define EVENT_FAR                 ((2u * BLE_DISPATCH_RANGE_SIZE) + 0x05u)
+
+/* Host time spent in the slow handler, in ns (cycles on the host) */
+#define SLOW_HANDLER_NS           (20000u)
+
+#define MAX_CALLS                 (16u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* Handlers called since the last reset, by name */
+static char calls[MAX_CALLS + 1u];
+static uint32_t call_count = 0u;
+static uint32_t last_event = 0u;
+
+
+/*******************************************************************************
+* Function Name: record
+********************************************************************************
+* Summary:
+*  Appends the name of a handler to the call record.
+*
+*******************************************************************************/
+static void record(char name, uint32_t event)
+{
+    if(call_count < MAX_CALLS)
+    {
+        calls[call_count] = name;
+        call_count++;
+        calls[call_count] = '\0';
+    }
+
+    last_event = event;
+}
+
+static void handler_a(uint32_t event, void *eventParam)
+{
+    (void)eventParam;
+    record('a', event);
+}
+
+static void handler_b(uint32_t event, void *eventParam)
+{
+    (void)eventParam;
+    record('b', event);
+}
+
+static void handler_default(uint32_t event, void *eventParam)
+{
+    (void)eventParam;
+    record('d', event);
+}
+
+
+/*******************************************************************************
+* Function Name: handler_slow
+********************************************************************************
+* Summary:
+*  Spins for SLOW_HANDLER_NS, so that the cycle statistics have a known
+*  lower bound.
+*
+*******************************************************************************/
+static void handler_slow(uint32_t event, void *eventParam)
+{
+    uint64_t start = test_now_ns();
+
+    (void)eventParam;
+    while((test_now_ns() - start) < SLOW_HANDLER_NS)
+    {
+    }
+    record('s', event);
+}
+
+
+/*******************************************************************************
+* Function Name: reset
+********************************************************************************
+* Summary:
+*  Clears the dispatcher and the call record.
+*
+*******************************************************************************/
+static void reset(ble_dispatch_handler_t default_handler)
+{
+    ble_dispatch_init(default_handler);
+    calls[0] = '\0';
+    call_count = 0u;
+    last_event = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: test_order
+********************************************************************************
+* Summary:
+*  Handlers of one event run in registration order, across tables.
+*
+*******************************************************************************/
+static void test_order(void)
+{
+    static const ble_dispatch_entry_t first[] =
+    {
+        { EVENT_A, handler_a },
+        { EVENT_B, handler_b },
+    };
+    static const ble_dispatch_entry_t second[] =
+    {
+        { EVENT_A, handler_b },
+        { EVENT_C, handler_a },
+    };
+
+    reset(handler_default);
+    TEST_CHECK(ble_dispatch_register(first, BLE_DISPATCH_COUNT(first)));
+    TEST_CHECK(ble_dispatch_register(second, BLE_DISPATCH_COUNT(second)));
+
+    ble_dispatch_event(EVENT_A, NULL);
+    ble_dispatch_event(EVENT_B, NULL);
+    ble_dispatch_event(EVENT_C, NULL);
+    TEST_CHECK(0 == strcmp(calls, "abba"));
+    TEST_CHECK_EQ(last_event, EVENT_C);
+}
+
+
+/*******************************************************************************
+* Function Name: test_default
+********************************************************************************
+* Summary:
+*  Events without handlers go to the default handler, also when their
+*  window exists, and are counted in the unhandled statistics.
+*
+*******************************************************************************/
+static void test_default(void)
+{
+    static const ble_dispatch_entry_t table[] =
+    {
+        { EVENT_A, handler_a },
+    };
+    ble_dispatch_stats_t unhandled;
+
+    reset(handler_default);
+    TEST_CHECK(ble_dispatch_register(table, BLE_DISPATCH_COUNT(table)));
+
+    ble_dispatch_event(EVENT_B, NULL);
+    ble_dispatch_event(EVENT_FAR, NULL);
+    ble_dispatch_event(EVENT_A, NULL);
+    TEST_CHECK(0 == strcmp(calls, "dda"));
+
+    ble_dispatch_get_unhandled_stats(&unhandled);
+    TEST_CHECK_EQ(unhandled.hits, 2u);
+    TEST_CHECK_EQ(unhandled.event, EVENT_FAR);
+
+    /* Without a default handler, the events are only counted */
+    reset(NULL);
+    ble_dispatch_event(EVENT_B, NULL);
+    TEST_CHECK_EQ(call_count, 0u);
+    ble_dispatch_get_unhandled_stats(&unhandled);
+    TEST_CHECK_EQ(unhandled.hits, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_handlers_full
+********************************************************************************
+* Summary:
+*  A handler beyond BLE_DISPATCH_MAX_HANDLERS makes the registration fail;
+*  the other rows of the table are still registered.
+*
+*******************************************************************************/
+static void test_handlers_full(void)
+{
+    static const ble_dispatch_entry_t table[] =
+    {
+        { EVENT_B, handler_b },
+        { EVENT_A, handler_a },
+    };
+    ble_dispatch_stats_t stats[BLE_DISPATCH_MAX_EVENTS];
+    uint32_t i;
+
+    reset(NULL);
+    for(i = 0u; i < (BLE_DISPATCH_MAX_HANDLERS - 1u); i++)
+    {
+        TEST_CHECK(ble_dispatch_register(&table[1], 1u));
+    }
+    TEST_CHECK(ble_dispatch_register(table, BLE_DISPATCH_COUNT(table)));
+    TEST_CHECK(!ble_dispatch_register(table, BLE_DISPATCH_COUNT(table)));
+
+    ble_dispatch_event(EVENT_A, NULL);
+    TEST_CHECK_EQ(call_count, BLE_DISPATCH_MAX_HANDLERS);
+
+    /* EVENT_B got its second handler although EVENT_A was full */
+    call_count = 0u;
+    ble_dispatch_event(EVENT_B, NULL);
+    TEST_CHECK(0 == strcmp(calls, "bb"));
+
+    TEST_CHECK_EQ(ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS), 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_slots_full
+********************************************************************************
+* Summary:
+*  Once BLE_DISPATCH_MAX_EVENTS codes have slots, a new code is refused,
+*  while more handlers for a known code are still accepted.
+*
+*******************************************************************************/
+static void test_slots_full(void)
+{
+    ble_dispatch_entry_t entry = { 0u, handler_a };
+    ble_dispatch_stats_t unhandled;
+    uint32_t i;
+
+    reset(handler_default);
+    for(i = 0u; i < BLE_DISPATCH_MAX_EVENTS; i++)
+    {
+        entry.event = i;
+        TEST_CHECK(ble_dispatch_register(&entry, 1u));
+    }
+
+    entry.event = BLE_DISPATCH_MAX_EVENTS;
+    TEST_CHECK(!ble_dispatch_register(&entry, 1u));
+
+    entry.event = 0u;
+    entry.handler = handler_b;
+    TEST_CHECK(ble_dispatch_register(&entry, 1u));
+
+    ble_dispatch_event(BLE_DISPATCH_MAX_EVENTS, NULL);
+    ble_dispatch_event(0u, NULL);
+    TEST_CHECK(0 == strcmp(calls, "dab"));
+
+    ble_dispatch_get_unhandled_stats(&unhandled);
+    TEST_CHECK_EQ(unhandled.hits, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_windows_full
+********************************************************************************
+* Summary:
+*  Once BLE_DISPATCH_MAX_RANGES windows are in use, a code of another range
+*  is refused; the codes of the windows in use still get slots.
+*
+*******************************************************************************/
+static void test_windows_full(void)
+{
+    ble_dispatch_entry_t entry = { 0u, handler_a };
+    uint32_t i;
+
+    reset(handler_default);
+    for(i = 0u; i < BLE_DISPATCH_MAX_RANGES; i++)
+    {
+        entry.event = (i * BLE_DISPATCH_RANGE_SIZE) + 1u;
+        TEST_CHECK(ble_dispatch_register(&entry, 1u));
+    }
+
+    entry.event = (BLE_DISPATCH_MAX_RANGES * BLE_DISPATCH_RANGE_SIZE) + 1u;
+    TEST_CHECK(!ble_dispatch_register(&entry, 1u));
+    ble_dispatch_event(entry.event, NULL);
+
+    entry.event = 2u;
+    entry.handler = handler_b;
+    TEST_CHECK(ble_dispatch_register(&entry, 1u));
+    ble_dispatch_event(2u, NULL);
+    ble_dispatch_event(1u, NULL);
+    TEST_CHECK(0 == strcmp(calls, "dba"));
+}
+
+
+/*******************************************************************************
+* Function Name: test_stats
+********************************************************************************
+* Summary:
+*  Hits and cycles are accounted per event code, in slot order; reset
+*  clears them and keeps the handlers.
+*
+*******************************************************************************/
+static void test_stats(void)
+{
+    static const ble_dispatch_entry_t table[] =
+    {
+        { EVENT_A, handler_a },
+        { EVENT_C, handler_slow },
+    };
+    ble_dispatch_stats_t stats[BLE_DISPATCH_MAX_EVENTS];
+    uint32_t i;
+
+    reset(NULL);
+    TEST_CHECK(ble_dispatch_register(table, BLE_DISPATCH_COUNT(table)));
+
+    for(i = 0u; i < 3u; i++)
+    {
+        ble_dispatch_event(EVENT_A, NULL);
+    }
+    ble_dispatch_event(EVENT_C, NULL);
+    ble_dispatch_event(EVENT_C, NULL);
+
+    TEST_CHECK_EQ(ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS), 2u);
+    TEST_CHECK_EQ(stats[0].event, EVENT_A);
+    TEST_CHECK_EQ(stats[0].hits, 3u);
+    TEST_CHECK(stats[0].cycles_total >= stats[0].cycles_max);
+    TEST_CHECK_EQ(stats[1].event, EVENT_C);
+    TEST_CHECK_EQ(stats[1].hits, 2u);
+    TEST_CHECK(stats[1].cycles_max >= SLOW_HANDLER_NS);
+    TEST_CHECK(stats[1].cycles_total >= (2u * SLOW_HANDLER_NS));
+    TEST_CHECK(stats[1].cycles_total >= stats[1].cycles_max);
+
+    /* max_count limits the copy */
+    (void)memset(stats, 0, sizeof(stats));
+    TEST_CHECK_EQ(ble_dispatch_get_stats(stats, 1u), 1u);
+    TEST_CHECK_EQ(stats[1].hits, 0u);
+
+    ble_dispatch_reset_stats();
+    TEST_CHECK_EQ(ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS), 2u);
+    TEST_CHECK_EQ(stats[0].event, EVENT_A);
+    TEST_CHECK_EQ(stats[0].hits, 0u);
+    TEST_CHECK_EQ(stats[1].cycles_total, 0u);
+    TEST_CHECK_EQ(stats[1].cycles_max, 0u);
+
+    ble_dispatch_event(EVENT_A, NULL);
+    (void)ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS);
+    TEST_CHECK_EQ(stats[0].hits, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("ble_dispatch\n");
+    TEST_RUN(test_order);
+    TEST_RUN(test_default);
+    TEST_RUN(test_handlers_full);
+    TEST_RUN(test_slots_full);
+    TEST_RUN(test_windows_full);
+    TEST_RUN(test_stats);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,609 @@
+/******************************************************************************
+* File Name: test_button_gesture.c
+*
+* Description: This file contains the host tests of button_gesture.c. A
+*              synthetic pin plays press and release waveforms with contact
+*              bounce; its edge interrupt masks the pin as button.c does and
+*              the debounce and gap timers run on a virtual wakeup timer.
+*              The tests check the gestures that come out and count the
+*              wakeups (pin interrupts and timer expiries) per press.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "button_gesture.h"
+#include "app_timer.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define MAX_TIMERS                (4u)
+#define MAX_TRANSITIONS           (256u)
+#define MAX_GESTURES              (16u)
+
+/* Converts microseconds to wakeup timer ticks */
+#define US(us)                    ((uint32_t)(((uint64_t)(us) * APP_TIMER_TICKS_PER_SEC) / 1000000u))
+#define MS(ms)                    APP_TIMER_MS_TO_TICKS(ms)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* Pin level from a point in time on */
+typedef struct
+{
+    uint32_t time;
+    bool     pressed;
+} transition_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* Virtual wakeup timer */
+static uint32_t sim_now;
+static app_timer_t *sim_timers[MAX_TIMERS];
+static uint32_t sim_timer_count;
+
+/* Synthetic pin: the waveform, the current level and its interrupt mask */
+static transition_t wave[MAX_TRANSITIONS];
+static uint32_t wave_count;
+static uint32_t wave_next;
+static bool pin_pressed;
+static bool pin_enabled;
+
+/* Wakeups seen by the CPU */
+static uint32_t pin_interrupts;
+static uint32_t timer_wakeups;
+
+static char gestures[MAX_GESTURES + 1u];
+static uint32_t gesture_count;
+
+/* Seed of the bounce generator */
+static uint32_t bounce_seed = 1u;
+
+
+/*******************************************************************************
+* Function Name: app_timer_start
+********************************************************************************
+* Summary:
+*  Virtual wakeup timer.
+*
+*******************************************************************************/
+void app_timer_start(app_timer_t *timer, uint32_t delay_ticks, uint32_t period_ticks,
+                     app_timer_callback_t callback, void *arg)
+{
+    uint32_t i;
+
+    timer->deadline = sim_now + delay_ticks;
+    timer->period = period_ticks;
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->active = true;
+
+    for(i = 0u; i < sim_timer_count; i++)
+    {
+        if(timer == sim_timers[i])
+        {
+            return;
+        }
+    }
+    if(sim_timer_count < MAX_TIMERS)
+    {
+        sim_timers[sim_timer_count] = timer;
+        sim_timer_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_stop
+********************************************************************************
+* Summary:
+*  Stops a virtual timer.
+*
+*******************************************************************************/
+void app_timer_stop(app_timer_t *timer)
+{
+    timer->active = false;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_now
+********************************************************************************
+* Summary:
+*  Returns the virtual time in ticks.
+*
+*******************************************************************************/
+uint32_t app_timer_now(void)
+{
+    return sim_now;
+}
+
+
+/*******************************************************************************
+* Function Name: pin_is_pressed
+********************************************************************************
+* Summary:
+*  Pin backend: returns the level of the synthetic pin.
+*
+*******************************************************************************/
+static bool pin_is_pressed(void)
+{
+    return pin_pressed;
+}
+
+
+/*******************************************************************************
+* Function Name: pin_enable_edges
+********************************************************************************
+* Summary:
+*  Pin backend: unmasks or masks the interrupt of the synthetic pin.
+*
+*******************************************************************************/
+static void pin_enable_edges(bool enable)
+{
+    pin_enabled = enable;
+}
+
+static const button_backend_t pin_backend =
+{
+    .is_pressed   = pin_is_pressed,
+    .enable_edges = pin_enable_edges
+};
+
+
+/*******************************************************************************
+* Function Name: record_gesture
+********************************************************************************
+* Summary:
+*  Gesture callback: appends S, L or D to the record.
+*
+*******************************************************************************/
+static void record_gesture(button_gesture_t gesture)
+{
+    static const char names[] = "SLD";
+
+    if(gesture_count < MAX_GESTURES)
+    {
+        gestures[gesture_count] = names[gesture];
+        gesture_count++;
+        gestures[gesture_count] = '\0';
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: reset
+********************************************************************************
+* Summary:
+*  Clears the waveform, the virtual clock and the counts, and restarts the
+*  state machine with the pin at the given level.
+*
+*******************************************************************************/
+static void reset(bool pressed)
+{
+    sim_now = 0u;
+    sim_timer_count = 0u;
+    wave_count = 0u;
+    wave_next = 0u;
+    pin_pressed = pressed;
+    pin_interrupts = 0u;
+    timer_wakeups = 0u;
+    gestures[0] = '\0';
+    gesture_count = 0u;
+
+    button_gesture_init(&pin_backend, record_gesture);
+    pin_enabled = true;
+}
+
+
+/*******************************************************************************
+* Function Name: wave_add
+********************************************************************************
+* Summary:
+*  Appends a pin level change to the waveform.
+*
+*******************************************************************************/
+static void wave_add(uint32_t time, bool pressed)
+{
+    if(wave_count < MAX_TRANSITIONS)
+    {
+        wave[wave_count].time = time;
+        wave[wave_count].pressed = pressed;
+        wave_count++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: wave_edge
+********************************************************************************
+* Summary:
+*  Appends an edge to the given level that bounces for bounce_us: the
+*  contacts toggle at random intervals of 50 to 800 us before they settle.
+*  Returns the time the level is stable.
+*
+*******************************************************************************/
+static uint32_t wave_edge(uint32_t time, bool pressed, uint32_t bounce_us)
+{
+    uint32_t end = time + US(bounce_us);
+    bool level = pressed;
+
+    while(time < end)
+    {
+        wave_add(time, level);
+        level = !level;
+        bounce_seed = (bounce_seed * 1103515245u) + 12345u;
+        time += US(50u + ((bounce_seed >> 16u) % 750u)) + 1u;
+    }
+
+    /* Settle on the final level */
+    wave_add(time, pressed);
+
+    return time;
+}
+
+
+/*******************************************************************************
+* Function Name: wave_press
+********************************************************************************
+* Summary:
+*  Appends a press held for hold_ms, with bounce on both edges. Returns the
+*  time of the release.
+*
+*******************************************************************************/
+static uint32_t wave_press(uint32_t time, uint32_t hold_ms, uint32_t bounce_us)
+{
+    (void)wave_edge(time, true, bounce_us);
+    return wave_edge(time + MS(hold_ms), false, bounce_us);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Plays the waveform and the timers in time order up to the given time. A
+*  pin change raises an interrupt while the pin is unmasked; the handler
+*  masks the pin as button.c does and the main loop then passes the edge to
+*  the state machine.
+*
+*******************************************************************************/
+static void sim_run(uint32_t end)
+{
+    for(;;)
+    {
+        app_timer_t *timer = NULL;
+        uint32_t next = end;
+        uint32_t i;
+
+        for(i = 0u; i < sim_timer_count; i++)
+        {
+            if(sim_timers[i]->active &&
+               ((int32_t)(next - sim_timers[i]->deadline) >= 0) &&
+               ((NULL == timer) || ((int32_t)(timer->deadline - sim_timers[i]->deadline) > 0)))
+            {
+                timer = sim_timers[i];
+                next = timer->deadline;
+            }
+        }
+
+        if((wave_next < wave_count) && ((int32_t)(next - wave[wave_next].time) >= 0) &&
+           ((NULL == timer) || (wave[wave_next].time < timer->deadline)))
+        {
+            bool changed = (wave[wave_next].pressed != pin_pressed);
+
+            sim_now = wave[wave_next].time;
+            pin_pressed = wave[wave_next].pressed;
+            wave_next++;
+
+            if(changed && pin_enabled)
+            {
+                pin_enabled = false;
+                pin_interrupts++;
+                button_gesture_edge();
+            }
+        }
+        else if(NULL != timer)
+        {
+            sim_now = timer->deadline;
+            timer->active = false;
+            timer_wakeups++;
+            timer->callback(timer->arg);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    sim_now = end;
+}
+
+
+/*******************************************************************************
+* Function Name: test_short
+********************************************************************************
+* Summary:
+*  A bouncing short press is one SHORT gesture once the double press gap
+*  has passed, for two interrupts and three timer wakeups.
+*
+*******************************************************************************/
+static void test_short(void)
+{
+    button_stats_t stats;
+    uint32_t release;
+
+    reset(false);
+    release = wave_press(MS(100u), 150u, 3000u);
+    sim_run(release + MS(BUTTON_DOUBLE_MS) - MS(50u));
+    TEST_CHECK_EQ(gesture_count, 0u);
+
+    sim_run(release + MS(1000u));
+    TEST_CHECK(0 == strcmp(gestures, "S"));
+    TEST_CHECK_EQ(pin_interrupts, 2u);
+    TEST_CHECK_EQ(timer_wakeups, 3u);
+
+    button_gesture_get_stats(&stats);
+    TEST_CHECK_EQ(stats.presses, 1u);
+    TEST_CHECK_EQ(stats.gestures, 1u);
+    TEST_CHECK_EQ(stats.timer_runs, timer_wakeups);
+}
+
+
+/*******************************************************************************
+* Function Name: test_long
+********************************************************************************
+* Summary:
+*  A press of at least BUTTON_LONG_MS is a LONG gesture reported at the
+*  release, without a gap timer.
+*
+*******************************************************************************/
+static void test_long(void)
+{
+    uint32_t release;
+
+    reset(false);
+    release = wave_press(MS(100u), BUTTON_LONG_MS + 100u, 5000u);
+    sim_run(release + MS(BUTTON_DEBOUNCE_MS) + 1u);
+    TEST_CHECK(0 == strcmp(gestures, "L"));
+
+    sim_run(release + MS(2000u));
+    TEST_CHECK(0 == strcmp(gestures, "L"));
+    TEST_CHECK_EQ(pin_interrupts + timer_wakeups, 4u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_double
+********************************************************************************
+* Summary:
+*  Two short presses inside the gap are one DOUBLE gesture; a short press
+*  followed by a long one inside the gap is SHORT then LONG.
+*
+*******************************************************************************/
+static void test_double(void)
+{
+    uint32_t release;
+
+    reset(false);
+    release = wave_press(MS(100u), 120u, 2000u);
+    release = wave_press(release + MS(200u), 120u, 2000u);
+    sim_run(release + MS(2000u));
+    TEST_CHECK(0 == strcmp(gestures, "D"));
+    TEST_CHECK_EQ(pin_interrupts + timer_wakeups, 8u);
+
+    reset(false);
+    release = wave_press(MS(100u), 120u, 2000u);
+    release = wave_press(release + MS(200u), BUTTON_LONG_MS + 100u, 2000u);
+    sim_run(release + MS(2000u));
+    TEST_CHECK(0 == strcmp(gestures, "SL"));
+
+    /* Two short presses further apart than the gap */
+    reset(false);
+    release = wave_press(MS(100u), 120u, 2000u);
+    release = wave_press(release + MS(BUTTON_DOUBLE_MS + 100u), 120u, 2000u);
+    sim_run(release + MS(2000u));
+    TEST_CHECK(0 == strcmp(gestures, "SS"));
+}
+
+
+/*******************************************************************************
+* Function Name: test_glitch
+********************************************************************************
+* Summary:
+*  A spike shorter than the debounce time is not a press, and costs one
+*  interrupt and one timer wakeup.
+*
+*******************************************************************************/
+static void test_glitch(void)
+{
+    button_stats_t stats;
+
+    reset(false);
+    wave_add(MS(100u), true);
+    wave_add(MS(100u) + US(500u), false);
+    sim_run(MS(2000u));
+
+    TEST_CHECK_EQ(gesture_count, 0u);
+    TEST_CHECK_EQ(pin_interrupts, 1u);
+    TEST_CHECK_EQ(timer_wakeups, 1u);
+    button_gesture_get_stats(&stats);
+    TEST_CHECK_EQ(stats.presses, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_long_bounce
+********************************************************************************
+* Summary:
+*  A press whose contacts are still open when the debounce timer expires is
+*  caught by the next edge, which the timer has unmasked: it costs one more
+*  interrupt and timer wakeup, and gives a single press.
+*
+*******************************************************************************/
+static void test_long_bounce(void)
+{
+    button_stats_t stats;
+    uint32_t press = MS(100u);
+    uint32_t release;
+
+    reset(false);
+    wave_add(press, true);
+    wave_add(press + US(800u), false);
+    wave_add(press + MS(BUTTON_DEBOUNCE_MS + 5u), true);
+    release = wave_edge(press + MS(200u), false, 3000u);
+    sim_run(release + MS(2000u));
+
+    TEST_CHECK(0 == strcmp(gestures, "S"));
+    button_gesture_get_stats(&stats);
+    TEST_CHECK_EQ(stats.presses, 1u);
+    TEST_CHECK_EQ(pin_interrupts, 3u);
+    TEST_CHECK_EQ(timer_wakeups, 4u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_wake_press
+********************************************************************************
+* Summary:
+*  The release of the press that woke the device is not a gesture.
+*
+*******************************************************************************/
+static void test_wake_press(void)
+{
+    uint32_t release;
+
+    reset(true);
+    release = wave_edge(MS(300u), false, 3000u);
+    sim_run(release + MS(2000u));
+    TEST_CHECK_EQ(gesture_count, 0u);
+
+    release = wave_press(release + MS(2000u), 100u, 3000u);
+    sim_run(release + MS(2000u));
+    TEST_CHECK(0 == strcmp(gestures, "S"));
+}
+
+
+/*******************************************************************************
+* Function Name: bench_wakeups
+********************************************************************************
+* Summary:
+*  Reports the wakeups per gesture, and the pin edges the masking saved,
+*  over many presses with random bounce.
+*
+*******************************************************************************/
+static void bench_wakeups(void)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t    presses;
+        uint32_t    hold_ms;
+        uint32_t    gap_ms;
+    } cases[] =
+    {
+        { "short",  1u, 150u,  0u },
+        { "long",   1u, 2000u, 0u },
+        { "double", 2u, 120u,  150u },
+    };
+    const uint32_t rounds = 50u;
+    uint32_t i;
+
+    for(i = 0u; i < (sizeof(cases) / sizeof(cases[0])); i++)
+    {
+        uint32_t edges = 0u;
+        uint32_t wakeups = 0u;
+        uint32_t gestures_seen = 0u;
+        uint32_t round;
+
+        for(round = 0u; round < rounds; round++)
+        {
+            uint32_t time = MS(100u);
+            uint32_t press;
+
+            reset(false);
+            for(press = 0u; press < cases[i].presses; press++)
+            {
+                time = wave_press(time, cases[i].hold_ms, 4000u) + MS(cases[i].gap_ms);
+            }
+            sim_run(time + MS(2000u));
+
+            edges += wave_count;
+            wakeups += pin_interrupts + timer_wakeups;
+            gestures_seen += gesture_count;
+        }
+
+        TEST_CHECK_EQ(gestures_seen, rounds);
+        printf("    %-6s: %.1f wakeups per gesture, %.1f pin transitions\n", cases[i].name,
+               (double)wakeups / rounds, (double)edges / rounds);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("button_gesture\n");
+    TEST_RUN(test_short);
+    TEST_RUN(test_long);
+    TEST_RUN(test_double);
+    TEST_RUN(test_glitch);
+    TEST_RUN(test_long_bounce);
+    TEST_RUN(test_wake_press);
+    TEST_RUN(bench_wakeups);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
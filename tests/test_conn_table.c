@@ -0,0 +1,260 @@
+/******************************************************************************
+* File Name: test_conn_table.c
+*
+* Description: This file contains the host tests of conn_table.c: links
+*              found by their connection handle only, the alert level
+*              aggregated over the links, a disconnect that leaves the alerts
+*              of the other links alone, and a benchmark of the cost of an
+*              alert write and of the RAM as links are added.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "conn_table.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define BENCH_WRITES              (1000000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+
+/*******************************************************************************
+* Function Name: make_handle
+********************************************************************************
+* Summary:
+*  Returns the connection handle of link i, with a BD handle that differs
+*  from its ATT index as it does on the stack.
+*
+*******************************************************************************/
+static cy_stc_ble_conn_handle_t make_handle(uint32_t i)
+{
+    cy_stc_ble_conn_handle_t handle;
+
+    handle.attId = (uint8_t)i;
+    handle.bdHandle = (uint8_t)(0x10u + i);
+
+    return handle;
+}
+
+
+/*******************************************************************************
+* Function Name: alert_write
+********************************************************************************
+* Summary:
+*  Handles an Alert Level write of a link as the IAS handler does: stores
+*  the level of the link and returns the level shown on the LED.
+*
+*******************************************************************************/
+static uint8_t alert_write(cy_stc_ble_conn_handle_t handle, uint8_t level)
+{
+    conn_entry_t *entry = conn_table_find(handle);
+
+    if(NULL != entry)
+    {
+        entry->alert_level = level;
+    }
+
+    return conn_table_max_alert();
+}
+
+
+/*******************************************************************************
+* Function Name: test_add_find
+********************************************************************************
+* Summary:
+*  A link is found by its full handle only. A handle beyond the table is
+*  refused, and a removed link is no longer found.
+*
+*******************************************************************************/
+static void test_add_find(void)
+{
+    cy_stc_ble_conn_handle_t handle = make_handle(1u);
+    cy_stc_ble_conn_handle_t other = handle;
+    uint32_t i;
+
+    conn_table_init();
+    TEST_CHECK_EQ(conn_table_count(), 0u);
+
+    for(i = 0u; i < CY_BLE_CONN_COUNT; i++)
+    {
+        TEST_CHECK(NULL != conn_table_add(make_handle(i)));
+    }
+    TEST_CHECK_EQ(conn_table_count(), CY_BLE_CONN_COUNT);
+    TEST_CHECK(NULL == conn_table_add(make_handle(CY_BLE_CONN_COUNT)));
+    TEST_CHECK_EQ(conn_table_count(), CY_BLE_CONN_COUNT);
+
+    TEST_CHECK(NULL != conn_table_find(handle));
+    other.bdHandle++;
+    TEST_CHECK(NULL == conn_table_find(other));
+    TEST_CHECK(NULL == conn_table_find(make_handle(CY_BLE_CONN_COUNT)));
+
+    conn_table_remove(handle);
+    TEST_CHECK(NULL == conn_table_find(handle));
+    TEST_CHECK_EQ(conn_table_count(), CY_BLE_CONN_COUNT - 1u);
+
+    /* Removing a link that is gone changes nothing */
+    conn_table_remove(handle);
+    TEST_CHECK_EQ(conn_table_count(), CY_BLE_CONN_COUNT - 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_aggregate
+********************************************************************************
+* Summary:
+*  The shown level is the highest over the links. A disconnect drops the
+*  level of that link only; the others keep theirs. A new link starts
+*  without an alert.
+*
+*******************************************************************************/
+static void test_aggregate(void)
+{
+    conn_table_init();
+    (void)conn_table_add(make_handle(0u));
+    (void)conn_table_add(make_handle(1u));
+    (void)conn_table_add(make_handle(2u));
+
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_NO_ALERT);
+    TEST_CHECK_EQ(alert_write(make_handle(0u), CY_BLE_MILD_ALERT), CY_BLE_MILD_ALERT);
+    TEST_CHECK_EQ(alert_write(make_handle(2u), CY_BLE_HIGH_ALERT), CY_BLE_HIGH_ALERT);
+    TEST_CHECK_EQ(alert_write(make_handle(1u), CY_BLE_NO_ALERT), CY_BLE_HIGH_ALERT);
+
+    conn_table_remove(make_handle(2u));
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_MILD_ALERT);
+    TEST_CHECK_EQ(conn_table_find(make_handle(0u))->alert_level, CY_BLE_MILD_ALERT);
+
+    (void)conn_table_add(make_handle(2u));
+    TEST_CHECK_EQ(conn_table_find(make_handle(2u))->alert_level, CY_BLE_NO_ALERT);
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_MILD_ALERT);
+
+    /* A write from a link that is gone is ignored */
+    conn_table_remove(make_handle(0u));
+    TEST_CHECK_EQ(alert_write(make_handle(0u), CY_BLE_HIGH_ALERT), CY_BLE_NO_ALERT);
+
+    /* The button clears the alerts of every link, which stay connected */
+    TEST_CHECK_EQ(alert_write(make_handle(1u), CY_BLE_HIGH_ALERT), CY_BLE_HIGH_ALERT);
+    conn_table_clear_alerts();
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_NO_ALERT);
+    TEST_CHECK_EQ(conn_table_count(), 2u);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_scaling
+********************************************************************************
+* Summary:
+*  Reports, for each number of connected links, the host time of an alert
+*  write (lookup, store and aggregation) and of a connect and disconnect,
+*  and the application RAM of the links. The table is indexed by the ATT
+*  connection ID, so the lookup does not depend on the number of links;
+*  the aggregation scans the CY_BLE_CONN_COUNT entries.
+*
+*******************************************************************************/
+static void bench_scaling(void)
+{
+    volatile uint8_t sink = 0u;
+    uint64_t start;
+    uint64_t write_ns;
+    uint64_t link_ns;
+    uint32_t links;
+    uint32_t i;
+
+    printf("    links  ns/write  ns/connect  RAM bytes\n");
+
+    for(links = 1u; links <= CY_BLE_CONN_COUNT; links++)
+    {
+        conn_table_init();
+        for(i = 0u; i < links; i++)
+        {
+            (void)conn_table_add(make_handle(i));
+        }
+
+        start = test_now_ns();
+        for(i = 0u; i < BENCH_WRITES; i++)
+        {
+            sink += alert_write(make_handle(i % links), (uint8_t)(i % 3u));
+        }
+        write_ns = test_now_ns() - start;
+
+        start = test_now_ns();
+        for(i = 0u; i < BENCH_WRITES; i++)
+        {
+            conn_table_remove(make_handle(links - 1u));
+            (void)conn_table_add(make_handle(links - 1u));
+        }
+        link_ns = test_now_ns() - start;
+
+        TEST_CHECK_EQ(conn_table_count(), links);
+
+        printf("    %5lu  %8.1f  %10.1f  %9lu\n", (unsigned long)links,
+               (double)write_ns / BENCH_WRITES, (double)link_ns / BENCH_WRITES,
+               (unsigned long)(links * sizeof(conn_entry_t)));
+    }
+
+    (void)sink;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("conn_table\n");
+    TEST_RUN(test_add_find);
+    TEST_RUN(test_aggregate);
+    TEST_RUN(bench_scaling);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,2024 @@
+/******************************************************************************
+* File Name: test_findme.c
+*
+* Description: This file contains the host simulation of the Find Me Target.
+*              main.c and all the application modules are built unchanged
+*              against the headers in shim/, and this file stands in for the
+*              HAL, the PDL and the BLE stack: a virtual clock drives the
+*              wakeup timer, the radio and a scripted Central, and every
+*              sleep of the application advances the clock to the next
+*              wakeup. The scenarios check the advertising timeout and the
+*              hibernate, a connection with an alert, and a long idle
+*              connection, and report the handler time per event, the
+*              wakeups per hour and the time in each power state.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "adv_policy.h"
+#include "app_event.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "bond_mgr.h"
+#include "conn_param.h"
+#include "conn_table.h"
+#include "phy_policy.h"
+#include "power_stats.h"
+#include "sleep_policy.h"
+#include "cy_retarget_io.h"
+#include "cybsp.h"
+#include "cyhal.h"
+#include "cycfg_ble.h"
+
+/* main() of main.c is built as findme_main() (see the Makefile) */
+#undef main
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SIM_HOUR_MS               (3600000u)
+#define SIM_US_PER_SEC            (1000000u)
+
+/* CPU time that the stack takes for one event */
+#define SIM_EVENT_US              (30u)
+
+#define SIM_QUEUE_SIZE            (32u)
+#define SIM_PIN_COUNT             (128u)
+#define SIM_BD_HANDLE             (3u)
+
+/* The Central opens the link at 30 ms, as phones do, and sees -60 dBm */
+#define SIM_CENTRAL_INTERVAL      (24u)
+#define SIM_CENTRAL_TIMEOUT       (500u)
+#define SIM_RSSI_DBM              (-60)
+
+/* Connection interval units of 1.25 ms, advertising units of 0.625 ms */
+#define SIM_CONN_US(intv)         ((uint64_t)(intv) * 1250u)
+#define SIM_ADV_US(intv)          ((uint64_t)(intv) * 625u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* A stack event waiting for Cy_BLE_ProcessEvents(). The pointers of the
+ * IAS and PHY parameters are set when the event is delivered.
+ */
+typedef struct
+{
+    uint32_t event;
+    union
+    {
+        cy_stc_ble_conn_handle_t                          conn_handle;
+        cy_stc_ble_timeout_param_t                        timeout;
+        cy_stc_ble_gap_connected_param_t                  connected;
+        cy_stc_ble_gap_disconnect_param_t                 disconnected;
+        cy_stc_ble_gap_auth_info_t                        auth;
+        cy_stc_ble_gap_conn_param_updated_in_controller_t updated;
+        cy_stc_ble_l2cap_conn_update_rsp_param_t          update_rsp;
+        cy_stc_ble_rssi_info_t                            rssi;
+        cy_stc_ble_data_length_change_info_t              data_length;
+        cy_stc_ble_events_param_generic_t                 generic;
+        cy_stc_ble_ias_char_value_t                       ias;
+    } param;
+    cy_stc_ble_phy_param_t  phy;
+    cy_stc_ble_gatt_value_t value;
+    uint8_t                 data;
+} sim_event_t;
+
+/* The link to the scripted Central */
+typedef struct
+{
+    bool     in_use;
+    uint16_t interval;        /* 1.25 ms units */
+    uint16_t latency;
+    uint64_t next_us;         /* next event the Peripheral listens to */
+    bool     write_pending;   /* Alert Level write at the next event */
+    uint8_t  alert_level;
+    bool     disconnect;      /* Central disconnects at the next event */
+} sim_link_t;
+
+/* What woke the CPU from sleep */
+typedef enum
+{
+    SIM_WAKE_TIMER,
+    SIM_WAKE_ADV,
+    SIM_WAKE_LINK,
+    SIM_WAKE_BUTTON,
+    SIM_WAKE_COUNT
+} sim_wake_t;
+
+/* A step of the script, run on the virtual clock */
+typedef void (*sim_action_t)(uint32_t arg);
+
+typedef struct
+{
+    uint32_t     at_ms;
+    sim_action_t action;
+    uint32_t     arg;
+} sim_step_t;
+
+typedef struct
+{
+    uint32_t   event;
+    const char *name;
+} sim_event_name_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+int findme_main(void);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* The shim cycle counter counts ns */
+uint32_t SystemCoreClock = 1000000000u;
+
+cyhal_uart_t cy_retarget_io_uart_obj;
+BACKUP_Type shim_backup;
+volatile uint8_t cy_ble_pendingFlashWrite = 0u;
+
+/* The parts of design.cybt that the application reads and changes */
+static const cy_stc_ble_params_t sim_ble_params =
+{
+    .gapRole = CY_BLE_GAP_PERIPHERAL | CY_BLE_GAP_CENTRAL
+};
+static cy_stc_ble_gap_auth_info_t sim_auth_info[1];
+static cy_stc_ble_hw_config_t sim_hw_config;
+static cy_stc_ble_gapp_adv_params_t sim_adv_params[1] =
+{
+    { 32u, 48u, 30u, 0u, 1600u, 4000u, 150u }
+};
+static cy_stc_ble_gapp_disc_param_t sim_disc_params[1] =
+{
+    { 32u, 48u, CY_BLE_GAPP_CONNECTABLE_UNDIRECTED_ADV, 0u, 0u,
+      { 0u, 0u, 0u, 0u, 0u, 0u }, 0x07u, CY_BLE_GAPP_SCAN_ANY_CONN_ANY }
+};
+static cy_stc_ble_gapp_disc_mode_info_t sim_disc_mode[1] =
+{
+    { 0x02u, sim_disc_params, 30u }
+};
+
+cy_stc_ble_config_t cy_ble_config =
+{
+    .params            = &sim_ble_params,
+    .authInfo          = sim_auth_info,
+    .hw                = &sim_hw_config,
+    .gappAdvParams     = sim_adv_params,
+    .discoveryModeInfo = sim_disc_mode
+};
+
+static const uint8_t sim_peer_addr[CY_BLE_BD_ADDR_SIZE] =
+{
+    0x11u, 0x22u, 0x33u, 0x44u, 0x55u, 0x66u
+};
+
+/* Names of the events in the handler report */
+static const sim_event_name_t sim_event_names[] =
+{
+    { CY_BLE_EVT_STACK_ON,                       "STACK_ON" },
+    { CY_BLE_EVT_TIMEOUT,                        "TIMEOUT" },
+    { CY_BLE_EVT_SET_TX_PWR_COMPLETE,            "SET_TX_PWR_COMPLETE" },
+    { CY_BLE_EVT_STACK_SHUTDOWN_COMPLETE,        "STACK_SHUTDOWN_COMPLETE" },
+    { CY_BLE_EVT_GET_RSSI_COMPLETE,              "GET_RSSI_COMPLETE" },
+    { CY_BLE_EVT_DATA_LENGTH_CHANGE,             "DATA_LENGTH_CHANGE" },
+    { CY_BLE_EVT_SET_PHY_COMPLETE,               "SET_PHY_COMPLETE" },
+    { CY_BLE_EVT_PHY_UPDATE_COMPLETE,            "PHY_UPDATE_COMPLETE" },
+    { CY_BLE_EVT_GAP_DEVICE_CONNECTED,           "GAP_DEVICE_CONNECTED" },
+    { CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,        "GAP_DEVICE_DISCONNECTED" },
+    { CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP,  "GAPP_ADVERTISEMENT_START_STOP" },
+    { CY_BLE_EVT_GAP_AUTH_REQ,                   "GAP_AUTH_REQ" },
+    { CY_BLE_EVT_GAP_AUTH_COMPLETE,              "GAP_AUTH_COMPLETE" },
+    { CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE, "GAP_CONNECTION_UPDATE_COMPLETE" },
+    { CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP,    "L2CAP_CONN_PARAM_UPDATE_RSP" },
+    { CY_BLE_EVT_GATT_CONNECT_IND,               "GATT_CONNECT_IND" },
+    { CY_BLE_EVT_GATT_DISCONNECT_IND,            "GATT_DISCONNECT_IND" },
+    { CY_BLE_EVT_IASS_WRITE_CHAR_CMD,            "IASS_WRITE_CHAR_CMD" },
+};
+
+/* Virtual clock, script and end of the scenario */
+static uint64_t sim_now_us;
+static uint64_t sim_end_us;
+static const sim_step_t *sim_script;
+static uint32_t sim_script_count;
+static uint32_t sim_next_step;
+static jmp_buf sim_exit;
+static uint32_t sim_wakeups[SIM_WAKE_COUNT];
+
+/* Wakeup timer */
+static cyhal_lptimer_event_callback_t sim_timer_callback;
+static uint64_t sim_timer_match_us;
+static bool sim_timer_armed;
+
+/* Pins and power modes */
+static bool sim_pins[SIM_PIN_COUNT];
+static cyhal_gpio_event_callback_t sim_button_callback;
+static void *sim_button_arg;
+static bool sim_button_enabled;
+static uint32_t sim_deepsleep_locks;
+static bool sim_hibernated;
+static uint64_t sim_hibernate_us;
+static uint32_t sim_hibernate_sources;
+
+/* Alert Level write of the script, until LED2 turns on */
+static uint64_t sim_alert_written_us;
+static bool sim_alert_timing;
+static uint64_t sim_alert_latency_us;
+
+/* Virtual stack */
+static void (*sim_bless_isr)(void);
+static cy_ble_callback_t sim_event_callback;
+static cy_ble_callback_t sim_ias_callback;
+static sim_event_t sim_queue[SIM_QUEUE_SIZE];
+static uint32_t sim_queue_head;
+static uint32_t sim_queue_count;
+static cy_en_ble_state_t sim_state = CY_BLE_STATE_STOPPED;
+static cy_en_ble_adv_state_t sim_adv_state = CY_BLE_ADV_STATE_STOPPED;
+static uint64_t sim_adv_interval_us;
+static uint64_t sim_adv_next_us;
+static uint64_t sim_adv_end_us;
+static uint32_t sim_adv_starts;
+static uint32_t sim_adv_directed;
+static uint32_t sim_adv_whitelist;
+static bool sim_connect_pending;
+static bool sim_bonded;
+static sim_link_t sim_link;
+
+
+/*******************************************************************************
+* Function Name: sim_ticks
+********************************************************************************
+* Summary:
+*  Returns the virtual clock in wakeup timer ticks.
+*
+*******************************************************************************/
+static uint64_t sim_ticks(void)
+{
+    return (sim_now_us * APP_TIMER_TICKS_PER_SEC) / SIM_US_PER_SEC;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_post
+********************************************************************************
+* Summary:
+*  Queues a stack event and raises the BLESS interrupt.
+*
+* Parameters:
+*  event: the event with its parameters
+*
+*******************************************************************************/
+static void sim_post(const sim_event_t *event)
+{
+    if(sim_queue_count < SIM_QUEUE_SIZE)
+    {
+        sim_queue[(sim_queue_head + sim_queue_count) % SIM_QUEUE_SIZE] = *event;
+        sim_queue_count++;
+    }
+    TEST_CHECK(sim_queue_count < SIM_QUEUE_SIZE);
+
+    if(NULL != sim_bless_isr)
+    {
+        sim_bless_isr();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_post_code
+********************************************************************************
+* Summary:
+*  Queues a stack event without parameters.
+*
+*******************************************************************************/
+static void sim_post_code(uint32_t code)
+{
+    sim_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = code;
+    sim_post(&event);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_adv_event
+********************************************************************************
+* Summary:
+*  An advertising event. The Central connects on it if the script asked it
+*  to, and the advertisement ends on its timeout.
+*
+*******************************************************************************/
+static void sim_adv_event(void)
+{
+    sim_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+
+    if(sim_connect_pending && !sim_link.in_use)
+    {
+        /* The stack stops advertising without an event when a link opens */
+        sim_connect_pending = false;
+        sim_adv_state = CY_BLE_ADV_STATE_STOPPED;
+
+        sim_link.in_use = true;
+        sim_link.interval = SIM_CENTRAL_INTERVAL;
+        sim_link.latency = 0u;
+        sim_link.next_us = sim_now_us + SIM_CONN_US(SIM_CENTRAL_INTERVAL);
+        sim_link.write_pending = false;
+        sim_link.disconnect = false;
+
+        event.event = CY_BLE_EVT_GAP_DEVICE_CONNECTED;
+        event.param.connected.status = 0u;
+        event.param.connected.role = CY_BLE_GAP_LL_ROLE_SLAVE;
+        event.param.connected.bdHandle = SIM_BD_HANDLE;
+        (void)memcpy(event.param.connected.peerAddr, sim_peer_addr, CY_BLE_BD_ADDR_SIZE);
+        event.param.connected.connIntv = SIM_CENTRAL_INTERVAL;
+        event.param.connected.connLatency = 0u;
+        event.param.connected.supervisionTO = SIM_CENTRAL_TIMEOUT;
+        sim_post(&event);
+
+        (void)memset(&event, 0, sizeof(event));
+        event.event = CY_BLE_EVT_GATT_CONNECT_IND;
+        event.param.conn_handle.bdHandle = SIM_BD_HANDLE;
+        event.param.conn_handle.attId = 0u;
+        sim_post(&event);
+    }
+    else if((0u != sim_adv_end_us) && (sim_now_us >= sim_adv_end_us))
+    {
+        sim_adv_state = CY_BLE_ADV_STATE_STOPPED;
+
+        event.event = CY_BLE_EVT_TIMEOUT;
+        event.param.timeout.reasonCode = CY_BLE_GAP_ADV_TO;
+        sim_post(&event);
+        sim_post_code(CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP);
+    }
+    else
+    {
+        /* The radio wakes the CPU with nothing to report */
+        sim_adv_next_us += sim_adv_interval_us;
+        if(NULL != sim_bless_isr)
+        {
+            sim_bless_isr();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_link_event
+********************************************************************************
+* Summary:
+*  A connection event that the Peripheral listens to. The Central sends a
+*  pending write or closes the link on it.
+*
+*******************************************************************************/
+static void sim_link_event(void)
+{
+    sim_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+    sim_link.next_us += SIM_CONN_US(sim_link.interval) * (sim_link.latency + 1u);
+
+    if(sim_link.disconnect)
+    {
+        sim_link.in_use = false;
+
+        event.event = CY_BLE_EVT_GATT_DISCONNECT_IND;
+        event.param.conn_handle.bdHandle = SIM_BD_HANDLE;
+        event.param.conn_handle.attId = 0u;
+        sim_post(&event);
+
+        (void)memset(&event, 0, sizeof(event));
+        event.event = CY_BLE_EVT_GAP_DEVICE_DISCONNECTED;
+        event.param.disconnected.status = 0u;
+        event.param.disconnected.reason = CY_BLE_HCI_ERROR_OTHER_END_TERMINATED_USER;
+        event.param.disconnected.bdHandle = SIM_BD_HANDLE;
+        sim_post(&event);
+    }
+    else if(sim_link.write_pending)
+    {
+        sim_link.write_pending = false;
+
+        event.event = CY_BLE_EVT_IASS_WRITE_CHAR_CMD;
+        event.param.ias.connHandle.bdHandle = SIM_BD_HANDLE;
+        event.param.ias.connHandle.attId = 0u;
+        event.param.ias.charIndex = CY_BLE_IAS_ALERT_LEVEL;
+        event.data = sim_link.alert_level;
+        sim_post(&event);
+    }
+    else
+    {
+        if(NULL != sim_bless_isr)
+        {
+            sim_bless_isr();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_idle
+********************************************************************************
+* Summary:
+*  Sleeps until the next wakeup: runs the script steps that are due before
+*  it, advances the virtual clock and fires the timer or the radio. Leaves
+*  the application at the end of the scenario.
+*
+*******************************************************************************/
+static void sim_idle(void)
+{
+    if(sim_now_us >= sim_end_us)
+    {
+        longjmp(sim_exit, 1);
+    }
+
+    for(;;)
+    {
+        sim_wake_t source = SIM_WAKE_COUNT;
+        uint64_t wake = UINT64_MAX;
+
+        if(sim_timer_armed)
+        {
+            wake = sim_timer_match_us;
+            source = SIM_WAKE_TIMER;
+        }
+        if(CY_BLE_ADV_STATE_ADVERTISING == sim_adv_state)
+        {
+            uint64_t adv = sim_adv_next_us;
+
+            if((0u != sim_adv_end_us) && (sim_adv_end_us < adv))
+            {
+                adv = sim_adv_end_us;
+            }
+            if(adv < wake)
+            {
+                wake = adv;
+                source = SIM_WAKE_ADV;
+            }
+        }
+        if(sim_link.in_use && (sim_link.next_us < wake))
+        {
+            wake = sim_link.next_us;
+            source = SIM_WAKE_LINK;
+        }
+
+        /* Script steps first; a button edge wakes the CPU */
+        if((sim_next_step < sim_script_count) &&
+           (((uint64_t)sim_script[sim_next_step].at_ms * 1000u) <= wake))
+        {
+            const sim_step_t *step = &sim_script[sim_next_step++];
+            uint64_t at = (uint64_t)step->at_ms * 1000u;
+
+            if(at > sim_now_us)
+            {
+                sim_now_us = at;
+            }
+            step->action(step->arg);
+            if(app_event_pending())
+            {
+                sim_wakeups[SIM_WAKE_BUTTON]++;
+                return;
+            }
+            continue;
+        }
+
+        if(wake >= sim_end_us)
+        {
+            /* Wake once more so that the sleep is accounted */
+            sim_now_us = sim_end_us;
+            return;
+        }
+
+        if(wake > sim_now_us)
+        {
+            sim_now_us = wake;
+        }
+        sim_wakeups[source]++;
+
+        switch(source)
+        {
+            case SIM_WAKE_TIMER:
+            {
+                sim_timer_armed = false;
+                sim_timer_callback(NULL, CYHAL_LPTIMER_COMPARE_MATCH);
+                break;
+            }
+            case SIM_WAKE_ADV:
+            {
+                sim_adv_event();
+                break;
+            }
+            default:
+            {
+                sim_link_event();
+                break;
+            }
+        }
+
+        if(app_event_pending())
+        {
+            return;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cybsp_init
+********************************************************************************
+* Summary:
+*  Board initialization: nothing to do.
+*
+*******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_retarget_io_init
+********************************************************************************
+* Summary:
+*  Console initialization: nothing to do.
+*
+*******************************************************************************/
+cy_rslt_t cy_retarget_io_init(cyhal_gpio_t tx, cyhal_gpio_t rx, uint32_t baudrate)
+{
+    (void)tx;
+    (void)rx;
+    (void)baudrate;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_writable
+********************************************************************************
+* Summary:
+*  The UART drops what the log writes, so it always has room.
+*
+*******************************************************************************/
+uint32_t cyhal_uart_writable(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    return 256u;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_write
+********************************************************************************
+* Summary:
+*  Drops the bytes.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length)
+{
+    (void)obj;
+    (void)tx;
+    (void)tx_length;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_is_tx_active
+********************************************************************************
+* Summary:
+*  The UART is never busy.
+*
+*******************************************************************************/
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_readable
+********************************************************************************
+* Summary:
+*  Nobody types on the console.
+*
+*******************************************************************************/
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_read
+********************************************************************************
+* Summary:
+*  Reads nothing.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_uart_read(cyhal_uart_t *obj, void *rx, size_t *rx_length)
+{
+    (void)obj;
+    (void)rx;
+
+    *rx_length = 0u;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_init
+********************************************************************************
+* Summary:
+*  Sets the initial level of a pin.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction,
+                          cyhal_gpio_drive_mode_t drive_mode, bool init_val)
+{
+    (void)direction;
+    (void)drive_mode;
+
+    sim_pins[pin % SIM_PIN_COUNT] = init_val;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_write
+********************************************************************************
+* Summary:
+*  Sets the level of a pin, and times the Alert Level write of the script
+*  up to LED2 turning on.
+*
+*******************************************************************************/
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    sim_pins[pin % SIM_PIN_COUNT] = value;
+
+    if((CYBSP_USER_LED2 == pin) && (CYBSP_LED_STATE_ON == value) && sim_alert_timing)
+    {
+        sim_alert_latency_us = sim_now_us - sim_alert_written_us;
+        sim_alert_timing = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_read
+********************************************************************************
+* Summary:
+*  Returns the level of a pin.
+*
+*******************************************************************************/
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    return sim_pins[pin % SIM_PIN_COUNT];
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_register_callback
+********************************************************************************
+* Summary:
+*  Keeps the edge handler of the button.
+*
+*******************************************************************************/
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_event_callback_t callback,
+                                  void *callback_arg)
+{
+    TEST_CHECK_EQ(pin, CYBSP_USER_BTN);
+
+    sim_button_callback = callback;
+    sim_button_arg = callback_arg;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_gpio_enable_event
+********************************************************************************
+* Summary:
+*  Enables or disables the edge interrupt of the button.
+*
+*******************************************************************************/
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event,
+                             uint8_t intr_priority, bool enable)
+{
+    (void)event;
+    (void)intr_priority;
+
+    TEST_CHECK_EQ(pin, CYBSP_USER_BTN);
+    sim_button_enabled = enable;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_init
+********************************************************************************
+* Summary:
+*  The wakeup timer counts the virtual clock.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_lptimer_init(cyhal_lptimer_t *obj)
+{
+    (void)obj;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_set_delay
+********************************************************************************
+* Summary:
+*  Sets the match a number of ticks from now.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_lptimer_set_delay(cyhal_lptimer_t *obj, uint32_t delay)
+{
+    uint64_t match = sim_ticks() + delay;
+
+    (void)obj;
+
+    /* The first microsecond at which the counter reads the match */
+    sim_timer_match_us = ((match * SIM_US_PER_SEC) + APP_TIMER_TICKS_PER_SEC - 1u) /
+                         APP_TIMER_TICKS_PER_SEC;
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_read
+********************************************************************************
+* Summary:
+*  Returns the virtual clock in ticks, wrapping like the 32-bit counter.
+*
+*******************************************************************************/
+uint32_t cyhal_lptimer_read(const cyhal_lptimer_t *obj)
+{
+    (void)obj;
+
+    return (uint32_t)sim_ticks();
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_register_callback
+********************************************************************************
+* Summary:
+*  Keeps the match handler of app_timer.c.
+*
+*******************************************************************************/
+void cyhal_lptimer_register_callback(cyhal_lptimer_t *obj,
+                                     cyhal_lptimer_event_callback_t callback,
+                                     void *callback_arg)
+{
+    (void)obj;
+    (void)callback_arg;
+
+    sim_timer_callback = callback;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_lptimer_enable_event
+********************************************************************************
+* Summary:
+*  Arms or disarms the match.
+*
+*******************************************************************************/
+void cyhal_lptimer_enable_event(cyhal_lptimer_t *obj, cyhal_lptimer_event_t event,
+                                uint8_t intr_priority, bool enable)
+{
+    (void)obj;
+    (void)event;
+    (void)intr_priority;
+
+    sim_timer_armed = enable;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_sleep
+********************************************************************************
+* Summary:
+*  CPU sleep until the next wakeup.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_syspm_sleep(void)
+{
+    sim_idle();
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_deepsleep
+********************************************************************************
+* Summary:
+*  Deep sleep until the next wakeup; refused while a driver holds the lock.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_syspm_deepsleep(void)
+{
+    if(0u != sim_deepsleep_locks)
+    {
+        return (cy_rslt_t)1u;
+    }
+
+    sim_idle();
+
+    return CY_RSLT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_hibernate
+********************************************************************************
+* Summary:
+*  Records the wakeup sources and ends the scenario; the device stays in
+*  hibernate up to its end.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_syspm_hibernate(uint32_t wakeup_source)
+{
+    sim_hibernated = true;
+    sim_hibernate_us = sim_now_us;
+    sim_hibernate_sources = wakeup_source;
+    sim_now_us = sim_end_us;
+
+    longjmp(sim_exit, 1);
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_lock_deepsleep
+********************************************************************************
+* Summary:
+*  Holds off deep sleep.
+*
+*******************************************************************************/
+void cyhal_syspm_lock_deepsleep(void)
+{
+    sim_deepsleep_locks++;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_syspm_unlock_deepsleep
+********************************************************************************
+* Summary:
+*  Releases a hold on deep sleep.
+*
+*******************************************************************************/
+void cyhal_syspm_unlock_deepsleep(void)
+{
+    sim_deepsleep_locks--;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_SysLib_GetResetReason
+********************************************************************************
+* Summary:
+*  Each scenario starts from a cold boot.
+*
+*******************************************************************************/
+uint32_t Cy_SysLib_GetResetReason(void)
+{
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_SysInt_Init
+********************************************************************************
+* Summary:
+*  Keeps the BLESS interrupt handler.
+*
+*******************************************************************************/
+cy_en_sysint_status_t Cy_SysInt_Init(const cy_stc_sysint_t *config, void (*userIsr)(void))
+{
+    TEST_CHECK_EQ(config->intrSrc, bless_interrupt_IRQn);
+    sim_bless_isr = userIsr;
+
+    return CY_SYSINT_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_RTC_GetInterruptStatus
+********************************************************************************
+* Summary:
+*  No RTC alarm is pending.
+*
+*******************************************************************************/
+uint32_t Cy_RTC_GetInterruptStatus(void)
+{
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_RTC_ClearInterrupt
+********************************************************************************
+* Summary:
+*  Nothing to clear.
+*
+*******************************************************************************/
+void Cy_RTC_ClearInterrupt(uint32_t clearMask)
+{
+    (void)clearMask;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_Init
+********************************************************************************
+* Summary:
+*  Checks that the application runs the Peripheral role.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_Init(cy_stc_ble_config_t *config)
+{
+    TEST_CHECK_EQ(config->params->gapRole, CY_BLE_GAP_PERIPHERAL);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_Enable
+********************************************************************************
+* Summary:
+*  Turns the stack on.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_Enable(void)
+{
+    sim_state = CY_BLE_STATE_ON;
+    sim_post_code(CY_BLE_EVT_STACK_ON);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_Disable
+********************************************************************************
+* Summary:
+*  Turns the stack and the radio off; the pending events are dropped.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_Disable(void)
+{
+    sim_state = CY_BLE_STATE_STOPPED;
+    sim_adv_state = CY_BLE_ADV_STATE_STOPPED;
+    sim_queue_count = 0u;
+    sim_post_code(CY_BLE_EVT_STACK_SHUTDOWN_COMPLETE);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_EnableLowPowerMode
+********************************************************************************
+* Summary:
+*  Nothing to do.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_EnableLowPowerMode(void)
+{
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_BlessIsrHandler
+********************************************************************************
+* Summary:
+*  The events are already queued.
+*
+*******************************************************************************/
+void Cy_BLE_BlessIsrHandler(void)
+{
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_ProcessEvents
+********************************************************************************
+* Summary:
+*  Delivers the events queued before the call, each after the stack time
+*  of an event.
+*
+*******************************************************************************/
+void Cy_BLE_ProcessEvents(void)
+{
+    uint32_t count = sim_queue_count;
+
+    while((count > 0u) && (sim_queue_count > 0u))
+    {
+        sim_event_t event = sim_queue[sim_queue_head];
+
+        sim_queue_head = (sim_queue_head + 1u) % SIM_QUEUE_SIZE;
+        sim_queue_count--;
+        count--;
+        sim_now_us += SIM_EVENT_US;
+
+        if(CY_BLE_EVT_PHY_UPDATE_COMPLETE == event.event)
+        {
+            event.param.generic.eventParams = &event.phy;
+        }
+
+        if(CY_BLE_EVT_IASS_WRITE_CHAR_CMD == event.event)
+        {
+            event.value.val = &event.data;
+            event.value.len = 1u;
+            event.value.actualLen = 1u;
+            event.param.ias.value = &event.value;
+            sim_ias_callback(event.event, &event.param);
+        }
+        else
+        {
+            sim_event_callback(event.event, &event.param);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_RegisterEventCallback
+********************************************************************************
+* Summary:
+*  Keeps the event handler.
+*
+*******************************************************************************/
+void Cy_BLE_RegisterEventCallback(cy_ble_callback_t callbackFunc)
+{
+    sim_event_callback = callbackFunc;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_IAS_RegisterAttrCallback
+********************************************************************************
+* Summary:
+*  Keeps the Immediate Alert Service handler.
+*
+*******************************************************************************/
+void Cy_BLE_IAS_RegisterAttrCallback(cy_ble_callback_t callbackFunc)
+{
+    sim_ias_callback = callbackFunc;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetState
+********************************************************************************
+* Summary:
+*  Returns the stack state.
+*
+*******************************************************************************/
+cy_en_ble_state_t Cy_BLE_GetState(void)
+{
+    return sim_state;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_StackGetBleSsState
+********************************************************************************
+* Summary:
+*  The BLESS sleeps between the radio events of the simulation.
+*
+*******************************************************************************/
+cy_en_ble_bless_state_t Cy_BLE_StackGetBleSsState(void)
+{
+    return CY_BLE_BLESS_STATE_DEEPSLEEP;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_StoreAppData
+********************************************************************************
+* Summary:
+*  The flash write completes at once.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_StoreAppData(const cy_stc_ble_app_flash_param_t *param)
+{
+    (void)param;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_StoreBondingData
+********************************************************************************
+* Summary:
+*  Stores the bond at once.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_StoreBondingData(void)
+{
+    cy_ble_pendingFlashWrite = 0u;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_SetTxPowerLevel
+********************************************************************************
+* Summary:
+*  Confirms the power level.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_SetTxPowerLevel(const cy_stc_ble_tx_pwr_lvl_info_t *param)
+{
+    (void)param;
+
+    sim_post_code(CY_BLE_EVT_SET_TX_PWR_COMPLETE);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetRssiPeer
+********************************************************************************
+* Summary:
+*  Reports the RSSI of the link.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GetRssiPeer(uint8_t bdHandle)
+{
+    sim_event_t event;
+
+    if(!sim_link.in_use || (SIM_BD_HANDLE != bdHandle))
+    {
+        return CY_BLE_ERROR_INVALID_OPERATION;
+    }
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_GET_RSSI_COMPLETE;
+    event.param.rssi.status = 0u;
+    event.param.rssi.rssi = SIM_RSSI_DBM;
+    event.param.rssi.bdHandle = bdHandle;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_SetPhy
+********************************************************************************
+* Summary:
+*  The Central supports the 2M PHY and takes what is asked.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_SetPhy(cy_stc_ble_set_phy_info_t *param)
+{
+    sim_event_t event;
+    uint8_t phy = (0u != (param->txPhyMask & CY_BLE_PHY_MASK_LE_2M)) ?
+                  CY_BLE_PHY_MASK_LE_2M : CY_BLE_PHY_MASK_LE_1M;
+
+    sim_post_code(CY_BLE_EVT_SET_PHY_COMPLETE);
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_PHY_UPDATE_COMPLETE;
+    event.param.generic.status = 0u;
+    event.phy.bdHandle = param->bdHandle;
+    event.phy.txPhyMask = phy;
+    event.phy.rxPhyMask = phy;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_SetDataLength
+********************************************************************************
+* Summary:
+*  The Central takes the data length that is asked.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_SetDataLength(cy_stc_ble_set_data_length_info_t *param)
+{
+    sim_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_DATA_LENGTH_CHANGE;
+    event.param.data_length.bdHandle = param->bdHandle;
+    event.param.data_length.connMaxTxOctets = param->connMaxTxOctets;
+    event.param.data_length.connMaxTxTime = param->connMaxTxTime;
+    event.param.data_length.connMaxRxOctets = param->connMaxTxOctets;
+    event.param.data_length.connMaxRxTime = param->connMaxTxTime;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetNumOfActiveConn
+********************************************************************************
+* Summary:
+*  Returns the number of links.
+*
+*******************************************************************************/
+uint8_t Cy_BLE_GetNumOfActiveConn(void)
+{
+    return sim_link.in_use ? 1u : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetAdvertisementState
+********************************************************************************
+* Summary:
+*  Returns the advertising state.
+*
+*******************************************************************************/
+cy_en_ble_adv_state_t Cy_BLE_GetAdvertisementState(void)
+{
+    return sim_adv_state;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GAPP_StartAdvertisement
+********************************************************************************
+* Summary:
+*  Advertises at the interval and for the timeout that adv_policy.c wrote
+*  into the configuration.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GAPP_StartAdvertisement(uint8_t advertisingIntervalType,
+                                                      uint8_t advIndex)
+{
+    const cy_stc_ble_gapp_adv_params_t *params = &cy_ble_config.gappAdvParams[advIndex];
+    const cy_stc_ble_gapp_disc_param_t *disc =
+        cy_ble_config.discoveryModeInfo[advIndex].advParam;
+
+    TEST_CHECK_EQ(advertisingIntervalType, CY_BLE_ADVERTISING_FAST);
+
+    if((CY_BLE_STATE_ON != sim_state) || (CY_BLE_ADV_STATE_STOPPED != sim_adv_state))
+    {
+        return CY_BLE_ERROR_INVALID_OPERATION;
+    }
+
+    sim_adv_state = CY_BLE_ADV_STATE_ADVERTISING;
+    sim_adv_interval_us = SIM_ADV_US(params->fastAdvIntervalMin);
+    sim_adv_next_us = sim_now_us + sim_adv_interval_us;
+    sim_adv_end_us = (0u != params->fastAdvTimeOut) ?
+                     (sim_now_us + ((uint64_t)params->fastAdvTimeOut * SIM_US_PER_SEC)) : 0u;
+    sim_adv_starts++;
+
+    if(CY_BLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV == disc->advType)
+    {
+        sim_adv_directed++;
+    }
+    else if(CY_BLE_GAPP_SCAN_CONN_WHITELIST_ONLY == disc->advFilterPolicy)
+    {
+        sim_adv_whitelist++;
+    }
+    else
+    {
+        /* Open advertising */
+    }
+
+    sim_post_code(CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GAPP_StopAdvertisement
+********************************************************************************
+* Summary:
+*  Stops advertising.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GAPP_StopAdvertisement(void)
+{
+    if(CY_BLE_ADV_STATE_ADVERTISING != sim_adv_state)
+    {
+        return CY_BLE_ERROR_INVALID_OPERATION;
+    }
+
+    sim_adv_state = CY_BLE_ADV_STATE_STOPPED;
+    sim_post_code(CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GAP_AuthReq
+********************************************************************************
+* Summary:
+*  The Central answers the security request with a pairing request.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GAP_AuthReq(cy_stc_ble_gap_auth_info_t *param)
+{
+    sim_event_t event;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_GAP_AUTH_REQ;
+    event.param.auth = *param;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GAPP_AuthReqReply
+********************************************************************************
+* Summary:
+*  Pairing completes and the Central is bonded; the bond waits for the
+*  flash write.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GAPP_AuthReqReply(cy_stc_ble_gap_auth_info_t *param)
+{
+    sim_event_t event;
+
+    sim_bonded = true;
+    cy_ble_pendingFlashWrite = 1u;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_GAP_AUTH_COMPLETE;
+    event.param.auth = *param;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GAP_GetBondList
+********************************************************************************
+* Summary:
+*  Returns the Central once it is bonded.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GAP_GetBondList(cy_stc_ble_gap_bonded_device_list_info_t *param)
+{
+    param->noOfDevices = 0u;
+
+    if(sim_bonded)
+    {
+        (void)memcpy(param->bdHandleAddrList[0].bdAddr.bdAddr, sim_peer_addr,
+                     CY_BLE_BD_ADDR_SIZE);
+        param->bdHandleAddrList[0].bdAddr.type = 0u;
+        param->bdHandleAddrList[0].bdHandle = SIM_BD_HANDLE;
+        param->noOfDevices = 1u;
+    }
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_AddDeviceToWhiteList
+********************************************************************************
+* Summary:
+*  The Central is the only one around, so the whitelist is not modelled.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_AddDeviceToWhiteList(cy_stc_ble_gap_bd_addr_t *param)
+{
+    (void)param;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_L2CAP_LeConnectionParamUpdateRequest
+********************************************************************************
+* Summary:
+*  The Central accepts the request and picks the shortest interval of the
+*  range.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_L2CAP_LeConnectionParamUpdateRequest(
+                                    cy_stc_ble_l2cap_conn_update_param_info_t *param)
+{
+    sim_event_t event;
+
+    if(!sim_link.in_use || (SIM_BD_HANDLE != param->bdHandle))
+    {
+        return CY_BLE_ERROR_INVALID_OPERATION;
+    }
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP;
+    event.param.update_rsp.bdHandle = param->bdHandle;
+    event.param.update_rsp.result = 0u;
+    sim_post(&event);
+
+    sim_link.interval = param->connIntvMin;
+    sim_link.latency = param->connLatency;
+
+    (void)memset(&event, 0, sizeof(event));
+    event.event = CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE;
+    event.param.updated.status = 0u;
+    event.param.updated.bdHandle = param->bdHandle;
+    event.param.updated.connIntv = param->connIntvMin;
+    event.param.updated.connLatency = param->connLatency;
+    event.param.updated.supervisionTo = param->supervisionTimeout;
+    sim_post(&event);
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_ErrorRsp
+********************************************************************************
+* Summary:
+*  Nothing to send.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTS_ErrorRsp(cy_stc_ble_gatt_err_param_t *param)
+{
+    (void)param;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_WriteRsp
+********************************************************************************
+* Summary:
+*  Nothing to send.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTS_WriteRsp(cy_stc_ble_conn_handle_t connHandle)
+{
+    (void)connHandle;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_WriteAttributeValueLocal
+********************************************************************************
+* Summary:
+*  The GATT database is not modelled.
+*
+*******************************************************************************/
+uint8_t Cy_BLE_GATTS_WriteAttributeValueLocal(const cy_stc_ble_gatt_handle_value_pair_t *param)
+{
+    (void)param;
+
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_WriteAttributeValueCCCD
+********************************************************************************
+* Summary:
+*  The GATT database is not modelled.
+*
+*******************************************************************************/
+uint8_t Cy_BLE_GATTS_WriteAttributeValueCCCD(cy_stc_ble_gatts_db_attr_val_info_t *param)
+{
+    (void)param;
+
+    return CY_BLE_GATT_ERR_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_Notification
+********************************************************************************
+* Summary:
+*  Nothing to send.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTS_Notification(cy_stc_ble_gatts_handle_value_ntf_t *param)
+{
+    (void)param;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTC_ExchangeMtuReq
+********************************************************************************
+* Summary:
+*  Nothing to send.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTC_ExchangeMtuReq(cy_stc_ble_gatt_xchg_mtu_param_t *param)
+{
+    (void)param;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATT_GetBusyStatus
+********************************************************************************
+* Summary:
+*  The stack always has room.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATT_GetBusyStatus(uint8_t attId)
+{
+    (void)attId;
+
+    return (cy_en_ble_api_result_t)CY_BLE_STACK_STATE_FREE;
+}
+
+
+/*******************************************************************************
+* Function Name: central_connect
+********************************************************************************
+* Summary:
+*  Script step: the Central connects on the next advertising event.
+*
+*******************************************************************************/
+static void central_connect(uint32_t arg)
+{
+    (void)arg;
+
+    sim_connect_pending = true;
+}
+
+
+/*******************************************************************************
+* Function Name: central_write_alert
+********************************************************************************
+* Summary:
+*  Script step: the Central writes the Alert Level, sent on the next event
+*  that the Peripheral listens to.
+*
+*******************************************************************************/
+static void central_write_alert(uint32_t level)
+{
+    TEST_CHECK(sim_link.in_use);
+
+    sim_link.write_pending = true;
+    sim_link.alert_level = (uint8_t)level;
+
+    sim_alert_written_us = sim_now_us;
+    sim_alert_timing = (CY_BLE_NO_ALERT != level);
+}
+
+
+/*******************************************************************************
+* Function Name: central_disconnect
+********************************************************************************
+* Summary:
+*  Script step: the Central closes the link on the next event.
+*
+*******************************************************************************/
+static void central_disconnect(uint32_t arg)
+{
+    (void)arg;
+
+    TEST_CHECK(sim_link.in_use);
+    sim_link.disconnect = true;
+}
+
+
+/*******************************************************************************
+* Function Name: user_button
+********************************************************************************
+* Summary:
+*  Script step: presses (1) or releases (0) the user button.
+*
+*******************************************************************************/
+static void user_button(uint32_t pressed)
+{
+    sim_pins[CYBSP_USER_BTN] = (0u != pressed) ? CYBSP_BTN_PRESSED : CYBSP_BTN_OFF;
+
+    if(sim_button_enabled && (NULL != sim_button_callback))
+    {
+        sim_button_callback(sim_button_arg,
+                            (0u != pressed) ? CYHAL_GPIO_IRQ_FALL : CYHAL_GPIO_IRQ_RISE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: check_idle_link
+********************************************************************************
+* Summary:
+*  Script step: the link has moved to the idle parameters.
+*
+*******************************************************************************/
+static void check_idle_link(uint32_t arg)
+{
+    (void)arg;
+
+    TEST_CHECK(sim_link.in_use);
+    TEST_CHECK_EQ(sim_link.interval, CONN_PARAM_IDLE_INTV_MIN);
+    TEST_CHECK_EQ(sim_link.latency, CONN_PARAM_IDLE_LATENCY);
+    TEST_CHECK_EQ(conn_table_count(), 1u);
+    TEST_CHECK_EQ(sim_pins[CYBSP_USER_LED1], CYBSP_LED_STATE_ON);
+}
+
+
+/*******************************************************************************
+* Function Name: check_alerting
+********************************************************************************
+* Summary:
+*  Script step: the high alert shows on LED2 and the link is responsive.
+*
+*******************************************************************************/
+static void check_alerting(uint32_t arg)
+{
+    (void)arg;
+
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_HIGH_ALERT);
+    TEST_CHECK_EQ(sim_pins[CYBSP_USER_LED2], CYBSP_LED_STATE_ON);
+    TEST_CHECK_EQ(sim_link.interval, CONN_PARAM_ACTIVE_INTV_MIN);
+    TEST_CHECK_EQ(sim_link.latency, CONN_PARAM_ACTIVE_LATENCY);
+}
+
+
+/*******************************************************************************
+* Function Name: check_cleared
+********************************************************************************
+* Summary:
+*  Script step: the button has cleared the alert.
+*
+*******************************************************************************/
+static void check_cleared(uint32_t arg)
+{
+    (void)arg;
+
+    TEST_CHECK_EQ(conn_table_max_alert(), CY_BLE_NO_ALERT);
+    TEST_CHECK_EQ(sim_pins[CYBSP_USER_LED2], CYBSP_LED_STATE_OFF);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_fork
+********************************************************************************
+* Summary:
+*  Runs a scenario in a child process, since the application keeps its
+*  state in static variables and main() never returns. The parent waits
+*  for the child and counts a failed child as a failure.
+*
+* Return:
+*  bool: true in the child, which runs the scenario and calls sim_join()
+*
+*******************************************************************************/
+static bool sim_fork(void)
+{
+    pid_t pid;
+    int status = 0;
+
+    (void)fflush(stdout);
+    pid = fork();
+    TEST_CHECK(pid >= 0);
+
+    if(0 == pid)
+    {
+        return true;
+    }
+
+    if((pid < 0) || (waitpid(pid, &status, 0) != pid) ||
+       !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        test_failures++;
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_join
+********************************************************************************
+* Summary:
+*  Ends the child process of a scenario with its result.
+*
+*******************************************************************************/
+static void sim_join(void)
+{
+    (void)fflush(stdout);
+    exit(TEST_RESULT());
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Boots the application on the virtual clock and runs it with a script,
+*  up to the end of the scenario or to hibernate.
+*
+*******************************************************************************/
+static void sim_run(const sim_step_t *script, uint32_t count, uint32_t end_ms)
+{
+    sim_script = script;
+    sim_script_count = count;
+    sim_end_us = (uint64_t)end_ms * 1000u;
+
+    if(0 == setjmp(sim_exit))
+    {
+        (void)findme_main();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_report
+********************************************************************************
+* Summary:
+*  Prints the wakeups per hour, the time in each power state and the
+*  handler time of each event.
+*
+*******************************************************************************/
+static void sim_report(void)
+{
+    static const char * const state_names[POWER_STATE_COUNT] =
+    {
+        "active", "BLE", "sleep", "deep sleep", "hibernate"
+    };
+    ble_dispatch_stats_t stats[BLE_DISPATCH_MAX_EVENTS];
+    uint64_t awake_us = sim_hibernated ? sim_hibernate_us : sim_end_us;
+    double hours = (double)awake_us / ((double)SIM_HOUR_MS * 1000.0);
+    power_stats_t power;
+    uint32_t count;
+    uint32_t i;
+    uint32_t j;
+
+    printf("    wakeups per hour: %.0f timer, %.0f advertising, %.0f connection, "
+           "%.0f button\n",
+           sim_wakeups[SIM_WAKE_TIMER] / hours, sim_wakeups[SIM_WAKE_ADV] / hours,
+           sim_wakeups[SIM_WAKE_LINK] / hours, sim_wakeups[SIM_WAKE_BUTTON] / hours);
+
+    power_stats_get(&power);
+    printf("    time in each state over %lu s:", (unsigned long)(power.uptime_ms / 1000u));
+    for(i = 0u; i < POWER_STATE_COUNT; i++)
+    {
+        printf(" %s %.3f s%s", state_names[i], power.residency_ms[i] / 1000.0,
+               ((i + 1u) < POWER_STATE_COUNT) ? "," : "");
+    }
+    printf("; %lu uAh/day\n", (unsigned long)power.uah_per_day);
+
+    printf("    handler time per event:\n");
+    count = ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS);
+    for(i = 0u; i < count; i++)
+    {
+        const char *name = "?";
+
+        if(0u == stats[i].hits)
+        {
+            continue;
+        }
+        for(j = 0u; j < (sizeof(sim_event_names) / sizeof(sim_event_names[0])); j++)
+        {
+            if(sim_event_names[j].event == stats[i].event)
+            {
+                name = sim_event_names[j].name;
+            }
+        }
+        printf("      %-32s %6lu hits, %7.0f ns mean, %7lu ns max\n", name,
+               (unsigned long)stats[i].hits,
+               (double)stats[i].cycles_total / stats[i].hits,
+               (unsigned long)stats[i].cycles_max);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_advertise_timeout
+********************************************************************************
+* Summary:
+*  Nobody connects: the Target steps through the three advertising stages
+*  and hibernates after 750 s, with the LEDs off and the button as a
+*  wakeup source.
+*
+*******************************************************************************/
+static void test_advertise_timeout(void)
+{
+    power_stats_t power;
+    uint64_t stages_us = (uint64_t)(ADV_FAST_TIMEOUT_S + ADV_MEDIUM_TIMEOUT_S +
+                                    ADV_SLOW_TIMEOUT_S) * SIM_US_PER_SEC;
+
+    if(sim_fork())
+    {
+        sim_run(NULL, 0u, SIM_HOUR_MS);
+
+        TEST_CHECK(sim_hibernated);
+        TEST_CHECK(sim_hibernate_us >= stages_us);
+        TEST_CHECK(sim_hibernate_us < (stages_us + (5u * SIM_US_PER_SEC)));
+        TEST_CHECK_EQ(sim_adv_starts, 3u);
+        TEST_CHECK(0u != (sim_hibernate_sources & CYHAL_SYSPM_HIBERNATE_PINB_LOW));
+        TEST_CHECK_EQ(sim_state, CY_BLE_STATE_STOPPED);
+        TEST_CHECK_EQ(sim_pins[CYBSP_USER_LED1], CYBSP_LED_STATE_OFF);
+        TEST_CHECK_EQ(sim_pins[CYBSP_USER_LED2], CYBSP_LED_STATE_OFF);
+
+        /* Awake, the device is in deep sleep nearly all the time */
+        power_stats_get(&power);
+        TEST_CHECK(power.residency_ms[POWER_STATE_DEEPSLEEP] >
+                   ((sim_hibernate_us / 1000u) * 99u) / 100u);
+
+        printf("    hibernate at %.1f s after %lu advertising stages\n",
+               (double)sim_hibernate_us / SIM_US_PER_SEC, (unsigned long)sim_adv_starts);
+        sim_report();
+        sim_join();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_connect_alert
+********************************************************************************
+* Summary:
+*  A Central connects and bonds, the link goes idle, a high alert shows on
+*  LED2 within one idle period and the button clears it. After the Central
+*  disconnects, the Target advertises to the bonded Central first.
+*
+*******************************************************************************/
+static void test_connect_alert(void)
+{
+    static const sim_step_t script[] =
+    {
+        { 1000u,  central_connect,     0u },
+        { 8000u,  check_idle_link,     0u },
+        { 10000u, central_write_alert, CY_BLE_HIGH_ALERT },
+        { 12000u, check_alerting,      0u },
+        { 15000u, user_button,         1u },
+        { 15100u, user_button,         0u },
+        { 17000u, check_cleared,       0u },
+        { 30000u, check_idle_link,     0u },
+        { 40000u, central_disconnect,  0u },
+    };
+    uint64_t idle_period_us = SIM_CONN_US(CONN_PARAM_IDLE_INTV_MIN) *
+                              (CONN_PARAM_IDLE_LATENCY + 1u);
+
+    if(sim_fork())
+    {
+        sim_run(script, sizeof(script) / sizeof(script[0]), 60000u);
+
+        TEST_CHECK(!sim_hibernated);
+        TEST_CHECK_EQ(sim_next_step, sizeof(script) / sizeof(script[0]));
+        TEST_CHECK(!sim_alert_timing);
+        TEST_CHECK(sim_alert_latency_us <= idle_period_us);
+        TEST_CHECK_EQ(bond_mgr_count(), 1u);
+        TEST_CHECK_EQ(cy_ble_pendingFlashWrite, 0u);
+        TEST_CHECK_EQ(conn_table_count(), 0u);
+
+        /* Directed, then whitelist, then open advertising again */
+        TEST_CHECK_EQ(sim_adv_directed, 1u);
+        TEST_CHECK_EQ(sim_adv_whitelist, 1u);
+        TEST_CHECK_EQ(sim_adv_state, CY_BLE_ADV_STATE_ADVERTISING);
+
+        printf("    alert shown %.1f ms after the write, idle period %.0f ms\n",
+               (double)sim_alert_latency_us / 1000.0, (double)idle_period_us / 1000.0);
+        sim_report();
+        sim_join();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_idle_connection
+********************************************************************************
+* Summary:
+*  A connection left idle for 4 hours: the link keeps the idle parameters,
+*  the Peripheral listens to one event in eight and the device is in deep
+*  sleep nearly all the time.
+*
+*******************************************************************************/
+static void test_idle_connection(void)
+{
+    static const sim_step_t script[] =
+    {
+        { 1000u, central_connect, 0u },
+    };
+    uint32_t end_ms = 4u * SIM_HOUR_MS;
+    uint64_t idle_period_us = SIM_CONN_US(CONN_PARAM_IDLE_INTV_MIN) *
+                              (CONN_PARAM_IDLE_LATENCY + 1u);
+    uint32_t link_events = (uint32_t)(((uint64_t)end_ms * 1000u) / idle_period_us);
+    phy_policy_stats_t phy;
+    power_stats_t power;
+
+    if(sim_fork())
+    {
+        sim_run(script, sizeof(script) / sizeof(script[0]), end_ms);
+
+        TEST_CHECK(!sim_hibernated);
+        check_idle_link(0u);
+
+        /* Link events at the idle period, plus the first seconds at the
+         * interval of the Central
+         */
+        TEST_CHECK(sim_wakeups[SIM_WAKE_LINK] >= link_events);
+        TEST_CHECK(sim_wakeups[SIM_WAKE_LINK] < (link_events + 500u));
+
+        /* Advertising for more Centrals stops after the fast stage */
+        TEST_CHECK_EQ(sim_adv_state, CY_BLE_ADV_STATE_STOPPED);
+        TEST_CHECK_EQ(sim_adv_starts, 2u);
+
+        phy_policy_get_stats(&phy);
+        TEST_CHECK_EQ(phy.upgrades, 1u);
+
+        power_stats_get(&power);
+        TEST_CHECK(power.residency_ms[POWER_STATE_DEEPSLEEP] > ((end_ms / 100u) * 99u));
+
+        sim_report();
+        sim_join();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the scenarios. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("findme\n");
+    TEST_RUN(test_advertise_timeout);
+    TEST_RUN(test_connect_alert);
+    TEST_RUN(test_idle_connection);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,439 @@
+/******************************************************************************
+* File Name: test_profiler.c
+*
+* Description: This file contains the host tests of profiler.c. Durations
+*              are recorded directly, so the tests check the histogram
+*              buckets, the percentiles against the exact values, the GATT
+*              report layout and the reset. The benchmark reports the cost
+*              of one PROFILER_BEGIN/PROFILER_END pair, which on the host
+*              times with the monotonic clock.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "profiler.h"
+#include "app_sched.h"
+#include "sleep_policy.h"
+#include "power_stats.h"
+#include "ble_dispatch.h"
+#include "console.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define PERCENTILE_SAMPLES        (10000u)
+#define BENCH_SCOPES              (1000000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+uint32_t SystemCoreClock = 100000000u;
+
+/* Handler tables registered by profiler.c */
+static const ble_dispatch_entry_t *sim_ble_table;
+static const console_entry_t *sim_console_table;
+static uint32_t sim_console_count;
+
+/* Last write to the GATT database */
+static uint8_t sim_gatt_value[PROFILER_REPORT_SIZE];
+static uint16_t sim_gatt_len;
+static uint32_t sim_gatt_writes;
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_register
+********************************************************************************
+* Summary:
+*  Keeps the GATT read handler of profiler.c.
+*
+*******************************************************************************/
+bool ble_dispatch_register(const ble_dispatch_entry_t *table, uint32_t count)
+{
+    (void)count;
+
+    sim_ble_table = table;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: console_register
+********************************************************************************
+* Summary:
+*  Keeps the console commands of profiler.c.
+*
+*******************************************************************************/
+bool console_register(const console_entry_t *table, uint32_t count)
+{
+    sim_console_table = table;
+    sim_console_count = count;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_WriteAttributeValueLocal
+********************************************************************************
+* Summary:
+*  Keeps a copy of the value written to the GATT database.
+*
+*******************************************************************************/
+uint8_t Cy_BLE_GATTS_WriteAttributeValueLocal(const cy_stc_ble_gatt_handle_value_pair_t *param)
+{
+    sim_gatt_len = param->value.len;
+    if(sim_gatt_len <= sizeof(sim_gatt_value))
+    {
+        (void)memcpy(sim_gatt_value, param->value.val, sim_gatt_len);
+    }
+    sim_gatt_writes++;
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_get_stats
+********************************************************************************
+* Summary:
+*  Returns empty scheduler statistics. Only the 'p' command reads them.
+*
+*******************************************************************************/
+void app_sched_get_stats(app_sched_stats_t *stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+}
+
+
+/*******************************************************************************
+* Function Name: sleep_policy_get_stats
+********************************************************************************
+* Summary:
+*  Returns empty sleep statistics. Only the 'p' command reads them.
+*
+*******************************************************************************/
+void sleep_policy_get_stats(sleep_policy_stats_t *stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+}
+
+
+/*******************************************************************************
+* Function Name: power_stats_get
+********************************************************************************
+* Summary:
+*  Returns an empty power estimate. Only the 'p' command reads it.
+*
+*******************************************************************************/
+void power_stats_get(power_stats_t *stats)
+{
+    (void)memset(stats, 0, sizeof(*stats));
+}
+
+
+/*******************************************************************************
+* Function Name: get_u32
+********************************************************************************
+* Summary:
+*  Reads a little-endian 32-bit value of the report.
+*
+*******************************************************************************/
+static uint32_t get_u32(const uint8_t *src)
+{
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8u) |
+           ((uint32_t)src[2] << 16u) | ((uint32_t)src[3] << 24u);
+}
+
+
+/*******************************************************************************
+* Function Name: check_bucket
+********************************************************************************
+* Summary:
+*  Records one value and checks that its p50, the upper bound of its bucket,
+*  is at most 25% above it.
+*
+*******************************************************************************/
+static void check_bucket(uint32_t ticks)
+{
+    profiler_summary_t summary;
+
+    profiler_reset();
+    profiler_record(PROFILER_SCOPE_BLE_DISPATCH, ticks);
+    profiler_record(PROFILER_SCOPE_BLE_DISPATCH, UINT32_MAX);
+    profiler_summarize(PROFILER_SCOPE_BLE_DISPATCH, &summary);
+
+    if((summary.p50 < ticks) || ((summary.p50 - ticks) > (ticks / 4u)))
+    {
+        printf("    value %lu has p50 %lu\n", (unsigned long)ticks, (unsigned long)summary.p50);
+        test_failures++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_buckets
+********************************************************************************
+* Summary:
+*  Values below 4 are exact; every other value, up to the largest, lands in
+*  a bucket whose upper bound is within 25% of it.
+*
+*******************************************************************************/
+static void test_buckets(void)
+{
+    unsigned int failures = test_failures;
+    uint32_t ticks;
+    uint32_t bit;
+
+    profiler_init();
+
+    for(ticks = 0u; ticks < 70000u; ticks++)
+    {
+        check_bucket(ticks);
+    }
+
+    for(bit = 16u; bit < 32u; bit++)
+    {
+        check_bucket((1uL << bit) - 1u);
+        check_bucket(1uL << bit);
+        check_bucket((1uL << bit) + (1uL << (bit - 3u)));
+    }
+    check_bucket(UINT32_MAX);
+
+    TEST_CHECK_EQ(test_failures, failures);
+}
+
+
+/*******************************************************************************
+* Function Name: test_percentiles
+********************************************************************************
+* Summary:
+*  The summary of a uniform and of a long-tailed distribution: count, min
+*  and max are exact, p50 and p99 are within 25% above the exact value.
+*
+*******************************************************************************/
+static void test_percentiles(void)
+{
+    profiler_summary_t summary;
+    uint32_t i;
+
+    profiler_reset();
+    profiler_summarize(PROFILER_SCOPE_PROCESS_EVENTS, &summary);
+    TEST_CHECK_EQ(summary.count, 0u);
+    TEST_CHECK_EQ(summary.p50, 0u);
+    TEST_CHECK_EQ(summary.max, 0u);
+
+    /* 1 to 10000 cycles */
+    for(i = 1u; i <= PERCENTILE_SAMPLES; i++)
+    {
+        profiler_record(PROFILER_SCOPE_PROCESS_EVENTS, i);
+    }
+    profiler_summarize(PROFILER_SCOPE_PROCESS_EVENTS, &summary);
+    TEST_CHECK_EQ(summary.count, PERCENTILE_SAMPLES);
+    TEST_CHECK_EQ(summary.min, 1u);
+    TEST_CHECK_EQ(summary.max, PERCENTILE_SAMPLES);
+    TEST_CHECK((summary.p50 >= 5000u) && (summary.p50 <= 6250u));
+    TEST_CHECK((summary.p99 >= 9900u) && (summary.p99 <= PERCENTILE_SAMPLES));
+
+    /* 98% at 200 cycles and 2% at 50000: the tail shows in p99 only */
+    for(i = 0u; i < PERCENTILE_SAMPLES; i++)
+    {
+        profiler_record(PROFILER_SCOPE_BLESS_ISR, ((i % 50u) == 0u) ? 50000u : 200u);
+    }
+    profiler_summarize(PROFILER_SCOPE_BLESS_ISR, &summary);
+    TEST_CHECK_EQ(summary.min, 200u);
+    TEST_CHECK((summary.p50 >= 200u) && (summary.p50 <= 250u));
+    TEST_CHECK_EQ(summary.p99, 50000u);
+    TEST_CHECK_EQ(summary.max, 50000u);
+
+    /* Scopes do not share histograms */
+    profiler_summarize(PROFILER_SCOPE_DEEPSLEEP, &summary);
+    TEST_CHECK_EQ(summary.count, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_report
+********************************************************************************
+* Summary:
+*  The report holds the summary of each scope in scope order, and a read of
+*  the Histograms characteristic writes it to the GATT database before the
+*  stack answers. Reads of other characteristics are left alone.
+*
+*******************************************************************************/
+static void test_report(void)
+{
+    static uint8_t report[PROFILER_REPORT_SIZE + 1u];
+    cy_stc_ble_gatts_char_val_read_req_t read_req;
+    profiler_summary_t summary;
+    const uint8_t *scope;
+    uint32_t i;
+
+    profiler_reset();
+    for(i = 1u; i <= 100u; i++)
+    {
+        profiler_record(PROFILER_SCOPE_BLE_DISPATCH, i * 10u);
+        profiler_record(PROFILER_SCOPE_ALERT_LATENCY, 7u);
+    }
+
+    report[PROFILER_REPORT_SIZE] = 0xA5u;
+    TEST_CHECK_EQ(profiler_serialize(report), PROFILER_REPORT_SIZE);
+    TEST_CHECK_EQ(report[PROFILER_REPORT_SIZE], 0xA5u);
+
+    for(i = 0u; i < (uint32_t)PROFILER_SCOPE_COUNT; i++)
+    {
+        scope = &report[i * PROFILER_SUMMARY_SIZE];
+        profiler_summarize((profiler_scope_t)i, &summary);
+        TEST_CHECK_EQ(get_u32(&scope[0]), summary.count);
+        TEST_CHECK_EQ(get_u32(&scope[4]), summary.min);
+        TEST_CHECK_EQ(get_u32(&scope[8]), summary.p50);
+        TEST_CHECK_EQ(get_u32(&scope[12]), summary.p99);
+        TEST_CHECK_EQ(get_u32(&scope[16]), summary.max);
+    }
+    scope = &report[PROFILER_SCOPE_BLE_DISPATCH * PROFILER_SUMMARY_SIZE];
+    TEST_CHECK_EQ(get_u32(&scope[0]), 100u);
+    TEST_CHECK_EQ(get_u32(&scope[16]), 1000u);
+
+    (void)memset(&read_req, 0, sizeof(read_req));
+    read_req.attrHandle = CY_BLE_SETTINGS_SETTING_CHAR_HANDLE;
+    sim_gatt_writes = 0u;
+    sim_ble_table[0].handler(CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ, &read_req);
+    TEST_CHECK_EQ(sim_gatt_writes, 0u);
+
+    read_req.attrHandle = CY_BLE_PROFILER_HISTOGRAMS_CHAR_HANDLE;
+    sim_ble_table[0].handler(CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ, &read_req);
+    TEST_CHECK_EQ(sim_gatt_writes, 1u);
+    TEST_CHECK_EQ(sim_gatt_len, PROFILER_REPORT_SIZE);
+    TEST_CHECK(0 == memcmp(sim_gatt_value, report, PROFILER_REPORT_SIZE));
+}
+
+
+/*******************************************************************************
+* Function Name: test_reset
+********************************************************************************
+* Summary:
+*  The 'r' console command clears every scope.
+*
+*******************************************************************************/
+static void test_reset(void)
+{
+    profiler_summary_t summary;
+    uint32_t i;
+
+    profiler_record(PROFILER_SCOPE_DEEPSLEEP, 1234u);
+
+    for(i = 0u; i < sim_console_count; i++)
+    {
+        if('r' == sim_console_table[i].command)
+        {
+            sim_console_table[i].handler('r');
+        }
+    }
+
+    for(i = 0u; i < (uint32_t)PROFILER_SCOPE_COUNT; i++)
+    {
+        profiler_summarize((profiler_scope_t)i, &summary);
+        TEST_CHECK_EQ(summary.count, 0u);
+        TEST_CHECK_EQ(summary.max, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_scope
+********************************************************************************
+* Summary:
+*  Reports the host time of an empty profiled scope, measured outside, and
+*  the p50 that the profiler records for it, which is the cost of reading
+*  the clock.
+*
+*******************************************************************************/
+static void bench_scope(void)
+{
+    profiler_summary_t summary;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t i;
+
+    profiler_reset();
+
+    start = test_now_ns();
+    for(i = 0u; i < BENCH_SCOPES; i++)
+    {
+        PROFILER_BEGIN(BLE_DISPATCH);
+        PROFILER_END(BLE_DISPATCH);
+    }
+    elapsed = test_now_ns() - start;
+
+    profiler_summarize(PROFILER_SCOPE_BLE_DISPATCH, &summary);
+    TEST_CHECK_EQ(summary.count, BENCH_SCOPES);
+    printf("    %.1f ns per empty scope on the host, recorded p50 %lu ns, p99 %lu ns\n",
+           (double)elapsed / BENCH_SCOPES, (unsigned long)summary.p50,
+           (unsigned long)summary.p99);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("profiler\n");
+    TEST_RUN(test_buckets);
+    TEST_RUN(test_percentiles);
+    TEST_RUN(test_report);
+    TEST_RUN(test_reset);
+    TEST_RUN(bench_scope);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
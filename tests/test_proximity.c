@@ -0,0 +1,528 @@
+/******************************************************************************
+* File Name: test_proximity.c
+*
+* Description: This file contains the host tests of proximity.c. The
+*              scheduler and the BLE stack are replaced by a virtual clock:
+*              each sampling wakeup requests the RSSI, and the test answers
+*              with CY_BLE_EVT_GET_RSSI_COMPLETE from a synthetic trace. The
+*              tests check the range hysteresis, the adaptive sampling
+*              period and the RSSI samples per hour of a still and of a
+*              moving peer, and report the filter time per sample.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "proximity.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "cycfg_ble.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define SIM_HOUR_MS               (3600000u)
+#define SIM_BD_HANDLE             (5u)
+
+/* Samples per hour at the shortest period, without adaptation */
+#define SIM_FIXED_SAMPLES         (SIM_HOUR_MS / PROXIMITY_SAMPLE_MIN_MS)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* RSSI of the peer at a time in ms */
+typedef int32_t (*sim_trace_t)(uint32_t now_ms);
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+/* Handlers registered by proximity.c */
+static const ble_dispatch_entry_t *sim_table;
+static uint32_t sim_table_count;
+
+/* Sampling tasks in the order proximity_init() added them */
+static app_sched_task_t *sim_tasks[CY_BLE_CONN_COUNT];
+static uint32_t sim_task_count;
+
+/* Virtual clock in ticks and the stack state */
+static uint32_t sim_now;
+static uint32_t sim_last_delay;
+static uint32_t sim_requests;
+static cy_en_ble_api_result_t sim_request_result;
+static uint32_t sim_changes;
+static uint32_t noise_seed = 1u;
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_register
+********************************************************************************
+* Summary:
+*  Keeps the handler table of proximity.c, so that the test can deliver the
+*  events.
+*
+*******************************************************************************/
+bool ble_dispatch_register(const ble_dispatch_entry_t *table, uint32_t count)
+{
+    sim_table = table;
+    sim_table_count = count;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_add
+********************************************************************************
+* Summary:
+*  Keeps a sampling task. It only runs when the test runs it.
+*
+*******************************************************************************/
+void app_sched_add(app_sched_task_t *task, app_sched_run_t run, void *arg,
+                   uint8_t priority, bool poll)
+{
+    task->run = run;
+    task->arg = arg;
+    task->priority = priority;
+    task->poll = poll;
+    task->ready = false;
+    task->timed = false;
+
+    if(sim_task_count < CY_BLE_CONN_COUNT)
+    {
+        sim_tasks[sim_task_count++] = task;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_wake
+********************************************************************************
+* Summary:
+*  Times a task on the virtual clock. The test runs it at its release tick,
+*  the latest wakeup that the slack allows.
+*
+*******************************************************************************/
+void app_sched_wake(app_sched_task_t *task, uint32_t delay_ticks, uint32_t slack_ticks)
+{
+    task->timed = true;
+    task->release = sim_now + delay_ticks;
+    task->deadline = task->release + slack_ticks;
+    sim_last_delay = delay_ticks;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_cancel
+********************************************************************************
+* Summary:
+*  Stops timing a task.
+*
+*******************************************************************************/
+void app_sched_cancel(app_sched_task_t *task)
+{
+    task->timed = false;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetRssiPeer
+********************************************************************************
+* Summary:
+*  Counts the RSSI requests, and fails them if the test asks for it.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GetRssiPeer(uint8_t bdHandle)
+{
+    (void)bdHandle;
+
+    sim_requests++;
+
+    return sim_request_result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_changed
+********************************************************************************
+* Summary:
+*  Range change callback: counts the changes.
+*
+*******************************************************************************/
+static void sim_changed(void)
+{
+    sim_changes++;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_event
+********************************************************************************
+* Summary:
+*  Delivers a BLE event to the registered handler.
+*
+*******************************************************************************/
+static void sim_event(uint32_t event, void *eventParam)
+{
+    uint32_t i;
+
+    for(i = 0u; i < sim_table_count; i++)
+    {
+        if(sim_table[i].event == event)
+        {
+            sim_table[i].handler(event, eventParam);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_connect
+********************************************************************************
+* Summary:
+*  Sets up proximity.c and opens one link.
+*
+*******************************************************************************/
+static void sim_connect(void)
+{
+    cy_stc_ble_conn_handle_t handle = { SIM_BD_HANDLE, 0u };
+
+    sim_task_count = 0u;
+    sim_now = 0u;
+    sim_requests = 0u;
+    sim_changes = 0u;
+    sim_request_result = CY_BLE_SUCCESS;
+
+    proximity_init(sim_changed);
+    sim_event(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_sample
+********************************************************************************
+* Summary:
+*  Delivers one RSSI sample of the link.
+*
+*******************************************************************************/
+static void sim_sample(int32_t dbm)
+{
+    cy_stc_ble_rssi_info_t info;
+
+    info.status = 0u;
+    info.rssi = (int8_t)((dbm < -127) ? -127 : ((dbm > 20) ? 20 : dbm));
+    info.bdHandle = SIM_BD_HANDLE;
+
+    sim_event(CY_BLE_EVT_GET_RSSI_COMPLETE, &info);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*  Runs the sampling task of the link on the virtual clock for a time, and
+*  answers each RSSI request from a trace.
+*
+* Return:
+*  uint32_t: RSSI requests made
+*
+*******************************************************************************/
+static uint32_t sim_run(uint32_t duration_ms, sim_trace_t trace)
+{
+    app_sched_task_t *task = sim_tasks[0];
+    uint32_t end = sim_now + APP_TIMER_MS_TO_TICKS(duration_ms);
+    uint32_t requests = sim_requests;
+
+    while(task->timed && (task->release <= end))
+    {
+        sim_now = task->release;
+        task->timed = false;
+        (void)task->run(task->arg);
+
+        sim_sample(trace((uint32_t)(((uint64_t)sim_now * 1000u) / APP_TIMER_TICKS_PER_SEC)));
+    }
+    sim_now = end;
+
+    return sim_requests - requests;
+}
+
+
+/*******************************************************************************
+* Function Name: noise_db
+********************************************************************************
+* Summary:
+*  Returns deterministic noise, the sum of two uniform values, in
+*  [-amplitude, amplitude] dB.
+*
+*******************************************************************************/
+static int32_t noise_db(int32_t amplitude)
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for(i = 0u; i < 2u; i++)
+    {
+        noise_seed = (noise_seed * 1103515245u) + 12345u;
+        sum += (int32_t)((noise_seed >> 16u) % (uint32_t)(amplitude + 1)) - (amplitude / 2);
+    }
+
+    return sum;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_still
+********************************************************************************
+* Summary:
+*  A peer left on a desk: -65 dBm with a little noise.
+*
+*******************************************************************************/
+static int32_t trace_still(uint32_t now_ms)
+{
+    (void)now_ms;
+
+    return -65 + noise_db(4);
+}
+
+
+/*******************************************************************************
+* Function Name: trace_moving
+********************************************************************************
+* Summary:
+*  A peer carried around a room: the RSSI swings by 20 dB every 30 s.
+*
+*******************************************************************************/
+static int32_t trace_moving(uint32_t now_ms)
+{
+    return ((0u == ((now_ms / 30000u) & 1u)) ? -60 : -80) + noise_db(4);
+}
+
+
+/*******************************************************************************
+* Function Name: test_range
+********************************************************************************
+* Summary:
+*  A link that drifts out of range raises the local alert once, clears it
+*  when it comes back, and a closed link no longer counts.
+*
+*******************************************************************************/
+static void test_range(void)
+{
+    cy_stc_ble_conn_handle_t handle = { SIM_BD_HANDLE, 0u };
+    int8_t dbm = 0;
+    uint32_t i;
+
+    sim_connect();
+    TEST_CHECK(!proximity_link_dbm(SIM_BD_HANDLE, &dbm));
+
+    for(i = 0u; i < 20u; i++)
+    {
+        sim_sample(-60);
+    }
+    TEST_CHECK(proximity_link_dbm(SIM_BD_HANDLE, &dbm));
+    TEST_CHECK_EQ(dbm, -60);
+    TEST_CHECK_EQ(proximity_alert_level(), CY_BLE_NO_ALERT);
+
+    /* Out of range, a second drop does not alert again */
+    for(i = 0u; i < 60u; i++)
+    {
+        sim_sample(-95);
+    }
+    TEST_CHECK_EQ(sim_changes, 1u);
+    TEST_CHECK_EQ(proximity_alert_level(), PROXIMITY_ALERT_LEVEL);
+
+    /* Between the thresholds, still out of range */
+    for(i = 0u; i < 60u; i++)
+    {
+        sim_sample(-82);
+    }
+    TEST_CHECK_EQ(sim_changes, 1u);
+    TEST_CHECK_EQ(proximity_alert_level(), PROXIMITY_ALERT_LEVEL);
+
+    for(i = 0u; i < 60u; i++)
+    {
+        sim_sample(-60);
+    }
+    TEST_CHECK_EQ(sim_changes, 2u);
+    TEST_CHECK_EQ(proximity_alert_level(), CY_BLE_NO_ALERT);
+
+    /* Closing a link that is out of range clears the alert */
+    for(i = 0u; i < 60u; i++)
+    {
+        sim_sample(-95);
+    }
+    TEST_CHECK_EQ(proximity_alert_level(), PROXIMITY_ALERT_LEVEL);
+    sim_event(CY_BLE_EVT_GATT_DISCONNECT_IND, &handle);
+    TEST_CHECK_EQ(proximity_alert_level(), CY_BLE_NO_ALERT);
+    TEST_CHECK(!sim_tasks[0]->timed);
+    TEST_CHECK(!proximity_link_dbm(SIM_BD_HANDLE, &dbm));
+}
+
+
+/*******************************************************************************
+* Function Name: test_failed_request
+********************************************************************************
+* Summary:
+*  A request that the stack refuses, or a sample with an error status, is
+*  retried at the same period and is not filtered.
+*
+*******************************************************************************/
+static void test_failed_request(void)
+{
+    app_sched_task_t *task;
+    cy_stc_ble_rssi_info_t info = { 0x0Cu, -20, SIM_BD_HANDLE };
+    proximity_stats_t stats;
+
+    sim_connect();
+    task = sim_tasks[0];
+    TEST_CHECK(task->timed);
+
+    sim_request_result = CY_BLE_ERROR_INVALID_OPERATION;
+    task->timed = false;
+    (void)task->run(task->arg);
+    TEST_CHECK(task->timed);
+    TEST_CHECK_EQ(sim_last_delay, APP_TIMER_MS_TO_TICKS(PROXIMITY_SAMPLE_MIN_MS));
+
+    sim_request_result = CY_BLE_SUCCESS;
+    task->timed = false;
+    sim_event(CY_BLE_EVT_GET_RSSI_COMPLETE, &info);
+    TEST_CHECK(task->timed);
+    proximity_get_stats(&stats);
+    TEST_CHECK_EQ(stats.samples, 0u);
+
+    /* A sample of another link is dropped */
+    info.status = 0u;
+    info.bdHandle = SIM_BD_HANDLE + 1u;
+    task->timed = false;
+    sim_event(CY_BLE_EVT_GET_RSSI_COMPLETE, &info);
+    TEST_CHECK(!task->timed);
+}
+
+
+/*******************************************************************************
+* Function Name: test_adaptive_period
+********************************************************************************
+* Summary:
+*  A still peer reaches the longest period and is sampled far less than at
+*  a fixed period; a step in the RSSI returns to the shortest period.
+*
+*******************************************************************************/
+static void test_adaptive_period(void)
+{
+    uint32_t still;
+    uint32_t moving;
+    uint32_t i;
+
+    sim_connect();
+    TEST_CHECK_EQ(sim_last_delay, APP_TIMER_MS_TO_TICKS(PROXIMITY_SAMPLE_MIN_MS));
+
+    still = sim_run(SIM_HOUR_MS, trace_still);
+    TEST_CHECK_EQ(sim_last_delay, APP_TIMER_MS_TO_TICKS(PROXIMITY_SAMPLE_MAX_MS));
+
+    /* One step of 20 dB */
+    sim_sample(-85);
+    TEST_CHECK_EQ(sim_last_delay, APP_TIMER_MS_TO_TICKS(PROXIMITY_SAMPLE_MIN_MS));
+
+    /* The period doubles after each run of stable samples */
+    for(i = 0u; i < 60u; i++)
+    {
+        sim_sample(-85);
+    }
+    TEST_CHECK_EQ(sim_last_delay, APP_TIMER_MS_TO_TICKS(PROXIMITY_SAMPLE_MAX_MS));
+
+    sim_connect();
+    moving = sim_run(SIM_HOUR_MS, trace_moving);
+
+    printf("    RSSI samples per hour: %lu fixed, %lu still, %lu moving\n",
+           (unsigned long)SIM_FIXED_SAMPLES, (unsigned long)still, (unsigned long)moving);
+    TEST_CHECK(still < (SIM_FIXED_SAMPLES / 4u));
+    TEST_CHECK(moving > still);
+    TEST_CHECK(moving < SIM_FIXED_SAMPLES);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_filter
+********************************************************************************
+* Summary:
+*  Reports the filter time per sample that proximity.c measures with the
+*  cycle counter, which counts ns on the host.
+*
+*******************************************************************************/
+static void bench_filter(void)
+{
+    proximity_stats_t stats;
+
+    sim_connect();
+    (void)sim_run(SIM_HOUR_MS, trace_moving);
+
+    proximity_get_stats(&stats);
+    TEST_CHECK(stats.samples > 0u);
+    printf("    filter %.1f ns per sample, %lu ns at most, over %lu samples\n",
+           (double)stats.cycles_total / stats.samples, (unsigned long)stats.cycles_max,
+           (unsigned long)stats.samples);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("proximity\n");
+    TEST_RUN(test_range);
+    TEST_RUN(test_failed_request);
+    TEST_RUN(test_adaptive_period);
+    TEST_RUN(bench_filter);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
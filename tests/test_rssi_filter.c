@@ -0,0 +1,354 @@
+/******************************************************************************
+* File Name: test_rssi_filter.c
+*
+* Description: This file contains the host tests of rssi_filter.c and a bench
+*              that runs synthetic RSSI traces through the filter and the
+*              proximity thresholds: noise reduction, step response, alert
+*              toggles near the thresholds, and the time per sample.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "rssi_filter.h"
+#include "proximity.h"
+#include <math.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TRACE_LENGTH              (2000u)
+#define BENCH_SAMPLES             (1000000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+static uint32_t noise_seed = 1u;
+
+
+/*******************************************************************************
+* Function Name: noise_db
+********************************************************************************
+* Summary:
+*  Returns deterministic noise, the sum of two uniform values, in
+*  [-amplitude, amplitude] dB.
+*
+*******************************************************************************/
+static int32_t noise_db(int32_t amplitude)
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for(i = 0u; i < 2u; i++)
+    {
+        noise_seed = (noise_seed * 1103515245u) + 12345u;
+        sum += (int32_t)((noise_seed >> 16u) % (uint32_t)(amplitude + 1)) - (amplitude / 2);
+    }
+
+    return sum;
+}
+
+
+/*******************************************************************************
+* Function Name: clamp_rssi
+********************************************************************************
+* Summary:
+*  Limits a synthetic sample to the int8_t range of the controller.
+*
+*******************************************************************************/
+static int8_t clamp_rssi(int32_t dbm)
+{
+    return (int8_t)((dbm < -127) ? -127 : ((dbm > 20) ? 20 : dbm));
+}
+
+
+/*******************************************************************************
+* Function Name: proximity_step
+********************************************************************************
+* Summary:
+*  Applies the hysteresis of proximity.c to one RSSI value and returns true
+*  if the out-of-range state changed.
+*
+*******************************************************************************/
+static bool proximity_step(bool *far, int32_t dbm)
+{
+    if(!*far && (dbm < PROXIMITY_FAR_DBM))
+    {
+        *far = true;
+        return true;
+    }
+    if(*far && (dbm > PROXIMITY_NEAR_DBM))
+    {
+        *far = false;
+        return true;
+    }
+
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: test_first_sample
+********************************************************************************
+* Summary:
+*  The first sample sets the estimate; a constant input keeps it.
+*
+*******************************************************************************/
+static void test_first_sample(void)
+{
+    rssi_filter_t filter;
+    uint32_t i;
+
+    rssi_filter_init(&filter);
+    TEST_CHECK(!filter.primed);
+    TEST_CHECK_EQ(rssi_filter_update(&filter, -63), 0);
+    TEST_CHECK_EQ(rssi_filter_dbm(&filter), -63);
+
+    for(i = 0u; i < 1000u; i++)
+    {
+        (void)rssi_filter_update(&filter, -63);
+    }
+    TEST_CHECK_EQ(rssi_filter_dbm(&filter), -63);
+    TEST_CHECK(filter.variance > 0);
+}
+
+
+/*******************************************************************************
+* Function Name: test_noise_reduction
+********************************************************************************
+* Summary:
+*  On a noisy constant trace, the filtered RSSI is much closer to the true
+*  value than the samples.
+*
+*******************************************************************************/
+static void test_noise_reduction(void)
+{
+    rssi_filter_t filter;
+    double raw_sq = 0.0;
+    double filtered_sq = 0.0;
+    int32_t sample;
+    uint32_t i;
+
+    rssi_filter_init(&filter);
+
+    for(i = 0u; i < TRACE_LENGTH; i++)
+    {
+        sample = -70 + noise_db(12);
+        (void)rssi_filter_update(&filter, clamp_rssi(sample));
+
+        /* Skip the settling of the first samples */
+        if(i >= 50u)
+        {
+            raw_sq += (double)((sample + 70) * (sample + 70));
+            filtered_sq += (double)((rssi_filter_dbm(&filter) + 70) *
+                                    (rssi_filter_dbm(&filter) + 70));
+        }
+    }
+
+    printf("    noise rms %.2f dB raw, %.2f dB filtered\n",
+           sqrt(raw_sq / (TRACE_LENGTH - 50u)), sqrt(filtered_sq / (TRACE_LENGTH - 50u)));
+    TEST_CHECK(filtered_sq < (raw_sq / 4.0));
+}
+
+
+/*******************************************************************************
+* Function Name: test_step_response
+********************************************************************************
+* Summary:
+*  After a 30 dB drop, the estimate follows within a bounded number of
+*  samples and does not overshoot.
+*
+*******************************************************************************/
+static void test_step_response(void)
+{
+    rssi_filter_t filter;
+    uint32_t settle = 0u;
+    uint32_t i;
+
+    rssi_filter_init(&filter);
+
+    for(i = 0u; i < 200u; i++)
+    {
+        (void)rssi_filter_update(&filter, -50);
+    }
+
+    for(i = 1u; i <= 200u; i++)
+    {
+        (void)rssi_filter_update(&filter, -80);
+        TEST_CHECK(rssi_filter_dbm(&filter) >= -80);
+
+        if((0u == settle) && (rssi_filter_dbm(&filter) <= -77))
+        {
+            settle = i;
+        }
+    }
+
+    printf("    30 dB step settles to 3 dB in %lu samples\n", (unsigned long)settle);
+    TEST_CHECK((settle > 0u) && (settle <= 40u));
+}
+
+
+/*******************************************************************************
+* Function Name: test_extremes
+********************************************************************************
+* Summary:
+*  Alternating samples at the ends of the RSSI range do not overflow the
+*  integer arithmetic.
+*
+*******************************************************************************/
+static void test_extremes(void)
+{
+    rssi_filter_t filter;
+    uint32_t i;
+
+    rssi_filter_init(&filter);
+
+    for(i = 0u; i < 10000u; i++)
+    {
+        (void)rssi_filter_update(&filter, (0u == (i & 1u)) ? -127 : 20);
+        TEST_CHECK((rssi_filter_dbm(&filter) >= -127) && (rssi_filter_dbm(&filter) <= 20));
+        TEST_CHECK(filter.variance > 0);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: test_proximity_trace
+********************************************************************************
+* Summary:
+*  A peer walking away and back, with noise, is reported out of range and
+*  back in range once each on the filtered RSSI, while the raw samples cross
+*  the thresholds many more times.
+*
+*******************************************************************************/
+static void test_proximity_trace(void)
+{
+    rssi_filter_t filter;
+    bool far_raw = false;
+    bool far_filtered = false;
+    uint32_t toggles_raw = 0u;
+    uint32_t toggles_filtered = 0u;
+    int32_t truth;
+    int32_t sample;
+    uint32_t i;
+
+    rssi_filter_init(&filter);
+
+    for(i = 0u; i < TRACE_LENGTH; i++)
+    {
+        /* -60 dBm, down to -100 dBm in the middle of the trace, and back */
+        truth = -60 - (int32_t)((40u * ((i < (TRACE_LENGTH / 2u)) ? i : (TRACE_LENGTH - i))) /
+                                (TRACE_LENGTH / 2u));
+        sample = truth + noise_db(12);
+
+        (void)rssi_filter_update(&filter, clamp_rssi(sample));
+
+        toggles_raw += proximity_step(&far_raw, sample) ? 1u : 0u;
+        toggles_filtered += proximity_step(&far_filtered, rssi_filter_dbm(&filter)) ? 1u : 0u;
+    }
+
+    printf("    walk-away trace: %lu alert changes raw, %lu filtered\n",
+           (unsigned long)toggles_raw, (unsigned long)toggles_filtered);
+    TEST_CHECK_EQ(toggles_filtered, 2u);
+    TEST_CHECK(toggles_raw > toggles_filtered);
+    TEST_CHECK(!far_filtered);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_update
+********************************************************************************
+* Summary:
+*  Reports the host time of one filter update.
+*
+*******************************************************************************/
+static void bench_update(void)
+{
+    static int8_t samples[1024];
+    rssi_filter_t filter;
+    volatile int32_t sink = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t i;
+
+    for(i = 0u; i < (sizeof(samples) / sizeof(samples[0])); i++)
+    {
+        samples[i] = clamp_rssi(-70 + noise_db(12));
+    }
+
+    rssi_filter_init(&filter);
+
+    start = test_now_ns();
+    for(i = 0u; i < BENCH_SAMPLES; i++)
+    {
+        sink += rssi_filter_update(&filter, samples[i & 1023u]);
+    }
+    elapsed = test_now_ns() - start;
+
+    (void)sink;
+    printf("    %.1f ns per sample on the host\n", (double)elapsed / BENCH_SAMPLES);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("rssi_filter\n");
+    TEST_RUN(test_first_sample);
+    TEST_RUN(test_noise_reduction);
+    TEST_RUN(test_step_response);
+    TEST_RUN(test_extremes);
+    TEST_RUN(test_proximity_trace);
+    TEST_RUN(bench_update);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,463 @@
+/******************************************************************************
+* File Name: test_scan_table.c
+*
+* Description: This file contains the host tests of scan_table.c: lookup,
+*              RSSI smoothing, aging and eviction, a scaling benchmark that
+*              reports the cost of one advertising report and the longest
+*              probe sequence as the number of devices grows, and a density
+*              benchmark that feeds the report stream of a scan among
+*              hundreds of tags, with the aging of the Locator.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "scan_table.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define BENCH_REPORTS             (200000u)
+
+/* Density benchmark: every tag advertises once per second, the Locator ages
+ * the table every LOCATOR_SELECT_PERIOD_MS (2 s) with a 10 s limit. Times
+ * are in ms.
+ */
+#define DENSITY_SECONDS           (120u)
+#define DENSITY_AGE_PERIOD_MS     (2000u)
+#define DENSITY_MAX_AGE_MS        (10000u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+
+/*******************************************************************************
+* Function Name: make_addr
+********************************************************************************
+* Summary:
+*  Derives a distinct, well spread device address from a device number.
+*
+*******************************************************************************/
+static void make_addr(uint32_t device, uint8_t addr[6])
+{
+    uint32_t mixed = device * 2654435761u;
+
+    addr[0] = (uint8_t)device;
+    addr[1] = (uint8_t)(device >> 8u);
+    addr[2] = (uint8_t)mixed;
+    addr[3] = (uint8_t)(mixed >> 8u);
+    addr[4] = (uint8_t)(mixed >> 16u);
+    addr[5] = (uint8_t)(mixed >> 24u);
+}
+
+
+/*******************************************************************************
+* Function Name: report
+********************************************************************************
+* Summary:
+*  Feeds one advertising report of a device and returns whether it was new.
+*
+*******************************************************************************/
+static bool report(uint32_t device, int8_t rssi, uint32_t now)
+{
+    uint8_t addr[6];
+    bool is_new;
+
+    make_addr(device, addr);
+    (void)scan_table_update(addr, 0u, rssi, now, &is_new);
+
+    return is_new;
+}
+
+
+/*******************************************************************************
+* Function Name: find
+********************************************************************************
+* Summary:
+*  Looks up a device by its number.
+*
+*******************************************************************************/
+static scan_entry_t* find(uint32_t device)
+{
+    uint8_t addr[6];
+
+    make_addr(device, addr);
+    return scan_table_find(addr, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_insert_find
+********************************************************************************
+* Summary:
+*  Every inserted device is found; a repeated report is not a new device and
+*  an address of the other type is a different device.
+*
+*******************************************************************************/
+static void test_insert_find(void)
+{
+    uint8_t addr[6];
+    bool is_new;
+    uint32_t i;
+
+    scan_table_init();
+
+    for(i = 0u; i < 100u; i++)
+    {
+        TEST_CHECK(report(i, -50, i));
+    }
+    for(i = 0u; i < 100u; i++)
+    {
+        TEST_CHECK(!report(i, -50, 100u + i));
+        TEST_CHECK(NULL != find(i));
+    }
+    TEST_CHECK_EQ(scan_table_count(), 100u);
+    TEST_CHECK(NULL == find(1000u));
+
+    make_addr(7u, addr);
+    (void)scan_table_update(addr, 1u, -50, 0u, &is_new);
+    TEST_CHECK(is_new);
+    TEST_CHECK_EQ(scan_table_count(), 101u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_rssi_smoothing
+********************************************************************************
+* Summary:
+*  The first report sets the RSSI; later reports move it by
+*  1/SCAN_TABLE_RSSI_WEIGHT of the difference. The report count saturates.
+*
+*******************************************************************************/
+static void test_rssi_smoothing(void)
+{
+    scan_entry_t *entry;
+    uint32_t i;
+
+    scan_table_init();
+
+    (void)report(1u, -40, 0u);
+    entry = find(1u);
+    TEST_CHECK_EQ(SCAN_TABLE_RSSI_DBM(entry->rssi_q4), -40);
+
+    (void)report(1u, -80, 1u);
+    entry = find(1u);
+    TEST_CHECK_EQ(SCAN_TABLE_RSSI_DBM(entry->rssi_q4), -40 - (40 / SCAN_TABLE_RSSI_WEIGHT));
+    TEST_CHECK_EQ(entry->reports, 2u);
+
+    for(i = 0u; i < 70000u; i++)
+    {
+        (void)report(1u, -80, 2u + i);
+    }
+    entry = find(1u);
+    TEST_CHECK_EQ(entry->reports, UINT16_MAX);
+    TEST_CHECK(SCAN_TABLE_RSSI_DBM(entry->rssi_q4) <= -79);
+}
+
+
+/*******************************************************************************
+* Function Name: test_age
+********************************************************************************
+* Summary:
+*  Aging removes exactly the devices older than the limit, and the removal
+*  keeps every remaining device reachable from its home slot.
+*
+*******************************************************************************/
+static void test_age(void)
+{
+    scan_table_stats_t stats;
+    uint32_t i;
+
+    scan_table_init();
+
+    /* Even devices are seen at time 0, odd ones at time 1000 */
+    for(i = 0u; i < 150u; i++)
+    {
+        (void)report(i, -60, (0u == (i & 1u)) ? 0u : 1000u);
+    }
+
+    TEST_CHECK_EQ(scan_table_age(1500u, 1000u), 75u);
+    TEST_CHECK_EQ(scan_table_count(), 75u);
+
+    for(i = 0u; i < 150u; i++)
+    {
+        TEST_CHECK((0u == (i & 1u)) == (NULL == find(i)));
+    }
+
+    scan_table_get_stats(&stats);
+    TEST_CHECK_EQ(stats.expired, 75u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_eviction
+********************************************************************************
+* Summary:
+*  A full table evicts a device to make room, never grows beyond
+*  SCAN_TABLE_MAX_ENTRIES and always keeps the device just reported.
+*
+*******************************************************************************/
+static void test_eviction(void)
+{
+    scan_table_stats_t stats;
+    uint32_t i;
+
+    scan_table_init();
+
+    for(i = 0u; i < (SCAN_TABLE_MAX_ENTRIES + 100u); i++)
+    {
+        (void)report(i, -60, i);
+        TEST_CHECK(NULL != find(i));
+        TEST_CHECK(scan_table_count() <= SCAN_TABLE_MAX_ENTRIES);
+    }
+
+    scan_table_get_stats(&stats);
+    TEST_CHECK_EQ(scan_table_count(), SCAN_TABLE_MAX_ENTRIES);
+    TEST_CHECK_EQ(stats.evictions, 100u);
+    TEST_CHECK_EQ(stats.inserts, SCAN_TABLE_MAX_ENTRIES + 100u);
+
+    /* Every device still counted is reachable */
+    for(i = 0u; i < (SCAN_TABLE_MAX_ENTRIES + 100u); i++)
+    {
+        if(NULL != find(i))
+        {
+            stats.inserts--;
+        }
+    }
+    TEST_CHECK_EQ(stats.inserts, 100u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_strongest
+********************************************************************************
+* Summary:
+*  The strongest device is chosen among those with the requested flags.
+*
+*******************************************************************************/
+static void test_strongest(void)
+{
+    scan_entry_t *entry;
+
+    scan_table_init();
+    TEST_CHECK(NULL == scan_table_strongest(0u, 0u));
+
+    (void)report(1u, -70, 0u);
+    (void)report(2u, -40, 0u);
+    (void)report(3u, -55, 0u);
+    find(1u)->flags = SCAN_TABLE_FLAG_TARGET;
+    find(2u)->flags = SCAN_TABLE_FLAG_TARGET | SCAN_TABLE_FLAG_ALERTED;
+    find(3u)->flags = SCAN_TABLE_FLAG_TARGET;
+
+    entry = scan_table_strongest(SCAN_TABLE_FLAG_TARGET, SCAN_TABLE_FLAG_ALERTED);
+    TEST_CHECK(entry == find(3u));
+
+    entry = scan_table_strongest(0u, 0u);
+    TEST_CHECK(entry == find(2u));
+}
+
+
+/*******************************************************************************
+* Function Name: bench_scaling
+********************************************************************************
+* Summary:
+*  Fills the table with an increasing number of devices and reports the
+*  time per report of a known device and the longest probe sequence. The
+*  cost should stay flat up to the 75% load limit.
+*
+*******************************************************************************/
+static void bench_scaling(void)
+{
+    static const uint32_t sizes[] = { 16u, 64u, 128u, SCAN_TABLE_MAX_ENTRIES };
+    scan_table_stats_t stats;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t seed = 1u;
+    uint32_t i;
+    uint32_t n;
+
+    printf("    devices  ns/report  max probe\n");
+
+    for(n = 0u; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        scan_table_init();
+        for(i = 0u; i < sizes[n]; i++)
+        {
+            (void)report(i, -60, 0u);
+        }
+
+        start = test_now_ns();
+        for(i = 0u; i < BENCH_REPORTS; i++)
+        {
+            seed = (seed * 1103515245u) + 12345u;
+            (void)report((seed >> 8u) % sizes[n], (int8_t)(-40 - (int8_t)(seed & 31u)), i);
+        }
+        elapsed = test_now_ns() - start;
+
+        scan_table_get_stats(&stats);
+        TEST_CHECK_EQ(scan_table_count(), sizes[n]);
+        TEST_CHECK(stats.max_probe < (SCAN_TABLE_SIZE / 4u));
+
+        printf("    %7lu  %9.1f  %9lu\n", (unsigned long)sizes[n],
+               (double)elapsed / BENCH_REPORTS, (unsigned long)stats.max_probe);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_density
+********************************************************************************
+* Summary:
+*  Feeds the reports of 50 to 600 tags, each once per second at a random
+*  point of the second, for two minutes, and ages the table as the Locator
+*  does. Reports the host time per report including the aging, the report
+*  rate that this time allows, the evictions once the tags outnumber the
+*  table, and the RAM of the table, which does not depend on the density.
+*
+*******************************************************************************/
+static void bench_density(void)
+{
+    static const uint32_t densities[] = { 50u, 150u, SCAN_TABLE_MAX_ENTRIES, 300u, 600u };
+    static uint32_t order[600];
+    scan_table_stats_t stats;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t seed = 7u;
+    uint32_t reports;
+    uint32_t swap;
+    uint32_t now;
+    uint32_t next_age;
+    uint32_t tags;
+    uint32_t n;
+    uint32_t sec;
+    uint32_t i;
+    uint32_t j;
+
+    printf("    table RAM %lu bytes (%lu slots of %lu bytes)\n",
+           (unsigned long)(SCAN_TABLE_SIZE * sizeof(scan_entry_t)),
+           (unsigned long)SCAN_TABLE_SIZE, (unsigned long)sizeof(scan_entry_t));
+    printf("    tags  ns/report  reports/s  evictions  devices\n");
+
+    for(n = 0u; n < (sizeof(densities) / sizeof(densities[0])); n++)
+    {
+        tags = densities[n];
+        for(i = 0u; i < tags; i++)
+        {
+            order[i] = i;
+        }
+
+        scan_table_init();
+        next_age = DENSITY_AGE_PERIOD_MS;
+        reports = 0u;
+        elapsed = 0u;
+
+        for(sec = 0u; sec < DENSITY_SECONDS; sec++)
+        {
+            /* A new random order of the tags in each second */
+            for(i = tags - 1u; i > 0u; i--)
+            {
+                seed = (seed * 1103515245u) + 12345u;
+                j = (seed >> 8u) % (i + 1u);
+                swap = order[i];
+                order[i] = order[j];
+                order[j] = swap;
+            }
+
+            start = test_now_ns();
+            for(i = 0u; i < tags; i++)
+            {
+                now = (sec * 1000u) + ((i * 1000u) / tags);
+                (void)report(order[i], (int8_t)(-50 - (int8_t)(order[i] % 40u)), now);
+
+                if((int32_t)(now - next_age) >= 0)
+                {
+                    (void)scan_table_age(now, DENSITY_MAX_AGE_MS);
+                    next_age += DENSITY_AGE_PERIOD_MS;
+                }
+            }
+            elapsed += test_now_ns() - start;
+            reports += tags;
+        }
+
+        scan_table_get_stats(&stats);
+        TEST_CHECK(scan_table_count() <= SCAN_TABLE_MAX_ENTRIES);
+        TEST_CHECK(stats.max_probe < (SCAN_TABLE_SIZE / 4u));
+        if(tags <= SCAN_TABLE_MAX_ENTRIES)
+        {
+            /* Every tag fits and none goes stale */
+            TEST_CHECK_EQ(stats.evictions, 0u);
+            TEST_CHECK_EQ(stats.inserts, tags);
+            TEST_CHECK_EQ(scan_table_count(), tags);
+        }
+
+        printf("    %4lu  %9.1f  %9.0f  %9lu  %7lu\n", (unsigned long)tags,
+               (double)elapsed / reports, (1e9 * reports) / (double)elapsed,
+               (unsigned long)stats.evictions, (unsigned long)scan_table_count());
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("scan_table\n");
+    TEST_RUN(test_insert_find);
+    TEST_RUN(test_rssi_smoothing);
+    TEST_RUN(test_age);
+    TEST_RUN(test_eviction);
+    TEST_RUN(test_strongest);
+    TEST_RUN(bench_scaling);
+    TEST_RUN(bench_density);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,691 @@
+/******************************************************************************
+* File Name: test_settings.c
+*
+* Description: This file contains the host tests of settings.c behind a small
+*              flash shim that stands in for Cy_BLE_StoreAppData(): defaults
+*              on erased flash, commit and reload, the row ring, recovery of
+*              the previous snapshot from a corrupt or torn row, the priority
+*              of bonding data, and writes to the Setting characteristic. A
+*              benchmark reports the boot-time scan against the number of
+*              stored records and of corrupt rows.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "settings.h"
+#include "ble_dispatch.h"
+#include "cy_pdl.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define ROW_SIZE                  (CY_FLASH_SIZEOF_ROW)
+
+/* Header of a row in settings.c: magic, sequence, count and CRC */
+#define ROW_HEADER_SIZE           (16u)
+#define ROW_COUNT_OFFSET          (8u)
+#define ROW_CRC_OFFSET            (12u)
+
+/* Boots timed per benchmark case */
+#define BENCH_BOOTS               (20000u)
+
+/* Bytes of a row that reach the flash before a simulated power loss: the
+ * header and the key of the first record
+ */
+#define TORN_BYTES                (ROW_HEADER_SIZE + 4u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+typedef enum
+{
+    FLASH_OK,
+    FLASH_FAIL,
+    FLASH_TORN
+} flash_mode_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+volatile uint8_t cy_ble_pendingFlashWrite = 0u;
+
+static flash_mode_t flash_mode = FLASH_OK;
+static bool flash_busy = false;
+static uint32_t flash_calls = 0u;
+static uint32_t flash_writes = 0u;
+static uint8_t *flash_base = NULL;
+static uint8_t *flash_last_row = NULL;
+
+static uint32_t error_rsp_count = 0u;
+static uint8_t error_rsp_code = 0u;
+static uint32_t write_rsp_count = 0u;
+
+static ble_dispatch_handler_t write_handler = NULL;
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_StoreAppData
+********************************************************************************
+* Summary:
+*  Flash shim. Like the BLE stack, the first call of a write starts it and
+*  returns CY_BLE_INFO_FLASH_WRITE_IN_PROGRESS, and the next call completes
+*  it. The row is erased before it is programmed; in FLASH_TORN mode only
+*  TORN_BYTES are programmed and the write never completes.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_StoreAppData(const cy_stc_ble_app_flash_param_t *param)
+{
+    /* The firmware places the ring in flash as const data */
+    uint8_t *row = (uint8_t *)(uintptr_t)param->destAddr;
+
+    flash_calls++;
+
+    if(FLASH_FAIL == flash_mode)
+    {
+        return CY_BLE_ERROR_FLASH_WRITE;
+    }
+
+    if(!flash_busy)
+    {
+        flash_busy = true;
+        flash_last_row = row;
+        if(NULL == flash_base)
+        {
+            /* The first write to erased flash goes to the first row */
+            flash_base = row;
+        }
+
+        (void)memset(row, 0, param->buffLen);
+        if(FLASH_TORN == flash_mode)
+        {
+            (void)memcpy(row, param->srcBuff, TORN_BYTES);
+        }
+        return CY_BLE_INFO_FLASH_WRITE_IN_PROGRESS;
+    }
+
+    if(FLASH_TORN == flash_mode)
+    {
+        return CY_BLE_INFO_FLASH_WRITE_IN_PROGRESS;
+    }
+
+    (void)memcpy(row, param->srcBuff, param->buffLen);
+    flash_busy = false;
+    flash_writes++;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_ErrorRsp
+********************************************************************************
+* Summary:
+*  Records an ATT error response.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTS_ErrorRsp(cy_stc_ble_gatt_err_param_t *param)
+{
+    error_rsp_count++;
+    error_rsp_code = param->errInfo.errorCode;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GATTS_WriteRsp
+********************************************************************************
+* Summary:
+*  Records a write response.
+*
+*******************************************************************************/
+cy_en_ble_api_result_t Cy_BLE_GATTS_WriteRsp(cy_stc_ble_conn_handle_t connHandle)
+{
+    (void)connHandle;
+    write_rsp_count++;
+
+    return CY_BLE_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: ble_dispatch_register
+********************************************************************************
+* Summary:
+*  Keeps the write request handler of settings.c so that the tests can
+*  deliver writes to it.
+*
+*******************************************************************************/
+bool ble_dispatch_register(const ble_dispatch_entry_t *table, uint32_t count)
+{
+    uint32_t i;
+
+    for(i = 0u; i < count; i++)
+    {
+        if(CY_BLE_EVT_GATTS_WRITE_REQ == table[i].event)
+        {
+            write_handler = table[i].handler;
+        }
+    }
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_erase
+********************************************************************************
+* Summary:
+*  Erases the ring and resets the shim. The ring is only known once settings.c
+*  wrote to it, so the first test starts on erased flash.
+*
+*******************************************************************************/
+static void flash_erase(void)
+{
+    if(NULL != flash_base)
+    {
+        (void)memset(flash_base, 0, SETTINGS_ROW_COUNT * ROW_SIZE);
+    }
+
+    flash_mode = FLASH_OK;
+    flash_busy = false;
+    flash_calls = 0u;
+    flash_writes = 0u;
+    cy_ble_pendingFlashWrite = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: commit
+********************************************************************************
+* Summary:
+*  Runs the main loop work of settings.c until a pending commit finished.
+*
+*******************************************************************************/
+static void commit(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < 4u; i++)
+    {
+        settings_process();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: row_index
+********************************************************************************
+* Summary:
+*  Returns the ring row of the last write.
+*
+*******************************************************************************/
+static uint32_t row_index(void)
+{
+    return (uint32_t)(flash_last_row - flash_base) / ROW_SIZE;
+}
+
+
+/*******************************************************************************
+* Function Name: write_setting
+********************************************************************************
+* Summary:
+*  Delivers a write request of the given length to the Setting
+*  characteristic.
+*
+*******************************************************************************/
+static void write_setting(uint16_t handle, uint8_t key, uint32_t value, uint16_t len)
+{
+    uint8_t data[SETTINGS_WRITE_SIZE + 1u] =
+    {
+        key, (uint8_t)value, (uint8_t)(value >> 8u), (uint8_t)(value >> 16u),
+        (uint8_t)(value >> 24u), 0u
+    };
+    cy_stc_ble_gatts_write_cmd_req_param_t write_req;
+
+    (void)memset(&write_req, 0, sizeof(write_req));
+    write_req.handleValPair.attrHandle = handle;
+    write_req.handleValPair.value.val = data;
+    write_req.handleValPair.value.len = len;
+
+    write_handler(CY_BLE_EVT_GATTS_WRITE_REQ, &write_req);
+}
+
+
+/*******************************************************************************
+* Function Name: test_defaults
+********************************************************************************
+* Summary:
+*  Erased flash gives the defaults, registers the write handler and needs no
+*  flash write.
+*
+*******************************************************************************/
+static void test_defaults(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(NULL != write_handler);
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_FAST_INTERVAL), ADV_FAST_INTERVAL_MIN);
+    TEST_CHECK_EQ(settings_get(SETTINGS_ALERT_MILD_ON_MS), STATUS_LED_MILD_ON_MS);
+    TEST_CHECK_EQ(settings_get(SETTINGS_TX_POWER_LEVEL), 0u);
+
+    commit();
+    TEST_CHECK_EQ(flash_calls, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_commit_load
+********************************************************************************
+* Summary:
+*  A committed snapshot is loaded by the next init; a change that was not
+*  committed is lost.
+*
+*******************************************************************************/
+static void test_commit_load(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_FAST_INTERVAL, 100u));
+    TEST_CHECK(settings_set(SETTINGS_ALERT_MILD_ON_MS, 50u));
+    commit();
+    TEST_CHECK_EQ(flash_calls, 2u);
+    TEST_CHECK_EQ(flash_writes, 1u);
+    TEST_CHECK_EQ(row_index(), 0u);
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_SLOW_INTERVAL, 2000u));
+    settings_init();
+
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_FAST_INTERVAL), 100u);
+    TEST_CHECK_EQ(settings_get(SETTINGS_ALERT_MILD_ON_MS), 50u);
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_INTERVAL), ADV_SLOW_INTERVAL_MIN);
+}
+
+
+/*******************************************************************************
+* Function Name: test_range
+********************************************************************************
+* Summary:
+*  Unknown keys and values out of range are rejected; setting the current
+*  value does not cause a flash write.
+*
+*******************************************************************************/
+static void test_range(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(!settings_set(SETTINGS_ADV_FAST_INTERVAL, 31u));
+    TEST_CHECK(!settings_set(SETTINGS_ADV_FAST_INTERVAL, 16001u));
+    TEST_CHECK(!settings_set(SETTINGS_TX_POWER_LEVEL, 10u));
+    TEST_CHECK(!settings_set(SETTINGS_KEY_COUNT, 0u));
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_FAST_INTERVAL), ADV_FAST_INTERVAL_MIN);
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_FAST_INTERVAL, ADV_FAST_INTERVAL_MIN));
+    commit();
+    TEST_CHECK_EQ(flash_calls, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_ring
+********************************************************************************
+* Summary:
+*  Commits go to consecutive rows and wrap around the ring; the newest
+*  snapshot is loaded after a wrap and the next commit follows it.
+*
+*******************************************************************************/
+static void test_ring(void)
+{
+    uint32_t i;
+
+    flash_erase();
+    settings_init();
+
+    for(i = 0u; i < ((2u * SETTINGS_ROW_COUNT) + 3u); i++)
+    {
+        TEST_CHECK(settings_set(SETTINGS_ADV_MEDIUM_INTERVAL, 100u + i));
+        commit();
+        TEST_CHECK_EQ(row_index(), i % SETTINGS_ROW_COUNT);
+    }
+    TEST_CHECK_EQ(flash_writes, (2u * SETTINGS_ROW_COUNT) + 3u);
+
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_MEDIUM_INTERVAL), 100u + i - 1u);
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_MEDIUM_INTERVAL, 50u));
+    commit();
+    TEST_CHECK_EQ(row_index(), i % SETTINGS_ROW_COUNT);
+
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_MEDIUM_INTERVAL), 50u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_corrupt_row
+********************************************************************************
+* Summary:
+*  A newest row that fails its CRC check, or claims more records than a row
+*  holds, is skipped in favour of the previous snapshot.
+*
+*******************************************************************************/
+static void test_corrupt_row(void)
+{
+    uint32_t *count;
+
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_SLOW_TIMEOUT, 100u));
+    commit();
+    TEST_CHECK(settings_set(SETTINGS_ADV_SLOW_TIMEOUT, 200u));
+    commit();
+    TEST_CHECK(settings_set(SETTINGS_ADV_SLOW_TIMEOUT, 300u));
+    commit();
+
+    /* Flip a bit in the value of the newest snapshot */
+    flash_last_row[ROW_HEADER_SIZE + 4u] ^= 0x01u;
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_TIMEOUT), 200u);
+
+    /* The previous snapshot, with an impossible record count */
+    count = (uint32_t *)(void *)&flash_base[ROW_SIZE + ROW_COUNT_OFFSET];
+    *count = 0xFFFFFFFFu;
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_TIMEOUT), 100u);
+
+    /* The next commit does not overwrite the snapshot in use */
+    TEST_CHECK(settings_set(SETTINGS_ADV_SLOW_TIMEOUT, 400u));
+    commit();
+    TEST_CHECK(row_index() != 0u);
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_TIMEOUT), 400u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_torn_write
+********************************************************************************
+* Summary:
+*  A reset in the middle of a commit leaves a row with a valid header and
+*  missing records; the next init falls back to the previous snapshot.
+*
+*******************************************************************************/
+static void test_torn_write(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(settings_set(SETTINGS_ALERT_MILD_OFF_MS, 500u));
+    commit();
+
+    TEST_CHECK(settings_set(SETTINGS_ALERT_MILD_OFF_MS, 700u));
+    flash_mode = FLASH_TORN;
+    commit();
+    TEST_CHECK_EQ(flash_writes, 1u);
+    TEST_CHECK_EQ(row_index(), 1u);
+
+    /* Reset */
+    flash_mode = FLASH_OK;
+    flash_busy = false;
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ALERT_MILD_OFF_MS), 500u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_bond_priority
+********************************************************************************
+* Summary:
+*  A commit waits while the BLE stack has bonding data to write.
+*
+*******************************************************************************/
+static void test_bond_priority(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_WHITELIST_TIMEOUT, 20u));
+    cy_ble_pendingFlashWrite = 1u;
+    commit();
+    TEST_CHECK_EQ(flash_calls, 0u);
+
+    cy_ble_pendingFlashWrite = 0u;
+    commit();
+    TEST_CHECK_EQ(flash_writes, 1u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_write_failure
+********************************************************************************
+* Summary:
+*  A failed flash write keeps the previous snapshot and is retried.
+*
+*******************************************************************************/
+static void test_write_failure(void)
+{
+    flash_erase();
+    settings_init();
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_FAST_TIMEOUT, 10u));
+    commit();
+    TEST_CHECK(settings_set(SETTINGS_ADV_FAST_TIMEOUT, 20u));
+    flash_mode = FLASH_FAIL;
+    commit();
+    TEST_CHECK_EQ(flash_writes, 1u);
+
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_FAST_TIMEOUT), 10u);
+
+    TEST_CHECK(settings_set(SETTINGS_ADV_FAST_TIMEOUT, 20u));
+    commit();
+    flash_mode = FLASH_OK;
+    commit();
+    TEST_CHECK_EQ(flash_writes, 2u);
+
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_FAST_TIMEOUT), 20u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_gatt_write
+********************************************************************************
+* Summary:
+*  Writes to the Setting characteristic: a wrong length or a rejected value
+*  gets an ATT error, a valid write a write response, and writes to other
+*  attributes are left to other handlers.
+*
+*******************************************************************************/
+static void test_gatt_write(void)
+{
+    flash_erase();
+    settings_init();
+    error_rsp_count = 0u;
+    write_rsp_count = 0u;
+
+    write_setting(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE, SETTINGS_ADV_SLOW_INTERVAL, 3200u,
+                  SETTINGS_WRITE_SIZE - 1u);
+    TEST_CHECK_EQ(error_rsp_count, 1u);
+    TEST_CHECK_EQ(error_rsp_code, CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN);
+
+    write_setting(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE, SETTINGS_ADV_SLOW_INTERVAL, 20000u,
+                  SETTINGS_WRITE_SIZE);
+    TEST_CHECK_EQ(error_rsp_count, 2u);
+    TEST_CHECK_EQ(error_rsp_code, CY_BLE_GATT_ERR_OUT_OF_RANGE);
+
+    write_setting(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE, SETTINGS_KEY_COUNT, 100u,
+                  SETTINGS_WRITE_SIZE);
+    TEST_CHECK_EQ(error_rsp_count, 3u);
+
+    write_setting(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE + 1u, SETTINGS_ADV_SLOW_INTERVAL, 3200u,
+                  SETTINGS_WRITE_SIZE);
+    TEST_CHECK_EQ(error_rsp_count, 3u);
+    TEST_CHECK_EQ(write_rsp_count, 0u);
+
+    write_setting(CY_BLE_SETTINGS_SETTING_CHAR_HANDLE, SETTINGS_ADV_SLOW_INTERVAL, 3200u,
+                  SETTINGS_WRITE_SIZE);
+    TEST_CHECK_EQ(write_rsp_count, 1u);
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_INTERVAL), 3200u);
+
+    commit();
+    settings_init();
+    TEST_CHECK_EQ(settings_get(SETTINGS_ADV_SLOW_INTERVAL), 3200u);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_boot
+********************************************************************************
+* Summary:
+*  Fills the ring with snapshots of 0 to SETTINGS_KEY_COUNT - 1 records,
+*  breaks the CRC of the newest rows, and reports the host time of
+*  settings_init(). The scan reads every header once and checks one CRC per
+*  corrupt row plus the one it loads, so its cost is bounded by the ring
+*  size whatever was written before.
+*
+*******************************************************************************/
+static void bench_boot(void)
+{
+    const uint32_t sizes[] = { 0u, (SETTINGS_KEY_COUNT - 1u) / 2u, SETTINGS_KEY_COUNT - 1u };
+    uint8_t *rows[SETTINGS_ROW_COUNT];
+    uint32_t expected[SETTINGS_KEY_COUNT];
+    uint32_t def;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t records;
+    uint32_t corrupt;
+    uint32_t n;
+    uint32_t i;
+
+    printf("    records  corrupt rows  ns/boot\n");
+
+    for(n = 0u; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        records = sizes[n];
+
+        for(corrupt = 0u; corrupt < SETTINGS_ROW_COUNT; corrupt++)
+        {
+            flash_erase();
+            settings_init();
+            def = settings_get((settings_key_t)0);
+
+            /* Keys 1 to records differ from their defaults */
+            for(i = 1u; i <= records; i++)
+            {
+                TEST_CHECK(settings_set((settings_key_t)i, settings_get((settings_key_t)i) + 1u));
+            }
+            for(i = 0u; i < (uint32_t)SETTINGS_KEY_COUNT; i++)
+            {
+                expected[i] = settings_get((settings_key_t)i);
+            }
+
+            /* Key 0 goes out and back to its default, so each commit
+             * stores the same records
+             */
+            for(i = 0u; i < SETTINGS_ROW_COUNT; i++)
+            {
+                TEST_CHECK(settings_set((settings_key_t)0, def + 1u));
+                TEST_CHECK(settings_set((settings_key_t)0, def));
+                commit();
+                rows[i] = flash_last_row;
+            }
+
+            for(i = 0u; i < corrupt; i++)
+            {
+                rows[SETTINGS_ROW_COUNT - 1u - i][ROW_CRC_OFFSET] ^= 0x01u;
+            }
+
+            start = test_now_ns();
+            for(i = 0u; i < BENCH_BOOTS; i++)
+            {
+                settings_init();
+            }
+            elapsed = test_now_ns() - start;
+
+            for(i = 0u; i < (uint32_t)SETTINGS_KEY_COUNT; i++)
+            {
+                TEST_CHECK_EQ(settings_get((settings_key_t)i), expected[i]);
+            }
+
+            printf("    %7lu  %12lu  %7.1f\n", (unsigned long)records, (unsigned long)corrupt,
+                   (double)elapsed / BENCH_BOOTS);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("settings\n");
+    TEST_RUN(test_defaults);
+    TEST_RUN(test_commit_load);
+    TEST_RUN(test_range);
+    TEST_RUN(test_ring);
+    TEST_RUN(test_corrupt_row);
+    TEST_RUN(test_torn_write);
+    TEST_RUN(test_bond_priority);
+    TEST_RUN(test_write_failure);
+    TEST_RUN(test_gatt_write);
+    TEST_RUN(bench_boot);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,364 @@
+/******************************************************************************
+* File Name: test_sleep_policy.c
+*
+* Description: This file contains the host tests of sleep_policy.c. The BLE
+*              stack state, the next timer deadline and the pending work
+*              are set by the test. The tests check the selection table:
+*              the pick between CPU sleep and deep sleep against the charge
+*              of each mode in the current model of power_stats.h, the
+*              radio states that hold off deep sleep, and the timers and
+*              pending work that hold off hibernate.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "sleep_policy.h"
+#include "app_sched.h"
+#include "app_timer.h"
+#include "settings.h"
+#include "cycfg_ble.h"
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Idle periods swept by the break-even test, in ticks */
+#define SWEEP_TICKS               (APP_TIMER_TICKS_PER_SEC / 100u)
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+volatile uint8_t cy_ble_pendingFlashWrite;
+
+/* State seen by the policy */
+static cy_en_ble_state_t sim_ble_state;
+static cy_en_ble_bless_state_t sim_bless_state;
+static bool sim_timed;
+static uint32_t sim_delay;
+static bool sim_settings_pending;
+static bool sim_sched_pending;
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_GetState
+********************************************************************************
+* Summary:
+*  Returns the simulated state of the BLE stack.
+*
+*******************************************************************************/
+cy_en_ble_state_t Cy_BLE_GetState(void)
+{
+    return sim_ble_state;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_BLE_StackGetBleSsState
+********************************************************************************
+* Summary:
+*  Returns the simulated state of the BLE subsystem.
+*
+*******************************************************************************/
+cy_en_ble_bless_state_t Cy_BLE_StackGetBleSsState(void)
+{
+    return sim_bless_state;
+}
+
+
+/*******************************************************************************
+* Function Name: app_timer_next_delay
+********************************************************************************
+* Summary:
+*  Returns the simulated delay to the next timer deadline.
+*
+*******************************************************************************/
+bool app_timer_next_delay(uint32_t *delay_ticks)
+{
+    *delay_ticks = sim_delay;
+    return sim_timed;
+}
+
+
+/*******************************************************************************
+* Function Name: settings_pending
+********************************************************************************
+* Summary:
+*  Returns the simulated settings write state.
+*
+*******************************************************************************/
+bool settings_pending(void)
+{
+    return sim_settings_pending;
+}
+
+
+/*******************************************************************************
+* Function Name: app_sched_pending
+********************************************************************************
+* Summary:
+*  Returns the simulated scheduler state.
+*
+*******************************************************************************/
+bool app_sched_pending(void)
+{
+    return sim_sched_pending;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_reset
+********************************************************************************
+* Summary:
+*  Starts a test with the stack on, the radio asleep, no timer running and
+*  no pending work.
+*
+*******************************************************************************/
+static void sim_reset(void)
+{
+    sim_ble_state = CY_BLE_STATE_ON;
+    sim_bless_state = CY_BLE_BLESS_STATE_DEEPSLEEP;
+    sim_timed = false;
+    sim_delay = 0u;
+    sim_settings_pending = false;
+    sim_sched_pending = false;
+    cy_ble_pendingFlashWrite = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: select_at
+********************************************************************************
+* Summary:
+*  Runs the policy with the next timer deadline delay_ticks away.
+*
+*******************************************************************************/
+static sleep_mode_t select_at(uint32_t delay_ticks)
+{
+    sim_timed = true;
+    sim_delay = delay_ticks;
+
+    return sleep_policy_select();
+}
+
+
+/*******************************************************************************
+* Function Name: test_break_even
+********************************************************************************
+* Summary:
+*  For each idle period up to 10 ms, the policy picks the mode that costs
+*  the least charge in the model: the sleep current over the period,
+*  against the deep sleep current plus the charge of one entry and exit.
+*  On a tie either mode is right. With no timer running the idle period is
+*  unbounded and the policy deep sleeps.
+*
+*******************************************************************************/
+static void test_break_even(void)
+{
+    sleep_policy_stats_t before;
+    sleep_policy_stats_t after;
+    uint64_t sleep_charge;
+    uint64_t deepsleep_charge;
+    uint32_t sleeps = 0u;
+    uint32_t wrong = 0u;
+    uint32_t first_deepsleep = 0u;
+    sleep_mode_t mode;
+    uint32_t t;
+
+    sim_reset();
+    sleep_policy_get_stats(&before);
+
+    for(t = 0u; t <= SWEEP_TICKS; t++)
+    {
+        /* Charge in nA x ticks */
+        sleep_charge = (uint64_t)POWER_MODEL_SLEEP_NA * t;
+        deepsleep_charge = ((uint64_t)POWER_MODEL_DEEPSLEEP_NA * t) +
+                           ((uint64_t)POWER_MODEL_DEEPSLEEP_CHARGE_NC * APP_TIMER_TICKS_PER_SEC);
+
+        mode = select_at(t);
+        if(SLEEP_MODE_SLEEP == mode)
+        {
+            sleeps++;
+        }
+        else if(0u == first_deepsleep)
+        {
+            first_deepsleep = t;
+        }
+        else
+        {
+            /* Deep sleep again */
+        }
+
+        if(((sleep_charge < deepsleep_charge) && (SLEEP_MODE_SLEEP != mode)) ||
+           ((sleep_charge > deepsleep_charge) && (SLEEP_MODE_DEEPSLEEP != mode)))
+        {
+            wrong++;
+        }
+    }
+
+    TEST_CHECK_EQ(wrong, 0u);
+
+    sleep_policy_get_stats(&after);
+    TEST_CHECK_EQ(after.timer_near - before.timer_near, sleeps);
+    TEST_CHECK_EQ(after.ble_busy - before.ble_busy, 0u);
+
+    sim_timed = false;
+    TEST_CHECK_EQ(sleep_policy_select(), SLEEP_MODE_DEEPSLEEP);
+
+    printf("    break-even %u us, deep sleep from %lu ticks (%lu us)\n",
+           (unsigned int)SLEEP_POLICY_BREAK_EVEN_US, (unsigned long)first_deepsleep,
+           (unsigned long)(((uint64_t)first_deepsleep * 1000000u) / APP_TIMER_TICKS_PER_SEC));
+}
+
+
+/*******************************************************************************
+* Function Name: test_ble_busy
+********************************************************************************
+* Summary:
+*  The CPU sleeps while the BLE subsystem runs or prepares a radio event,
+*  however far the next timer deadline, and deep sleeps once it is back in
+*  a sleep state.
+*
+*******************************************************************************/
+static void test_ble_busy(void)
+{
+    static const cy_en_ble_bless_state_t busy[] =
+    {
+        CY_BLE_BLESS_STATE_ACTIVE, CY_BLE_BLESS_STATE_EVENT_CLOSE,
+        CY_BLE_BLESS_STATE_ECO_ON, CY_BLE_BLESS_STATE_ECO_STABLE
+    };
+    static const cy_en_ble_bless_state_t idle[] =
+    {
+        CY_BLE_BLESS_STATE_SLEEP, CY_BLE_BLESS_STATE_DEEPSLEEP
+    };
+    sleep_policy_stats_t before;
+    sleep_policy_stats_t after;
+    uint32_t i;
+
+    sim_reset();
+    sleep_policy_get_stats(&before);
+
+    for(i = 0u; i < (sizeof(busy) / sizeof(busy[0])); i++)
+    {
+        sim_bless_state = busy[i];
+        TEST_CHECK_EQ(select_at(APP_TIMER_TICKS_PER_SEC), SLEEP_MODE_SLEEP);
+    }
+
+    for(i = 0u; i < (sizeof(idle) / sizeof(idle[0])); i++)
+    {
+        sim_bless_state = idle[i];
+        TEST_CHECK_EQ(select_at(APP_TIMER_TICKS_PER_SEC), SLEEP_MODE_DEEPSLEEP);
+    }
+
+    sleep_policy_get_stats(&after);
+    TEST_CHECK_EQ(after.ble_busy - before.ble_busy, sizeof(busy) / sizeof(busy[0]));
+}
+
+
+/*******************************************************************************
+* Function Name: test_hibernate
+********************************************************************************
+* Summary:
+*  With the stack stopped, the device hibernates unless a timer is due
+*  within SLEEP_POLICY_HIBERNATE_MIN_MS, or bonding data, settings or a
+*  scheduled task are pending, however far their time. It then deep sleeps,
+*  whatever the radio state.
+*
+*******************************************************************************/
+static void test_hibernate(void)
+{
+    uint32_t min_ticks = APP_TIMER_MS_TO_TICKS(SLEEP_POLICY_HIBERNATE_MIN_MS);
+    sleep_policy_stats_t before;
+    sleep_policy_stats_t after;
+
+    sim_reset();
+    sim_ble_state = CY_BLE_STATE_STOPPED;
+    sim_bless_state = CY_BLE_BLESS_STATE_ACTIVE;
+    sleep_policy_get_stats(&before);
+
+    TEST_CHECK_EQ(sleep_policy_select(), SLEEP_MODE_HIBERNATE);
+    TEST_CHECK_EQ(select_at(0u), SLEEP_MODE_DEEPSLEEP);
+    TEST_CHECK_EQ(select_at(min_ticks - 1u), SLEEP_MODE_DEEPSLEEP);
+    TEST_CHECK_EQ(select_at(min_ticks), SLEEP_MODE_HIBERNATE);
+
+    sim_settings_pending = true;
+    TEST_CHECK_EQ(select_at(min_ticks), SLEEP_MODE_DEEPSLEEP);
+    sim_timed = false;
+    TEST_CHECK_EQ(sleep_policy_select(), SLEEP_MODE_DEEPSLEEP);
+    sim_settings_pending = false;
+
+    cy_ble_pendingFlashWrite = 1u;
+    TEST_CHECK_EQ(sleep_policy_select(), SLEEP_MODE_DEEPSLEEP);
+    cy_ble_pendingFlashWrite = 0u;
+
+    sim_sched_pending = true;
+    TEST_CHECK_EQ(select_at(APP_TIMER_TICKS_PER_SEC * 3600u), SLEEP_MODE_DEEPSLEEP);
+    sim_sched_pending = false;
+
+    TEST_CHECK_EQ(select_at(APP_TIMER_TICKS_PER_SEC * 3600u), SLEEP_MODE_HIBERNATE);
+
+    sleep_policy_get_stats(&after);
+    TEST_CHECK_EQ(after.hibernate_held - before.hibernate_held, 6u);
+    TEST_CHECK_EQ(after.timer_near - before.timer_near, 0u);
+    TEST_CHECK_EQ(after.ble_busy - before.ble_busy, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("sleep_policy\n");
+    TEST_RUN(test_break_even);
+    TEST_RUN(test_ble_busy);
+    TEST_RUN(test_hibernate);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
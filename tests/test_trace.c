@@ -0,0 +1,959 @@
+/******************************************************************************
+* File Name: test_trace.c
+*
+* Description: This file contains the host tests of trace.c. The tick
+*              counter is set by the test and the debug UART is a fake FIFO
+*              whose output is decoded back into records. The tests check
+*              the record layout with its varint deltas and captured
+*              pointer data, the eviction that keeps the record times, the
+*              dump that never waits on the UART, and the replay of a dump
+*              through the real dispatcher with the pointers rebuilt.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "test.h"
+#include "trace.h"
+#include "trace_replay_data.h"
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "console.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* TX FIFO of the SCB in byte mode */
+#define UART_FIFO_SIZE            (128u)
+
+/* A full ring as dump lines, with room to spare */
+#define CAPTURE_SIZE              (16384u)
+
+#define EVICT_RECORDS             (1000u)
+#define EVICT_DELTA               (7u)
+#define BENCH_RECORDS             (1000000u)
+
+/* Advertising data of a report, the longest legacy payload */
+#define ADV_DATA_SIZE             (31u)
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* What the handlers saw of the scenario events */
+typedef struct
+{
+    uint32_t connects;
+    uint8_t  conn_bd_handle;
+    uint8_t  alert_level;
+    uint16_t write_handle;
+    uint8_t  write_value[4];
+    uint16_t write_len;
+    uint8_t  adv_addr[6];
+    uint8_t  adv_data[ADV_DATA_SIZE];
+    uint8_t  adv_len;
+    int8_t   adv_rssi;
+} seen_t;
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+unsigned int test_failures = 0u;
+
+uint32_t SystemCoreClock = 100000000u;
+
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+/* Filled with a decoded dump before the replay */
+uint8_t trace_replay_data[TRACE_RING_SIZE];
+
+/* Ticks returned by app_timer_now() */
+static uint32_t sim_ticks;
+
+/* Console commands registered by trace.c */
+static const console_entry_t *sim_console_table;
+static uint32_t sim_console_count;
+
+/* Fake UART: free FIFO entries and the bytes written since the last reset.
+ * With auto_empty set, the FIFO is empty every time its free space is read.
+ */
+static uint32_t uart_free = UART_FIFO_SIZE;
+static char uart_capture[CAPTURE_SIZE + 1u];
+static uint32_t uart_length = 0u;
+static bool uart_auto_empty = false;
+
+static seen_t seen;
+
+
+/*******************************************************************************
+* Function Name: app_timer_now
+********************************************************************************
+* Summary:
+*  Returns the simulated tick counter.
+*
+*******************************************************************************/
+uint32_t app_timer_now(void)
+{
+    return sim_ticks;
+}
+
+
+/*******************************************************************************
+* Function Name: console_register
+********************************************************************************
+* Summary:
+*  Keeps the console commands of trace.c.
+*
+*******************************************************************************/
+bool console_register(const console_entry_t *table, uint32_t count)
+{
+    sim_console_table = table;
+    sim_console_count = count;
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_writable
+********************************************************************************
+* Summary:
+*  Returns the free entries of the fake FIFO.
+*
+*******************************************************************************/
+uint32_t cyhal_uart_writable(cyhal_uart_t *obj)
+{
+    (void)obj;
+
+    if(uart_auto_empty)
+    {
+        uart_free = UART_FIFO_SIZE;
+    }
+
+    return uart_free;
+}
+
+
+/*******************************************************************************
+* Function Name: cyhal_uart_write
+********************************************************************************
+* Summary:
+*  Appends bytes to the capture. Writing more than the FIFO holds is a
+*  check failure, since the firmware would then wait on the UART.
+*
+*******************************************************************************/
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length)
+{
+    size_t length = *tx_length;
+
+    (void)obj;
+    TEST_CHECK(length <= uart_free);
+
+    uart_free -= (uint32_t)length;
+
+    if((uart_length + length) > CAPTURE_SIZE)
+    {
+        length = CAPTURE_SIZE - uart_length;
+    }
+    (void)memcpy(&uart_capture[uart_length], tx, length);
+    uart_length += (uint32_t)length;
+    uart_capture[uart_length] = '\0';
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: uart_reset
+********************************************************************************
+* Summary:
+*  Empties the fake FIFO and the capture.
+*
+*******************************************************************************/
+static void uart_reset(bool auto_empty)
+{
+    uart_free = UART_FIFO_SIZE;
+    uart_length = 0u;
+    uart_capture[0] = '\0';
+    uart_auto_empty = auto_empty;
+}
+
+
+/*******************************************************************************
+* Function Name: console_key
+********************************************************************************
+* Summary:
+*  Runs the handler of a console command of trace.c.
+*
+*******************************************************************************/
+static void console_key(uint8_t command)
+{
+    uint32_t i;
+
+    for(i = 0u; i < sim_console_count; i++)
+    {
+        if(sim_console_table[i].command == command)
+        {
+            sim_console_table[i].handler(command);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: hex_value
+********************************************************************************
+* Summary:
+*  Returns the value of an upper-case hex digit.
+*
+*******************************************************************************/
+static uint32_t hex_value(char digit)
+{
+    return ((digit >= 'A') ? (uint32_t)(digit - 'A' + 10) : (uint32_t)(digit - '0')) & 0xFu;
+}
+
+
+/*******************************************************************************
+* Function Name: hex_field
+********************************************************************************
+* Summary:
+*  Reads a fixed number of hex digits.
+*
+*******************************************************************************/
+static uint32_t hex_field(const char *text, uint32_t digits)
+{
+    uint32_t value = 0u;
+    uint32_t i;
+
+    for(i = 0u; i < digits; i++)
+    {
+        value = (value << 4u) | hex_value(text[i]);
+    }
+
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: parse_dump
+********************************************************************************
+* Summary:
+*  Decodes the captured dump lines into the records, the base ticks and the
+*  dropped count, the way tools/trace_tool.py reads them. Checks that every
+*  line is whole and that the data matches the length in the header.
+*
+* Return:
+*  uint32_t: length of the records
+*
+*******************************************************************************/
+static uint32_t parse_dump(uint8_t *records, uint32_t *base, uint32_t *dropped)
+{
+    const char *line = uart_capture;
+    const char *end;
+    uint32_t expected = 0u;
+    uint32_t length = 0u;
+    bool done = false;
+    uint32_t i;
+
+    while(('\0' != *line) && !done)
+    {
+        end = strstr(line, "\r\n");
+        TEST_CHECK(NULL != end);
+        if(NULL == end)
+        {
+            break;
+        }
+
+        if(0 == strncmp(line, "TRACE END", 9u))
+        {
+            done = true;
+        }
+        else if(0 == strncmp(line, "TRACE ", 6u))
+        {
+            TEST_CHECK_EQ(end - line, 32);
+            *base = hex_field(&line[6], 8u);
+            expected = hex_field(&line[15], 8u);
+            *dropped = hex_field(&line[24], 8u);
+        }
+        else
+        {
+            TEST_CHECK(0 == strncmp(line, "TR ", 3u));
+            for(i = 3u; &line[i + 1u] < end; i += 2u)
+            {
+                records[length++] = (uint8_t)hex_field(&line[i], 2u);
+            }
+        }
+
+        line = end + 2;
+    }
+
+    TEST_CHECK(done);
+    TEST_CHECK_EQ(length, expected);
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: dump
+********************************************************************************
+* Summary:
+*  Dumps the ring through a UART that is always drained, and decodes it.
+*
+*******************************************************************************/
+static uint32_t dump(uint8_t *records, uint32_t *base, uint32_t *dropped)
+{
+    uart_reset(true);
+    console_key('t');
+    trace_process();
+
+    return parse_dump(records, base, dropped);
+}
+
+
+/*******************************************************************************
+* Function Name: get_varint
+********************************************************************************
+* Summary:
+*  Reads a varint of a decoded dump.
+*
+*******************************************************************************/
+static uint32_t get_varint(const uint8_t *records, uint32_t *pos)
+{
+    uint32_t value = 0u;
+    uint32_t shift = 0u;
+    uint8_t byte;
+
+    do
+    {
+        byte = records[(*pos)++];
+        value |= (uint32_t)(byte & 0x7Fu) << shift;
+        shift += 7u;
+    } while(0u != (byte & 0x80u));
+
+    return value;
+}
+
+
+/*******************************************************************************
+* Function Name: next_record
+********************************************************************************
+* Summary:
+*  Splits the record at a position of a decoded dump.
+*
+* Return:
+*  uint32_t: position of the next record
+*
+*******************************************************************************/
+static uint32_t next_record(const uint8_t *records, uint32_t pos, uint32_t *delta,
+                            uint32_t *event, uint32_t *block, const uint8_t **param)
+{
+    *delta = get_varint(records, &pos);
+    *event = get_varint(records, &pos);
+    *block = records[pos++];
+    *param = &records[pos];
+
+    return pos + *block;
+}
+
+
+/*******************************************************************************
+* Function Name: seen_connect
+********************************************************************************
+* Summary:
+*  Scenario handler: keeps the BD handle of a connection.
+*
+*******************************************************************************/
+static void seen_connect(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_conn_handle_t *handle = (cy_stc_ble_conn_handle_t *)eventParam;
+
+    (void)event;
+    seen.connects++;
+    seen.conn_bd_handle = handle->bdHandle;
+}
+
+
+/*******************************************************************************
+* Function Name: seen_ias_write
+********************************************************************************
+* Summary:
+*  Scenario handler: keeps the written alert level.
+*
+*******************************************************************************/
+static void seen_ias_write(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_ias_char_value_t *char_value = (cy_stc_ble_ias_char_value_t *)eventParam;
+
+    (void)event;
+    seen.alert_level = char_value->value->val[0];
+}
+
+
+/*******************************************************************************
+* Function Name: seen_gatts_write
+********************************************************************************
+* Summary:
+*  Scenario handler: keeps the handle and the value of a write.
+*
+*******************************************************************************/
+static void seen_gatts_write(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gatts_write_cmd_req_param_t *write_req =
+        (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParam;
+
+    (void)event;
+    seen.write_handle = write_req->handleValPair.attrHandle;
+    seen.write_len = write_req->handleValPair.value.len;
+    if(seen.write_len <= sizeof(seen.write_value))
+    {
+        (void)memcpy(seen.write_value, write_req->handleValPair.value.val, seen.write_len);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: seen_adv_report
+********************************************************************************
+* Summary:
+*  Scenario handler: keeps the address, the data and the RSSI of a report.
+*
+*******************************************************************************/
+static void seen_adv_report(uint32_t event, void *eventParam)
+{
+    cy_stc_ble_gapc_adv_report_param_t *report = (cy_stc_ble_gapc_adv_report_param_t *)eventParam;
+
+    (void)event;
+    (void)memcpy(seen.adv_addr, report->peerBdAddr, sizeof(seen.adv_addr));
+    seen.adv_len = report->dataLen;
+    if(seen.adv_len <= sizeof(seen.adv_data))
+    {
+        (void)memcpy(seen.adv_data, report->data, seen.adv_len);
+    }
+    seen.adv_rssi = report->rssi;
+}
+
+
+/*******************************************************************************
+* Function Name: run_scenario
+********************************************************************************
+* Summary:
+*  Passes a connection, an alert, a settings write, an advertising report,
+*  an event without captured parameters and a disconnection through a
+*  function, the dispatcher or trace_record() itself, advancing the ticks
+*  between them.
+*
+*******************************************************************************/
+static void run_scenario(void (*deliver)(uint32_t event, void *eventParam))
+{
+    static uint8_t level = CY_BLE_HIGH_ALERT;
+    static uint8_t setting[3] = { 0x01u, 0x02u, 0x03u };
+    static uint8_t addr[6] = { 0x11u, 0x22u, 0x33u, 0x44u, 0x55u, 0x66u };
+    static uint8_t data[5] = { 0x02u, 0x01u, 0x06u, 0xAAu, 0xBBu };
+    cy_stc_ble_conn_handle_t handle = { 3u, 0u };
+    cy_stc_ble_gatt_value_t level_value = { &level, 1u, 1u };
+    cy_stc_ble_ias_char_value_t char_value;
+    cy_stc_ble_gatts_write_cmd_req_param_t write_req;
+    cy_stc_ble_gapc_adv_report_param_t report;
+
+    (void)memset(&char_value, 0, sizeof(char_value));
+    char_value.connHandle = handle;
+    char_value.value = &level_value;
+
+    (void)memset(&write_req, 0, sizeof(write_req));
+    write_req.connHandle = handle;
+    write_req.handleValPair.attrHandle = CY_BLE_SETTINGS_SETTING_CHAR_HANDLE;
+    write_req.handleValPair.value.val = setting;
+    write_req.handleValPair.value.len = sizeof(setting);
+
+    (void)memset(&report, 0, sizeof(report));
+    report.peerBdAddr = addr;
+    report.data = data;
+    report.dataLen = sizeof(data);
+    report.rssi = -61;
+
+    sim_ticks = 1000u;
+    deliver(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+    sim_ticks += 10u;
+    deliver(CY_BLE_EVT_IASS_WRITE_CHAR_CMD, &char_value);
+    sim_ticks += 300u;
+    deliver(CY_BLE_EVT_GATTS_WRITE_REQ, &write_req);
+    sim_ticks += 5u;
+    deliver(CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT, &report);
+    sim_ticks += 70000u;
+    deliver(0x99u, &handle);
+    sim_ticks += 1u;
+    deliver(CY_BLE_EVT_GATT_DISCONNECT_IND, &handle);
+}
+
+
+/*******************************************************************************
+* Function Name: record_event
+********************************************************************************
+* Summary:
+*  Records an event without dispatching it.
+*
+*******************************************************************************/
+static void record_event(uint32_t event, void *eventParam)
+{
+    trace_record(event, eventParam);
+}
+
+
+/*******************************************************************************
+* Function Name: test_record_layout
+********************************************************************************
+* Summary:
+*  Each record holds the tick delta and the event code as varints, the
+*  parameter structure, and the bytes that its pointers refer to. Events
+*  without a parameter description have an empty block.
+*
+*******************************************************************************/
+static void test_record_layout(void)
+{
+    static uint8_t records[TRACE_RING_SIZE];
+    static const uint32_t deltas[] = { 0u, 10u, 300u, 5u, 70000u, 1u };
+    static const uint32_t events[] =
+    {
+        CY_BLE_EVT_GATT_CONNECT_IND, CY_BLE_EVT_IASS_WRITE_CHAR_CMD,
+        CY_BLE_EVT_GATTS_WRITE_REQ, CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT,
+        0x99u, CY_BLE_EVT_GATT_DISCONNECT_IND
+    };
+    const uint32_t blocks[] =
+    {
+        sizeof(cy_stc_ble_conn_handle_t), sizeof(cy_stc_ble_ias_char_value_t) + 1u,
+        sizeof(cy_stc_ble_gatts_write_cmd_req_param_t) + 3u,
+        sizeof(cy_stc_ble_gapc_adv_report_param_t) + 6u + 5u,
+        0u, sizeof(cy_stc_ble_conn_handle_t)
+    };
+    /* Header bytes: the delta of 300, the events 0x99 and 0x100 take two
+     * varint bytes and the delta of 70000 takes three
+     */
+    const uint32_t headers = (6u * 3u) + 1u + 1u + 1u + 2u;
+    uint32_t length;
+    uint32_t base = 0u;
+    uint32_t dropped = 0u;
+    uint32_t pos = 0u;
+    uint32_t delta;
+    uint32_t event;
+    uint32_t block;
+    const uint8_t *param;
+    uint32_t total = 0u;
+    uint32_t i;
+
+    trace_init();
+    run_scenario(record_event);
+
+    length = dump(records, &base, &dropped);
+    TEST_CHECK_EQ(base, 1000u);
+    TEST_CHECK_EQ(dropped, 0u);
+
+    for(i = 0u; i < (sizeof(deltas) / sizeof(deltas[0])); i++)
+    {
+        pos = next_record(records, pos, &delta, &event, &block, &param);
+        TEST_CHECK_EQ(delta, deltas[i]);
+        TEST_CHECK_EQ(event, events[i]);
+        TEST_CHECK_EQ(block, blocks[i]);
+        total += blocks[i];
+
+        if(CY_BLE_EVT_IASS_WRITE_CHAR_CMD == event)
+        {
+            TEST_CHECK_EQ(param[block - 1u], CY_BLE_HIGH_ALERT);
+        }
+        else if(CY_BLE_EVT_GATTS_WRITE_REQ == event)
+        {
+            TEST_CHECK_EQ(param[block - 1u], 0x03u);
+        }
+        else if(CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT == event)
+        {
+            TEST_CHECK_EQ(param[sizeof(cy_stc_ble_gapc_adv_report_param_t)], 0x11u);
+            TEST_CHECK_EQ(param[block - 1u], 0xBBu);
+        }
+        else
+        {
+            /* Plain structure */
+        }
+    }
+    TEST_CHECK_EQ(pos, length);
+    TEST_CHECK_EQ(length, total + headers);
+}
+
+
+/*******************************************************************************
+* Function Name: test_truncation
+********************************************************************************
+* Summary:
+*  A written value longer than the block is cut at TRACE_PARAM_MAX bytes;
+*  an IAS write without a value records the structure only.
+*
+*******************************************************************************/
+static void test_truncation(void)
+{
+    static uint8_t records[TRACE_RING_SIZE];
+    static uint8_t value[200];
+    cy_stc_ble_gatts_write_cmd_req_param_t write_req;
+    cy_stc_ble_ias_char_value_t char_value;
+    uint32_t base;
+    uint32_t dropped;
+    uint32_t pos;
+    uint32_t delta;
+    uint32_t event;
+    uint32_t block;
+    const uint8_t *param;
+    uint32_t i;
+
+    for(i = 0u; i < sizeof(value); i++)
+    {
+        value[i] = (uint8_t)i;
+    }
+
+    (void)memset(&write_req, 0, sizeof(write_req));
+    write_req.handleValPair.value.val = value;
+    write_req.handleValPair.value.len = sizeof(value);
+    (void)memset(&char_value, 0, sizeof(char_value));
+
+    trace_init();
+    trace_record(CY_BLE_EVT_GATTS_WRITE_REQ, &write_req);
+    trace_record(CY_BLE_EVT_IASS_WRITE_CHAR_CMD, &char_value);
+    trace_record(CY_BLE_EVT_GATT_CONNECT_IND, NULL);
+    (void)dump(records, &base, &dropped);
+
+    pos = next_record(records, 0u, &delta, &event, &block, &param);
+    TEST_CHECK_EQ(block, TRACE_PARAM_MAX);
+    TEST_CHECK(0 == memcmp(&param[sizeof(write_req)], value,
+                           TRACE_PARAM_MAX - sizeof(write_req)));
+
+    pos = next_record(records, pos, &delta, &event, &block, &param);
+    TEST_CHECK_EQ(block, sizeof(char_value));
+
+    (void)next_record(records, pos, &delta, &event, &block, &param);
+    TEST_CHECK_EQ(block, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_eviction
+********************************************************************************
+* Summary:
+*  When the ring wraps, the oldest records are dropped and counted, and the
+*  base moves with them, so the remaining records keep their times.
+*
+*******************************************************************************/
+static void test_eviction(void)
+{
+    static uint8_t records[TRACE_RING_SIZE];
+    cy_stc_ble_conn_handle_t handle = { 0u, 0u };
+    uint32_t length;
+    uint32_t base = 0u;
+    uint32_t dropped = 0u;
+    uint32_t pos = 0u;
+    uint32_t count = 0u;
+    uint32_t time;
+    uint32_t delta;
+    uint32_t event;
+    uint32_t block;
+    const uint8_t *param;
+    uint32_t first = 0u;
+    uint32_t i;
+
+    trace_init();
+    sim_ticks = 5000u;
+
+    for(i = 0u; i < EVICT_RECORDS; i++)
+    {
+        handle.bdHandle = (uint8_t)i;
+        trace_record(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+        sim_ticks += EVICT_DELTA;
+    }
+
+    length = dump(records, &base, &dropped);
+    TEST_CHECK(length <= TRACE_RING_SIZE);
+    TEST_CHECK(dropped > 0u);
+
+    time = base;
+    while(pos < length)
+    {
+        pos = next_record(records, pos, &delta, &event, &block, &param);
+        time += delta;
+        if(0u == count)
+        {
+            /* The BD handle numbers the record */
+            first = param[0];
+        }
+        else
+        {
+            TEST_CHECK_EQ(delta, EVICT_DELTA);
+        }
+        count++;
+
+        TEST_CHECK_EQ(time, 5000u + ((dropped + count - 1u) * EVICT_DELTA));
+    }
+
+    TEST_CHECK_EQ(count + dropped, EVICT_RECORDS);
+    TEST_CHECK_EQ(first, (uint8_t)dropped);
+    TEST_CHECK_EQ(time, sim_ticks - EVICT_DELTA);
+    printf("    %lu of %lu records kept in %u bytes\n", (unsigned long)count,
+           (unsigned long)EVICT_RECORDS, (unsigned int)TRACE_RING_SIZE);
+}
+
+
+/*******************************************************************************
+* Function Name: test_dump_paced
+********************************************************************************
+* Summary:
+*  A dump only writes whole lines that fit in the FIFO and resumes on the
+*  next call. Events during a dump are dropped and counted, and the clear
+*  command waits for the dump to end.
+*
+*******************************************************************************/
+static void test_dump_paced(void)
+{
+    static uint8_t records[TRACE_RING_SIZE];
+    cy_stc_ble_conn_handle_t handle = { 1u, 0u };
+    uint32_t base = 0u;
+    uint32_t dropped = 0u;
+    uint32_t calls = 0u;
+    uint32_t length;
+    uint32_t i;
+
+    trace_init();
+    for(i = 0u; i < 100u; i++)
+    {
+        trace_record(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+    }
+
+    uart_reset(false);
+    console_key('t');
+    while((calls < 1000u) && (NULL == strstr(uart_capture, "TRACE END\r\n")))
+    {
+        trace_process();
+        calls++;
+
+        /* Only whole lines */
+        TEST_CHECK((0u == uart_length) ||
+                   (0 == strcmp(&uart_capture[uart_length - 2u], "\r\n")));
+
+        /* Recording and clearing wait for the dump */
+        if(1u == calls)
+        {
+            trace_record(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+            console_key('c');
+        }
+
+        /* The UART shifts out a FIFO between calls */
+        uart_free = UART_FIFO_SIZE;
+    }
+
+    length = parse_dump(records, &base, &dropped);
+    TEST_CHECK(calls > 1u);
+    TEST_CHECK_EQ(length, 100u * (3u + sizeof(handle)));
+    TEST_CHECK_EQ(dropped, 0u);
+
+    /* Recording resumed and counts the event it missed */
+    trace_record(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+    length = dump(records, &base, &dropped);
+    TEST_CHECK_EQ(length, 101u * (3u + sizeof(handle)));
+    TEST_CHECK_EQ(dropped, 1u);
+
+    console_key('c');
+    length = dump(records, &base, &dropped);
+    TEST_CHECK_EQ(length, 0u);
+    TEST_CHECK_EQ(dropped, 0u);
+    printf("    %lu calls to dump %u records\n", (unsigned long)calls, 100u);
+}
+
+
+/*******************************************************************************
+* Function Name: test_replay
+********************************************************************************
+* Summary:
+*  A scenario passed through the dispatcher is recorded, dumped, decoded
+*  and replayed with the 'x' command. The handlers see the same parameters,
+*  with the pointers rebuilt to the captured bytes, and the replay is not
+*  recorded.
+*
+*******************************************************************************/
+static void test_replay(void)
+{
+    static const ble_dispatch_entry_t table[] =
+    {
+        { CY_BLE_EVT_GATT_CONNECT_IND,          seen_connect },
+        { CY_BLE_EVT_IASS_WRITE_CHAR_CMD,       seen_ias_write },
+        { CY_BLE_EVT_GATTS_WRITE_REQ,           seen_gatts_write },
+        { CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT, seen_adv_report },
+    };
+    static uint8_t records[TRACE_RING_SIZE];
+    seen_t live;
+    uint32_t base = 0u;
+    uint32_t dropped = 0u;
+    uint32_t length;
+    uint32_t pos;
+
+    ble_dispatch_init(NULL);
+    TEST_CHECK(ble_dispatch_register(table, BLE_DISPATCH_COUNT(table)));
+
+    trace_init();
+    (void)memset(&seen, 0, sizeof(seen));
+    run_scenario(ble_dispatch_event);
+    live = seen;
+    TEST_CHECK_EQ(live.connects, 1u);
+    TEST_CHECK_EQ(live.alert_level, CY_BLE_HIGH_ALERT);
+
+    length = dump(records, &base, &dropped);
+    TEST_CHECK(length < TRACE_RING_SIZE);
+
+    /* The records, then empty records of event 0 up to the end of the
+     * buffer. A delta of two or three varint bytes absorbs the remainder.
+     */
+    (void)memset(trace_replay_data, 0, sizeof(trace_replay_data));
+    (void)memcpy(trace_replay_data, records, length);
+    pos = length;
+    if(1u == ((sizeof(trace_replay_data) - pos) % 3u))
+    {
+        trace_replay_data[pos] = 0x80u;
+        pos += 4u;
+    }
+    else if(2u == ((sizeof(trace_replay_data) - pos) % 3u))
+    {
+        trace_replay_data[pos] = 0x80u;
+        trace_replay_data[pos + 1u] = 0x80u;
+        pos += 5u;
+    }
+    else
+    {
+        /* Whole empty records */
+    }
+
+    console_key('c');
+    (void)memset(&seen, 0, sizeof(seen));
+    console_key('x');
+
+    TEST_CHECK_EQ(seen.connects, 1u);
+    TEST_CHECK_EQ(seen.conn_bd_handle, live.conn_bd_handle);
+    TEST_CHECK_EQ(seen.alert_level, live.alert_level);
+    TEST_CHECK_EQ(seen.write_handle, live.write_handle);
+    TEST_CHECK_EQ(seen.write_len, live.write_len);
+    TEST_CHECK(0 == memcmp(seen.write_value, live.write_value, live.write_len));
+    TEST_CHECK(0 == memcmp(seen.adv_addr, live.adv_addr, sizeof(live.adv_addr)));
+    TEST_CHECK_EQ(seen.adv_len, live.adv_len);
+    TEST_CHECK(0 == memcmp(seen.adv_data, live.adv_data, live.adv_len));
+    TEST_CHECK_EQ(seen.adv_rssi, live.adv_rssi);
+
+    length = dump(records, &base, &dropped);
+    TEST_CHECK_EQ(length, 0u);
+    TEST_CHECK_EQ(dropped, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: bench_record
+********************************************************************************
+* Summary:
+*  Reports the ring bytes and the host time of a connection record and of
+*  an advertising report with a full payload.
+*
+*******************************************************************************/
+static void bench_record(void)
+{
+    static uint8_t data[ADV_DATA_SIZE];
+    static uint8_t addr[6];
+    cy_stc_ble_conn_handle_t handle = { 1u, 0u };
+    cy_stc_ble_gapc_adv_report_param_t report;
+    uint64_t start;
+    uint64_t connect_ns;
+    uint64_t report_ns;
+    uint32_t i;
+
+    (void)memset(&report, 0, sizeof(report));
+    report.peerBdAddr = addr;
+    report.data = data;
+    report.dataLen = ADV_DATA_SIZE;
+
+    trace_init();
+    start = test_now_ns();
+    for(i = 0u; i < BENCH_RECORDS; i++)
+    {
+        sim_ticks += 3u;
+        trace_record(CY_BLE_EVT_GATT_CONNECT_IND, &handle);
+    }
+    connect_ns = test_now_ns() - start;
+
+    start = test_now_ns();
+    for(i = 0u; i < BENCH_RECORDS; i++)
+    {
+        sim_ticks += 3u;
+        trace_record(CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT, &report);
+    }
+    report_ns = test_now_ns() - start;
+
+    printf("    connection: %u B, %.1f ns per record on the host\n",
+           (unsigned int)(3u + sizeof(handle)), (double)connect_ns / BENCH_RECORDS);
+    printf("    advertising report: %u B, %.1f ns per record on the host\n",
+           (unsigned int)(3u + sizeof(report) + sizeof(addr) + ADV_DATA_SIZE),
+           (double)report_ns / BENCH_RECORDS);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*  Runs the tests and the benchmark. Returns 1 if any check failed.
+*
+*******************************************************************************/
+int main(void)
+{
+    printf("trace\n");
+    TEST_RUN(test_record_layout);
+    TEST_RUN(test_truncation);
+    TEST_RUN(test_eviction);
+    TEST_RUN(test_dump_paced);
+    TEST_RUN(test_replay);
+    TEST_RUN(bench_record);
+
+    return TEST_RESULT();
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""
+Estimates the radio-on time and energy of a connection event on each PHY.
+
+The model is one exchange per connection event, as on an idle link or one
+carrying a notification: the Central sends a packet, the Peripheral answers
+after the inter frame space, and the event closes. The radio of the
+Peripheral is on from its wake-up ramp, through the receive window widening
+and the Central's packet, across the inter frame space and through its own
+packet. The payload is carried by the Peripheral's packet, or with
+--receive by the Central's packet, as for an alert write; the other packet
+is empty. Radio currents default to the PSoC 6 BLE datasheet figures at
+3.3 V and 0 dBm; pass the figures of another part to compare.
+
+Usage:
+    airtime_model.py [--payloads 0,20,100,251] [--encrypted] [--receive]
+                     [--interval-ms 1000] [--tx-ma 5.7] [--rx-ma 6.7]
+"""
+
+import argparse
+
+# Bytes of a link layer packet around its payload
+ACCESS_ADDRESS = 4
+HEADER = 2
+CRC = 3
+MIC = 4
+
+# Preamble bytes and microseconds per byte of each PHY
+PHYS = (("1M", 1, 8.0), ("2M", 2, 4.0))
+
+T_IFS_US = 150.0
+
+
+def packet_us(preamble, us_per_byte, payload, encrypted):
+    """Returns the air time of a packet in microseconds."""
+    length = preamble + ACCESS_ADDRESS + HEADER + payload + CRC
+    if encrypted and payload > 0:
+        length += MIC
+    return length * us_per_byte
+
+
+def event(preamble, us_per_byte, payload, args):
+    """Returns the receive and transmit time of the Peripheral in one
+    connection event, in microseconds."""
+    data = packet_us(preamble, us_per_byte, payload, args.encrypted)
+    empty = packet_us(preamble, us_per_byte, 0, args.encrypted)
+    rx_packet, tx_packet = (data, empty) if args.receive else (empty, data)
+    rx = args.ramp_us + args.widening_us + rx_packet + T_IFS_US
+    return rx, tx_packet
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--payloads", default="0,20,27,100,244,251",
+                        help="comma separated link layer payload sizes")
+    parser.add_argument("--encrypted", action="store_true",
+                        help="add the 4-byte MIC to non-empty packets")
+    parser.add_argument("--receive", action="store_true",
+                        help="the Central's packet carries the payload")
+    parser.add_argument("--interval-ms", type=float, default=None,
+                        help="also print the average radio current at this "
+                             "connection event period")
+    parser.add_argument("--ramp-us", type=float, default=80.0,
+                        help="radio wake-up before the receive window")
+    parser.add_argument("--widening-us", type=float, default=32.0,
+                        help="receive window widening for the clock drift")
+    parser.add_argument("--tx-ma", type=float, default=5.7,
+                        help="transmit current in mA")
+    parser.add_argument("--rx-ma", type=float, default=6.7,
+                        help="receive current in mA")
+    parser.add_argument("--volts", type=float, default=3.3,
+                        help="supply voltage")
+    args = parser.parse_args()
+
+    payloads = [int(p) for p in args.payloads.split(",")]
+    if any(p < 0 or p > 251 for p in payloads):
+        parser.error("payloads must be 0 to 251 bytes")
+
+    header = "%7s %4s %10s %10s %10s" % ("Payload", "PHY", "Packet us",
+                                          "Radio us", "Energy uJ")
+    if args.interval_ms:
+        header += " %10s" % "Avg uA"
+    header += " %8s" % "Saving"
+    print(header)
+
+    for payload in payloads:
+        energy_1m = None
+        for name, preamble, us_per_byte in PHYS:
+            rx, tx = event(preamble, us_per_byte, payload, args)
+            charge_nc = rx * args.rx_ma + tx * args.tx_ma
+            energy_uj = charge_nc * args.volts / 1000.0
+            line = "%7d %4s %10.1f %10.1f %10.2f" % (
+                payload, name,
+                packet_us(preamble, us_per_byte, payload, args.encrypted),
+                rx + tx, energy_uj)
+            if args.interval_ms:
+                line += " %10.2f" % (charge_nc / args.interval_ms)
+            if energy_1m is None:
+                energy_1m = energy_uj
+                line += " %8s" % "-"
+            else:
+                line += " %7.1f%%" % (100.0 * (1.0 - energy_uj / energy_1m))
+            print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Decodes the binary log stream written by app_log.c when APP_LOG_TEXT is 0.
+
+The message table is read from app_log.h, so the decoder always matches the
+firmware it was built from.
+
+Usage:
+    app_log_decode.py [--header ../app_log.h] [capture.bin]
+
+Reads the capture from stdin when no file is given, e.g. from a serial port:
+    cat /dev/ttyACM0 | app_log_decode.py
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC_BYTE = 0xA5
+RECORD_SIZE = 7
+LEVELS = {1: "[ERROR] : ", 2: "[INFO] : "}
+
+
+def load_messages(header):
+    """Returns the message texts in token order from APP_LOG_MESSAGES."""
+    with open(header, "r") as f:
+        text = f.read()
+    table = text.split("#define APP_LOG_MESSAGES(X)", 1)[1]
+    table = table.split("\n\n", 1)[0]
+    return [m.group(2) for m in
+            re.finditer(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', table)]
+
+
+def format_message(text, arg):
+    """Applies the single printf-style conversion of a message, if any."""
+    text = text.replace("%lX", "%X").replace("%lu", "%u").replace("%ld", "%d")
+    if "%" in text:
+        if "%d" in text and arg & 0x80000000:
+            arg -= 1 << 32
+        return text % arg
+    return text
+
+
+def decode(stream, messages):
+    data = stream.read()
+    i = 0
+    while i + RECORD_SIZE <= len(data):
+        if data[i] != SYNC_BYTE:
+            i += 1
+            continue
+        _, level, msg_id, arg = struct.unpack_from("<BBBI", data, i)
+        if level not in LEVELS or msg_id >= len(messages):
+            i += 1
+            continue
+        yield LEVELS[level] + format_message(messages[msg_id], arg)
+        i += RECORD_SIZE
+
+
+def main():
+    default_header = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                  "..", "app_log.h")
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--header", default=default_header,
+                        help="path to app_log.h (default: %(default)s)")
+    parser.add_argument("capture", nargs="?",
+                        help="binary capture file (default: stdin)")
+    args = parser.parse_args()
+
+    messages = load_messages(args.header)
+    if args.capture:
+        with open(args.capture, "rb") as stream:
+            lines = list(decode(stream, messages))
+    else:
+        lines = decode(sys.stdin.buffer, messages)
+    for line in lines:
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""
+Breaks the flash and RAM footprint of a build down per module.
+
+The sizes are read from the GNU linker map file. Application sources are
+reported per object file, libraries per library. Initialized data counts
+against both flash and RAM. The exit status is 1 when a total exceeds its
+budget, so a size regression fails the build like a failing test.
+
+Usage:
+    size_report.py [--flash-budget BYTES] [--ram-budget BYTES] app.map
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Output sections that only occupy RAM, and those copied from flash to RAM
+RAM_SECTIONS = {".bss", ".noinit", ".heap", ".ramVectors", ".cy_sharedmem",
+                ".stack_dummy"}
+LOAD_SECTIONS = {".data"}
+
+# Output sections that are not part of the image
+IGNORED_PREFIXES = (".debug", ".comment", ".ARM.attributes", ".stab",
+                    "/DISCARD/")
+
+OUTPUT_RE = re.compile(r"^(\.\S+|/DISCARD/)(?:\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+)?")
+INPUT_RE = re.compile(r"^\s+(?:\S+\s+)?0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+OBJECT_RE = re.compile(r"\.(o|obj)\)?$")
+
+
+def module_name(path):
+    """Returns the module an input file belongs to."""
+    member = re.match(r"(.*\.a)\((.*)\)$", path)
+    if member:
+        return os.path.basename(member.group(1))
+    parts = re.split(r"[\\/]", path)
+    for anchor in ("mtb_shared", "libs"):
+        if anchor in parts:
+            index = parts.index(anchor)
+            if index + 1 < len(parts) - 1:
+                return parts[index + 1]
+    return os.path.splitext(parts[-1])[0]
+
+
+def parse_map(stream):
+    """Returns {module: [flash, ram]} from the memory map of a map file."""
+    modules = {}
+    section = None
+    in_map = False
+    for line in stream:
+        line = line.rstrip("\n")
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+        output = OUTPUT_RE.match(line)
+        if output:
+            section = output.group(1)
+            continue
+        if section is None or section.startswith(IGNORED_PREFIXES):
+            continue
+        # Input sections name an object file; fill and symbol lines do not.
+        # A long input section name puts the address and size on the next
+        # line, which the expression accepts without a name.
+        match = INPUT_RE.match(line)
+        if not match or not OBJECT_RE.search(match.group(3)):
+            continue
+        size = int(match.group(2), 16)
+        sizes = modules.setdefault(module_name(match.group(3).strip()), [0, 0])
+        if section in RAM_SECTIONS:
+            sizes[1] += size
+        elif section in LOAD_SECTIONS:
+            sizes[0] += size
+            sizes[1] += size
+        else:
+            sizes[0] += size
+    return modules
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--flash-budget", type=int,
+                        help="fail if the flash total exceeds BYTES")
+    parser.add_argument("--ram-budget", type=int,
+                        help="fail if the RAM total exceeds BYTES")
+    parser.add_argument("map", help="linker map file")
+    args = parser.parse_args()
+
+    with open(args.map, "r", errors="replace") as stream:
+        modules = parse_map(stream)
+
+    flash = sum(sizes[0] for sizes in modules.values())
+    ram = sum(sizes[1] for sizes in modules.values())
+
+    print("%-32s %10s %10s" % ("Module", "Flash", "RAM"))
+    for name, sizes in sorted(modules.items(),
+                              key=lambda item: (-item[1][0], -item[1][1])):
+        print("%-32s %10d %10d" % (name, sizes[0], sizes[1]))
+    print("%-32s %10d %10d" % ("Total", flash, ram))
+
+    failed = False
+    for label, total, budget in (("Flash", flash, args.flash_budget),
+                                 ("RAM", ram, args.ram_budget)):
+        if budget is not None and total > budget:
+            print("%s budget exceeded: %d > %d bytes" % (label, total, budget))
+            failed = True
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
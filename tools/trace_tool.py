@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Decodes a BLE event trace dumped by trace.c and prepares it for replay.
+
+The dump is the text between the "TRACE" and "TRACE END" lines that the
+device prints on the 't' console command; other console output around it is
+ignored. Each record is printed with its absolute time, event code and
+parameter bytes.
+
+Usage:
+    trace_tool.py [capture.txt]
+    trace_tool.py --c-header ../trace_replay_data.h capture.txt
+
+With --c-header, the records are written as a C array for a firmware built
+with TRACE_REPLAY=1, which replays them on the 'x' console command. A trace
+only replays on the firmware build it was captured with, as the parameter
+blocks are raw copies of the stack structures.
+"""
+
+import argparse
+import sys
+
+TICKS_PER_SEC = 32768
+
+
+def read_dump(stream):
+    """Returns the base ticks, the dropped count and the record bytes."""
+    base = None
+    dropped = 0
+    length = 0
+    data = bytearray()
+    for line in stream:
+        line = line.strip()
+        if line.startswith("TRACE END"):
+            if base is not None:
+                break
+        elif line.startswith("TRACE "):
+            fields = line.split()
+            base = int(fields[1], 16)
+            length = int(fields[2], 16)
+            dropped = int(fields[3], 16)
+            data = bytearray()
+        elif line.startswith("TR ") and base is not None:
+            data += bytes.fromhex(line[3:])
+    if base is None:
+        sys.exit("no trace dump found")
+    if len(data) != length:
+        sys.exit("truncated dump: %d of %d bytes" % (len(data), length))
+    return base, dropped, bytes(data)
+
+
+def read_varint(data, i):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[i]
+        i += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, i
+
+
+def decode(data, base):
+    """Yields the absolute ticks, event code and parameter block of each
+    record."""
+    ticks = base
+    i = 0
+    while i < len(data):
+        delta, i = read_varint(data, i)
+        event, i = read_varint(data, i)
+        size = data[i]
+        block = data[i + 1:i + 1 + size]
+        i += 1 + size
+        ticks = (ticks + delta) & 0xFFFFFFFF
+        yield ticks, event, block
+
+
+def write_header(path, data):
+    with open(path, "w") as f:
+        f.write("/* Generated by tools/trace_tool.py. Do not edit. */\n")
+        f.write("static const uint8_t trace_replay_data[] =\n{\n")
+        for i in range(0, len(data), 12):
+            row = ", ".join("0x%02X" % b for b in data[i:i + 12])
+            f.write("    %s,\n" % row)
+        f.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--c-header", metavar="PATH",
+                        help="write the records as trace_replay_data.h")
+    parser.add_argument("capture", nargs="?",
+                        help="console capture (default: stdin)")
+    args = parser.parse_args()
+
+    if args.capture:
+        with open(args.capture, "r", errors="replace") as stream:
+            base, dropped, data = read_dump(stream)
+    else:
+        base, dropped, data = read_dump(sys.stdin)
+
+    if args.c_header:
+        if not data:
+            sys.exit("the trace is empty")
+        write_header(args.c_header, data)
+        return
+
+    count = 0
+    for ticks, event, block in decode(data, base):
+        print("%10.3f ms  0x%08X  %s" % (ticks * 1000.0 / TICKS_PER_SEC,
+                                        event, block.hex()))
+        count += 1
+    print("%d records, %d bytes, %d dropped" % (count, len(data), dropped))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,789 @@
+/******************************************************************************
+* File Name: trace.c
+*
+* Description: This file contains the BLE event trace. Every event that goes
+*              through the dispatcher is recorded with its parameters and a
+*              timestamp in a RAM ring of compact records. The ring is dumped
+*              on the debug UART as hex lines that tools/trace_tool.py
+*              decodes, and a dumped trace can be linked back into a build
+*              and replayed through the event handlers, which measures their
+*              time per event.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include "trace.h"
+
+#if (TRACE_ENABLE != 0u)
+
+#include "app_timer.h"
+#include "ble_dispatch.h"
+#include "console.h"
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#include "cycfg_ble.h"
+#include <string.h>
+
+#if (TRACE_REPLAY != 0u)
+#include "trace_replay_data.h"
+#include <stdio.h>
+#endif
+
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TRACE_RING_MASK           (TRACE_RING_SIZE - 1u)
+
+#if ((TRACE_RING_SIZE & TRACE_RING_MASK) != 0u)
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+#if (CONSOLE_ENABLE == 0u)
+#error "The trace is dumped on the console; set TRACE_ENABLE to 0"
+#endif
+
+/* A record is the tick delta to the previous record and the event code, both
+ * as base-128 varints, the length of the parameter block, and the block
+ */
+#define TRACE_VARINT_MAX          (5u)
+#define TRACE_HEADER_MAX          ((2u * TRACE_VARINT_MAX) + 1u)
+
+/* Stream bytes per dump line: "TR " followed by 32 hex digits */
+#define TRACE_DUMP_LINE_BYTES     (16u)
+#define TRACE_DUMP_LINE_SIZE      (3u + (2u * TRACE_DUMP_LINE_BYTES) + 2u)
+
+/* Address bytes of an advertising report */
+#define TRACE_BD_ADDR_SIZE        (6u)
+
+/* Console commands */
+#define TRACE_CMD_DUMP            ('t')
+#define TRACE_CMD_CLEAR           ('c')
+#define TRACE_CMD_REPLAY          ('x')
+
+/* Row of the parameter table */
+#define TRACE_PARAM(event, type, kind)                                        \
+    { (event), (uint16_t)sizeof(type), (uint8_t)(kind) }
+
+
+/*******************************************************************************
+* Data types
+********************************************************************************/
+/* How the parameters of an event are captured. Pointers in the parameters
+ * are meaningless in a dump, so the bytes they refer to are appended to the
+ * block and the pointers are rebuilt on replay.
+ */
+typedef enum
+{
+    TRACE_PARAM_PLAIN,        /* the parameter structure only */
+    TRACE_PARAM_GATTS_WRITE,  /* structure, then the written value */
+    TRACE_PARAM_IAS_WRITE,    /* structure, then the written value */
+    TRACE_PARAM_ADV_REPORT    /* structure, then the address and the data */
+} trace_param_kind_t;
+
+typedef struct
+{
+    uint32_t event;
+    uint16_t size;
+    uint8_t  kind;
+} trace_param_desc_t;
+
+typedef enum
+{
+    TRACE_DUMP_IDLE,
+    TRACE_DUMP_HEADER,
+    TRACE_DUMP_DATA,
+    TRACE_DUMP_END
+} trace_dump_state_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static const trace_param_desc_t* trace_find_desc(uint32_t event);
+static uint32_t trace_capture(uint32_t event, const void *eventParam, uint8_t *block);
+static uint32_t trace_put_varint(uint8_t *dst, uint32_t value);
+static uint32_t trace_get_varint(uint32_t pos, uint32_t *value);
+static void trace_evict(void);
+static void trace_console_handler(uint8_t command);
+static bool trace_write(const char *text, uint32_t length);
+static uint32_t trace_put_hex(char *dst, uint32_t value, uint32_t digits);
+#if (TRACE_REPLAY != 0u)
+static void trace_replay(const uint8_t *trace, uint32_t length);
+#endif
+
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Events whose parameters are captured. Other events are recorded without
+ * parameters and replayed with a NULL parameter.
+ */
+static const trace_param_desc_t trace_params[] =
+{
+    TRACE_PARAM(CY_BLE_EVT_TIMEOUT,
+                cy_stc_ble_timeout_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_STACK_BUSY_STATUS,
+                uint8_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GET_RSSI_COMPLETE,
+                cy_stc_ble_rssi_info_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_DATA_LENGTH_CHANGE,
+                cy_stc_ble_data_length_change_info_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_DEVICE_CONNECTED,
+                cy_stc_ble_gap_connected_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE,
+                cy_stc_ble_gap_enhance_conn_complete_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_DEVICE_DISCONNECTED,
+                cy_stc_ble_gap_disconnect_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_AUTH_REQ,
+                cy_stc_ble_gap_auth_info_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_AUTH_COMPLETE,
+                cy_stc_ble_gap_auth_info_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_AUTH_FAILED,
+                cy_stc_ble_gap_auth_info_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE,
+                cy_stc_ble_gap_conn_param_updated_in_controller_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_L2CAP_CONN_PARAM_UPDATE_RSP,
+                cy_stc_ble_l2cap_conn_update_rsp_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATT_CONNECT_IND,
+                cy_stc_ble_conn_handle_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATT_DISCONNECT_IND,
+                cy_stc_ble_conn_handle_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATTC_DISCOVERY_COMPLETE,
+                cy_stc_ble_conn_handle_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATTS_XCNHG_MTU_REQ,
+                cy_stc_ble_gatt_xchg_mtu_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATTC_XCHNG_MTU_RSP,
+                cy_stc_ble_gatt_xchg_mtu_param_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ,
+                cy_stc_ble_gatts_char_val_read_req_t, TRACE_PARAM_PLAIN),
+    TRACE_PARAM(CY_BLE_EVT_GATTS_WRITE_REQ,
+                cy_stc_ble_gatts_write_cmd_req_param_t, TRACE_PARAM_GATTS_WRITE),
+    TRACE_PARAM(CY_BLE_EVT_IASS_WRITE_CHAR_CMD,
+                cy_stc_ble_ias_char_value_t, TRACE_PARAM_IAS_WRITE),
+    TRACE_PARAM(CY_BLE_EVT_GAPC_SCAN_PROGRESS_RESULT,
+                cy_stc_ble_gapc_adv_report_param_t, TRACE_PARAM_ADV_REPORT)
+};
+
+static const console_entry_t trace_console_table[] =
+{
+    { TRACE_CMD_DUMP,   trace_console_handler },
+    { TRACE_CMD_CLEAR,  trace_console_handler },
+#if (TRACE_REPLAY != 0u)
+    { TRACE_CMD_REPLAY, trace_console_handler },
+#endif
+};
+
+/* Record ring. Written by the dispatcher and read by the dump, both from the
+ * main loop.
+ */
+static uint8_t trace_ring[TRACE_RING_SIZE];
+static uint32_t trace_wr;
+static uint32_t trace_rd;
+
+/* Ticks that the delta of the oldest record is relative to, and ticks of
+ * the newest record
+ */
+static uint32_t trace_base;
+static uint32_t trace_last;
+
+/* Records overwritten, or not recorded while a dump was in progress */
+static uint32_t trace_dropped;
+
+/* Set while the ring is dumped or a trace is replayed */
+static bool trace_paused;
+
+static trace_dump_state_t trace_dump_state;
+static uint32_t trace_dump_pos;
+
+
+/*******************************************************************************
+* Function Name: trace_init
+********************************************************************************
+* Summary:
+*  Empties the ring and registers the console commands.
+*
+*******************************************************************************/
+void trace_init(void)
+{
+    trace_wr = 0u;
+    trace_rd = 0u;
+    trace_dropped = 0u;
+    trace_paused = false;
+    trace_dump_state = TRACE_DUMP_IDLE;
+
+    (void)console_register(trace_console_table, CONSOLE_COUNT(trace_console_table));
+}
+
+
+/*******************************************************************************
+* Function Name: trace_record
+********************************************************************************
+* Summary:
+*  Appends an event to the ring, overwriting the oldest records if needed.
+*  Called by the dispatcher before the handlers run.
+*
+* Parameters:
+*  uint32_t event:          event code
+*  const void *eventParam:  event parameters, or NULL
+*
+*******************************************************************************/
+void trace_record(uint32_t event, const void *eventParam)
+{
+    static uint8_t record[TRACE_HEADER_MAX + TRACE_PARAM_MAX];
+    uint32_t now = app_timer_now();
+    uint32_t length;
+    uint32_t block;
+    uint32_t i;
+
+    if(trace_paused)
+    {
+        trace_dropped++;
+        return;
+    }
+
+    if(trace_wr == trace_rd)
+    {
+        trace_base = now;
+        trace_last = now;
+    }
+
+    length = trace_put_varint(record, now - trace_last);
+    length += trace_put_varint(&record[length], event);
+    block = trace_capture(event, eventParam, &record[length + 1u]);
+    record[length] = (uint8_t)block;
+    length += 1u + block;
+
+    while((TRACE_RING_SIZE - (trace_wr - trace_rd)) < length)
+    {
+        trace_evict();
+    }
+
+    for(i = 0u; i < length; i++)
+    {
+        trace_ring[(trace_wr + i) & TRACE_RING_MASK] = record[i];
+    }
+
+    trace_wr += length;
+    trace_last = now;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_process
+********************************************************************************
+* Summary:
+*  Continues a dump started from the console. A line is only written when it
+*  fits in the UART FIFO, so the dump never waits on the UART and the log
+*  records are not split. The dump is a header line with the base ticks, the
+*  length and the dropped count, the data lines, and an end line, all in hex.
+*
+*******************************************************************************/
+void trace_process(void)
+{
+    char line[TRACE_DUMP_LINE_SIZE];
+    uint32_t length;
+    uint32_t count;
+    uint32_t i;
+
+    while(TRACE_DUMP_IDLE != trace_dump_state)
+    {
+        if(TRACE_DUMP_HEADER == trace_dump_state)
+        {
+            (void)memcpy(line, "TRACE ", 6u);
+            length = 6u;
+            length += trace_put_hex(&line[length], trace_base, 8u);
+            line[length++] = ' ';
+            length += trace_put_hex(&line[length], trace_wr - trace_rd, 8u);
+            line[length++] = ' ';
+            length += trace_put_hex(&line[length], trace_dropped, 8u);
+            line[length++] = '\r';
+            line[length++] = '\n';
+
+            if(!trace_write(line, length))
+            {
+                break;
+            }
+            trace_dump_pos = trace_rd;
+            trace_dump_state = TRACE_DUMP_DATA;
+        }
+        else if(TRACE_DUMP_DATA == trace_dump_state)
+        {
+            count = trace_wr - trace_dump_pos;
+            if(0u == count)
+            {
+                trace_dump_state = TRACE_DUMP_END;
+                continue;
+            }
+            if(count > TRACE_DUMP_LINE_BYTES)
+            {
+                count = TRACE_DUMP_LINE_BYTES;
+            }
+
+            (void)memcpy(line, "TR ", 3u);
+            length = 3u;
+            for(i = 0u; i < count; i++)
+            {
+                length += trace_put_hex(&line[length],
+                                        trace_ring[(trace_dump_pos + i) & TRACE_RING_MASK], 2u);
+            }
+            line[length++] = '\r';
+            line[length++] = '\n';
+
+            if(!trace_write(line, length))
+            {
+                break;
+            }
+            trace_dump_pos += count;
+        }
+        else
+        {
+            if(!trace_write("TRACE END\r\n", 11u))
+            {
+                break;
+            }
+            trace_dump_state = TRACE_DUMP_IDLE;
+            trace_paused = false;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: trace_find_desc
+********************************************************************************
+* Summary:
+*  Returns how the parameters of an event are captured, or NULL if they are
+*  not.
+*
+*******************************************************************************/
+static const trace_param_desc_t* trace_find_desc(uint32_t event)
+{
+    uint32_t i;
+
+    for(i = 0u; i < (sizeof(trace_params) / sizeof(trace_params[0])); i++)
+    {
+        if(trace_params[i].event == event)
+        {
+            return &trace_params[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_capture
+********************************************************************************
+* Summary:
+*  Copies the parameter block of an event: the parameter structure, then the
+*  bytes its pointers refer to, up to TRACE_PARAM_MAX bytes in total.
+*
+* Parameters:
+*  uint32_t event:          event code
+*  const void *eventParam:  event parameters, or NULL
+*  uint8_t *block:          destination, TRACE_PARAM_MAX bytes
+*
+* Return:
+*  uint32_t: length of the block
+*
+*******************************************************************************/
+static uint32_t trace_capture(uint32_t event, const void *eventParam, uint8_t *block)
+{
+    const trace_param_desc_t *desc = trace_find_desc(event);
+    const uint8_t *extra = NULL;
+    uint32_t extra_length = 0u;
+    uint32_t offset;
+
+    if((NULL == desc) || (NULL == eventParam))
+    {
+        return 0u;
+    }
+
+    (void)memcpy(block, eventParam, desc->size);
+    offset = desc->size;
+
+    switch(desc->kind)
+    {
+        case TRACE_PARAM_GATTS_WRITE:
+        {
+            const cy_stc_ble_gatts_write_cmd_req_param_t *write_req = eventParam;
+
+            extra = write_req->handleValPair.value.val;
+            extra_length = write_req->handleValPair.value.len;
+            break;
+        }
+
+        case TRACE_PARAM_IAS_WRITE:
+        {
+            const cy_stc_ble_ias_char_value_t *char_value = eventParam;
+
+            if(NULL != char_value->value)
+            {
+                extra = char_value->value->val;
+                extra_length = char_value->value->len;
+            }
+            break;
+        }
+
+        case TRACE_PARAM_ADV_REPORT:
+        {
+            const cy_stc_ble_gapc_adv_report_param_t *report = eventParam;
+
+            (void)memcpy(&block[offset], report->peerBdAddr, TRACE_BD_ADDR_SIZE);
+            offset += TRACE_BD_ADDR_SIZE;
+            extra = report->data;
+            extra_length = report->dataLen;
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+
+    if(NULL == extra)
+    {
+        extra_length = 0u;
+    }
+    else if(extra_length > (TRACE_PARAM_MAX - offset))
+    {
+        extra_length = TRACE_PARAM_MAX - offset;
+    }
+    else
+    {
+        /* The whole value fits */
+    }
+
+    (void)memcpy(&block[offset], extra, extra_length);
+
+    return offset + extra_length;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_put_varint
+********************************************************************************
+* Summary:
+*  Writes a value as a base-128 varint, low bits first. Deltas between
+*  events are mostly below 128 ticks and take a single byte.
+*
+* Return:
+*  uint32_t: number of bytes written, at most TRACE_VARINT_MAX
+*
+*******************************************************************************/
+static uint32_t trace_put_varint(uint8_t *dst, uint32_t value)
+{
+    uint32_t length = 0u;
+
+    while(value >= 0x80u)
+    {
+        dst[length++] = (uint8_t)(value | 0x80u);
+        value >>= 7u;
+    }
+    dst[length++] = (uint8_t)value;
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_get_varint
+********************************************************************************
+* Summary:
+*  Reads a varint from the ring.
+*
+* Parameters:
+*  uint32_t pos:     ring position of the first byte
+*  uint32_t *value:  decoded value
+*
+* Return:
+*  uint32_t: number of bytes read
+*
+*******************************************************************************/
+static uint32_t trace_get_varint(uint32_t pos, uint32_t *value)
+{
+    uint32_t length = 0u;
+    uint32_t shift = 0u;
+    uint8_t byte;
+
+    *value = 0u;
+    do
+    {
+        byte = trace_ring[(pos + length) & TRACE_RING_MASK];
+        *value |= (uint32_t)(byte & 0x7Fu) << shift;
+        shift += 7u;
+        length++;
+    } while((0u != (byte & 0x80u)) && (length < TRACE_VARINT_MAX));
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_evict
+********************************************************************************
+* Summary:
+*  Drops the oldest record. Its delta moves into the base, so the times of
+*  the remaining records do not change.
+*
+*******************************************************************************/
+static void trace_evict(void)
+{
+    uint32_t delta;
+    uint32_t event;
+    uint32_t pos = trace_rd;
+
+    pos += trace_get_varint(pos, &delta);
+    pos += trace_get_varint(pos, &event);
+    pos += 1u + trace_ring[pos & TRACE_RING_MASK];
+
+    trace_base += delta;
+    trace_rd = pos;
+    trace_dropped++;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_console_handler
+********************************************************************************
+* Summary:
+*  Handles the console commands: 't' dumps the ring, 'c' clears it and, in a
+*  replay build, 'x' replays the linked trace. Recording pauses while the
+*  ring is dumped so that the dump is consistent.
+*
+*******************************************************************************/
+static void trace_console_handler(uint8_t command)
+{
+    if(TRACE_CMD_DUMP == command)
+    {
+        if(TRACE_DUMP_IDLE == trace_dump_state)
+        {
+            trace_paused = true;
+            trace_dump_state = TRACE_DUMP_HEADER;
+        }
+    }
+    else if(TRACE_CMD_CLEAR == command)
+    {
+        if(TRACE_DUMP_IDLE == trace_dump_state)
+        {
+            trace_rd = trace_wr;
+            trace_dropped = 0u;
+        }
+    }
+    else
+    {
+#if (TRACE_REPLAY != 0u)
+        trace_replay(trace_replay_data, sizeof(trace_replay_data));
+#endif
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: trace_write
+********************************************************************************
+* Summary:
+*  Writes a dump line to the debug UART if it fits in the FIFO.
+*
+* Return:
+*  bool: true if the line was written
+*
+*******************************************************************************/
+static bool trace_write(const char *text, uint32_t length)
+{
+    size_t size = length;
+
+    if(cyhal_uart_writable(&cy_retarget_io_uart_obj) < length)
+    {
+        return false;
+    }
+
+    (void)cyhal_uart_write(&cy_retarget_io_uart_obj, (void *)text, &size);
+
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_put_hex
+********************************************************************************
+* Summary:
+*  Formats a value as upper-case hex digits, most significant first. The
+*  dump does not use printf, which Release builds do not link.
+*
+* Return:
+*  uint32_t: number of characters written
+*
+*******************************************************************************/
+static uint32_t trace_put_hex(char *dst, uint32_t value, uint32_t digits)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint32_t i;
+
+    for(i = 0u; i < digits; i++)
+    {
+        dst[i] = hex[(value >> (4u * (digits - 1u - i))) & 0xFu];
+    }
+
+    return digits;
+}
+
+
+#if (TRACE_REPLAY != 0u)
+/*******************************************************************************
+* Function Name: trace_replay
+********************************************************************************
+* Summary:
+*  Replays a dumped trace through the dispatcher, in order and back to back,
+*  and prints the handler time per event code. The pointers in the
+*  parameters are rebuilt to refer to the captured bytes. Recording pauses
+*  during the replay. The handlers run against the live stack, so a replay
+*  reproduces the application state; API calls that need a peer fail.
+*
+* Parameters:
+*  const uint8_t *trace:  records, as decoded from a dump
+*  uint32_t length:       length of the records
+*
+*******************************************************************************/
+static void trace_replay(const uint8_t *trace, uint32_t length)
+{
+    static union
+    {
+        uint8_t  bytes[TRACE_PARAM_MAX];
+        uint32_t align;
+        void     *pointer;
+    } param;
+    static cy_stc_ble_gatt_value_t value;
+    static ble_dispatch_stats_t stats[BLE_DISPATCH_MAX_EVENTS];
+    const trace_param_desc_t *desc;
+    uint32_t pos = 0u;
+    uint32_t event;
+    uint32_t shift;
+    uint32_t block;
+    uint32_t events = 0u;
+    uint32_t dropped = trace_dropped;
+    uint32_t count;
+    uint32_t i;
+
+    trace_paused = true;
+    ble_dispatch_reset_stats();
+
+    while(pos < length)
+    {
+        /* The delta is skipped: events are replayed back to back */
+        while(0u != (trace[pos] & 0x80u))
+        {
+            pos++;
+        }
+        pos++;
+
+        event = 0u;
+        shift = 0u;
+        do
+        {
+            event |= (uint32_t)(trace[pos] & 0x7Fu) << shift;
+            shift += 7u;
+        } while(0u != (trace[pos++] & 0x80u));
+
+        block = trace[pos++];
+        (void)memcpy(param.bytes, &trace[pos], block);
+        pos += block;
+
+        desc = trace_find_desc(event);
+        if((NULL != desc) && (block >= desc->size))
+        {
+            if(TRACE_PARAM_GATTS_WRITE == desc->kind)
+            {
+                cy_stc_ble_gatts_write_cmd_req_param_t *write_req = (void *)param.bytes;
+
+                write_req->handleValPair.value.val = &param.bytes[desc->size];
+                write_req->handleValPair.value.len = (uint16_t)(block - desc->size);
+            }
+            else if(TRACE_PARAM_IAS_WRITE == desc->kind)
+            {
+                cy_stc_ble_ias_char_value_t *char_value = (void *)param.bytes;
+
+                value.val = &param.bytes[desc->size];
+                value.len = (uint16_t)(block - desc->size);
+                char_value->value = &value;
+            }
+            else if(TRACE_PARAM_ADV_REPORT == desc->kind)
+            {
+                cy_stc_ble_gapc_adv_report_param_t *report = (void *)param.bytes;
+
+                report->peerBdAddr = &param.bytes[desc->size];
+                report->data = &param.bytes[desc->size + TRACE_BD_ADDR_SIZE];
+                report->dataLen = (uint8_t)(block - desc->size - TRACE_BD_ADDR_SIZE);
+            }
+            else
+            {
+                /* No pointers to rebuild */
+            }
+        }
+
+        ble_dispatch_event(event, (0u == block) ? NULL : param.bytes);
+        events++;
+    }
+
+    /* Replayed events are not lost records */
+    trace_dropped = dropped;
+    trace_paused = false;
+
+    count = ble_dispatch_get_stats(stats, BLE_DISPATCH_MAX_EVENTS);
+    printf("Replayed %lu events (CPU cycles at %lu Hz):\r\n",
+           (unsigned long)events, (unsigned long)SystemCoreClock);
+    for(i = 0u; i < count; i++)
+    {
+        if(0u != stats[i].hits)
+        {
+            printf("0x%08lX n=%lu total=%lu max=%lu\r\n", (unsigned long)stats[i].event,
+                   (unsigned long)stats[i].hits, (unsigned long)stats[i].cycles_total,
+                   (unsigned long)stats[i].cycles_max);
+        }
+    }
+}
+#endif  /* (TRACE_REPLAY != 0u) */
+
+#endif  /* (TRACE_ENABLE != 0u) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: trace.h
+*
+* Description: This file is the public interface of trace.c, the recorder
+*              and replayer of BLE stack events.
+*
+* Related Document: README.md
+*
+*******************************************************************************
+* Copyright 2019-2021, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/******************************************************************************
+ * Include guard
+ *****************************************************************************/
+#ifndef TRACE_H
+#define TRACE_H
+
+
+/******************************************************************************
+ * Include header files
+ *****************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/******************************************************************************
+ * Macros
+ *****************************************************************************/
+/* The recorder is on in every build type; field issues show up in Release
+ * builds. Set to 0 to compile it out.
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE              (1u)
+#endif
+
+/* Bytes of the trace ring. Must be a power of two. The oldest records are
+ * overwritten when it is full.
+ */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE           (2048u)
+#endif
+
+/* Largest parameter block of a record, including the bytes that pointers in
+ * the event parameters refer to. Longer blocks are truncated.
+ */
+#define TRACE_PARAM_MAX           (96u)
+
+/* Set to 1 to link the trace in trace_replay_data.h, generated by
+ * tools/trace_tool.py, and replay it on a console command
+ */
+#ifndef TRACE_REPLAY
+#define TRACE_REPLAY              (0u)
+#endif
+
+
+/******************************************************************************
+ * Function prototypes
+ *****************************************************************************/
+#if (TRACE_ENABLE != 0u)
+void trace_init(void);
+void trace_record(uint32_t event, const void *eventParam);
+void trace_process(void);
+#else
+#define trace_init()              ((void)0)
+#define trace_record(event, eventParam)   ((void)0)
+#define trace_process()           ((void)0)
+#endif
+
+
+#endif  /* TRACE_H */
+
+
+/* [] END OF FILE */